@@ -159,6 +159,18 @@ public:
     auto dispatchPool(F&& f,
                       Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
 
+    template <class F, class... Args>
+    auto dispatchPool(ThreadPool::Priority priority, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    /**
+     * Dispatch a task to the pool that is discarded if token is cancelled before it has started.
+     * @see ThreadPool::enqueue
+     */
+    template <class F, class... Args>
+    auto dispatchPool(ThreadPool::Priority priority, CancellationToken token, F&& f,
+                      Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
+
     template <class F, class... Args>
     auto dispatchFront(F&& f,
                        Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
@@ -166,6 +178,7 @@ public:
     virtual void processFront();
 
     void waitForPool();
+    size_t getPoolSize() const;
     void setPostEnqueueFront(std::function<void()> func);
     void setProgressCallback(std::function<void(std::string)> progressCallback);
 
@@ -284,6 +297,20 @@ auto InviwoApplication::dispatchPool(F&& f, Args&&... args)
     return pool_.enqueue(std::forward<F>(f), std::forward<Args>(args)...);
 }
 
+template <class F, class... Args>
+auto InviwoApplication::dispatchPool(ThreadPool::Priority priority, F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+    return pool_.enqueue(priority, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <class F, class... Args>
+auto InviwoApplication::dispatchPool(ThreadPool::Priority priority, CancellationToken token, F&& f,
+                                     Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+    return pool_.enqueue(priority, std::move(token), std::forward<F>(f),
+                         std::forward<Args>(args)...);
+}
+
 template <class F, class... Args>
 auto InviwoApplication::dispatchFront(F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
@@ -312,6 +339,12 @@ auto dispatchPool(F&& f, Args&&... args) -> std::future<typename std::result_of<
     return InviwoApplication::getPtr()->dispatchPool(std::forward<F>(f),
                                                      std::forward<Args>(args)...);
 }
+template <class F, class... Args>
+auto dispatchPool(ThreadPool::Priority priority, F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+    return InviwoApplication::getPtr()->dispatchPool(priority, std::forward<F>(f),
+                                                     std::forward<Args>(args)...);
+}
 
 inline CameraFactory* InviwoApplication::getCameraFactory() const {
     return cameraFactory_.get();
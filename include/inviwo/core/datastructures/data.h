@@ -34,10 +34,41 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/representationconverterfactory.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/datastructures/diskrepresentation.h>
+#include <inviwo/core/util/introspection.h>
 #include <typeindex>
 
 namespace inviwo {
 
+namespace detail {
+
+template <typename Repr>
+auto representationElements(const Repr& repr, int) -> decltype(repr.getDimensions(), size_t()) {
+    return glm::compMul(repr.getDimensions());
+}
+template <typename Repr>
+auto representationElements(const Repr& repr, long) -> decltype(repr.getSize(), size_t()) {
+    return repr.getSize();
+}
+template <typename Repr>
+size_t representationElements(const Repr&, ...) {
+    return 0;
+}
+
+/**
+ * Number of bytes occupied by a representation. Disk representations are not counted since they
+ * do not hold any data in memory, and neither are representations that manage their own memory.
+ */
+template <typename Repr>
+size_t representationBytes(const Repr& repr) {
+    if (dynamic_cast<const DiskRepresentation<Repr>*>(&repr)) return 0;
+    if (dynamic_cast<const SelfManagedRepresentation*>(&repr)) return 0;
+    return representationElements(repr, 0) * repr.getDataFormat()->getSize();
+}
+
+}  // namespace detail
+
 /**
  * \ingroup datastructures
  *
@@ -75,6 +106,11 @@ namespace inviwo {
  *
  *
  *
+ * All representations are registered with the RepresentationMemoryManager. If a memory budget is
+ * set, the least recently used representations, except the last valid one, of Data objects that
+ * are only referenced by an outport may be evicted between network evaluations. They will then be
+ * recreated on the next access.
+ *
  * @note Do not use the same representation in different Data objects.
  * This can cause inconsistencies since the Data objects cannot know if
  * another one has edited the representation.
@@ -87,7 +123,7 @@ public:
     using repr = Repr;
 
     virtual Data<Self, Repr>* clone() const = 0;
-    virtual ~Data() = default;
+    virtual ~Data();
 
     /**
      * Get a representation of type T. If there already is a valid representation of type T, just
@@ -107,6 +143,27 @@ public:
     template <typename T>
     T* getEditableRepresentation();
 
+    /**
+     * Request a representation of type T without blocking the calling thread. The same work as in
+     * getRepresentation is done as a task on the application thread pool, and the returned future
+     * becomes ready when the representation is available. This can be used to prefetch data, like
+     * the next time step of a sequence, or to show a placeholder while the data is loaded.
+     * \code{.cpp}
+     *      auto next = volumes[i + 1]->requestRepresentation<VolumeRAM>();
+     *      ...
+     *      auto ram = next.get();  // Will rethrow any exception from the conversion
+     * \endcode
+     * If token is cancelled before the task has started, the request is discarded and the future
+     * will throw a std::future_error.
+     * @note The Data object has to outlive the request. Representations that need a graphics
+     * context, like GL representations, can not be requested from the pool and will fail to
+     * compile, see util::requires_graphics_context.
+     */
+    template <typename T>
+    std::future<const T*> requestRepresentation(
+        ThreadPool::Priority priority = ThreadPool::Priority::IO,
+        CancellationToken token = CancellationToken()) const;
+
     /**
     * Check if a specific representation type exists.
     * Example:
@@ -118,6 +175,13 @@ public:
     template <typename T>
     bool hasRepresentation() const;
 
+    /**
+     * Check if a representation of type T exists and is valid, i.e. can be used without any
+     * conversion.
+     */
+    template <typename T>
+    bool hasValidRepresentation() const;
+
     /**
      * Check if the Data object has any representation.
      * @return true if any representation exist, false otherwise.
@@ -177,6 +241,13 @@ protected:
     void copyRepresentationsTo(Data<Self, Repr>* targetData) const;
 
     std::shared_ptr<Repr> addRepresentationInternal(std::shared_ptr<Repr> representation) const;
+    void trackRepresentation(const std::shared_ptr<Repr>& representation) const;
+    /**
+     * Called by the RepresentationMemoryManager to evict a representation. Returns the removed
+     * representation or nullptr if it can not be evicted, i.e. if it is the last valid one or the
+     * Data object is busy.
+     */
+    std::shared_ptr<Repr> evictRepresentation(std::type_index type) const;
 
     mutable std::mutex mutex_;
     mutable std::unordered_map<std::type_index, std::shared_ptr<Repr>> representations_;
@@ -195,6 +266,11 @@ Data<Self, Repr>::Data(const Data<Self, Repr>& rhs)
     rhs.copyRepresentationsTo(this);
 }
 
+template <typename Self, typename Repr>
+Data<Self, Repr>::~Data() {
+    RepresentationMemoryManager::getPtr()->removeAll(this);
+}
+
 template <typename Self, typename Repr>
 Data<Self, Repr>& Data<Self, Repr>::operator=(const Data<Self, Repr>& that) {
     if (this != &that) {
@@ -219,6 +295,7 @@ const T* Data<Self, Repr>::getRepresentation() const {
     auto it = representations_.find(std::type_index(typeid(T)));
     if (it != representations_.end() && it->second->isValid()) {
         lastValidRepresentation_ = it->second;
+        RepresentationMemoryManager::getPtr()->touch(this, it->first);
         return dynamic_cast<const T*>(lastValidRepresentation_.get());
     } else {
         return getValidRepresentation<T>();
@@ -240,12 +317,14 @@ const T* Data<Self, Repr>::getValidRepresentation() const {
                 converter->update(lastValidRepresentation_, it->second);
                 lastValidRepresentation_ = it->second;
                 lastValidRepresentation_->setValid(true);
+                trackRepresentation(lastValidRepresentation_);
             } else {  // No representation found, create it
                 auto result = converter->createFrom(lastValidRepresentation_);
                 if (!result) throw ConverterException("Converter failed to create", IvwContext);
                 lastValidRepresentation_ = addRepresentationInternal(result);
             }
         }
+        RepresentationMemoryManager::getPtr()->countMiss(std::type_index(typeid(T)));
         return dynamic_cast<const T*>(lastValidRepresentation_.get());
     } else {
         throw ConverterException("Found no converters", IvwContext);
@@ -260,6 +339,17 @@ T* Data<Self, Repr>::getEditableRepresentation() {
     return const_cast<T*>(repr);
 }
 
+template <typename Self, typename Repr>
+template <typename T>
+std::future<const T*> Data<Self, Repr>::requestRepresentation(ThreadPool::Priority priority,
+                                                              CancellationToken token) const {
+    static_assert(!util::requires_graphics_context<T>::value,
+                  "Representations that need a graphics context have to be created on the main "
+                  "thread using getRepresentation");
+    return InviwoApplication::getPtr()->dispatchPool(
+        priority, std::move(token), [this]() { return getRepresentation<T>(); });
+}
+
 template <typename Self, typename Repr>
 template <typename T>
 bool Data<Self, Repr>::hasRepresentation() const {
@@ -267,6 +357,14 @@ bool Data<Self, Repr>::hasRepresentation() const {
     return util::has_key(representations_, std::type_index(typeid(T)));
 }
 
+template <typename Self, typename Repr>
+template <typename T>
+bool Data<Self, Repr>::hasValidRepresentation() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = representations_.find(std::type_index(typeid(T)));
+    return it != representations_.end() && it->second->isValid();
+}
+
 template <typename Self, typename Repr>
 void Data<Self, Repr>::invalidateAllOther(const Repr* repr) {
     bool found = false;
@@ -287,6 +385,7 @@ template <typename Self, typename Repr>
 void Data<Self, Repr>::clearRepresentations() {
     std::unique_lock<std::mutex> lock(mutex_);
     representations_.clear();
+    RepresentationMemoryManager::getPtr()->removeAll(this);
 }
 
 template <typename Self, typename Repr>
@@ -304,6 +403,30 @@ std::shared_ptr<Repr> Data<Self, Repr>::addRepresentationInternal(std::shared_pt
     repr->setValid(true);
     repr->setOwner(static_cast<Self*>(const_cast<Data<Self, Repr>*>(this)));
     representations_[repr->getTypeIndex()] = repr;
+    trackRepresentation(repr);
+    return repr;
+}
+
+template <typename Self, typename Repr>
+void Data<Self, Repr>::trackRepresentation(const std::shared_ptr<Repr>& repr) const {
+    const auto bytes = detail::representationBytes(*repr);
+    if (bytes == 0) return;
+    const auto type = repr->getTypeIndex();
+    RepresentationMemoryManager::getPtr()->track(
+        this, type, bytes, [this, type]() -> std::shared_ptr<void> {
+            return evictRepresentation(type);
+        });
+}
+
+template <typename Self, typename Repr>
+std::shared_ptr<Repr> Data<Self, Repr>::evictRepresentation(std::type_index type) const {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) return nullptr;
+
+    auto it = representations_.find(type);
+    if (it == representations_.end() || it->second == lastValidRepresentation_) return nullptr;
+    auto repr = it->second;
+    representations_.erase(it);
     return repr;
 }
 
@@ -319,6 +442,7 @@ void Data<Self, Repr>::removeRepresentation(const Repr* representation) {
 
     for (auto& elem : representations_) {
         if (elem.second.get() == representation) {
+            RepresentationMemoryManager::getPtr()->remove(this, elem.first);
             representations_.erase(elem.first);
             break;
         }
@@ -354,6 +478,11 @@ void Data<Self, Repr>::removeOtherRepresentations(const Repr* representation) {
         }
     }
     std::swap(repr, representations_);
+    for (auto& elem : repr) {
+        if (!util::has_key(representations_, elem.first)) {
+            RepresentationMemoryManager::getPtr()->remove(this, elem.first);
+        }
+    }
 }
 
 template <typename Self, typename Repr>
@@ -0,0 +1,161 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_REPRESENTATIONMEMORYMANAGER_H
+#define IVW_REPRESENTATIONMEMORYMANAGER_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <warn/pop>
+
+namespace inviwo {
+
+/**
+ * \ingroup datastructures
+ * \class RepresentationMemoryManager
+ * \brief Keeps track of the memory used by the representations of all Data objects and evicts the
+ * least recently used ones when a memory budget is exceeded.
+ *
+ * Every Data object registers its representations here when they are created or updated and
+ * touches them when they are accessed. When the total size exceeds the budget, representations are
+ * evicted starting from the least recently used one. A Data object always keeps its last valid
+ * representation, and disk representations and representations that manage their own memory are
+ * not counted, hence an evicted representation can always be recreated from the remaining ones on
+ * the next access.
+ *
+ * Anyone holding a Data object might also hold raw pointers to its representations, so only the
+ * representations of Data objects known to be unreferenced can be evicted. The
+ * ProcessorNetworkEvaluator enforces the budget after each network evaluation for the Data objects
+ * that are referenced by nothing but an outport.
+ *
+ * The budget defaults to 0, meaning unlimited, and is set from the SystemSettings.
+ */
+class IVW_CORE_API RepresentationMemoryManager {
+public:
+    /**
+     * Called to evict a representation, should remove it from its Data object and return it, or
+     * return nullptr if the representation can not be evicted at the moment.
+     */
+    using Evictor = std::function<std::shared_ptr<void>()>;
+
+    struct Stats {
+        size_t hits = 0;       ///< Requests served by an existing valid representation
+        size_t misses = 0;     ///< Requests that required a conversion
+        size_t evictions = 0;  ///< Representations evicted to stay within the budget
+        size_t bytes = 0;      ///< Bytes currently used by representations of this type
+    };
+
+    static RepresentationMemoryManager* getPtr();
+
+    RepresentationMemoryManager() = default;
+    RepresentationMemoryManager(const RepresentationMemoryManager&) = delete;
+    RepresentationMemoryManager& operator=(const RepresentationMemoryManager&) = delete;
+
+    /**
+     * Set the memory budget in bytes, 0 means unlimited. The budget is enforced by the next call
+     * to enforceBudget.
+     */
+    void setBudget(size_t bytes);
+    size_t getBudget() const;
+    /**
+     * Total number of bytes used by all tracked representations.
+     */
+    size_t getUsage() const;
+    bool isOverBudget() const;
+
+    /**
+     * Register a new representation, or update the size of an existing one, and mark it as most
+     * recently used.
+     */
+    void track(const void* owner, std::type_index type, size_t bytes, Evictor evictor);
+    /**
+     * Mark a representation as most recently used and count a hit for its type.
+     */
+    void touch(const void* owner, std::type_index type);
+    void remove(const void* owner, std::type_index type);
+    void removeAll(const void* owner);
+
+    void countMiss(std::type_index type);
+
+    /**
+     * Evict least recently used representations of the given owners until the usage is within
+     * the budget. The evicted representations are destroyed, hence nothing may hold pointers to
+     * the representations of the given owners.
+     */
+    void enforceBudget(const std::unordered_set<const void*>& evictable);
+
+    std::unordered_map<std::type_index, Stats> getStats() const;
+
+private:
+
+    struct Entry {
+        const void* owner;
+        std::type_index type;
+        size_t bytes;
+        Evictor evictor;
+    };
+    struct KeyHash {
+        size_t operator()(const std::pair<const void*, std::type_index>& key) const;
+    };
+    using Key = std::pair<const void*, std::type_index>;
+
+    void erase(std::list<Entry>::iterator it);
+
+    mutable std::mutex mutex_;
+    size_t budget_ = 0;
+    size_t usage_ = 0;
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+    std::unordered_map<std::type_index, Stats> stats_;
+};
+
+/**
+ * \ingroup datastructures
+ * Interface for representations that keep their memory usage within limits of their own, like
+ * VolumeBricked with its brick cache. They are not counted by the RepresentationMemoryManager.
+ */
+class IVW_CORE_API SelfManagedRepresentation {
+public:
+    virtual ~SelfManagedRepresentation() = default;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_REPRESENTATIONMEMORYMANAGER_H
@@ -0,0 +1,187 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEBRICKED_H
+#define IVW_VOLUMEBRICKED_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <warn/pop>
+
+namespace inviwo {
+
+class VolumeRAM;
+class VolumeDisk;
+
+/**
+ * \ingroup datastructures
+ * A volume split into bricks of fixed size, each stored as a separate VolumeRAM. Every brick is
+ * padded with ghost layers of voxels from its neighbors, clamped to the volume, such that
+ * trilinear interpolation and central differences can be evaluated within a single brick.
+ *
+ * A bricked volume created from a VolumeDisk with a VolumeRegionLoader reads bricks on demand
+ * and keeps at most getCacheLimit() bytes of them in memory, evicting the least recently used
+ * bricks. Bricks are read outside of the lock, so several bricks can be read in parallel while
+ * threads requesting a brick that is being read wait for it. Bricks set with setBrick, or bricks
+ * of a volume without a VolumeDisk, stay in memory.
+ * The min and max of the voxels of each brick are computed when it is set or read, and kept after
+ * it has been evicted, such that they can be used for empty space skipping. Since the brick cache
+ * has its own limit, bricked volumes are not counted by the RepresentationMemoryManager.
+ */
+class IVW_CORE_API VolumeBricked : public VolumeRepresentation, public SelfManagedRepresentation {
+public:
+    struct Region {
+        size3_t offset;
+        size3_t dimensions;
+    };
+
+    VolumeBricked(size3_t dimensions = size3_t(128, 128, 128),
+                  const DataFormatBase* format = DataUInt8::get(),
+                  size3_t brickSize = size3_t(64), size_t ghostLayers = 1);
+    VolumeBricked(std::shared_ptr<const VolumeDisk> disk, size3_t brickSize = size3_t(64),
+                  size_t ghostLayers = 1);
+    VolumeBricked(const VolumeBricked& rhs);
+    VolumeBricked& operator=(const VolumeBricked& that);
+    virtual VolumeBricked* clone() const override;
+    virtual ~VolumeBricked() = default;
+
+    virtual std::type_index getTypeIndex() const override final;
+
+    /**
+     * Resize to dimensions. This is destructive, all bricks are reset to zero.
+     */
+    virtual void setDimensions(size3_t dimensions) override;
+    virtual const size3_t& getDimensions() const override;
+
+    const size3_t& getBrickSize() const;
+    size_t getGhostLayers() const;
+    /**
+     * The number of bricks along each axis.
+     */
+    const size3_t& getBrickCount() const;
+    size_t getNumberOfBricks() const;
+    size3_t getBrickForVoxel(const size3_t& voxel) const;
+
+    /**
+     * The voxels owned by brick, without ghost layers.
+     */
+    Region getBrickInterior(const size3_t& brick) const;
+    /**
+     * The voxels stored in brick, including ghost layers.
+     */
+    Region getBrickRegion(const size3_t& brick) const;
+
+    /**
+     * The data of brick with the dimensions of getBrickRegion(brick). The brick is read from disk
+     * if it is not in memory.
+     */
+    std::shared_ptr<const VolumeRAM> getBrick(const size3_t& brick) const;
+    /**
+     * Set the data of brick, data has to have the dimensions of getBrickRegion(brick) and the
+     * format of this representation.
+     */
+    void setBrick(const size3_t& brick, std::shared_ptr<const VolumeRAM> data);
+    /**
+     * Split volume into bricks, replacing all bricks. The bricks stay in memory.
+     */
+    void setBricks(const VolumeRAM& volume);
+    bool isBrickInMemory(const size3_t& brick) const;
+
+    /**
+     * True if the min and max of brick are known, i.e. if the brick has been built or read.
+     */
+    bool hasBrickMinMax(const size3_t& brick) const;
+    /**
+     * Min and max of each component over the interior voxels of brick. They are computed when a
+     * brick is set or read, this never reads the brick. Until the brick has been read, the range
+     * of the data format is returned, which is conservative for empty space skipping.
+     */
+    std::pair<dvec4, dvec4> getBrickMinMax(const size3_t& brick) const;
+
+    /**
+     * Copy the voxels in [offset, offset + dimensions) into a new VolumeRAM, reading only the
+     * bricks overlapping the region.
+     */
+    std::shared_ptr<VolumeRAM> readRegion(const size3_t& offset, const size3_t& dimensions) const;
+
+    void setCacheLimit(size_t bytes);
+    size_t getCacheLimit() const;
+    /**
+     * Bytes used by bricks that can be evicted from memory.
+     */
+    size_t getCachedBytes() const;
+
+private:
+    struct Brick {
+        std::shared_ptr<const VolumeRAM> data;
+        bool evictable = false;
+        bool loading = false;  ///< being read from disk by some thread
+        bool hasMinMax = false;
+        std::pair<dvec4, dvec4> minMax;
+        std::list<size_t>::iterator lru;
+    };
+
+    size_t index(const size3_t& brick) const;
+    void initBricks();
+    /**
+     * Returns the data of brick, reading it from disk if needed. Called with lock holding mutex_,
+     * which is released while reading.
+     */
+    std::shared_ptr<const VolumeRAM> load(std::unique_lock<std::mutex>& lock,
+                                          const size3_t& brick) const;
+    void enforceCacheLimit() const;
+
+    size3_t dimensions_;
+    size3_t brickSize_;
+    size_t ghostLayers_;
+    size3_t brickCount_;
+    std::shared_ptr<const VolumeDisk> disk_;
+    size_t cacheLimit_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable loaded_;
+    size_t generation_ = 0;  ///< incremented whenever the bricks are replaced
+    mutable std::vector<Brick> bricks_;
+    mutable std::list<size_t> lru_;  ///< evictable bricks in memory, most recently used first
+    mutable size_t cachedBytes_ = 0;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMEBRICKED_H
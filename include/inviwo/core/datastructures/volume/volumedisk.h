@@ -37,6 +37,22 @@
 
 namespace inviwo {
 
+class VolumeRAM;
+
+/**
+ * \ingroup datastructures
+ * Interface for VolumeDisk loaders that can read a part of a volume without loading all of it.
+ */
+class IVW_CORE_API VolumeRegionLoader {
+public:
+    virtual ~VolumeRegionLoader() = default;
+    /**
+     * Read the voxels in [offset, offset + dimensions) into a new VolumeRAM.
+     */
+    virtual std::shared_ptr<VolumeRAM> readRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const = 0;
+};
+
 /**
  * \ingroup datastructures	
  */
@@ -56,6 +72,13 @@ public:
 
     virtual void setDimensions(size3_t dimensions) override;
     virtual const size3_t& getDimensions() const override;
+
+    /**
+     * Read the voxels in [offset, offset + dimensions) from disk if the loader is a
+     * VolumeRegionLoader, otherwise return nullptr.
+     */
+    std::shared_ptr<VolumeRAM> readRegion(const size3_t& offset, const size3_t& dimensions) const;
+
 private:
     size3_t dimensions_;
 };
@@ -32,91 +32,323 @@
 
 #include <inviwo/core/datastructures/histogram.h>
 #include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <warn/pop>
+
 namespace inviwo {
 
 namespace util {
 
+namespace detail {
+
+/**
+ * Bin counts and statistics for a range of z slices of a volume.
+ */
 template <typename T>
-HistogramContainer calculateVolumeHistogram(const T* data, size3_t dimensions, dvec2 dataRange,
-                                            const bool& stop = false, size_t bins = 2048,
-                                            size3_t sampleRate = size3_t(1)) {
+struct VolumeHistogramPartial {
     // a double type with the same extent as T
-    typedef typename util::same_extent<T, double>::type D;
-    // a size_t type with same extent as T
-    typedef typename util::same_extent<T, size_t>::type I;
-    
-    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
-    
-    // check whether number of bins exceeds the data range only if it is an integral type
-    if (!util::is_floating_point<T>::value) {
-        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
-    }
+    using D = typename util::same_extent<T, double>::type;
 
-    HistogramContainer histograms;
-    for (size_t i = 0; i < extent; ++i) {
-        histograms.add(new NormalizedHistogram(bins));
+    VolumeHistogramPartial(size_t bins, size_t extent)
+        : counts(bins * extent, 0)
+        , min(std::numeric_limits<double>::max())
+        , max(std::numeric_limits<double>::lowest())
+        , sum(0)
+        , sum2(0)
+        , count(0)
+        , significant(0) {}
+
+    void merge(const VolumeHistogramPartial& other) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+        sum += other.sum;
+        sum2 += other.sum2;
+        count += other.count;
+        significant += other.significant;
     }
 
-    D min(std::numeric_limits<double>::max());
-    D max(std::numeric_limits<double>::lowest());
-    D sum(0);
-    D sum2(0);
-    double count(0);
+    std::vector<size_t> counts;  // extent blocks of bins
+    D min;
+    D max;
+    D sum;
+    D sum2;
+    double count;
+    size_t significant;  // voxels with at least one non zero component
+};
 
-    D val;
-    I ind;
-    size_t v;
+// 8 and 16 bit integer scalars are counted per value, bins and statistics are then derived from
+// the value counts instead of converting every voxel to double.
+template <typename T>
+using UseValueCounts =
+    std::integral_constant<bool, std::is_integral<T>::value && (sizeof(T) <= 2)>;
+
+template <typename T>
+void accumulateVolumeHistogram(const T* data, size3_t dimensions, size_t zStart, size_t zEnd,
+                               size3_t sampleRate, dvec2 dataRange, size_t bins,
+                               const bool& stop, VolumeHistogramPartial<T>& res) {
+    using D = typename VolumeHistogramPartial<T>::D;
+    // a size_t type with same extent as T
+    using I = typename util::same_extent<T, size_t>::type;
+    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
 
     const D rangeMin(dataRange.x);
     const D rangeScaleFactor(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
-
     util::IndexMapper3D mapper(dimensions);
 
-    size3_t pos(0);
-    // Column major data, so x is the fastest index.
-    for (pos.z = 0; pos.z < dimensions.z; pos.z += sampleRate.z) {
-        for (pos.y = 0; pos.y < dimensions.y; pos.y += sampleRate.y) {
-            for (pos.x = 0; pos.x < dimensions.x; pos.x += sampleRate.x) {
-                if (stop) return histograms;
+    D min(res.min);
+    D max(res.max);
+    D sum(res.sum);
+    D sum2(res.sum2);
+    double count(res.count);
+    size_t significant(res.significant);
 
-                val = static_cast<D>(data[mapper(pos)]);
+    // Column major data, so x is the fastest index.
+    for (size_t z = zStart; z < zEnd; z += sampleRate.z) {
+        for (size_t y = 0; y < dimensions.y; y += sampleRate.y) {
+            if (stop) return;
+            const T* row = data + mapper(size3_t(0, y, z));
+            for (size_t x = 0; x < dimensions.x; x += sampleRate.x) {
+                const D val = static_cast<D>(row[x]);
 
                 min = glm::min(min, val);
                 max = glm::max(max, val);
                 sum += val;
                 sum2 += val * val;
                 count++;
+                significant += static_cast<size_t>(util::any(row[x] != T(0)));
 
-                ind = static_cast<I>((val - rangeMin) * rangeScaleFactor);
-
+                const I ind = static_cast<I>((val - rangeMin) * rangeScaleFactor);
                 for (size_t i = 0; i < extent; ++i) {
-                    v = util::glmcomp(ind, i);
-                    if (v < bins) {
-                        histograms[i][v]++;
-                    } 
+                    const size_t v = util::glmcomp(ind, i);
+                    if (v < bins) ++res.counts[i * bins + v];
                 }
             }
         }
     }
+    res.min = min;
+    res.max = max;
+    res.sum = sum;
+    res.sum2 = sum2;
+    res.count = count;
+    res.significant = significant;
+}
+
+template <typename T>
+size_t valueCountSize() {
+    return static_cast<size_t>(std::numeric_limits<T>::max()) -
+           static_cast<size_t>(std::numeric_limits<T>::lowest()) + 1;
+}
+
+/**
+ * Each chunk of the value counting path holds one counter per value, i.e. 512 KiB for 16 bit
+ * types. Use at most one chunk per thread, and a single chunk if there are fewer voxels than
+ * values.
+ */
+template <typename T>
+size_t histogramChunks(size_t chunks, size_t voxels, std::true_type) {
+    if (voxels < valueCountSize<T>()) return 1;
+    return std::max<size_t>(1, std::min(chunks, util::getPoolSize() + 1));
+}
+
+template <typename T>
+size_t histogramChunks(size_t chunks, size_t, std::false_type) {
+    return chunks;
+}
+
+template <typename T>
+void countVolumeValues(const T* data, size3_t dimensions, size_t zStart, size_t zEnd,
+                       size3_t sampleRate, const bool& stop, std::vector<size_t>& counts) {
+    util::IndexMapper3D mapper(dimensions);
+    for (size_t z = zStart; z < zEnd; z += sampleRate.z) {
+        for (size_t y = 0; y < dimensions.y; y += sampleRate.y) {
+            if (stop) return;
+            const T* row = data + mapper(size3_t(0, y, z));
+            for (size_t x = 0; x < dimensions.x; x += sampleRate.x) {
+                ++counts[static_cast<size_t>(row[x] - std::numeric_limits<T>::lowest())];
+            }
+        }
+    }
+}
+
+template <typename T>
+VolumeHistogramPartial<T> calculateVolumeHistogramPartial(
+    const T* data, size3_t dimensions, dvec2 dataRange, const bool& stop, size_t bins,
+    size3_t sampleRate, size_t chunks, std::false_type) {
+    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    const size_t slices = (dimensions.z + sampleRate.z - 1) / sampleRate.z;
+
+    std::vector<VolumeHistogramPartial<T>> partials(chunks,
+                                                    VolumeHistogramPartial<T>(bins, extent));
+    util::parallelFor(chunks, [&](size_t chunk) {
+        accumulateVolumeHistogram(data, dimensions, (chunk * slices / chunks) * sampleRate.z,
+                                  ((chunk + 1) * slices / chunks) * sampleRate.z, sampleRate,
+                                  dataRange, bins, stop, partials[chunk]);
+    });
+
+    auto& res = partials.front();
+    for (size_t chunk = 1; chunk < chunks; ++chunk) res.merge(partials[chunk]);
+    return std::move(res);
+}
+
+template <typename T>
+VolumeHistogramPartial<T> binValueCounts(const std::vector<size_t>& counts, dvec2 dataRange,
+                                         size_t bins) {
+    VolumeHistogramPartial<T> res(bins, 1);
+    const double rangeMin(dataRange.x);
+    const double rangeScaleFactor(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const auto c = counts[i];
+        if (c == 0) continue;
+        const double val =
+            static_cast<double>(i) + static_cast<double>(std::numeric_limits<T>::lowest());
+        const double n = static_cast<double>(c);
+        res.min = std::min(res.min, val);
+        res.max = std::max(res.max, val);
+        res.sum += n * val;
+        res.sum2 += n * val * val;
+        res.count += n;
+        if (val != 0.0) res.significant += c;
+
+        const double ind = (val - rangeMin) * rangeScaleFactor;
+        if (ind > -1.0 && ind < static_cast<double>(bins)) {
+            res.counts[static_cast<size_t>(std::max(ind, 0.0))] += c;
+        }
+    }
+    return res;
+}
+
+template <typename T>
+VolumeHistogramPartial<T> calculateVolumeHistogramPartial(
+    const T* data, size3_t dimensions, dvec2 dataRange, const bool& stop, size_t bins,
+    size3_t sampleRate, size_t chunks, std::true_type) {
+    const size_t values = valueCountSize<T>();
+    const size_t slices = (dimensions.z + sampleRate.z - 1) / sampleRate.z;
+    chunks = histogramChunks<T>(chunks,
+                                ((dimensions.x + sampleRate.x - 1) / sampleRate.x) *
+                                    ((dimensions.y + sampleRate.y - 1) / sampleRate.y) * slices,
+                                std::true_type{});
+
+    std::vector<std::vector<size_t>> partials(chunks, std::vector<size_t>(values, 0));
+    util::parallelFor(chunks, [&](size_t chunk) {
+        countVolumeValues(data, dimensions, (chunk * slices / chunks) * sampleRate.z,
+                          ((chunk + 1) * slices / chunks) * sampleRate.z, sampleRate, stop,
+                          partials[chunk]);
+    });
+    auto& counts = partials.front();
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        const auto& p = partials[chunk];
+        for (size_t i = 0; i < values; ++i) counts[i] += p[i];
+    }
+    return binValueCounts<T>(counts, dataRange, bins);
+}
+
+/**
+ * Clamp the number of bins to the data range for integral types.
+ */
+template <typename T>
+size_t histogramBins(size_t bins, dvec2 dataRange) {
+    if (!util::is_floating_point<T>::value) {
+        return std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
+    }
+    return bins;
+}
+
+template <typename T>
+HistogramContainer makeVolumeHistograms(const VolumeHistogramPartial<T>& res, dvec2 dataRange,
+                                        size_t bins) {
+    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
 
+    HistogramContainer histograms;
+    const auto count = res.count;
     for (size_t i = 0; i < extent; ++i) {
+        histograms.add(new NormalizedHistogram(bins));
+        for (size_t v = 0; v < bins; ++v) {
+            histograms[i][v] = static_cast<double>(res.counts[i * bins + v]);
+        }
         histograms[i].dataRange_ = dataRange;
-        histograms[i].stats_.min = util::glmcomp(min, i);
-        histograms[i].stats_.max = util::glmcomp(max, i);
-        histograms[i].stats_.mean = util::glmcomp(sum, i) / count;
-        histograms[i].stats_.standardDeviation = std::sqrt(
-            (count * util::glmcomp(sum2, i) - util::glmcomp(sum, i) * util::glmcomp(sum, i)) /
-            (count * (count - 1)));
+        histograms[i].stats_.min = util::glmcomp(res.min, i);
+        histograms[i].stats_.max = util::glmcomp(res.max, i);
+        histograms[i].stats_.mean = util::glmcomp(res.sum, i) / count;
+        histograms[i].stats_.standardDeviation =
+            std::sqrt((count * util::glmcomp(res.sum2, i) -
+                       util::glmcomp(res.sum, i) * util::glmcomp(res.sum, i)) /
+                      (count * (count - 1)));
 
         histograms[i].calculatePercentiles();
         histograms[i].performNormalization();
         histograms[i].calculateHistStats();
         histograms[i].setValid(true);
     }
-
     return histograms;
 }
 
+}  // namespace detail
+
+/**
+ * Statistics of volume data gathered in a single pass, see calculateVolumeStatistics.
+ */
+struct VolumeStatistics {
+    dvec4 min;
+    dvec4 max;
+    size_t significantVoxels;  ///< Sampled voxels with at least one non zero component
+    HistogramContainer histograms;
+};
+
+/**
+ * Calculates min, max, the number of significant voxels and one histogram per component of the
+ * volume data, together with mean, standard deviation and percentiles, in a single pass over the
+ * data. The volume is split into slabs along z that are processed in parallel on the thread
+ * pool, each with private bins that are merged at the end. 8 and 16 bit integer scalar data is
+ * counted per value and binned afterwards. For integer types the number of bins is clamped to
+ * the number of values in dataRange. If stop is set during the calculation, the histograms are
+ * empty and invalid.
+ */
+template <typename T>
+VolumeStatistics calculateVolumeStatistics(const T* data, size3_t dimensions, dvec2 dataRange,
+                                           const bool& stop = false, size_t bins = 2048,
+                                           size3_t sampleRate = size3_t(1)) {
+    bins = detail::histogramBins<T>(bins, dataRange);
+
+    const size_t slices = (dimensions.z + sampleRate.z - 1) / sampleRate.z;
+    const size_t chunks = util::parallelChunks(slices);
+
+    auto res = detail::calculateVolumeHistogramPartial(data, dimensions, dataRange, stop, bins,
+                                                       sampleRate, chunks,
+                                                       detail::UseValueCounts<T>{});
+
+    VolumeStatistics stats{util::glm_convert<dvec4>(res.min), util::glm_convert<dvec4>(res.max),
+                           res.significant, HistogramContainer{}};
+    if (stop) {
+        const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+        for (size_t i = 0; i < extent; ++i) {
+            stats.histograms.add(new NormalizedHistogram(bins));
+        }
+    } else {
+        stats.histograms = detail::makeVolumeHistograms(res, dataRange, bins);
+    }
+    return stats;
+}
+
+/**
+ * Calculates one histogram per component of the volume data.
+ * @see calculateVolumeStatistics
+ */
+template <typename T>
+HistogramContainer calculateVolumeHistogram(const T* data, size3_t dimensions, dvec2 dataRange,
+                                            const bool& stop = false, size_t bins = 2048,
+                                            size3_t sampleRate = size3_t(1)) {
+    return std::move(
+        calculateVolumeStatistics(data, dimensions, dataRange, stop, bins, sampleRate)
+            .histograms);
+}
+
 } // util
 
 }  // namespace
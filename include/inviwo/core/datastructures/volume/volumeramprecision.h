@@ -48,6 +48,12 @@ public:
 
     VolumeRAMPrecision(size3_t dimensions = size3_t(128, 128, 128));
     VolumeRAMPrecision(T* data, size3_t dimensions = size3_t(128, 128, 128));
+    /**
+     * Use data owned by dataOwner, for example a memory mapped file, without taking ownership of
+     * the data pointer. dataOwner is kept alive for as long as the data is in use. Copies of the
+     * representation get their own data.
+     */
+    VolumeRAMPrecision(T* data, size3_t dimensions, std::shared_ptr<void> dataOwner);
     VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs);
     VolumeRAMPrecision<T>& operator=(const VolumeRAMPrecision<T>& that);
     virtual VolumeRAMPrecision<T>* clone() const override;
@@ -106,6 +112,7 @@ private:
     size3_t dimensions_;
     bool ownsDataPtr_;
     std::unique_ptr<T[]> data_;
+    std::shared_ptr<void> dataOwner_;
     mutable HistogramContainer histCont_;
 };
 
@@ -136,6 +143,15 @@ VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions)
     , ownsDataPtr_(true)
     , data_(data ? data : new T[dimensions_.x * dimensions_.y * dimensions_.z]()) {}
 
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions,
+                                          std::shared_ptr<void> dataOwner)
+    : VolumeRAM(DataFormat<T>::get())
+    , dimensions_(dimensions)
+    , ownsDataPtr_(false)
+    , data_(data)
+    , dataOwner_(std::move(dataOwner)) {}
+
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs)
     : VolumeRAM(rhs)
@@ -155,7 +171,9 @@ VolumeRAMPrecision<T>& VolumeRAMPrecision<T>::operator=(const VolumeRAMPrecision
         std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * dim.z * sizeof(T));
         data_.swap(data);
         std::swap(dim, dimensions_);
+        if (!ownsDataPtr_) data.release();
         ownsDataPtr_ = true;
+        dataOwner_.reset();
     }
     return *this;
 }
@@ -207,6 +225,7 @@ void VolumeRAMPrecision<T>::setData(void* d, size3_t dimensions) {
 
     if (!ownsDataPtr_) data.release();
     ownsDataPtr_ = true;
+    dataOwner_.reset();
 }
 
 template <typename T>
@@ -231,6 +250,7 @@ void VolumeRAMPrecision<T>::setDimensions(size3_t dimensions) {
     dimensions_ = dimensions;
     if (!ownsDataPtr_) data.release();
     ownsDataPtr_ = true;
+    dataOwner_.reset();
 }
 
 template <typename T>
@@ -0,0 +1,85 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_RAWVOLUMEHISTOGRAM_H
+#define IVW_RAWVOLUMEHISTOGRAM_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/histogram.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <functional>
+#include <warn/pop>
+
+namespace inviwo {
+
+class Volume;
+class RawVolumeRAMLoader;
+
+namespace util {
+
+/**
+ * Calculates histograms of a raw volume file by streaming it through memory in slabs of at most
+ * maxSlabBytes, without ever creating a VolumeRAM for the whole volume. Each slab is binned in
+ * parallel on the thread pool. For strided sampling, i.e. sampleRate.z > 1, only the sampled
+ * slices are read from disk.
+ * If the calculation is stopped the returned container holds one empty histogram per component
+ * that is not valid, callers have to check HistogramContainer::isValid() before using it.
+ * @param loader the loader of the raw file
+ * @param dataRange data range used for binning
+ * @param stop abort the calculation when set to true
+ * @param bins number of bins
+ * @param sampleRate sample every sampleRate voxel along each axis
+ * @param progress called with the fraction of the volume processed so far
+ * @param maxSlabBytes upper bound for the memory used for each slab
+ */
+IVW_CORE_API HistogramContainer calculateVolumeHistogram(
+    const RawVolumeRAMLoader& loader, dvec2 dataRange, const bool& stop = false,
+    size_t bins = 2048, size3_t sampleRate = size3_t(1),
+    std::function<void(float)> progress = nullptr, size_t maxSlabBytes = 64 * 1024 * 1024);
+
+/**
+ * Calculates histograms of a volume. If the volume only has a disk representation backed by a
+ * raw file the histograms are calculated by streaming the file, otherwise the histograms of
+ * the VolumeRAM representation are used. Stopping behaves as for the raw file overload.
+ * @see calculateVolumeHistogram(const RawVolumeRAMLoader&, dvec2, const bool&, size_t, size3_t,
+ *      std::function<void(float)>, size_t)
+ */
+IVW_CORE_API HistogramContainer calculateVolumeHistogram(
+    const Volume& volume, const bool& stop = false, size_t bins = 2048,
+    size3_t sampleRate = size3_t(1), std::function<void(float)> progress = nullptr,
+    size_t maxSlabBytes = 64 * 1024 * 1024);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_RAWVOLUMEHISTOGRAM_H
@@ -36,6 +36,7 @@
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/datastructures/diskrepresentation.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/memorymappedfile.h>
 
 namespace inviwo {
 
@@ -43,6 +44,16 @@ namespace inviwo {
  * \class RawVolumeRAMLoader
  * \brief A loader of raw files. Used to create VolumeRAM representations.
  * This class us used by the DatVolumeReader, IvfVolumeReader and RawVolumeReader.
+ *
+ * By default the raw file is read into memory. If memory mapping is enabled, see
+ * setMemoryMapping, data that does not need byte swapping is not read, instead the
+ * representation refers directly to a copy-on-write memory map of the raw file. Pages are then
+ * loaded on demand and shared with other processes through the page cache, and only pages that
+ * are written to get copied. Note that the representation then aliases the file: pages that have
+ * not been written to reflect later changes of the file, and truncating the file while it is
+ * mapped makes accessing the data crash (SIGBUS). Only enable mapping for files that are not
+ * modified while in use. Representations created by updateRepresentation or clone always hold
+ * their own data.
  */
 
 class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation> {
@@ -53,6 +64,24 @@ public:
     virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override;
     virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override;
 
+    /**
+     * Read the slices [zStart, zEnd) into dest, which has to be large enough to hold
+     * (zEnd - zStart) * dimensions.x * dimensions.y voxels. Used to stream through a volume
+     * without loading all of it into memory.
+     */
+    void readSlices(size_t zStart, size_t zEnd, void* dest) const;
+
+    /**
+     * Enable or disable memory mapping of raw files for representations created from now on.
+     * Disabled by default, controlled by the "Memory map raw volume files" system setting.
+     */
+    static void setMemoryMapping(bool enable);
+    static bool getMemoryMapping();
+
+    const std::string& getRawFile() const;
+    const size3_t& getDimensions() const;
+    const DataFormatBase* getDataFormat() const;
+
     using type = std::shared_ptr<VolumeRAM>;
 
     template <class T>
@@ -60,6 +89,12 @@ public:
         typedef typename T::type F;
 
         std::size_t size = dimensions_.x * dimensions_.y * dimensions_.z;
+
+        if (auto file = mapFile(size * sizeof(F), alignof(F))) {
+            auto data = reinterpret_cast<F*>(file->data() + offset_);
+            return std::make_shared<VolumeRAMPrecision<F>>(data, dimensions_, file);
+        }
+
         auto data = util::make_unique<F[]>(size);
 
         if (!data) {
@@ -76,6 +111,12 @@ public:
     }
 
 private:
+    /**
+     * Returns a memory map of the raw file if memory mapping is enabled and the data can be used
+     * as is, i.e. no byte swapping is needed and the data is suitably aligned, otherwise nullptr.
+     */
+    std::shared_ptr<MemoryMappedFile> mapFile(size_t bytes, size_t alignment) const;
+
     std::string rawFile_;
     size_t offset_;
     size3_t dimensions_;
@@ -0,0 +1,83 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_BINARYDOCUMENT_H
+#define IVW_BINARYDOCUMENT_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/io/serialization/ticpp.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <iosfwd>
+#include <string>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Write doc in a compact binary encoding. All element names, attribute names and values are
+ * stored once in a string table and the tree refers to them by index, so reading it back requires
+ * no XML parsing. Elements, attributes, text, comments and declarations are preserved.
+ * @throws SerializationException if the stream can not be written
+ */
+IVW_CORE_API void writeBinaryDocument(const TxDocument& doc, std::ostream& stream);
+
+/**
+ * Read a document written by writeBinaryDocument, appending its nodes to doc.
+ * @throws SerializationException if the stream does not contain a valid binary document
+ */
+IVW_CORE_API void readBinaryDocument(std::istream& stream, TxDocument& doc);
+
+/**
+ * Check whether stream starts with a binary document. The stream position is not changed.
+ */
+IVW_CORE_API bool isBinaryDocument(std::istream& stream);
+
+/**
+ * Read a document in either the XML or binary encoding.
+ * @throws TxException if the XML can not be parsed
+ */
+IVW_CORE_API void readDocument(std::istream& stream, TxDocument& doc);
+
+/**
+ * Convert a workspace between the XML (.inv) and the binary encoding. The encoding of the source
+ * is detected from its content, the binary encoding is written if dst has the extension given
+ * by SerializeConstants::BinaryWorkspaceExtension and XML otherwise.
+ * @throws SerializationException if the files can not be read or written
+ */
+IVW_CORE_API void convertWorkspace(const std::string& src, const std::string& dst);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_BINARYDOCUMENT_H
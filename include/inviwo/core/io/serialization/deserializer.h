@@ -40,7 +40,10 @@
 
 #include <type_traits>
 #include <list>
+#include <unordered_map>
 #include <istream>
+#include <algorithm>
+#include <chrono>
 
 namespace inviwo {
 
@@ -262,6 +265,14 @@ public:
 
     int getInviwoWorkspaceVersion() const;
 
+protected:
+    /**
+     * Looks up children by name. Elements that are looked up repeatedly, typically an object
+     * deserializing its members, get their children indexed by name so that each lookup does
+     * not have to scan all the children.
+     */
+    virtual TxElement* retrieveChild(const std::string& key) override;
+
 private:
 
     // integers, strings
@@ -278,6 +289,13 @@ private:
 
     ExceptionHandler exceptionHandler_;
     std::map<std::string, TxElement*> referenceLookup_;
+
+    struct ChildIndex {
+        size_t lookups = 0;
+        bool indexed = false;
+        std::unordered_map<std::string, TxElement*> children;  // name -> first child
+    };
+    std::unordered_map<const TxElement*, ChildIndex> childIndex_;
     
     std::vector<FactoryBase*> registeredFactories_;
 
@@ -297,6 +315,7 @@ public:
     };
     using Getter = std::function<Item(const K& id, size_t ind)>;
     using IdentityGetter = std::function<K(TxElement* node)>;
+    using ItemTimer = std::function<void(const K& id, T& value, double seconds)>;
 
     ContainerWrapper(std::string itemKey, Getter getItem) : getItem_(getItem), itemKey_(itemKey) {}
 
@@ -305,10 +324,19 @@ public:
     const std::string& getItemKey() const { return itemKey_; }
 
     void deserialize(Deserializer& d, TxElement* node, size_t ind) {
-        auto item = getItem_(idGetter_(node), ind);
+        const auto id = idGetter_(node);
+        auto item = getItem_(id, ind);
         if (item.doDeserialize) {
             try {
-                d.deserialize(itemKey_, item.value);
+                if (timer_) {
+                    const auto start = std::chrono::high_resolution_clock::now();
+                    d.deserialize(itemKey_, item.value);
+                    const std::chrono::duration<double> elapsed =
+                        std::chrono::high_resolution_clock::now() - start;
+                    timer_(id, item.value, elapsed.count());
+                } else {
+                    d.deserialize(itemKey_, item.value);
+                }
                 item.callback(item.value);
             } catch (...) {
                 d.handleError(IvwContext);
@@ -317,6 +345,10 @@ public:
     }
 
     void setIdentityGetter(IdentityGetter getter) { idGetter_ = getter; }
+    /**
+     * Called with the time spent deserializing each item, not including the item callback.
+     */
+    void setItemTimer(ItemTimer timer) { timer_ = timer; }
 
 private:
     IdentityGetter idGetter_ = [](TxElement* node) {
@@ -326,11 +358,27 @@ private:
     };
 
     Getter getItem_;
+    ItemTimer timer_;
     const std::string itemKey_;
 };
 
 namespace util {
 
+namespace detail {
+
+/**
+ * Call onRemove, in order, for the ids in toRemove that are not in found. Sorts found, which
+ * avoids searching all found ids for each id.
+ */
+template <typename K, typename F>
+void removeNotFound(const std::vector<K>& toRemove, std::vector<K>& found, F& onRemove) {
+    std::sort(found.begin(), found.end());
+    for (auto& id : toRemove) {
+        if (!std::binary_search(found.begin(), found.end(), id)) onRemove(id);
+    }
+}
+
+}  // namespace detail
 
 /**
  * A helper class for more advanced deserialization. useful when one has to call observer 
@@ -436,10 +484,16 @@ public:
     void operator()(Deserializer& d, C& container) {
         T tmp{};
         auto toRemove = util::transform(container, [&](const T& x)->K {return getID_(x);});
+        std::vector<K> found;
         ContainerWrapper<T, K> cont(
             itemKey_, [&](K id, size_t ind) -> typename ContainerWrapper<T, K>::Item {
-                util::erase_remove(toRemove, id);
-                auto it = util::find_if(container, [&](T& i) { return getID_(i) == id; });
+                found.push_back(id);
+                // Items are usually stored in the same order as in the container
+                auto it = ind < container.size() ? std::next(std::begin(container), ind)
+                                                 : std::end(container);
+                if (it == std::end(container) || !(getID_(*it) == id)) {
+                    it = util::find_if(container, [&](T& i) { return getID_(i) == id; });
+                }
                 if (it != container.end()) {
                     return {true, *it, [&](T& /*val*/) {}};
                 } else {
@@ -449,7 +503,7 @@ public:
             });
 
         d.deserialize(key_, cont);
-        for (auto& id : toRemove) onRemoveItem_(id);
+        detail::removeNotFound(toRemove, found, onRemoveItem_);
     }
 
 private:
@@ -492,6 +546,13 @@ public:
         onRemoveItem_ = onRemoveItem;
         return *this;
     }
+    /**
+     * Called with the time spent deserializing each item, see ContainerWrapper::setItemTimer.
+     */
+    MapDeserializer<K, T>& setItemTimer(std::function<void(const K&, T&, double)> timer) {
+        timer_ = timer;
+        return *this;
+    }
     MapDeserializer<K, T>& setIdentifierTransform(std::function<K(const K&)> identifierTransform) {
         identifierTransform_ = identifierTransform;
         return *this;
@@ -502,9 +563,10 @@ public:
         T tmp{};
         auto toRemove =
             util::transform(container, [](const std::pair<const K, T>& item) { return item.first; });
+        std::vector<K> found;
         ContainerWrapper<T, K> cont(
             itemKey_, [&](K id, size_t ind) -> typename ContainerWrapper<T, K>::Item {
-                util::erase_remove(toRemove, id);
+                found.push_back(id);
                 auto it = container.find(id);
                 if (it != container.end()) {
                     return {true, it->second, [&](T& /*val*/) {}};
@@ -519,10 +581,15 @@ public:
             node->GetAttribute(attribKey_, &key);
             return identifierTransform_(key);
         });
+        if (timer_) {
+            cont.setItemTimer([&](const K& id, T& value, double seconds) {
+                timer_(id, value, seconds);
+            });
+        }
 
         d.deserialize(key_, cont);
 
-        for (auto& id : toRemove) onRemoveItem_(id);
+        detail::removeNotFound(toRemove, found, onRemoveItem_);
     }
 
 private:
@@ -541,6 +608,7 @@ private:
     std::function<K(const K&)> identifierTransform_ = [](const K &identifier) { 
         return identifier; 
     };
+    std::function<void(const K&, T&, double)> timer_;
 
     const std::string key_;
     const std::string itemKey_;
@@ -799,7 +867,11 @@ void Deserializer::deserialize(const std::string& key, std::vector<T*>& vector,
     TxEIt child(itemKey);
     for (child = child.begin(rootElement_); child != child.end(); ++child) {
         identifier.setKey(child.Get());
-        auto it = std::find_if(vector.begin(), vector.end(), identifier);
+        // Items are usually stored in the same order as in the vector, try the next one first
+        auto it = lastInsertion != vector.end() ? std::next(lastInsertion) : vector.end();
+        if (it == vector.end() || !identifier(*it)) {
+            it = std::find_if(vector.begin(), vector.end(), identifier);
+        }
 
         if (it != vector.end()) {  // There is a item in vector with same identifier as on disk
             NodeSwitch elementNodeSwitch(*this, &(*child), false);
@@ -858,7 +930,7 @@ void Deserializer::deserialize(const std::string& key, std::list<T>& container,
                                const std::string& itemKey) {
     NodeSwitch vectorNodeSwitch(*this, key);
     if (!vectorNodeSwitch) return;
-    unsigned int i = 0;
+    auto it = container.begin();
     TxEIt child(itemKey);
 
     for (child = child.begin(rootElement_); child != child.end(); ++child) {
@@ -866,17 +938,18 @@ void Deserializer::deserialize(const std::string& key, std::list<T>& container,
         // hence the "false" as the last arg.
         NodeSwitch elementNodeSwitch(*this, &(*child), false);
         try {
-            if (container.size() <= i) {
+            if (it == container.end()) {
                 T item;
                 deserialize(itemKey, item);
                 container.push_back(item);
             } else {
-                deserialize(itemKey, *std::next(container.begin(), i));
+                deserialize(itemKey, *it);
+                ++it;
             }
         } catch (...) {
+            if (it != container.end()) ++it;
             handleError(IvwContext);
         }
-        i++;
     }
 }
 
@@ -987,7 +1060,7 @@ void Deserializer::deserialize(const std::string& key, std::map<K, std::unique_p
 
 template <class T>
 void Deserializer::deserialize(const std::string& key, T*& data) {
-    auto keyNode = retrieveChild_ ? rootElement_->FirstChildElement(key, false) : rootElement_;
+    auto keyNode = retrieveChild_ ? retrieveChild(key) : rootElement_;
     if (!keyNode) return;
 
     const std::string type_attr(keyNode->GetAttribute(SerializeConstants::TypeAttribute));
@@ -102,7 +102,7 @@ public:
      * and de-serializer. Some of them are reference data manager,
      * (ticpp::Node) node switch and factory registration.
      *
-     * @param stream containing all xml data (for reading).
+     * @param stream containing all xml data, or a binary document (for reading).
      * @param path A path that will be used to decode the location of data during deserialization. 
      * @param allowReference disables or enables reference management schemes.
      */
@@ -156,6 +156,8 @@ public:
 
     private:
         RefMap referenceMap_;
+        // (type, reference or id) -> data, of inserted nodes that have those attributes
+        std::map<std::pair<std::string, std::string>, void*> lookup_;
         int referenceCount_ = 0;
     };
 
@@ -165,6 +167,12 @@ public:
 protected:
     friend class NodeSwitch;
 
+    /**
+     * \brief Returns the first child element of the current root element named key, or nullptr
+     * if there is none.
+     */
+    virtual TxElement* retrieveChild(const std::string& key);
+
     std::string fileName_;
     TxDocument doc_;
     TxElement* rootElement_;
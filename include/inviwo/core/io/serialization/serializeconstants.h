@@ -43,6 +43,7 @@ public:
     static const std::string VersionAttribute;
     static const std::string ContentAttribute;
     static const std::string KeyAttribute;
+    static const std::string BinaryWorkspaceExtension;
     
     // For reference management
     static const std::string TypeAttribute;
@@ -76,6 +76,15 @@ public:
      */
     virtual void writeFile(std::ostream& stream, bool format = false);
 
+    /**
+     * \brief Writes serialized data to stream in the binary encoding, see
+     * util::writeBinaryDocument. The stream should be opened in binary mode.
+     *
+     * @param stream Stream to be written to.
+     * @throws SerializationException
+     */
+    void writeBinaryFile(std::ostream& stream);
+
     // std containers
     template <typename T>
     void serialize(const std::string& key, const std::vector<T>& sVector,
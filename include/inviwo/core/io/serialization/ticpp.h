@@ -47,6 +47,7 @@ typedef ticpp::Node TxNode;
 typedef ticpp::Exception TxException;
 typedef ticpp::Declaration TxDeclaration;
 typedef ticpp::Comment TxComment;
+typedef ticpp::Text TxText;
 typedef ticpp::Attribute TxAttribute;
 typedef ticpp::Iterator<TxElement> TxEIt;
 typedef ticpp::Iterator<TxAttribute> TxAIt;
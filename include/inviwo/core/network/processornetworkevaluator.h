@@ -36,6 +36,11 @@
 #include <inviwo/core/network/processornetworkevaluationobserver.h>
 #include <inviwo/core/network/evaluationerrorhandler.h>
 
+#include <warn/push>
+#include <warn/ignore/all>
+#include <unordered_map>
+#include <warn/pop>
+
 namespace inviwo {
 
 class Processor;
@@ -50,6 +55,15 @@ public:
     virtual ~ProcessorNetworkEvaluator() = default;
     void setExceptionHandler(EvaluationErrorHandler handler);
 
+    /**
+     * Enable or disable parallel evaluation. In parallel mode independent processors are
+     * scheduled concurrently on the thread pool as soon as all their predecessors have been
+     * evaluated. Processors that require the main thread (see Processor::requiresMainThread)
+     * are always processed on the calling thread. Parallel evaluation is disabled by default.
+     */
+    void setParallelEvaluation(bool enable);
+    bool getParallelEvaluation() const;
+
 private:
     virtual void onProcessorNetworkEvaluateRequest() override;
     virtual void onProcessorNetworkUnlocked() override;
@@ -60,11 +74,38 @@ private:
 
     void requestEvaluate();
     void evaluate();
+    void evaluateSerial();
+    void evaluateParallel();
+
+    /**
+     * The topological order is maintained incrementally for single network edits. When several
+     * edits are made within one NetworkLock scope, i.e. during deserialization of a workspace
+     * or a batch of scripted edits, the order is instead recomputed once when the network is
+     * unlocked.
+     */
+    bool beginNetworkEdit();
+    void sortProcessors();
+    void updateSortedIndices(size_t start);
+    void addSortedConnection(Processor* src, Processor* dst);
+    void removeUnreachableProcessor(Processor* processor);
+
+    // Helpers for the different stages of evaluating a single processor
+    bool initializeProcessor(Processor* processor);
+    void processProcessor(Processor* processor);
+    void finishProcessor(Processor* processor);
+    void notReadyProcessor(Processor* processor);
 
     ProcessorNetwork* processorNetwork_;
     // the sorted list of processors obtained through topological sorting
     std::vector<Processor*> processorsSorted_;
+    // the position of each processor in processorsSorted_
+    std::unordered_map<Processor*, size_t> sortedIndices_;
+    // number of network edits since the network was last unlocked
+    size_t editCount_;
+    // true if processorsSorted_ has to be recomputed before the next evaluation
+    bool sortDirty_;
     bool evaulationQueued_;
+    bool parallelEvaluation_;
     EvaluationErrorHandler exceptionHandler_;
 };
 
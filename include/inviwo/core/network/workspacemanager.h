@@ -79,7 +79,9 @@ public:
      * \param stream the stream to write to.
      * \param refPath a reference that that can be use by the serializer to store relative paths.
      *      The same refPath should be given when loading. Most often this should be the path to the
-     *      saved file.
+     *      saved file. If refPath has the binary workspace extension
+     *      (SerializeConstants::BinaryWorkspaceExtension) the binary encoding is written and the
+     *      stream should be opened in binary mode, otherwise xml is written.
      * \param exceptionHandler A callback for handling errors. 
      */
     void save(std::ostream& stream, const std::string& refPath,
@@ -94,7 +96,7 @@ public:
               const ExceptionHandler& exceptionHandler = StandardExceptionHandler());
 
     /**
-     * Load a workspace from a stream
+     * Load a workspace from a stream. Both xml and binary encoded workspaces are accepted.
      * \param stream the stream to read from.
      * \param refPath a reference that that can be use by the deserializer to calculate relative 
      *      paths. The same refPath should be given when loading. Most often this should be the 
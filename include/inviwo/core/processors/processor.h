@@ -231,6 +231,16 @@ public:
      */
     virtual void doIfNotReady() {}
 
+    /**
+     * Returns true if process() has to be called from the main thread. Processors returning false
+     * might be processed concurrently on the thread pool when the ProcessorNetworkEvaluator runs
+     * in parallel mode. Such processors must not need an OpenGL context and must not modify
+     * properties, ports other than their outports, or any other shared state in process(). The
+     * default implementation returns true, override it only for processors that are known to be
+     * thread safe.
+     */
+    virtual bool requiresMainThread() const;
+
     /**
      * Called by the network after Processor::process has been called.
      * This will set the following to valid
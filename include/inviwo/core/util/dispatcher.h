@@ -79,6 +79,18 @@ public:
             });
         }
     }
+
+    /**
+     * True if there is no live callback, i.e. invoke would not call anything. Can be used to
+     * skip computing arguments nobody listens to.
+     */
+    bool empty() const {
+        return std::all_of(callbacks.begin(), callbacks.end(),
+                           [](const std::weak_ptr<std::function<C>>& callback) {
+                               return callback.expired();
+                           });
+    }
+
 private:
     std::vector<std::weak_ptr<std::function<C>>> callbacks;
     int32_t concurrent_dispatcher_count = 0;
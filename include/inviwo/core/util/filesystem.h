@@ -35,6 +35,7 @@
 #include <inviwo/core/util/pathtype.h>
 
 #include <vector>
+#include <ctime>
 
 namespace inviwo {
 
@@ -72,6 +73,20 @@ IVW_CORE_API bool fileExists(const std::string& filePath);
  */
 IVW_CORE_API bool directoryExists(const std::string& path);
 
+/**
+ * \brief Get the last modification time of a file.
+ * @param filePath The path to the file
+ * @return the modification time in seconds since the epoch, 0 if the file does not exist
+ */
+IVW_CORE_API std::time_t fileModificationTime(const std::string& filePath);
+
+/**
+ * \brief Get the size of a file.
+ * @param filePath The path to the file
+ * @return the size in bytes, 0 if the file does not exist
+ */
+IVW_CORE_API size_t fileSize(const std::string& filePath);
+
 enum class ListMode {
     Files,
     Directories,
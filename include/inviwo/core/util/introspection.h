@@ -117,6 +117,22 @@ std::string data_info(const T*) {
     return "";
 }
 
+/**
+ * Representations that need a graphics context, like the OpenGL representations, declare
+ * `static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;`. They can only be created on the main
+ * thread.
+ */
+template <class T>
+class requires_graphics_context {
+    template <class U>
+    static std::integral_constant<bool, U::REQUIRES_GRAPHICS_CONTEXT> check(int);
+    template <class>
+    static std::false_type check(...);
+
+public:
+    static const bool value = decltype(check<T>(0))::value;
+};
+
 template <class T>
 class is_stream_insertable {
     template <typename U, class = typename std::enable_if<std::is_convertible<
@@ -0,0 +1,101 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_MEMORYMAPPEDFILE_H
+#define IVW_MEMORYMAPPEDFILE_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <warn/pop>
+
+namespace inviwo {
+
+/**
+ * \class MemoryMappedFile
+ * \brief Read-only view of a whole file mapped into memory.
+ *
+ * The operating system pages the file contents in on demand, hence no copy of the file is made
+ * and only the parts that are actually accessed occupy physical memory. The mapping stays valid
+ * for the lifetime of the object. An empty file results in a valid object with data() == nullptr
+ * and size() == 0.
+ *
+ * In Access::CopyOnWrite mode the mapped memory may be written to, modified pages are then
+ * privately copied by the operating system and the file itself is never changed.
+ */
+class IVW_CORE_API MemoryMappedFile {
+public:
+    enum class Access { ReadOnly, CopyOnWrite };
+
+    /**
+     * Maps the file at filePath.
+     * @throw FileException if the file cannot be opened or mapped
+     */
+    explicit MemoryMappedFile(const std::string& filePath, Access access = Access::ReadOnly);
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    MemoryMappedFile(MemoryMappedFile&& rhs);
+    MemoryMappedFile& operator=(MemoryMappedFile&& that);
+    ~MemoryMappedFile();
+
+    const char* data() const { return data_; }
+    /**
+     * Writable pointer to the data, only valid to write to in Access::CopyOnWrite mode.
+     */
+    char* data() { return data_; }
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const std::string& getFilePath() const { return filePath_; }
+    Access getAccess() const { return access_; }
+
+private:
+    void unmap();
+
+    std::string filePath_;
+    Access access_;
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_MEMORYMAPPEDFILE_H
@@ -0,0 +1,95 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_PARALLEL_H
+#define IVW_PARALLEL_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/threadpool.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Returns the number of threads in the application thread pool, or zero if there is no
+ * application or the pool is empty.
+ */
+IVW_CORE_API size_t getPoolSize();
+
+/**
+ * Returns the number of chunks to split count work items into for parallelFor. A few chunks per
+ * thread, counting the calling thread, balance the load, while each chunk gets at least
+ * minChunkSize items to amortize the task overhead. The result is in [1, max(count, 1)].
+ */
+IVW_CORE_API size_t parallelChunks(size_t count, size_t minChunkSize = 1);
+
+/**
+ * Calls func(i) for each i in [0, count), distributing the calls over the application thread
+ * pool. The calling thread takes part in the work and only waits for calls that have already
+ * been started, hence it is safe to call from within tasks running on the pool. Falls back to a
+ * serial loop if there is no application or the pool is empty. The first exception thrown by
+ * func is rethrown after all started calls have finished.
+ */
+IVW_CORE_API void parallelFor(size_t count, const std::function<void(size_t)>& func,
+                              ThreadPool::Priority priority = ThreadPool::Priority::Interactive);
+
+/**
+ * Split [0, size) into chunks and reduce them in parallel on the thread pool.
+ * func(begin, end, partial) should accumulate the range into partial and return it, the partials
+ * are then combined in order with merge(a, b).
+ */
+template <typename Result, typename Func, typename Merge>
+Result parallelReduce(size_t size, const Result& init, Func func, Merge merge) {
+    const size_t chunks = parallelChunks(size, 1 << 16);
+
+    std::vector<Result> partials(chunks, init);
+    parallelFor(chunks, [&](size_t chunk) {
+        partials[chunk] =
+            func(chunk * size / chunks, (chunk + 1) * size / chunks, std::move(partials[chunk]));
+    });
+
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        partials.front() = merge(std::move(partials.front()), partials[chunk]);
+    }
+    return std::move(partials.front());
+}
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_PARALLEL_H
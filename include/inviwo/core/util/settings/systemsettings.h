@@ -48,6 +48,7 @@ public:
 
     TemplateOptionProperty<UsageMode> applicationUsageMode_;
     IntProperty poolSize_;
+    BoolProperty parallelEvaluation_;
     BoolProperty txtEditor_;
     BoolProperty enablePortInformation_;
     BoolProperty enablePortInspectors_;
@@ -56,7 +57,10 @@ public:
     BoolProperty enablePickingProperty_;
     BoolProperty enableSoundProperty_;
     IntProperty  useRAMPercentProperty_;
+    IntProperty representationMemoryBudget_;
+    BoolProperty mapRawVolumeFiles_;
     BoolProperty  logStackTraceProperty_;
+    BoolProperty logWorkspaceLoadTimes_;
     ButtonProperty btnAllocTestProperty_;
     ButtonProperty btnSysInfoProperty_;
 
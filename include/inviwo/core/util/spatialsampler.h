@@ -53,6 +53,13 @@ public:
     virtual Vector<DataDims, T> sample(const Vector<SpatialDims, double> &pos, Space space) const;
     virtual Vector<DataDims, T> sample(const Vector<SpatialDims, float> &pos, Space space) const;
 
+    /**
+     * Samples count positions, given in the space of the sampler, at once. Samplers can override
+     * batchSampleDataSpace to avoid one virtual call per sample.
+     */
+    void sample(const Vector<SpatialDims, double> *pos, Vector<DataDims, T> *result,
+                size_t count) const;
+
     virtual bool withinBounds(const Vector<SpatialDims, double> &pos) const;
     virtual bool withinBounds(const Vector<SpatialDims, float> &pos) const;
 
@@ -71,6 +78,8 @@ public:
 protected:
     virtual Vector<DataDims, T> sampleDataSpace(const Vector<SpatialDims, double> &pos) const = 0;
     virtual bool withinBoundsDataSpace(const Vector<SpatialDims, double> &pos) const = 0;
+    virtual void batchSampleDataSpace(const Vector<SpatialDims, double> *pos,
+                                      Vector<DataDims, T> *result, size_t count) const;
 
     Space space_;
     const SpatialEntity<SpatialDims> &spatialEntity_;
@@ -119,6 +128,28 @@ Vector<DataDims, T> SpatialSampler<SpatialDims, DataDims, T>::sample(
     }
 }
 
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+void SpatialSampler<SpatialDims, DataDims, T>::sample(const Vector<SpatialDims, double> *pos,
+                                                      Vector<DataDims, T> *result,
+                                                      size_t count) const {
+    if (space_ != Space::Data) {
+        std::vector<Vector<SpatialDims, double>> dataPos(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto p = transform_ * Vector<SpatialDims + 1, double>(pos[i], 1.0);
+            dataPos[i] = Vector<SpatialDims, double>(p) / p[SpatialDims];
+        }
+        batchSampleDataSpace(dataPos.data(), result, count);
+    } else {
+        batchSampleDataSpace(pos, result, count);
+    }
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+void SpatialSampler<SpatialDims, DataDims, T>::batchSampleDataSpace(
+    const Vector<SpatialDims, double> *pos, Vector<DataDims, T> *result, size_t count) const {
+    for (size_t i = 0; i < count; ++i) result[i] = sampleDataSpace(pos[i]);
+}
+
 template <unsigned int SpatialDims, unsigned int DataDims, typename T>
 bool SpatialSampler<SpatialDims, DataDims, T>::withinBounds(
     const Vector<SpatialDims, float> &pos) const {
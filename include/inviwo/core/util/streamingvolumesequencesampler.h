@@ -0,0 +1,139 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_STREAMINGVOLUMESEQUENCESAMPLER_H
+#define IVW_STREAMINGVOLUMESEQUENCESAMPLER_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/util/spatial4dsampler.h>
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/util/threadpool.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <warn/pop>
+
+namespace inviwo {
+
+class VolumeDisk;
+
+/**
+ * \class StreamingVolumeSequenceSampler
+ * \brief Samples a volume sequence while only keeping a window of time steps in memory.
+ *
+ * Works like VolumeSequenceSampler, but the time steps are not converted to VolumeRAM up front.
+ * Instead the time steps needed for the interval given to setWindow are loaded, the following
+ * ones in the direction of integration are prefetched on the thread pool, and all other time
+ * steps are evicted. Time steps with a VolumeDisk representation are read through its loader
+ * into a separate Volume, the volumes of the sequence are never modified. Time steps that only
+ * exist in memory are used as is.
+ *
+ * A time step that is sampled outside of the window is loaded synchronously, and stays loaded
+ * until the next call to setWindow. Each time step is loaded under its own lock, hence threads
+ * sampling resident time steps are never blocked by a load. Sampling is thread safe, but
+ * setWindow must not be called concurrently with sampling since it releases the evicted time
+ * steps. A failed prefetch is retried synchronously, if that fails as well an Exception is
+ * thrown.
+ * @see PathLineTracer::traceFrom which moves all seeds through time in lockstep
+ */
+class IVW_CORE_API StreamingVolumeSequenceSampler : public Spatial4DSampler<3, double> {
+public:
+    /**
+     * @param volumeSequence the time steps, timestamps and durations are read from the
+     * "timestamp" and "duration" meta data in the same way as in VolumeSequenceSampler.
+     * @param prefetch number of time steps to load ahead of the window.
+     * @param allowLooping wrap times outside of the sequence
+     */
+    StreamingVolumeSequenceSampler(
+        std::shared_ptr<const std::vector<std::shared_ptr<Volume>>> volumeSequence,
+        size_t prefetch = 2, bool allowLooping = true);
+    virtual ~StreamingVolumeSequenceSampler();
+
+    void setAllowedLooping(bool allowed = true) { allowLooping_ = allowed; }
+
+    /**
+     * Make sure all time steps needed to sample in [t0, t1] are loaded, start prefetching the
+     * next time steps in the given direction, and release everything else. This only changes
+     * which time steps are held in memory, not the sampled values, hence it is const.
+     * @throw Exception if a time step in the window cannot be read
+     */
+    void setWindow(double t0, double t1, bool forward = true) const;
+
+    /**
+     * Number of time steps currently held in memory, excluding pending prefetches.
+     */
+    size_t getNumberOfResidentTimeSteps() const;
+    size_t getNumberOfTimeSteps() const;
+    dvec2 getTimeRange() const;
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec4 &pos) const override;
+    virtual bool withinBoundsDataSpace(const dvec4 &pos) const override;
+
+private:
+    struct TimeStep {
+        std::shared_ptr<const Volume> source;
+        const VolumeDisk *disk = nullptr;  // Set if the time step can be loaded from disk
+        double timestamp = 0.0;
+        double duration = 0.0;
+
+        std::future<std::shared_ptr<const Volume>> pending;
+        CancellationToken token;
+
+        std::unique_ptr<VolumeDoubleSampler<3>> sampler;
+        std::atomic<const VolumeDoubleSampler<3> *> resident{nullptr};
+
+        std::mutex mutex;  // Guards everything above except resident
+    };
+
+    size_t indexOf(double t) const;
+    double wrap(double t) const;
+    const VolumeDoubleSampler<3> &get(size_t index) const;
+    // These expect the lock of the time step to be held
+    void load(TimeStep &step) const;
+    void prefetch(TimeStep &step) const;
+    void evict(TimeStep &step) const;
+
+    static std::shared_ptr<const Volume> read(const Volume &source, const VolumeDisk &disk);
+
+    std::vector<std::unique_ptr<TimeStep>> steps_;
+    bool allowLooping_;
+    size_t prefetch_;
+    dvec2 timeRange_;
+    double totDuration_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_STREAMINGVOLUMESEQUENCESAMPLER_H
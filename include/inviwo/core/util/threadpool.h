@@ -63,6 +63,8 @@
 #include <warn/ignore/all>
 #include <vector>
 #include <queue>
+#include <deque>
+#include <array>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -71,20 +73,173 @@
 #include <functional>
 #include <stdexcept>
 #include <atomic>
+#include <type_traits>
+#include <cstddef>
+#include <utility>
 #include <warn/pop>
 
 namespace inviwo {
 
+/**
+ * \class CancellationToken
+ * A token used to cooperatively cancel tasks submitted to the ThreadPool. Copies share the same
+ * state, i.e. cancelling one copy cancels all of them. Tasks that have not been started when
+ * the token is cancelled are discarded by the pool, running tasks can poll isCancelled() to
+ * abort early.
+ */
+class IVW_CORE_API CancellationToken {
+public:
+    CancellationToken();
+    void cancel();
+    bool isCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+namespace detail {
+
+/**
+ * A move only type erased void() callable. Callables that fit into the internal buffer are
+ * stored without any heap allocation.
+ */
+class PoolTask {
+public:
+    PoolTask() = default;
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, PoolTask>::value>::type>
+    PoolTask(F&& f) {
+        using Fn = typename std::decay<F>::type;
+        using Local = std::integral_constant<bool, sizeof(Fn) <= sizeof(Storage) &&
+                                                       alignof(Fn) <= alignof(Storage) &&
+                                                       std::is_nothrow_move_constructible<Fn>::value>;
+        construct<Fn>(std::forward<F>(f), Local{});
+    }
+    PoolTask(const PoolTask&) = delete;
+    PoolTask& operator=(const PoolTask&) = delete;
+    PoolTask(PoolTask&& rhs) noexcept : ops_(rhs.ops_) {
+        if (ops_) ops_->move(&storage_, &rhs.storage_);
+        rhs.ops_ = nullptr;
+    }
+    PoolTask& operator=(PoolTask&& that) noexcept {
+        if (this != &that) {
+            reset();
+            ops_ = that.ops_;
+            if (ops_) ops_->move(&storage_, &that.storage_);
+            that.ops_ = nullptr;
+        }
+        return *this;
+    }
+    ~PoolTask() { reset(); }
+
+    void operator()() { ops_->invoke(&storage_); }
+    explicit operator bool() const { return ops_ != nullptr; }
+
+private:
+    using Storage = typename std::aligned_storage<6 * sizeof(void*), alignof(std::max_align_t)>::type;
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    template <typename Fn>
+    static const Ops* localOps() {
+        static const Ops ops{[](void* s) { (*static_cast<Fn*>(s))(); },
+                             [](void* dst, void* src) {
+                                 new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+                                 static_cast<Fn*>(src)->~Fn();
+                             },
+                             [](void* s) { static_cast<Fn*>(s)->~Fn(); }};
+        return &ops;
+    }
+    template <typename Fn>
+    static const Ops* heapOps() {
+        static const Ops ops{[](void* s) { (**static_cast<Fn**>(s))(); },
+                             [](void* dst, void* src) {
+                                 *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+                             },
+                             [](void* s) { delete *static_cast<Fn**>(s); }};
+        return &ops;
+    }
+
+    template <typename Fn, typename F>
+    void construct(F&& f, std::true_type) {
+        new (&storage_) Fn(std::forward<F>(f));
+        ops_ = localOps<Fn>();
+    }
+    template <typename Fn, typename F>
+    void construct(F&& f, std::false_type) {
+        *reinterpret_cast<Fn**>(&storage_) = new Fn(std::forward<F>(f));
+        ops_ = heapOps<Fn>();
+    }
+
+    void reset() {
+        if (ops_) ops_->destroy(&storage_);
+        ops_ = nullptr;
+    }
+
+    Storage storage_;
+    const Ops* ops_ = nullptr;
+};
+
+}  // namespace detail
+
+/**
+ * \class ThreadPool
+ * A work stealing thread pool. Tasks submitted from outside of the pool are put in a global
+ * queue per priority. Tasks submitted from a worker thread, i.e. sub tasks of a running task,
+ * are put in the worker's own deque. Idle workers first take tasks from their own deque, then
+ * from the global queues in priority order and finally steal from other workers.
+ */
 class IVW_CORE_API ThreadPool {
 public:
+    /**
+     * Task priority, when picking tasks from the global queues workers will always pick
+     * Interactive tasks first, then IO, and then Background.
+     */
+    enum class Priority { Interactive = 0, IO = 1, Background = 2 };
+
+    struct Stats {
+        std::array<size_t, 3> queued;  //< Tasks in the global queue, per priority
+        size_t local;                  //< Tasks in the workers' own deques
+        size_t executed;               //< Total number of executed tasks, excluding cancelled ones
+        size_t stolen;                 //< Total number of tasks stolen from other workers
+        size_t cancelled;              //< Total number of discarded cancelled tasks
+    };
+
     ThreadPool(size_t threads, std::function<void()> onThreadStart = []() {},
                std::function<void()> onThreadStop = []() {});
     ~ThreadPool();
 
+    /**
+     * Enqueue a task with Interactive priority.
+     */
     template <class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    template <class F, class... Args>
+    auto enqueue(Priority priority, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    /**
+     * Enqueue a task that will be discarded if token is cancelled before the task has been
+     * started. The future of a discarded task will throw a std::future_error.
+     */
+    template <class F, class... Args>
+    auto enqueue(Priority priority, CancellationToken token, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    /**
+     * Submit a fire and forget task without a future. Small callables are queued without any
+     * heap allocation. The task must not throw.
+     */
+    template <class F>
+    void submit(Priority priority, F&& f);
+
     size_t trySetSize(size_t size);
     size_t getSize() const;
+    Stats getStats() const;
 
 private:
     enum class State {
@@ -103,19 +258,36 @@ private:
         Worker& operator=(Worker&& rhs) = delete;
         ~Worker();
 
+        ThreadPool& pool;
         std::atomic<State> state; //< State of the worker
+        std::mutex mutex;  //< Guards tasks
+        std::deque<detail::PoolTask> tasks;  //< Sub tasks enqueued by this worker
+        bool discarded = false;  //< The current task was cancelled and not run
         std::thread thread;
     };
+
+    void push(Priority priority, detail::PoolTask task);
+    detail::PoolTask take(Worker& worker);
+    void release(Worker& worker);
+    static Worker*& currentWorker();
+
     // need to keep track of threads so we can join them
     std::vector<std::unique_ptr<Worker>> workers;
+    mutable std::mutex workers_mutex;
 
-    // the task queue
-    std::queue<std::function<void()>> tasks;
+    // the global task queues, one per priority
+    std::array<std::queue<detail::PoolTask>, 3> tasks;
+    // number of tasks in the global queues and worker deques that no worker has claimed yet
+    size_t pending;
 
     // synchronization
-    std::mutex queue_mutex;
+    mutable std::mutex queue_mutex;
     std::condition_variable condition;
 
+    std::atomic<size_t> executed;
+    std::atomic<size_t> stolen;
+    std::atomic<size_t> cancelled;
+
     // Thread start end exit actions
     std::function<void()> onThreadStart_;
     std::function<void()> onThreadStop_;
@@ -124,6 +296,12 @@ private:
 // add new work item to the pool
 template <class F, class... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+    return enqueue(Priority::Interactive, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <class F, class... Args>
+auto ThreadPool::enqueue(Priority priority, F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
     using return_type = typename std::result_of<F(Args...)>::type;
 
@@ -132,16 +310,47 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
 
     std::future<return_type> res = task->get_future();
 
-    if (workers.empty()) {
+    if (getSize() == 0) {
         (*task)();  // No worker threads, just run the task.
     } else {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace([task]() { (*task)(); });
+        push(priority, detail::PoolTask([task]() { (*task)(); }));
+    }
+    return res;
+}
+
+template <class F, class... Args>
+auto ThreadPool::enqueue(Priority priority, CancellationToken token, F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+    using return_type = typename std::result_of<F(Args...)>::type;
+
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+
+    std::future<return_type> res = task->get_future();
+
+    if (getSize() == 0) {
+        if (!token.isCancelled()) (*task)();
+    } else {
+        push(priority, detail::PoolTask([task, token]() {
+                 if (token.isCancelled()) {
+                     if (auto worker = currentWorker()) worker->discarded = true;
+                 } else {
+                     (*task)();
+                 }
+             }));
     }
-    condition.notify_one();
     return res;
 }
 
+template <class F>
+void ThreadPool::submit(Priority priority, F&& f) {
+    if (getSize() == 0) {
+        f();  // No worker threads, just run the task.
+    } else {
+        push(priority, detail::PoolTask(std::forward<F>(f)));
+    }
+}
+
 }  // namespace
 
 #endif  // IVW_THREADPOOL_H
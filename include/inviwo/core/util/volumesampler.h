@@ -37,13 +37,84 @@
 #include <inviwo/core/util/interpolation.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/util/formatdispatching.h>
 
 #include <inviwo/core/util/spatialsampler.h>
 
 namespace inviwo {
 
+namespace detail {
+
+/**
+ * Trilinear interpolation of typed voxel data at pos given in data space. Voxels are read
+ * directly and converted to doubles like VolumeRAM::getAsDVec4 and friends. Positions outside of
+ * [0,1]^3 return zero.
+ */
+template <unsigned int DataDims, typename DataType>
+Vector<DataDims, double> sampleVoxels(const DataType *data, const size3_t &dims,
+                                      const dvec3 &pos) {
+    using V = Vector<DataDims, double>;
+    if (glm::any(glm::lessThan(pos, dvec3(0.0))) || glm::any(glm::greaterThan(pos, dvec3(1.0)))) {
+        return V(0.0);
+    }
+    const size3_t last = dims - size3_t(1);
+    const dvec3 samplePos = pos * dvec3(last);
+    const size3_t p0 = glm::min(size3_t(samplePos), last);
+    const size3_t p1 = glm::min(p0 + size3_t(1), last);
+    const dvec3 interpolants = samplePos - dvec3(p0);
+
+    const size_t x0 = p0.x, x1 = p1.x;
+    const size_t y0 = p0.y * dims.x, y1 = p1.y * dims.x;
+    const size_t z0 = p0.z * dims.x * dims.y, z1 = p1.z * dims.x * dims.y;
+    const V samples[8] = {
+        util::glm_convert<V>(data[x0 + y0 + z0]), util::glm_convert<V>(data[x1 + y0 + z0]),
+        util::glm_convert<V>(data[x0 + y1 + z0]), util::glm_convert<V>(data[x1 + y1 + z0]),
+        util::glm_convert<V>(data[x0 + y0 + z1]), util::glm_convert<V>(data[x1 + y0 + z1]),
+        util::glm_convert<V>(data[x0 + y1 + z1]), util::glm_convert<V>(data[x1 + y1 + z1])};
+
+    return Interpolation<V>::trilinear(samples, interpolants);
+}
+
+template <unsigned int DataDims, typename DataType>
+Vector<DataDims, double> sampleVoxels(const void *data, const size3_t &dims, const dvec3 &pos) {
+    return sampleVoxels<DataDims>(static_cast<const DataType *>(data), dims, pos);
+}
+
+template <unsigned int DataDims, typename DataType>
+void sampleVoxels(const void *data, const size3_t &dims, const dvec3 *pos,
+                  Vector<DataDims, double> *result, size_t count) {
+    const auto typed = static_cast<const DataType *>(data);
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = sampleVoxels<DataDims>(typed, dims, pos[i]);
+    }
+}
+
+/**
+ * Selects the sampleVoxels function matching a data format, for use with
+ * dispatching::dispatch.
+ */
+template <unsigned int DataDims>
+struct VoxelSamplerDispatcher {
+    using Sampler = Vector<DataDims, double> (*)(const void *, const size3_t &, const dvec3 &);
+
+    template <typename Result, typename Format>
+    Result operator()() {
+        return &sampleVoxels<DataDims, typename Format::type>;
+    }
+};
+
+}  // namespace detail
+
 /**
  * \class VolumeDoubleSampler
+ * \brief Trilinear sampling of a Volume returning doubles with DataDims components.
+ *
+ * The data type of the volume is dispatched once at construction, after which voxels are read
+ * directly from the VolumeRAM data without any virtual calls. Use the batch version of
+ * SpatialSampler::sample to sample many positions with a single call.
+ * @see TypedVolumeSampler for a sampler where the data type is known at compile time.
  */
 template <unsigned int DataDims>
 class VolumeDoubleSampler : public SpatialSampler<3, DataDims, double> {
@@ -59,26 +130,89 @@ public:
     virtual bool withinBoundsDataSpace(const dvec3 &pos) const override;
 
 protected:
-    Vector<DataDims, double> getVoxel(const size3_t &pos) const;
+    virtual void batchSampleDataSpace(const dvec3 *pos, Vector<DataDims, double> *result,
+                                      size_t count) const override;
 
     std::shared_ptr<const Volume> volume_;
     const VolumeRAM *ram_;
     size3_t dims_;
+
+private:
+    const void *data_;
+    Vector<DataDims, double> (*sample_)(const void *, const size3_t &, const dvec3 &);
+    void (*batchSample_)(const void *, const size3_t &, const dvec3 *, Vector<DataDims, double> *,
+                         size_t);
 };
 
-template <>
-IVW_CORE_API Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const;
+using VolumeSampler = VolumeDoubleSampler<4>;
+
+/**
+ * \class TypedVolumeSampler
+ * \brief Trilinear sampling of a Volume with data of type DataType known at compile time.
+ *
+ * Equivalent to VolumeDoubleSampler, but sampleDataSpace can be inlined when called on the
+ * concrete type, which matters in tight loops, e.g. inside a format dispatch.
+ * @throws Exception if the data format of the volume is not DataType
+ */
+template <typename DataType, unsigned int DataDims = DataFormat<DataType>::comp>
+class TypedVolumeSampler : public SpatialSampler<3, DataDims, double> {
+public:
+    TypedVolumeSampler(std::shared_ptr<const Volume> vol,
+                       CoordinateSpace space = CoordinateSpace::Data);
+    TypedVolumeSampler(const Volume &vol, CoordinateSpace space = CoordinateSpace::Data);
+    virtual ~TypedVolumeSampler() = default;
 
-template <>
-IVW_CORE_API Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const;
+    virtual Vector<DataDims, double> sampleDataSpace(const dvec3 &pos) const override final;
+    virtual bool withinBoundsDataSpace(const dvec3 &pos) const override final;
 
-template <>
-IVW_CORE_API Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const;
+protected:
+    virtual void batchSampleDataSpace(const dvec3 *pos, Vector<DataDims, double> *result,
+                                      size_t count) const override final;
 
-template <>
-IVW_CORE_API Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const;
+private:
+    std::shared_ptr<const Volume> volume_;
+    const DataType *data_;
+    size3_t dims_;
+};
 
-using VolumeSampler = VolumeDoubleSampler<4>;
+/**
+ * \class BrickedVolumeSampler
+ * \brief Trilinear sampling of a Volume through its VolumeBricked representation.
+ *
+ * Only the bricks that are sampled are read, hence the volume does not have to fit in memory.
+ * Samples are read within a single brick using its ghost layers, which requires at least one
+ * ghost layer. Consecutive positions in a batch that fall in the same brick share one brick
+ * lookup.
+ * @throws Exception if the bricked representation has no ghost layers
+ */
+template <unsigned int DataDims>
+class BrickedVolumeSampler : public SpatialSampler<3, DataDims, double> {
+public:
+    BrickedVolumeSampler(std::shared_ptr<const Volume> vol,
+                         CoordinateSpace space = CoordinateSpace::Data);
+    BrickedVolumeSampler(const Volume &vol, CoordinateSpace space = CoordinateSpace::Data);
+    virtual ~BrickedVolumeSampler() = default;
+
+    virtual Vector<DataDims, double> sampleDataSpace(const dvec3 &pos) const override;
+    virtual bool withinBoundsDataSpace(const dvec3 &pos) const override;
+
+protected:
+    virtual void batchSampleDataSpace(const dvec3 *pos, Vector<DataDims, double> *result,
+                                      size_t count) const override;
+
+private:
+    struct Cursor {
+        size3_t brick{std::numeric_limits<size_t>::max()};
+        std::shared_ptr<const VolumeRAM> data;
+        VolumeBricked::Region region;
+    };
+    Vector<DataDims, double> sampleBrick(const dvec3 &pos, Cursor &cursor) const;
+
+    std::shared_ptr<const Volume> volume_;
+    const VolumeBricked *bricked_;
+    size3_t dims_;
+    Vector<DataDims, double> (*sample_)(const void *, const size3_t &, const dvec3 &);
+};
 
 template <unsigned int DataDims>
 VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(std::shared_ptr<const Volume> vol,
@@ -91,29 +225,25 @@ template <unsigned int DataDims>
 VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(const Volume &vol, CoordinateSpace space)
     : SpatialSampler<3, DataDims, double>(vol, space)
     , ram_(vol.getRepresentation<VolumeRAM>())
-    , dims_(vol.getDimensions()) {}
+    , dims_(vol.getDimensions())
+    , data_(ram_->getData()) {
+    ram_->dispatch<void>([this](auto vram) {
+        using ValueType = util::PrecsionValueType<decltype(vram)>;
+        sample_ = &detail::sampleVoxels<DataDims, ValueType>;
+        batchSample_ = &detail::sampleVoxels<DataDims, ValueType>;
+    });
+}
 
 template <unsigned int DataDims>
 Vector<DataDims, double> VolumeDoubleSampler<DataDims>::sampleDataSpace(const dvec3 &pos) const {
-    if (!withinBoundsDataSpace(pos)) {
-        return Vector<DataDims, double>(0.0);
-    }
-    const dvec3 samplePos = pos * dvec3(dims_ - size3_t(1));
-    const size3_t indexPos = size3_t(samplePos);
-    const dvec3 interpolants = samplePos - dvec3(indexPos);
-
-    Vector<DataDims, double> samples[8];
-    samples[0] = getVoxel(indexPos);
-    samples[1] = getVoxel(indexPos + size3_t(1, 0, 0));
-    samples[2] = getVoxel(indexPos + size3_t(0, 1, 0));
-    samples[3] = getVoxel(indexPos + size3_t(1, 1, 0));
-
-    samples[4] = getVoxel(indexPos + size3_t(0, 0, 1));
-    samples[5] = getVoxel(indexPos + size3_t(1, 0, 1));
-    samples[6] = getVoxel(indexPos + size3_t(0, 1, 1));
-    samples[7] = getVoxel(indexPos + size3_t(1, 1, 1));
+    return sample_(data_, dims_, pos);
+}
 
-    return Interpolation<Vector<DataDims, double>>::trilinear(samples, interpolants);
+template <unsigned int DataDims>
+void VolumeDoubleSampler<DataDims>::batchSampleDataSpace(const dvec3 *pos,
+                                                         Vector<DataDims, double> *result,
+                                                         size_t count) const {
+    batchSample_(data_, dims_, pos, result, count);
 }
 
 template <unsigned int DataDims>
@@ -124,6 +254,112 @@ bool VolumeDoubleSampler<DataDims>::withinBoundsDataSpace(const dvec3 &pos) cons
     return true;
 }
 
+template <typename DataType, unsigned int DataDims>
+TypedVolumeSampler<DataType, DataDims>::TypedVolumeSampler(std::shared_ptr<const Volume> vol,
+                                                           CoordinateSpace space)
+    : TypedVolumeSampler(*vol, space) {
+    volume_ = vol;
+}
+
+template <typename DataType, unsigned int DataDims>
+TypedVolumeSampler<DataType, DataDims>::TypedVolumeSampler(const Volume &vol,
+                                                           CoordinateSpace space)
+    : SpatialSampler<3, DataDims, double>(vol, space)
+    , data_(nullptr)
+    , dims_(vol.getDimensions()) {
+    auto ram = vol.getRepresentation<VolumeRAM>();
+    if (ram->getDataFormat() != DataFormat<DataType>::get()) {
+        throw Exception("Volume data format " + std::string(ram->getDataFormat()->getString()) +
+                            " does not match sampler format " +
+                            std::string(DataFormat<DataType>::str()),
+                        IvwContext);
+    }
+    data_ = static_cast<const DataType *>(ram->getData());
+}
+
+template <typename DataType, unsigned int DataDims>
+Vector<DataDims, double> TypedVolumeSampler<DataType, DataDims>::sampleDataSpace(
+    const dvec3 &pos) const {
+    return detail::sampleVoxels<DataDims>(data_, dims_, pos);
+}
+
+template <typename DataType, unsigned int DataDims>
+bool TypedVolumeSampler<DataType, DataDims>::withinBoundsDataSpace(const dvec3 &pos) const {
+    return !(glm::any(glm::lessThan(pos, dvec3(0.0))) ||
+             glm::any(glm::greaterThan(pos, dvec3(1.0))));
+}
+
+template <typename DataType, unsigned int DataDims>
+void TypedVolumeSampler<DataType, DataDims>::batchSampleDataSpace(
+    const dvec3 *pos, Vector<DataDims, double> *result, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = detail::sampleVoxels<DataDims>(data_, dims_, pos[i]);
+    }
+}
+
+template <unsigned int DataDims>
+BrickedVolumeSampler<DataDims>::BrickedVolumeSampler(std::shared_ptr<const Volume> vol,
+                                                     CoordinateSpace space)
+    : BrickedVolumeSampler(*vol, space) {
+    volume_ = vol;
+}
+
+template <unsigned int DataDims>
+BrickedVolumeSampler<DataDims>::BrickedVolumeSampler(const Volume &vol, CoordinateSpace space)
+    : SpatialSampler<3, DataDims, double>(vol, space)
+    , bricked_(vol.getRepresentation<VolumeBricked>())
+    , dims_(vol.getDimensions()) {
+    if (bricked_->getGhostLayers() == 0) {
+        throw Exception("Bricked sampling requires at least one ghost layer", IvwContext);
+    }
+    // Dispatch on the format, loading a brick just for its type would read it from disk.
+    using Dispatcher = detail::VoxelSamplerDispatcher<DataDims>;
+    sample_ = dispatching::dispatch<typename Dispatcher::Sampler, dispatching::filter::All>(
+        bricked_->getDataFormatId(), Dispatcher{});
+}
+
+template <unsigned int DataDims>
+Vector<DataDims, double> BrickedVolumeSampler<DataDims>::sampleBrick(const dvec3 &pos,
+                                                                     Cursor &cursor) const {
+    if (!withinBoundsDataSpace(pos)) return Vector<DataDims, double>(0.0);
+
+    const size3_t last = dims_ - size3_t(1);
+    const dvec3 samplePos = pos * dvec3(last);
+    const size3_t brick = bricked_->getBrickForVoxel(glm::min(size3_t(samplePos), last));
+    if (!cursor.data || brick != cursor.brick) {
+        cursor.brick = brick;
+        cursor.data = bricked_->getBrick(brick);
+        cursor.region = bricked_->getBrickRegion(brick);
+    }
+    // Map to data space of the brick, the ghost layers hold the neighbors needed.
+    const dvec3 localLast{glm::max(cursor.region.dimensions - size3_t(1), size3_t(1))};
+    const dvec3 localPos = (samplePos - dvec3(cursor.region.offset)) / localLast;
+    return sample_(cursor.data->getData(), cursor.region.dimensions, localPos);
+}
+
+template <unsigned int DataDims>
+Vector<DataDims, double> BrickedVolumeSampler<DataDims>::sampleDataSpace(
+    const dvec3 &pos) const {
+    Cursor cursor;
+    return sampleBrick(pos, cursor);
+}
+
+template <unsigned int DataDims>
+void BrickedVolumeSampler<DataDims>::batchSampleDataSpace(const dvec3 *pos,
+                                                          Vector<DataDims, double> *result,
+                                                          size_t count) const {
+    Cursor cursor;
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = sampleBrick(pos[i], cursor);
+    }
+}
+
+template <unsigned int DataDims>
+bool BrickedVolumeSampler<DataDims>::withinBoundsDataSpace(const dvec3 &pos) const {
+    return !(glm::any(glm::lessThan(pos, dvec3(0.0))) ||
+             glm::any(glm::greaterThan(pos, dvec3(1.0))));
+}
+
 }  // namespace inviwo
 
 #endif  // IVW_VOLUMESAMPLER_H
@@ -38,6 +38,7 @@
 namespace inviwo {
 
 class Volume;
+class VolumeRAM;
 
 namespace util {
 
@@ -61,6 +62,18 @@ std::pair<vec3, vec3> IVW_CORE_API getVolumeMargins(const std::shared_ptr<const
 */
 size3_t IVW_CORE_API getVolumeDimensions(const std::shared_ptr<const Volume> &volume);
 
+/**
+ * \brief read a region of a volume without creating a RAM representation
+ *
+ * If the volume has no valid RAM representation, but a valid bricked representation, or a valid
+ * disk representation with a loader that supports regions, only the voxels in
+ * [offset, offset + dimensions) are read.
+ * @return a VolumeRAM with the region, or nullptr if the region can not be read this way.
+ */
+std::shared_ptr<VolumeRAM> IVW_CORE_API readVolumeRegion(const Volume &volume,
+                                                         const size3_t &offset,
+                                                         const size3_t &dimensions);
+
 } // namespace util
 
 }  // namespace inviwo
@@ -99,11 +99,9 @@ void AnimationController::stop() {
 }
 
 void AnimationController::tick() {
-    // TODO: Implement fully working solution for this.
-    // What to do when network cannot be evaluated in the speed that is given by deltaTime?
-    // Initial solution: Don't care about that, and let it evaluate fully in the speed that it can
-    // muster
-    // Since we probably want to generate an imagesequence or something for videos.
+    // When the network cannot be evaluated in the speed given by deltaTime we simply evaluate as
+    // fast as we can. To generate image sequences for videos use the AnimationRenderer, which
+    // renders every frame regardless of how long it takes.
 
     if (state_ == AnimationState::Playing) {
         auto newTime = currentTime_ + deltaTime_;
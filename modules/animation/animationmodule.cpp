@@ -31,10 +31,12 @@
 
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/common/inviwoapplication.h>
 
 #include <modules/animation/datastructures/keyframe.h>
 #include <modules/animation/datastructures/track.h>
 #include <modules/animation/datastructures/propertytrack.h>
+#include <modules/animation/animationrenderer.h>
 
 namespace inviwo {
 
@@ -52,7 +54,13 @@ struct OrdinalReghelper {
 };
 
 AnimationModule::AnimationModule(InviwoApplication* app)
-    : InviwoModule(app, "Animation"), animation::AnimationSupplier(manager_), manager_(app, this) {
+    : InviwoModule(app, "Animation")
+    , animation::AnimationSupplier(manager_)
+    , manager_(app, this)
+    , renderAnimationArg_("", "renderAnimation",
+                          "Render the animation of the workspace to an image sequence in the "
+                          "given directory, at the play speed of the animation",
+                          false, "", "Directory for the images") {
 
     using namespace animation;
 
@@ -60,6 +68,20 @@ AnimationModule::AnimationModule(InviwoApplication* app)
                              dmat2, dmat3, dmat4>;
 
     util::for_each_type<Types>{}(OrdinalReghelper{}, *this);
+
+    app->getCommandLineParser().add(&renderAnimationArg_,
+                                    [this]() {
+                                        auto& controller = manager_.getAnimationController();
+                                        AnimationRenderer::Settings settings;
+                                        settings.directory = renderAnimationArg_.getValue();
+                                        settings.framesPerSecond = controller.getPlaySpeedFps();
+                                        try {
+                                            AnimationRenderer(controller, app_).render(settings);
+                                        } catch (const Exception& e) {
+                                            LogError(e.getMessage());
+                                        }
+                                    },
+                                    1100);
 }
 
 AnimationModule::~AnimationModule() {
@@ -32,6 +32,7 @@
 
 #include <modules/animation/animationmoduledefine.h>
 #include <inviwo/core/common/inviwomodule.h>
+#include <inviwo/core/util/commandlineparser.h>
 #include <modules/animation/animationsupplier.h>
 #include <modules/animation/animationmanager.h>
 
@@ -50,6 +51,7 @@ public:
 
 private:
     animation::AnimationManager manager_;
+    TCLAP::ValueArg<std::string> renderAnimationArg_;
 };
 
 } // namespace
@@ -0,0 +1,185 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/animation/animationrenderer.h>
+#include <modules/animation/animationcontroller.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/processors/canvasprocessor.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/io/datawriterfactory.h>
+#include <inviwo/core/io/datawriter.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace animation {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct EncodeJob {
+    std::string path;
+    std::shared_ptr<const Layer> layer;
+    std::shared_ptr<DataWriterType<Layer>> writer;
+};
+
+}  // namespace
+
+AnimationRenderer::AnimationRenderer(AnimationController& controller, InviwoApplication* app)
+    : controller_(controller), app_(app) {}
+
+std::vector<AnimationRenderer::FrameTimes> AnimationRenderer::render(const Settings& settings) {
+    if (settings.framesPerSecond <= 0.0) {
+        throw Exception("Frames per second has to be positive", IvwContext);
+    }
+    if (!filesystem::directoryExists(settings.directory)) {
+        filesystem::createDirectoryRecursively(settings.directory);
+    }
+    auto factory = app_->getDataWriterFactory();
+    if (!factory->getWriterForTypeAndExtension<Layer>(settings.extension)) {
+        throw Exception("No image writer found for extension: " + settings.extension, IvwContext);
+    }
+
+    std::vector<CanvasProcessor*> canvases;
+    for (auto canvas : app_->getProcessorNetwork()->getProcessorsByType<CanvasProcessor>()) {
+        if (settings.canvases.empty() ||
+            util::contains(settings.canvases, canvas->getIdentifier())) {
+            canvases.push_back(canvas);
+        }
+    }
+    if (canvases.empty()) throw Exception("No canvases found to render", IvwContext);
+
+    const auto end =
+        settings.end < Seconds(0.0) ? controller_.getAnimation()->lastTime() : settings.end;
+    const size_t frameCount =
+        end < settings.start
+            ? 0
+            : static_cast<size_t>((end - settings.start).count() * settings.framesPerSecond +
+                                  1e-6) + 1;
+    const size_t maxPending = settings.maxPendingFrames > 0
+                                  ? settings.maxPendingFrames
+                                  : 2 * std::max<size_t>(app_->getPoolSize(), 1);
+    const auto digits = std::max<size_t>(4, std::to_string(frameCount).size());
+
+    auto filename = [&](CanvasProcessor* canvas, size_t frame) {
+        std::stringstream ss;
+        ss << settings.directory << "/" << settings.baseName;
+        if (canvases.size() > 1) ss << "-" << canvas->getIdentifier();
+        ss << "-" << std::setw(digits) << std::setfill('0') << frame << "." << settings.extension;
+        return ss.str();
+    };
+
+    controller_.pause();
+    const auto initialTime = controller_.getCurrentTime();
+
+    // Shared with the encoding tasks, which may outlive this function if it throws
+    auto times = std::make_shared<std::vector<FrameTimes>>(frameCount);
+    std::deque<std::future<void>> pending;
+    const auto renderStart = Clock::now();
+
+    auto oldTime = initialTime;
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        const auto time = settings.start + Seconds(frame / settings.framesPerSecond);
+        const auto evalStart = Clock::now();
+        controller_.eval(oldTime, time);
+        app_->processFront();
+        oldTime = time;
+
+        // Download the images on this thread, the pool only sees RAM representations.
+        std::vector<EncodeJob> jobs;
+        for (auto canvas : canvases) {
+            if (auto layer = canvas->getVisibleLayer()) {
+                auto ram = std::shared_ptr<LayerRepresentation>(
+                    layer->getRepresentation<LayerRAM>()->clone());
+                jobs.push_back({filename(canvas, frame), std::make_shared<Layer>(ram),
+                                factory->getWriterForTypeAndExtension<Layer>(settings.extension)});
+            } else {
+                LogWarn("No image in canvas " << canvas->getIdentifier() << " for frame "
+                                              << frame);
+            }
+        }
+        (*times)[frame] = {frame, time, secondsSince(evalStart), 0.0};
+
+        // Limit the number of images waiting to be written
+        while (pending.size() >= maxPending) {
+            pending.front().get();
+            pending.pop_front();
+        }
+        pending.push_back(app_->dispatchPool([jobs, frame, times]() {
+            const auto encodeStart = Clock::now();
+            for (const auto& job : jobs) {
+                try {
+                    job.writer->setOverwrite(true);
+                    job.writer->writeData(job.layer.get(), job.path);
+                } catch (const DataWriterException& e) {
+                    LogErrorCustom("AnimationRenderer", e.getMessage());
+                }
+            }
+            (*times)[frame].encode = secondsSince(encodeStart);
+        }));
+    }
+    for (auto& f : pending) f.get();
+
+    controller_.eval(oldTime, initialTime);
+
+    if (frameCount > 0) {
+        const auto sum = [&](auto member) {
+            return std::accumulate(times->begin(), times->end(), 0.0,
+                                   [&](double s, const FrameTimes& t) { return s + t.*member; });
+        };
+        LogInfo("Rendered " << frameCount << " frames to " << settings.directory << " in "
+                            << secondsSince(renderStart) << " s, mean evaluation "
+                            << 1000.0 * sum(&FrameTimes::eval) / frameCount
+                            << " ms, mean encoding "
+                            << 1000.0 * sum(&FrameTimes::encode) / frameCount << " ms per frame");
+    }
+    return *times;
+}
+
+}  // namespace animation
+
+}  // namespace inviwo
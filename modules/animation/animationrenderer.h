@@ -0,0 +1,99 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_ANIMATIONRENDERER_H
+#define IVW_ANIMATIONRENDERER_H
+
+#include <modules/animation/animationmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/animation/datastructures/animationtime.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <string>
+#include <vector>
+#include <warn/pop>
+
+namespace inviwo {
+
+class InviwoApplication;
+
+namespace animation {
+
+class AnimationController;
+
+/**
+ * Renders an animation offline into an image sequence, as fast as the network can be evaluated,
+ * instead of stepping the time with a timer as the AnimationController does while playing.
+ * For every frame the animation is evaluated at the frame time on the calling thread and the
+ * visible layers of the canvases are downloaded to RAM. Encoding and writing the images to disk is
+ * done on the thread pool while the next frame is evaluated.
+ */
+class IVW_MODULE_ANIMATION_API AnimationRenderer {
+public:
+    struct Settings {
+        std::string directory;             ///< Where to put the images
+        std::string baseName = "frame";    ///< Images are named <baseName>[-<canvas>]-<frame>.<ext>
+        std::string extension = "png";     ///< Image file extension, selects the writer
+        std::vector<std::string> canvases; ///< Identifiers of canvases to save, empty means all
+        double framesPerSecond = 30.0;
+        Seconds start{0.0};
+        Seconds end{-1.0};  ///< A negative end time means the last time of the animation
+        /// Number of frames that may wait for encoding before evaluation is halted,
+        /// 0 means twice the number of pool threads.
+        size_t maxPendingFrames = 0;
+    };
+
+    struct FrameTimes {
+        size_t frame;
+        Seconds time;   ///< The animation time of the frame
+        double eval;    ///< Seconds spent evaluating the network and downloading the images
+        double encode;  ///< Seconds spent encoding and writing the images
+    };
+
+    AnimationRenderer(AnimationController& controller, InviwoApplication* app);
+
+    /**
+     * Render all frames between settings.start and settings.end. Returns the timings of each
+     * frame, a summary is also logged. The output directory is created if it does not exist.
+     * @throws Exception if the frame rate is not positive, no writer is found for the extension
+     * or no canvas is found
+     */
+    std::vector<FrameTimes> render(const Settings& settings);
+
+private:
+    AnimationController& controller_;
+    InviwoApplication* app_;
+};
+
+}  // namespace animation
+
+}  // namespace inviwo
+
+#endif  // IVW_ANIMATIONRENDERER_H
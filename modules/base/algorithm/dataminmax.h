@@ -33,6 +33,14 @@
 #include <modules/base/basemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <modules/base/algorithm/algorithmoptions.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include <warn/pop>
 
 namespace inviwo {
 
@@ -64,25 +72,94 @@ IVW_MODULE_BASE_API std::pair<dvec4, dvec4> layerMinMax(
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> bufferMinMax(
     const BufferBase* buffer, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
-template <typename ValueType>
-std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
-                                   IgnoreSpecialValues ignore = IgnoreSpecialValues::No) {
-    using Res = std::pair<ValueType, ValueType>;
-    Res minmax{DataFormat<ValueType>::max(), DataFormat<ValueType>::lowest()};
+namespace detail {
+
+/**
+ * False if any component is NaN or infinite, always true for integer types. Written without
+ * calls to std::isfinite so that it also works for half floats and can be vectorized.
+ */
+template <typename T>
+bool isFinite(const T& v) {
+    bool finite = true;
+    for (size_t i = 0; i < DataFormat<T>::comp; ++i) {
+        const auto c = util::glmcomp(v, i);
+        finite = finite && (c - c == c - c);
+    }
+    return finite;
+}
 
+template <typename T>
+std::pair<T, T> minMaxRange(const T* data, size_t begin, size_t end, IgnoreSpecialValues ignore,
+                            std::pair<T, T> minmax, std::false_type) {
     if (ignore == IgnoreSpecialValues::Yes) {
-        minmax = std::accumulate(data, data + size, minmax,
-                                 [](const Res& mm, const ValueType& v) -> Res {
-                                     return util::all(v != v + ValueType(1))
-                                                ? Res{glm::min(mm.first, v), glm::max(mm.second, v)}
-                                                : mm;
-                                 });
+        for (size_t i = begin; i < end; ++i) {
+            if (!isFinite(data[i])) continue;
+            minmax.first = glm::min(minmax.first, data[i]);
+            minmax.second = glm::max(minmax.second, data[i]);
+        }
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            minmax.first = glm::min(minmax.first, data[i]);
+            minmax.second = glm::max(minmax.second, data[i]);
+        }
+    }
+    return minmax;
+}
+
+// Scalar integer and float types. Several independent lanes with branch free updates, which the
+// compiler can keep in vector registers.
+template <typename T>
+std::pair<T, T> minMaxRange(const T* data, size_t begin, size_t end, IgnoreSpecialValues ignore,
+                            std::pair<T, T> minmax, std::true_type) {
+    constexpr size_t lanes = 8;
+    T mins[lanes];
+    T maxs[lanes];
+    std::fill(mins, mins + lanes, minmax.first);
+    std::fill(maxs, maxs + lanes, minmax.second);
+
+    const size_t vecEnd = begin + (end - begin) / lanes * lanes;
+    if (std::is_floating_point<T>::value && ignore == IgnoreSpecialValues::Yes) {
+        for (size_t i = begin; i < vecEnd; i += lanes) {
+            for (size_t l = 0; l < lanes; ++l) {
+                const T v = data[i + l];
+                const bool finite = v - v == T(0);
+                mins[l] = (finite && v < mins[l]) ? v : mins[l];
+                maxs[l] = (finite && v > maxs[l]) ? v : maxs[l];
+            }
+        }
     } else {
-        minmax = std::accumulate(data, data + size, minmax,
-                                 [](const Res& mm, const ValueType& v) -> Res {
-                                     return {glm::min(mm.first, v), glm::max(mm.second, v)};
-                                 });
+        for (size_t i = begin; i < vecEnd; i += lanes) {
+            for (size_t l = 0; l < lanes; ++l) {
+                const T v = data[i + l];
+                mins[l] = v < mins[l] ? v : mins[l];
+                maxs[l] = v > maxs[l] ? v : maxs[l];
+            }
+        }
     }
+    minmax = {*std::min_element(mins, mins + lanes), *std::max_element(maxs, maxs + lanes)};
+    return minMaxRange(data, vecEnd, end, ignore, minmax, std::false_type{});
+}
+
+}  // namespace detail
+
+/**
+ * Component wise min and max of the data. With IgnoreSpecialValues::Yes values with NaN or
+ * infinite components are skipped. The data is reduced in parallel chunks on the thread pool.
+ */
+template <typename ValueType>
+std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
+                                   IgnoreSpecialValues ignore = IgnoreSpecialValues::No) {
+    using Res = std::pair<ValueType, ValueType>;
+    using Scalar = std::integral_constant<bool, std::is_arithmetic<ValueType>::value>;
+
+    const auto minmax = util::parallelReduce(
+        size, Res{DataFormat<ValueType>::max(), DataFormat<ValueType>::lowest()},
+        [&](size_t begin, size_t end, Res mm) {
+            return detail::minMaxRange(data, begin, end, ignore, mm, Scalar{});
+        },
+        [](const Res& a, const Res& b) -> Res {
+            return {glm::min(a.first, b.first), glm::max(a.second, b.second)};
+        });
 
     return {util::glm_convert<dvec4>(minmax.first), util::glm_convert<dvec4>(minmax.second)};
 }
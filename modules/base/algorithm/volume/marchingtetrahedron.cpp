@@ -38,103 +38,112 @@ std::shared_ptr<Mesh> MarchingTetrahedron::apply(
                                              progressCallback);
 }
 
-void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                           std::vector<vec3> &positions, std::vector<vec3> &normals,
-                           const glm::vec3 &p0, double v0, const glm::vec3 &p1,
-                           double v1, const glm::vec3 &p2, double v2,
-                           const glm::vec3 &p3, double v3) {
+detail::MarchingTetrahedronBuffer::MarchingTetrahedronBuffer(size3_t dim, size_t zStart,
+                                                             size_t zEnd)
+    : dim_{dim}
+    , spacing_{1.0 / (dim.x - 1.0), 1.0 / (dim.y - 1.0), 1.0 / (dim.z - 1.0)}
+    , zStart_{zStart}
+    , zEnd_{zEnd} {
+    const size_t sx = 1;
+    const size_t sy = dim.x;
+    const size_t sz = dim.x * dim.y;
+    offsets_ = {{sx, sy - sx, sy, sy + sx, sz - sy - sx, sz - sy, sz - sy + sx, sz - sx, sz,
+                 sz + sx, sz + sy - sx, sz + sy, sz + sy + sx, 0}};
+}
+
+void detail::MarchingTetrahedronBuffer::evaluateTetra(size_t p0, double v0, size_t p1, double v1,
+                                                      size_t p2, double v2, size_t p3,
+                                                      double v3) {
     int index = 0;
     if (v0 >= 0) index += 1;
     if (v1 >= 0) index += 2;
     if (v2 >= 0) index += 4;
     if (v3 >= 0) index += 8;
-    glm::vec3 a, b, c, d;
+    uint32_t a, b, c, d;
     if (index == 0 || index == 15) return;
     if (index == 1 || index == 14) {
-        a = interpolate(p0, v0, p2, v2);
-        b = interpolate(p0, v0, p1, v1);
-        c = interpolate(p0, v0, p3, v3);
+        a = addVertex(p0, v0, p2, v2);
+        b = addVertex(p0, v0, p1, v1);
+        c = addVertex(p0, v0, p3, v3);
         if (index == 1) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         }
     } else if (index == 2 || index == 13) {
-        a = interpolate(p1, v1, p0, v0);
-        b = interpolate(p1, v1, p2, v2);
-        c = interpolate(p1, v1, p3, v3);
+        a = addVertex(p1, v1, p0, v0);
+        b = addVertex(p1, v1, p2, v2);
+        c = addVertex(p1, v1, p3, v3);
         if (index == 2) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         }
 
     } else if (index == 4 || index == 11) {
-        a = interpolate(p2, v2, p0, v0);
-        b = interpolate(p2, v2, p1, v1);
-        c = interpolate(p2, v2, p3, v3);
+        a = addVertex(p2, v2, p0, v0);
+        b = addVertex(p2, v2, p1, v1);
+        c = addVertex(p2, v2, p3, v3);
         if (index == 4) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         }
     } else if (index == 7 || index == 8) {
-        a = interpolate(p3, v3, p0, v0);
-        b = interpolate(p3, v3, p2, v2);
-        c = interpolate(p3, v3, p1, v1);
+        a = addVertex(p3, v3, p0, v0);
+        b = addVertex(p3, v3, p2, v2);
+        c = addVertex(p3, v3, p1, v1);
         if (index == 7) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         }
     } else if (index == 3 || index == 12) {
-        a = interpolate(p0, v0, p2, v2);
-        b = interpolate(p1, v1, p3, v3);
-        c = interpolate(p0, v0, p3, v3);
-        d = interpolate(p1, v1, p2, v2);
+        a = addVertex(p0, v0, p2, v2);
+        b = addVertex(p1, v1, p3, v3);
+        c = addVertex(p0, v0, p3, v3);
+        d = addVertex(p1, v1, p2, v2);
 
         if (index == 3) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, d, b);
+            addTriangle(a, b, c);
+            addTriangle(a, d, b);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, d);
+            addTriangle(a, c, b);
+            addTriangle(a, b, d);
         }
 
     } else if (index == 5 || index == 10) {
-        a = interpolate(p2, v2, p3, v3);
-        b = interpolate(p0, v0, p1, v1);
-        c = interpolate(p0, v0, p3, v3);
-        d = interpolate(p1, v1, p2, v2);
+        a = addVertex(p2, v2, p3, v3);
+        b = addVertex(p0, v0, p1, v1);
+        c = addVertex(p0, v0, p3, v3);
+        d = addVertex(p1, v1, p2, v2);
 
         if (index == 5) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, d, b);
+            addTriangle(a, b, c);
+            addTriangle(a, d, b);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, d);
+            addTriangle(a, c, b);
+            addTriangle(a, b, d);
         }
 
     } else if (index == 6 || index == 9) {
-        a = interpolate(p1, v1, p3, v3);
-        b = interpolate(p0, v0, p2, v2);
-        c = interpolate(p0, v0, p1, v1);
-        d = interpolate(p2, v2, p3, v3);
+        a = addVertex(p1, v1, p3, v3);
+        b = addVertex(p0, v0, p2, v2);
+        c = addVertex(p0, v0, p1, v1);
+        d = addVertex(p2, v2, p3, v3);
 
         if (index == 6) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, d);
+            addTriangle(a, c, b);
+            addTriangle(a, b, d);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, d, b);
+            addTriangle(a, b, c);
+            addTriangle(a, d, b);
         }
     }
 }
 
-void detail::evaluateTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                              std::vector<vec3> &positions, std::vector<vec3> &normals,
-                              const glm::vec3 &p0, double v0, const glm::vec3 &p1, double v1,
-                              const glm::vec3 &p2, double v2) {
+void detail::MarchingTetrahedronBuffer::evaluateTriangle(size_t p0, double v0, size_t p1,
+                                                         double v1, size_t p2, double v2) {
     int index = 0;
     if (v0 <= 0.0) index += 1;
     if (v1 <= 0.0) index += 2;
@@ -143,87 +152,187 @@ void detail::evaluateTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM
     if (index == 0) {  // FULLY OUTSIDE
         return;
     } else if (index == 1) {  // ONLY P0 INSIDE
-        auto p01 = interpolate(p0, v0, p1, v1);
-        auto p02 = interpolate(p0, v0, p2, v2);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p01, p02);
+        auto p01 = addVertex(p0, v0, p1, v1);
+        auto p02 = addVertex(p0, v0, p2, v2);
+        addTriangle(addVertex(p0), p01, p02);
     } else if (index == 2) {  // ONLY P1 INSIDE
-        auto p10 = interpolate(p1, v1, p0, v0);
-        auto p12 = interpolate(p1, v1, p2, v2);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p1, p12, p10);
+        auto p10 = addVertex(p1, v1, p0, v0);
+        auto p12 = addVertex(p1, v1, p2, v2);
+        addTriangle(addVertex(p1), p12, p10);
     } else if (index == 3) {  // P0 AND P1 INSIDE
-        auto p02 = interpolate(p0, v0, p2, v2);
-        auto p12 = interpolate(p1, v1, p2, v2);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p1, p12);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p12, p02);
+        auto p02 = addVertex(p0, v0, p2, v2);
+        auto p12 = addVertex(p1, v1, p2, v2);
+        addTriangle(addVertex(p0), addVertex(p1), p12);
+        addTriangle(addVertex(p0), p12, p02);
     } else if (index == 4) {  // ONLY P2 INSIDE
-        auto p20 = interpolate(p2, v2, p0, v0);
-        auto p21 = interpolate(p2, v2, p1, v1);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p2, p20, p21);
+        auto p20 = addVertex(p2, v2, p0, v0);
+        auto p21 = addVertex(p2, v2, p1, v1);
+        addTriangle(addVertex(p2), p20, p21);
     } else if (index == 5) {  // P0 AND P2 INSIDE
-        auto p01 = interpolate(p0, v0, p1, v1);
-        auto p21 = interpolate(p2, v2, p1, v1);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p01, p21);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p21, p2);
+        auto p01 = addVertex(p0, v0, p1, v1);
+        auto p21 = addVertex(p2, v2, p1, v1);
+        addTriangle(addVertex(p0), p01, p21);
+        addTriangle(addVertex(p0), p21, addVertex(p2));
     } else if (index == 6) {  // P1 AND P2 INSIDE
-        auto p10 = interpolate(p1, v1, p0, v0);
-        auto p20 = interpolate(p2, v2, p0, v0);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p1, p20, p10);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p1, p2, p20);
+        auto p10 = addVertex(p1, v1, p0, v0);
+        auto p20 = addVertex(p2, v2, p0, v0);
+        addTriangle(addVertex(p1), p20, p10);
+        addTriangle(addVertex(p1), addVertex(p2), p20);
     } else if (index == 7) {  // FULLY INSIDE
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p1, p2);
+        addTriangle(addVertex(p0), addVertex(p1), addVertex(p2));
     }
 }
 
-size_t detail::addVertex(K3DTree<size_t, float> &vertexTree, std::vector<vec3> &positions,
-                         std::vector<vec3> &normals, const vec3 pos) {
-    K3DTree<size_t, float>::Node *nearest = vertexTree.findNearest(vec3(pos));
-    vec3 p;
-    if (nearest) {
-        p.x = nearest->getPosition()[0];
-        p.y = nearest->getPosition()[1];
-        p.z = nearest->getPosition()[2];
+uint32_t detail::MarchingTetrahedronBuffer::addVertex(size_t p0, double v0, size_t p1,
+                                                      double v1) {
+    // Always interpolate from the lower to the higher index to get the same position for an
+    // edge regardless of which tetrahedron it was reached from.
+    if (p1 < p0) {
+        std::swap(p0, p1);
+        std::swap(v0, v1);
     }
-    if (!nearest || (glm::distance(p, pos) > glm::epsilon<double>() * 5)) {
-        nearest = vertexTree.insert(pos, positions.size());
-        positions.push_back(pos);
-        normals.push_back(vec3(0, 0, 0));
-    }
-    return nearest->get();
+    double t = 0;
+    if (v0 != v1) t = v0 / (v0 - v1);
+    const float tF = static_cast<float>(t);
+
+    if (tF <= 0.0f) return addVertex(p0);
+    if (tF >= 1.0f) return addVertex(p1);
+
+    const size_t code =
+        std::find(offsets_.begin(), offsets_.end() - 1, p1 - p0) - offsets_.begin();
+    const auto key = static_cast<std::uint64_t>(p0) * offsets_.size() + code;
+
+    auto it = vertices_.find(key);
+    if (it != vertices_.end()) return it->second;
+
+    // Positions very close to a grid point might be rounded onto it, use the grid point vertex
+    // then to not get several vertices at the same position.
+    const vec3 a = position(p0);
+    const vec3 b = position(p1);
+    const vec3 pos = tF * b + (1.f - tF) * a;
+    if (pos == a) return addVertex(p0);
+    if (pos == b) return addVertex(p1);
+    return addVertex(key, pos);
+}
+
+uint32_t detail::MarchingTetrahedronBuffer::addVertex(size_t p) {
+    const auto key = static_cast<std::uint64_t>(p) * offsets_.size() + (offsets_.size() - 1);
+    return addVertex(key, position(p));
 }
 
-void detail::addTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                         std::vector<vec3> &positions, std::vector<vec3> &normals,
-                         const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
-    size_t i0 = addVertex(vertexTree, positions, normals, a);
-    size_t i1 = addVertex(vertexTree, positions, normals, b);
-    size_t i2 = addVertex(vertexTree, positions, normals, c);
+uint32_t detail::MarchingTetrahedronBuffer::addVertex(std::uint64_t key, const vec3 &pos) {
+    auto res = vertices_.emplace(key, static_cast<uint32_t>(positions_.size()));
+    if (res.second) {
+        positions_.push_back(pos);
+        normals_.push_back(vec3(0, 0, 0));
+        keys_.push_back(key);
+    }
+    return res.first->second;
+}
 
+void detail::MarchingTetrahedronBuffer::addTriangle(uint32_t i0, uint32_t i1, uint32_t i2) {
     if (i0 == i1 || i0 == i2 || i1 == i2) {
         // triangle is so small so that the vertices are merged.
         return;
     }
 
-    indexBuffer->add(static_cast<uint32_t>(i0));
-    indexBuffer->add(static_cast<uint32_t>(i1));
-    indexBuffer->add(static_cast<uint32_t>(i2));
+    indices_.push_back(i0);
+    indices_.push_back(i1);
+    indices_.push_back(i2);
 
-    vec3 e0 = b - a;
-    vec3 e1 = c - a;
-    vec3 n = glm::normalize(glm::cross(e0, e1));
+    const vec3 e0 = positions_[i1] - positions_[i0];
+    const vec3 e1 = positions_[i2] - positions_[i0];
+    const vec3 n = glm::cross(e0, e1);
+    const float len = glm::length(n);
+    if (len > 0.0f) {
+        normals_[i0] += n / len;
+        normals_[i1] += n / len;
+        normals_[i2] += n / len;
+    }
+}
 
-    normals[i0] += n;
-    normals[i1] += n;
-    normals[i2] += n;
+vec3 detail::MarchingTetrahedronBuffer::position(size_t p) const {
+    const size_t sliceSize = dim_.x * dim_.y;
+    const size3_t pos{p % dim_.x, (p / dim_.x) % dim_.y, p / sliceSize};
+    return vec3(pos) * spacing_;
 }
 
-glm::vec3 detail::interpolate(const glm::vec3 &p0, double v0, const glm::vec3 &p1,
-                              double v1) {
-    double t = 0;
+std::pair<size_t, size_t> detail::MarchingTetrahedronBuffer::endpoints(std::uint64_t key) const {
+    const auto p = static_cast<size_t>(key / offsets_.size());
+    return {p, p + offsets_[key % offsets_.size()]};
+}
 
-    if (v0 != v1) t = v0 / (v0 - v1);
+bool detail::MarchingTetrahedronBuffer::onPlane(std::uint64_t key, size_t z) const {
+    const size_t sliceSize = dim_.x * dim_.y;
+    const auto p = endpoints(key);
+    return p.first / sliceSize == z && p.second / sliceSize == z;
+}
+
+std::shared_ptr<BasicMesh> detail::MarchingTetrahedronBuffer::merge(
+    const std::vector<MarchingTetrahedronBuffer> &slabs,
+    const std::vector<MarchingTetrahedronBuffer> &sides, const vec4 &color) {
+
+    auto mesh = std::make_shared<BasicMesh>();
+    auto indexBuffer = mesh->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+    auto &indices = indexBuffer->getDataContainer();
+
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto &buffer : slabs) {
+        vertexCount += buffer.positions_.size();
+        indexCount += buffer.indices_.size();
+    }
+    for (const auto &buffer : sides) {
+        vertexCount += buffer.positions_.size();
+        indexCount += buffer.indices_.size();
+    }
+
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    positions.reserve(vertexCount);
+    normals.reserve(vertexCount);
+    indices.reserve(indexCount);
+
+    // vertices on the top plane of the previous slab
+    std::unordered_map<std::uint64_t, uint32_t> shared;
+    std::unordered_map<std::uint64_t, uint32_t> nextShared;
+    std::vector<uint32_t> remap;
+
+    auto append = [&](const MarchingTetrahedronBuffer &buffer, bool weld) {
+        remap.resize(buffer.positions_.size());
+        nextShared.clear();
+        for (size_t i = 0; i < buffer.positions_.size(); ++i) {
+            const auto key = buffer.keys_[i];
+            if (weld && buffer.onPlane(key, buffer.zStart_)) {
+                auto it = shared.find(key);
+                if (it != shared.end()) {
+                    remap[i] = it->second;
+                    normals[it->second] += buffer.normals_[i];
+                    continue;
+                }
+            }
+            remap[i] = static_cast<uint32_t>(positions.size());
+            positions.push_back(buffer.positions_[i]);
+            normals.push_back(buffer.normals_[i]);
+            if (weld && buffer.onPlane(key, buffer.zEnd_)) nextShared[key] = remap[i];
+        }
+        for (auto index : buffer.indices_) indices.push_back(remap[index]);
+        std::swap(shared, nextShared);
+    };
+
+    for (const auto &buffer : slabs) append(buffer, true);
+    for (const auto &buffer : sides) append(buffer, false);
+
+    std::vector<BasicMesh::Vertex> vertices;
+    vertices.reserve(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const float len = glm::length(normals[i]);
+        vertices.push_back(
+            {positions[i], len > 0.0f ? normals[i] / len : normals[i], positions[i], color});
+    }
+    mesh->addVertices(vertices);
 
-    float tF = static_cast<float>(t);
-    return tF * p1 + (1.f - tF) * p0;
+    return mesh;
 }
 
 }  // namespace
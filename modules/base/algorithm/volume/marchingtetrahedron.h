@@ -36,8 +36,14 @@
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/parallel.h>
 
-#include <modules/base/datastructures/kdtree.h>
+#include <warn/push>
+#include <warn/ignore/all>
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <warn/pop>
 
 namespace inviwo {
 
@@ -58,28 +64,66 @@ struct IVW_MODULE_BASE_API MarchingTetrahedronDispatcher {
 };
 
 template <typename T>
-double getValue(const T *src, size3_t pos, size3_t dim, double iso, bool invert = false) {
-    double v = util::glm_convert<double>(src[VolumeRAM::posToIndex(pos, dim)]);
+double getValue(const T *src, size_t index, double iso, bool invert = false) {
+    double v = util::glm_convert<double>(src[index]);
     return invert ? v - iso : -(v - iso);
 }
 
-void evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                   std::vector<vec3> &positions, std::vector<vec3> &normals, const glm::vec3 &p0,
-                   double v0, const glm::vec3 &p1, double v1, const glm::vec3 &p2,
-                   double v2, const glm::vec3 &p3, double v3);
-
-void evaluateTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                      std::vector<vec3> &positions, std::vector<vec3> &normals, const glm::vec3 &p0,
-                      double v0, const glm::vec3 &p1, double v1, const glm::vec3 &p2, double v2);
-
-size_t addVertex(K3DTree<size_t, float> &vertexTree, std::vector<vec3> &positions,
-                 std::vector<vec3> &normals, const vec3 pos);
-
-void addTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                 std::vector<vec3> &positions, std::vector<vec3> &normals, const glm::vec3 &a,
-                 const glm::vec3 &b, const glm::vec3 &c);
+inline bool isValidValue(double v) {
+    return v == v && v != std::numeric_limits<float>::infinity() &&
+           v != -std::numeric_limits<float>::infinity() &&
+           v != std::numeric_limits<float>::max() && v != std::numeric_limits<float>::min() &&
+           v != std::numeric_limits<double>::infinity() &&
+           v != -std::numeric_limits<double>::infinity() &&
+           v != std::numeric_limits<double>::max() && v != std::numeric_limits<double>::min();
+}
 
-glm::vec3 interpolate(const glm::vec3 &p0, double v0, const glm::vec3 &p1, double v1);
+/**
+ * Vertex and triangle buffer for a part of the extracted surface. Vertices are welded by the
+ * grid edge they are interpolated on, or by the grid point if they coincide with one, which
+ * makes vertex lookups a single hash map access. The grid points are given as linear voxel
+ * indices.
+ */
+class IVW_MODULE_BASE_API MarchingTetrahedronBuffer {
+public:
+    MarchingTetrahedronBuffer(size3_t dim, size_t zStart = 0, size_t zEnd = 0);
+
+    void evaluateTetra(size_t i0, double v0, size_t i1, double v1, size_t i2, double v2,
+                       size_t i3, double v3);
+    void evaluateTriangle(size_t i0, double v0, size_t i1, double v1, size_t i2, double v2);
+
+    /**
+     * Merges the buffers into a mesh. Vertices of consecutive slabs that lie on the plane
+     * between the slabs are welded, the side buffers are appended without welding.
+     */
+    static std::shared_ptr<BasicMesh> merge(const std::vector<MarchingTetrahedronBuffer> &slabs,
+                                            const std::vector<MarchingTetrahedronBuffer> &sides,
+                                            const vec4 &color);
+
+private:
+    uint32_t addVertex(size_t i0, double v0, size_t i1, double v1);
+    uint32_t addVertex(size_t i);
+    uint32_t addVertex(std::uint64_t key, const vec3 &pos);
+    void addTriangle(uint32_t a, uint32_t b, uint32_t c);
+
+    vec3 position(size_t i) const;
+    std::pair<size_t, size_t> endpoints(std::uint64_t key) const;
+    bool onPlane(std::uint64_t key, size_t z) const;
+
+    size3_t dim_;
+    vec3 spacing_;
+    size_t zStart_;
+    size_t zEnd_;
+    // index offsets between the end points of all edges used by the tetrahedra, the last
+    // entry is used for vertices at grid points.
+    std::array<size_t, 14> offsets_;
+
+    std::vector<vec3> positions_;
+    std::vector<vec3> normals_;
+    std::vector<std::uint64_t> keys_;
+    std::vector<uint32_t> indices_;
+    std::unordered_map<std::uint64_t, uint32_t> vertices_;
+};
 
 template <class DataType>
 std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
@@ -93,191 +137,139 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
     auto volume = dynamic_cast<const VolumeRAMPrecision<T> *>(volrepr);
     if (!volume) return nullptr;
 
-    K3DTree<size_t, float> vertexTree;
-
-    auto mesh = std::make_shared<BasicMesh>();
-    auto indexBuffer = mesh->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+    const T *src = static_cast<const T *>(volume->getData());
+    const size3_t dim{volume->getDimensions()};
+    const size_t sliceSize = dim.x * dim.y;
 
-    std::vector<vec3> positions;
-    std::vector<vec3> normals;
+    std::vector<MarchingTetrahedronBuffer> slabs;
+    std::vector<MarchingTetrahedronBuffer> sides;
 
-    mesh->setModelMatrix(baseVolume->getModelMatrix());
-    mesh->setWorldMatrix(baseVolume->getWorldMatrix());
+    if (glm::all(glm::greaterThan(dim, size3_t(1)))) {
+        const size_t cells = dim.z - 1;
+        const size_t chunks = util::parallelChunks(cells);
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            slabs.emplace_back(dim, chunk * cells / chunks, (chunk + 1) * cells / chunks);
+        }
 
-    const T *src = static_cast<const T *>(volume->getData());
+        const std::array<size_t, 4> corners = {{0, 1, 1 + dim.x, dim.x}};
+        const static size_t tetras[6][4] = {{0, 1, 3, 5}, {1, 2, 3, 5}, {2, 3, 5, 6},
+                                            {0, 3, 4, 5}, {7, 4, 3, 5}, {7, 6, 5, 3}};
+
+        std::mutex progressMutex;
+        size_t slicesDone = 0;
+
+        util::parallelFor(chunks, [&](size_t chunk) {
+            auto &buffer = slabs[chunk];
+            const size_t kStart = chunk * cells / chunks;
+            const size_t kEnd = (chunk + 1) * cells / chunks;
+
+            // Each voxel is shared by eight cells, convert and validate each slice only once.
+            std::vector<double> lower(sliceSize), upper(sliceSize);
+            std::vector<char> lowerOk(sliceSize), upperOk(sliceSize);
+            auto loadSlice = [&](size_t k, std::vector<double> &values, std::vector<char> &ok) {
+                for (size_t i = 0; i < sliceSize; ++i) {
+                    values[i] = getValue(src, i + k * sliceSize, iso, invert);
+                    ok[i] = isValidValue(values[i]);
+                }
+            };
+            loadSlice(kStart, lower, lowerOk);
+
+            size_t p[8];
+            double v[8];
+            for (size_t k = kStart; k < kEnd; k++) {
+                loadSlice(k + 1, upper, upperOk);
+                for (size_t j = 0; j < dim.y - 1; j++) {
+                    for (size_t i = 0; i < dim.x - 1; i++) {
+                        const size_t index = i + j * dim.x;
+                        bool ok = true;
+                        int inside = 0;
+                        for (size_t c = 0; c < 4; c++) {
+                            ok = ok && lowerOk[index + corners[c]] && upperOk[index + corners[c]];
+                            v[c] = lower[index + corners[c]];
+                            v[c + 4] = upper[index + corners[c]];
+                            inside += (v[c] >= 0) + (v[c + 4] >= 0);
+                        }
+                        if (!ok || inside == 0 || inside == 8) continue;
 
-    const size3_t dim{volume->getDimensions()};
-    double x, y, z, dx, dy, dz;
-    dx = 1.0f / (dim.x - 1);
-    dy = 1.0f / (dim.y - 1);
-    dz = 1.0f / (dim.z - 1);
-    double v[8];
-    glm::vec3 p[8];
-    auto volSize = dim.x * dim.y * dim.z;
-
-    indexBuffer->getDataContainer().reserve(volSize * 6);
-    positions.reserve(volSize * 6);
-    normals.reserve(volSize * 6);
-    const static size_t tetras[6][4] = {{0, 1, 3, 5}, {1, 2, 3, 5}, {2, 3, 5, 6},
-                                        {0, 3, 4, 5}, {7, 4, 3, 5}, {7, 6, 5, 3}};
-
-    for (size_t k = 0; k < dim.z - 1; k++) {
-        for (size_t j = 0; j < dim.y - 1; j++) {
-            for (size_t i = 0; i < dim.x - 1; i++) {
-                x = dx * i;
-                y = dy * j;
-                z = dz * k;
-
-                p[0] = glm::vec3(x, y, z);
-                p[1] = glm::vec3(x + dx, y, z);
-                p[2] = glm::vec3(x + dx, y + dy, z);
-                p[3] = glm::vec3(x, y + dy, z);
-                p[4] = glm::vec3(x, y, z + dz);
-                p[5] = glm::vec3(x + dx, y, z + dz);
-                p[6] = glm::vec3(x + dx, y + dy, z + dz);
-                p[7] = glm::vec3(x, y + dy, z + dz);
-
-                v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
-                v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
-                v[2] = getValue(src, size3_t(i + 1, j + 1, k), dim, iso, invert);
-                v[3] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
-                v[4] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
-                v[5] = getValue(src, size3_t(i + 1, j, k + 1), dim, iso, invert);
-                v[6] = getValue(src, size3_t(i + 1, j + 1, k + 1), dim, iso, invert);
-                v[7] = getValue(src, size3_t(i, j + 1, k + 1), dim, iso, invert);
-
-                bool ok = true;
-                for (int ii = 0; ii < 8 && ok; ii++) {
-                    ok = false;
-                    if (v[ii] != v[ii]) break;
-                    if (v[ii] == std::numeric_limits<float>::infinity()) break;
-                    if (v[ii] == -std::numeric_limits<float>::infinity()) break;
-                    if (v[ii] == std::numeric_limits<float>::max()) break;
-                    if (v[ii] == std::numeric_limits<float>::min()) break;
-                    if (v[ii] == std::numeric_limits<double>::infinity()) break;
-                    if (v[ii] == -std::numeric_limits<double>::infinity()) break;
-                    if (v[ii] == std::numeric_limits<double>::max()) break;
-                    if (v[ii] == std::numeric_limits<double>::min()) break;
-                    ok = true;
+                        for (size_t c = 0; c < 4; c++) {
+                            p[c] = index + corners[c] + k * sliceSize;
+                            p[c + 4] = p[c] + sliceSize;
+                        }
+                        for (int a = 0; a < 6; a++) {
+                            buffer.evaluateTetra(p[tetras[a][0]], v[tetras[a][0]],
+                                                 p[tetras[a][1]], v[tetras[a][1]],
+                                                 p[tetras[a][2]], v[tetras[a][2]],
+                                                 p[tetras[a][3]], v[tetras[a][3]]);
+                        }
+                    }
                 }
-                if (!ok) continue;
+                std::swap(lower, upper);
+                std::swap(lowerOk, upperOk);
 
-                for (int a = 0; a < 6; a++) {
-                    evaluateTetra(vertexTree, indexBuffer, positions, normals, p[tetras[a][0]],
-                                  v[tetras[a][0]], p[tetras[a][1]], v[tetras[a][1]],
-                                  p[tetras[a][2]], v[tetras[a][2]], p[tetras[a][3]],
-                                  v[tetras[a][3]]);
+                if (progressCallback) {
+                    std::lock_guard<std::mutex> lock(progressMutex);
+                    progressCallback(static_cast<float>(++slicesDone) /
+                                     static_cast<float>(cells));
                 }
             }
-        }
-        if (progressCallback)
-            progressCallback(static_cast<float>(k) / static_cast<float>(dim.z - 1));
-    }
+        });
+
+        if (enclose) {
+            auto val = [&](size_t index) { return getValue(src, index, iso, invert); };
 
-    if (enclose) {
-        {
-            K3DTree<size_t, float> sideVertexTree;
             // Z axis
-            for (size_t k = 0; k < dim.z; k += dim.z - 1) {
+            sides.emplace_back(dim);
+            for (auto k : {size_t{0}, dim.z - 1}) {
                 for (size_t j = 0; j < dim.y - 1; ++j) {
                     for (size_t i = 0; i < dim.x - 1; ++i) {
-                        x = dx * i;
-                        y = dy * j;
-                        z = dz * k;
-
-                        p[0] = glm::vec3(x, y, z);
-                        p[1] = glm::vec3(x + dx, y, z);
-                        p[2] = glm::vec3(x + dx, y + dy, z);
-                        p[3] = glm::vec3(x, y + dy, z);
-
-                        v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
-                        v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
-                        v[2] = getValue(src, size3_t(i + 1, j + 1, k), dim, iso, invert);
-                        v[3] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
-
+                        const size_t p0 = i + j * dim.x + k * sliceSize;
+                        const size_t p1 = p0 + 1;
+                        const size_t p2 = p0 + 1 + dim.x;
+                        const size_t p3 = p0 + dim.x;
                         if (k == 0) {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[3], v[3], p[1], v[1]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
-                                v[1], p[3], v[3], p[2], v[2]);
-                        }
-                        else {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[1], v[1], p[3], v[3]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
-                                v[1], p[2], v[2], p[3], v[3]);
+                            sides.back().evaluateTriangle(p0, val(p0), p3, val(p3), p1, val(p1));
+                            sides.back().evaluateTriangle(p1, val(p1), p3, val(p3), p2, val(p2));
+                        } else {
+                            sides.back().evaluateTriangle(p0, val(p0), p1, val(p1), p3, val(p3));
+                            sides.back().evaluateTriangle(p1, val(p1), p2, val(p2), p3, val(p3));
                         }
                     }
                 }
             }
-        }
-        {
-            K3DTree<size_t, float> sideVertexTree;
             // Y axis
+            sides.emplace_back(dim);
             for (size_t k = 0; k < dim.z - 1; ++k) {
-                for (size_t j = 0; j < dim.y; j += dim.y - 1) {
+                for (auto j : {size_t{0}, dim.y - 1}) {
                     for (size_t i = 0; i < dim.x - 1; ++i) {
-                        x = dx * i;
-                        y = dy * j;
-                        z = dz * k;
-
-                        p[0] = glm::vec3(x, y, z);
-                        p[1] = glm::vec3(x + dx, y, z);
-                        p[2] = glm::vec3(x + dx, y, z + dz);
-                        p[3] = glm::vec3(x, y, z + dz);
-
-                        v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
-                        v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
-                        v[2] = getValue(src, size3_t(i + 1, j, k + 1), dim, iso, invert);
-                        v[3] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
-
+                        const size_t p0 = i + j * dim.x + k * sliceSize;
+                        const size_t p1 = p0 + 1;
+                        const size_t p2 = p0 + 1 + sliceSize;
+                        const size_t p3 = p0 + sliceSize;
                         if (j == 0) {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[1], v[1], p[2], v[2]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[2], v[2], p[3], v[3]);
-                        }
-                        else {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[2], v[2], p[1], v[1]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[3], v[3], p[2], v[2]);
+                            sides.back().evaluateTriangle(p0, val(p0), p1, val(p1), p2, val(p2));
+                            sides.back().evaluateTriangle(p0, val(p0), p2, val(p2), p3, val(p3));
+                        } else {
+                            sides.back().evaluateTriangle(p0, val(p0), p2, val(p2), p1, val(p1));
+                            sides.back().evaluateTriangle(p0, val(p0), p3, val(p3), p2, val(p2));
                         }
                     }
                 }
             }
-        }
-        {
-            K3DTree<size_t, float> sideVertexTree;
             // X axis
+            sides.emplace_back(dim);
             for (size_t k = 0; k < dim.z - 1; ++k) {
                 for (size_t j = 0; j < dim.y - 1; ++j) {
-                    for (size_t i = 0; i < dim.x; i += dim.x - 1) {
-                        x = dx * i;
-                        y = dy * j;
-                        z = dz * k;
-
-                        p[0] = glm::vec3(x, y, z);
-                        p[1] = glm::vec3(x, y + dy, z);
-                        p[2] = glm::vec3(x, y + dy, z + dz);
-                        p[3] = glm::vec3(x, y, z + dz);
-
-                        v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
-                        v[1] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
-                        v[2] = getValue(src, size3_t(i, j + 1, k + 1), dim, iso, invert);
-                        v[3] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
-
+                    for (auto i : {size_t{0}, dim.x - 1}) {
+                        const size_t p0 = i + j * dim.x + k * sliceSize;
+                        const size_t p1 = p0 + dim.x;
+                        const size_t p2 = p0 + dim.x + sliceSize;
+                        const size_t p3 = p0 + sliceSize;
                         if (i == 0) {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[3], v[3], p[1], v[1]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
-                                v[1], p[3], v[3], p[2], v[2]);
-                        }
-                        else {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
-                                v[0], p[1], v[1], p[3], v[3]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
-                                v[1], p[2], v[2], p[3], v[3]);
+                            sides.back().evaluateTriangle(p0, val(p0), p3, val(p3), p1, val(p1));
+                            sides.back().evaluateTriangle(p1, val(p1), p3, val(p3), p2, val(p2));
+                        } else {
+                            sides.back().evaluateTriangle(p0, val(p0), p1, val(p1), p3, val(p3));
+                            sides.back().evaluateTriangle(p1, val(p1), p2, val(p2), p3, val(p3));
                         }
                     }
                 }
@@ -285,16 +277,9 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
         }
     }
 
-    ivwAssert(positions.size() == normals.size(), "positions_ and normals_ must be equal");
-    std::vector<BasicMesh::Vertex> vertices;
-    vertices.reserve(positions.size());
-
-    for (auto pit = positions.begin(), nit = normals.begin(); pit != positions.end();
-         ++pit, ++nit) {
-        vertices.push_back({*pit, glm::normalize(*nit), *pit, color});
-    }
-
-    mesh->addVertices(vertices);
+    auto mesh = MarchingTetrahedronBuffer::merge(slabs, sides, color);
+    mesh->setModelMatrix(baseVolume->getModelMatrix());
+    mesh->setWorldMatrix(baseVolume->getWorldMatrix());
 
     if (progressCallback) progressCallback(1.0f);
 
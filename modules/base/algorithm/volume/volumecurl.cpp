@@ -28,10 +28,9 @@
  *********************************************************************************/
 
 #include <modules/base/algorithm/volume/volumecurl.h>
+#include <modules/base/algorithm/volume/volumestencil.h>
+#include <modules/base/algorithm/dataminmax.h>
 
-#include <inviwo/core/util/volumeramutils.h>
-#include <inviwo/core/util/indexmapper.h>
-#include <inviwo/core/util/templatesampler.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
@@ -50,64 +49,32 @@ std::unique_ptr<Volume> curlVolume(const Volume& volume) {
 
     newVolume->dataMap_ = volume.dataMap_;
 
-    const auto m = newVolume->getCoordinateTransformer().getDataToWorldMatrix();
-
-    const auto a = m * vec4(0, 0, 0, 1);
-    const auto b = m * vec4(1.0f / vec3(volume.getDimensions() - size3_t(1)), 1);
-    const auto spacing = b - a;
-
-    const vec3 ox(spacing.x, 0, 0);
-    const vec3 oy(0, spacing.y, 0);
-    const vec3 oz(0, 0, spacing.z);
+    // transforms index space derivatives into world space
+    const auto m = glm::inverse(util::indexToWorldJacobian(*newVolume));
+    auto data = static_cast<vec3*>(newVolume->getEditableRepresentation<VolumeRAM>()->getData());
 
     volume.getRepresentation<VolumeRAM>()->dispatch<void, dispatching::filter::Vec3s>(
         [&](auto vol) {
             using ValueType = util::PrecsionValueType<decltype(vol)>;
-            using ComponentType = typename ValueType::value_type;
-
-            util::IndexMapper3D index(volume.getDimensions());
-            auto data =
-                static_cast<vec3*>(newVolume->getEditableRepresentation<VolumeRAM>()->getData());
-            float minV = std::numeric_limits<float>::max();
-            float maxV = std::numeric_limits<float>::lowest();
-
-            const auto worldSpace = TemplateVolumeSampler<ValueType, ComponentType>::Space::World;
-            TemplateVolumeSampler<ValueType, ComponentType> sampler(volume, worldSpace);
-
-            auto func = [&](const size3_t& pos) {
-                const vec3 world{m *
-                                 vec4(vec3(pos) / vec3(volume.getDimensions() - size3_t(1)), 1)};
-
-                auto Fxp = static_cast<vec3>(sampler.sample(world + ox));
-                auto Fxm = static_cast<vec3>(sampler.sample(world - ox));
-                auto Fyp = static_cast<vec3>(sampler.sample(world + oy));
-                auto Fym = static_cast<vec3>(sampler.sample(world - oy));
-                auto Fzp = static_cast<vec3>(sampler.sample(world + oz));
-                auto Fzm = static_cast<vec3>(sampler.sample(world - oz));
-
-                const vec3 Fx = (Fxp - Fxm) / (2.0f * spacing.x);
-                const vec3 Fy = (Fyp - Fym) / (2.0f * spacing.y);
-                const vec3 Fz = (Fzp - Fzm) / (2.0f * spacing.z);
-
-                vec3 c;
-                c.x = static_cast<float>(Fy.z - Fz.y);
-                c.y = static_cast<float>(Fz.x - Fx.z);
-                c.z = static_cast<float>(Fx.y - Fy.x);
-
-                minV = std::min({minV, c.x, c.y, c.z});
-                maxV = std::max({maxV, c.x, c.y, c.z});
-
-                data[index(pos)] = c;
-            };
-
-            util::forEachVoxel(*volume.getRepresentation<VolumeRAM>(), func);
-
-            auto range = std::max(std::abs(minV), std::abs(maxV));
-            newVolume->dataMap_.dataRange = dvec2(-range, range);
-            newVolume->dataMap_.valueRange = dvec2(minV, maxV);
 
+            util::forEachVoxelStencil<dvec3>(
+                vol->getDataTyped(), vol->getDimensions(),
+                [](const ValueType& v) { return dvec3{v}; },
+                [&](size_t i, const VolumeStencil<dvec3>& s) {
+                    // columns are the derivatives along the world x, y, and z axis
+                    const dmat3 J = dmat3{s.firstDerivative(0), s.firstDerivative(1),
+                                          s.firstDerivative(2)} *
+                                    m;
+                    data[i] = vec3{J[1].z - J[2].y, J[2].x - J[0].z, J[0].y - J[1].x};
+                });
         });
-    //      */
+
+    const auto minmax = util::dataMinMax(data, glm::compMul(volume.getDimensions()));
+    const auto minV = glm::compMin(dvec3(minmax.first));
+    const auto maxV = glm::compMax(dvec3(minmax.second));
+    const auto range = std::max(std::abs(minV), std::abs(maxV));
+    newVolume->dataMap_.dataRange = dvec2(-range, range);
+    newVolume->dataMap_.valueRange = dvec2(minV, maxV);
 
     return newVolume;
 }
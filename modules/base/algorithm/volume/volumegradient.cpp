@@ -28,11 +28,10 @@
  *********************************************************************************/
 
 #include <modules/base/algorithm/volume/volumegradient.h>
+#include <modules/base/algorithm/volume/volumestencil.h>
 
-#include <inviwo/core/util/volumeramutils.h>
-#include <inviwo/core/util/indexmapper.h>
-#include <inviwo/core/util/volumesampler.h>
 #include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
 
 namespace inviwo {
 namespace util {
@@ -43,39 +42,25 @@ std::shared_ptr<Volume> gradientVolume(std::shared_ptr<const Volume> volume, int
     newVolume->setModelMatrix(volume->getModelMatrix());
     newVolume->setWorldMatrix(volume->getWorldMatrix());
 
-    auto m = newVolume->getCoordinateTransformer().getDataToWorldMatrix();
-
-    const auto a = m * vec4(0, 0, 0, 1);
-    const auto b = m * vec4(1.0f / vec3(volume->getDimensions() - size3_t(1)), 1);
-    const auto spacing = b - a;
-
-    const vec3 ox(spacing.x, 0, 0);
-    const vec3 oy(0, spacing.y, 0);
-    const vec3 oz(0, 0, spacing.z);
-
-    VolumeDoubleSampler<4> sampler(volume);
-    const auto worldSpace = VolumeDoubleSampler<3>::Space::World;
-
-    util::IndexMapper3D index(volume->getDimensions());
+    // transforms index space gradients into world space
+    const auto m = glm::transpose(glm::inverse(util::indexToWorldJacobian(*newVolume)));
     auto data = static_cast<vec3*>(newVolume->getEditableRepresentation<VolumeRAM>()->getData());
 
-    auto func = [&](const size3_t& pos) {
-        const vec3 world{m * vec4(vec3(pos) / vec3(volume->getDimensions() - size3_t(1)), 1)};
-
-        vec3 g;
-        g.x = static_cast<float>((sampler.sample(world + ox, worldSpace) -
-                                  sampler.sample(world - ox, worldSpace))[channel] /
-                                 (2.0 * spacing.x));
-        g.y = static_cast<float>((sampler.sample(world + oy, worldSpace) -
-                                  sampler.sample(world - oy, worldSpace))[channel] /
-                                 (2.0 * spacing.y));
-        g.z = static_cast<float>((sampler.sample(world + oz, worldSpace) -
-                                  sampler.sample(world - oz, worldSpace))[channel] /
-                                 (2.0 * spacing.z));
-        data[index(pos)] = g;
-    };
+    volume->getRepresentation<VolumeRAM>()->dispatch<void>([&](auto vol) {
+        using ValueType = util::PrecsionValueType<decltype(vol)>;
+        const size_t c = static_cast<size_t>(channel);
+        const bool valid = channel >= 0 && c < DataFormat<ValueType>::comp;
 
-    util::forEachVoxel(*volume->getRepresentation<VolumeRAM>(), func);
+        util::forEachVoxelStencil<double>(
+            vol->getDataTyped(), vol->getDimensions(),
+            [&](const ValueType& v) {
+                return valid ? static_cast<double>(util::glmcomp(v, c)) : 0.0;
+            },
+            [&](size_t i, const VolumeStencil<double>& s) {
+                data[i] = vec3{m * dvec3{s.firstDerivative(0), s.firstDerivative(1),
+                                         s.firstDerivative(2)}};
+            });
+    });
 
     return newVolume;
 }
@@ -33,9 +33,10 @@
 #include <modules/base/basemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/volume/volume.h>
-#include <inviwo/core/util/volumeramutils.h>
-#include <inviwo/core/util/indexmapper.h>
-#include <inviwo/core/util/templatesampler.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/parallel.h>
+#include <modules/base/algorithm/volume/volumestencil.h>
+#include <modules/base/algorithm/dataminmax.h>
 
 namespace inviwo {
 
@@ -43,6 +44,10 @@ namespace util {
 
 enum class VolumeLaplacianPostProcessing { None, Normalized, SignNormalized, Scaled };
 
+/**
+ * Computes the Laplacian of each component of the volume in world space.
+ * @throw Exception if the basis vectors of the volume are not orthogonal
+ */
 IVW_MODULE_BASE_API std::shared_ptr<Volume> volumeLaplacian(
     std::shared_ptr<const Volume> volume, VolumeLaplacianPostProcessing postProcessing,
     double scale);
@@ -63,7 +68,7 @@ std::shared_ptr<Volume> inviwo::util::detail::VolumeLaplacianDispatcher::dispatc
     using T = typename DF::type;
     constexpr size_t comp = DF::comp;
     using R = typename util::same_extent<T, float>::type;
-    using Sampler = TemplateVolumeSampler<T, double, double>;
+    using D = typename util::same_extent<T, double>::type;
 
     static_assert(comp > 0, "zero extent");
 
@@ -73,68 +78,72 @@ std::shared_ptr<Volume> inviwo::util::detail::VolumeLaplacianDispatcher::dispatc
     newVolume->setModelMatrix(volume->getModelMatrix());
     newVolume->setWorldMatrix(volume->getWorldMatrix());
 
-    const dmat4 m{volume->getCoordinateTransformer().getDataToWorldMatrix()};
-    const auto a = m * dvec4(0, 0, 0, 1);
-    const auto b = m * dvec4(dvec3(1.0) / dvec3(volume->getDimensions() - size3_t(1)), 1);
-    const auto spacing = dvec3(b - a);
-
-    const auto o = glm::diagonal3x3(spacing);
-    const Sampler s(volume, CoordinateSpace::World);
+    // The stencil has no diagonal neighbors to compute the mixed derivatives that a
+    // non-orthogonal basis needs, for orthogonal axes the spacing is the length of a voxel step
+    const auto jacobian = util::indexToWorldJacobian(*volume);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = i + 1; j < 3; ++j) {
+            if (std::abs(glm::dot(jacobian[i], jacobian[j])) >
+                1e-6 * glm::length(jacobian[i]) * glm::length(jacobian[j])) {
+                throw Exception("The Laplacian requires a volume with orthogonal basis vectors",
+                                IvwContextCustom("util::volumeLaplacian"));
+            }
+        }
+    }
+    const dvec3 spacing{glm::length(jacobian[0]), glm::length(jacobian[1]),
+                        glm::length(jacobian[2])};
+    const auto resSpace2 = dvec3(1.0) / (spacing * spacing);
 
-    const util::IndexMapper3D index{volume->getDimensions()};
+    const auto vol = static_cast<const VolumeRAMPrecision<T>*>(
+        volume->template getRepresentation<VolumeRAM>());
+    const size_t size = glm::compMul(volume->getDimensions());
 
-    const auto resDim = dvec3(1.0) / dvec3(volume->getDimensions() - size3_t(1));
-    const auto resSpace2 = dvec3(1.0) / (spacing * spacing);
+    util::forEachVoxelStencil<D>(vol->getDataTyped(), vol->getDimensions(),
+                                 [](const T& v) { return static_cast<D>(v); },
+                                 [&](size_t i, const VolumeStencil<D>& s) {
+                                     const auto laplacian = s.secondDerivative(0) * resSpace2.x +
+                                                            s.secondDerivative(1) * resSpace2.y +
+                                                            s.secondDerivative(2) * resSpace2.z;
+                                     newData[i] = static_cast<R>(laplacian);
+                                 });
 
+    // Make range symmetric
+    const auto minmax = util::dataMinMax(newData, size);
     auto minval(std::numeric_limits<double>::max());
     auto maxval(std::numeric_limits<double>::lowest());
+    for (size_t i = 0; i < comp; ++i) {
+        minval = std::min(minval, minmax.first[i]);
+        maxval = std::max(maxval, minmax.second[i]);
+    }
+    auto rangemax = std::max(std::abs(minval), std::abs(maxval));
 
-    auto func = [&](const size3_t& pos) {
-        const dvec3 world{m * dvec4((dvec3(pos) + dvec3(0.5)) * resDim, 1.0)};
-
-        const auto center = 2.0 * s.sample(world);
-        const auto D2x = (s.sample(world + o[0]) + center - s.sample(world - o[0])) * resSpace2.x;
-        const auto D2y = (s.sample(world + o[1]) + center - s.sample(world - o[1])) * resSpace2.y;
-        const auto D2z = (s.sample(world + o[2]) + center - s.sample(world - o[2])) * resSpace2.z;
-        const auto laplacian = center + D2x + D2y + D2z;
-
-        for (size_t i = 0; i < comp; ++i) {
-            minval = glm::min(minval, util::glmcomp(laplacian, i));
-            maxval = glm::max(maxval, util::glmcomp(laplacian, i));
-        }
-        newData[index(pos)] = static_cast<R>(laplacian);
+    auto transform = [&](auto func) {
+        const size_t jobs = util::parallelChunks(size);
+        util::parallelFor(jobs, [&](size_t job) {
+            std::transform(newData + job * size / jobs, newData + (job + 1) * size / jobs,
+                           newData + job * size / jobs, func);
+        });
     };
 
-    util::forEachVoxelParallel(*volume->getRepresentation<VolumeRAM>(), func);
-
-    // Make range symmetric
-    auto rangemax = std::max(std::abs(minval), std::abs(maxval));
-
     switch (postProcessing) {
         case VolumeLaplacianPostProcessing::Normalized:
-            util::forEachVoxelParallel(
-                *volume->getRepresentation<VolumeRAM>(), [&](const size3_t& pos) {
-                    newData[index(pos)] = (newData[index(pos)] + R{static_cast<float>(rangemax)}) /
-                                          R{static_cast<float>(2.0 * rangemax)};
-                });
+            transform([&](const R& v) {
+                return (v + R{static_cast<float>(rangemax)}) /
+                       R{static_cast<float>(2.0 * rangemax)};
+            });
             newVolume->dataMap_.dataRange = dvec2(0.0, 1.0);
             newVolume->dataMap_.valueRange = dvec2(0.0, 1.0);
             break;
         case VolumeLaplacianPostProcessing::SignNormalized:
-            util::forEachVoxelParallel(
-                *volume->getRepresentation<VolumeRAM>(), [&](const size3_t& pos) {
-                    newData[index(pos)] = (newData[index(pos)] + R{static_cast<float>(rangemax)}) /
-                                              R{static_cast<float>(rangemax)} -
-                                          R{1.0f};
-                });
+            transform([&](const R& v) {
+                return (v + R{static_cast<float>(rangemax)}) / R{static_cast<float>(rangemax)} -
+                       R{1.0f};
+            });
             newVolume->dataMap_.dataRange = dvec2(-1.0, 1.0);
             newVolume->dataMap_.valueRange = dvec2(-1.0, 1.0);
             break;
         case VolumeLaplacianPostProcessing::Scaled:
-            util::forEachVoxelParallel(
-                *volume->getRepresentation<VolumeRAM>(), [&](const size3_t& pos) {
-                    newData[index(pos)] = newData[index(pos)] * R{static_cast<float>(scale)};
-                });
+            transform([&](const R& v) { return v * R{static_cast<float>(scale)}; });
             newVolume->dataMap_.dataRange = dvec2(-rangemax * scale, rangemax * scale);
             newVolume->dataMap_.valueRange = dvec2(-rangemax * scale, rangemax * scale);
             break;
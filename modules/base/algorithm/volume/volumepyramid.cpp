@@ -0,0 +1,198 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/volume/volumepyramid.h>
+#include <modules/base/algorithm/volume/volumeramsubsample.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/io/ivfvolumereader.h>
+#include <inviwo/core/io/ivfvolumewriter.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/metadata/metadata.h>
+#include <inviwo/core/util/filesystem.h>
+
+namespace inviwo {
+
+namespace util {
+
+VolumePyramid::VolumePyramid(std::vector<std::shared_ptr<Volume>> levels)
+    : levels_(std::move(levels)) {}
+
+size_t VolumePyramid::size() const { return levels_.size(); }
+
+std::shared_ptr<Volume> VolumePyramid::getLevel(size_t level) const {
+    return levels_.at(level);
+}
+
+const std::vector<std::shared_ptr<Volume>>& VolumePyramid::getLevels() const { return levels_; }
+
+size_t VolumePyramid::selectLevel(double voxelScreenSize, double maxError) const {
+    if (levels_.empty()) return 0;
+    const dvec3 dims0{levels_.front()->getDimensions()};
+    size_t selected = 0;
+    for (size_t level = 1; level < levels_.size(); ++level) {
+        const dvec3 scale = dims0 / dvec3{levels_[level]->getDimensions()};
+        const double size = voxelScreenSize * glm::compMax(scale);
+        if (size > maxError) break;
+        selected = level;
+    }
+    return selected;
+}
+
+std::vector<size3_t> volumePyramidDimensions(size3_t dims, size_t minDimension) {
+    std::vector<size3_t> res{dims};
+    for (;;) {
+        size3_t next = dims;
+        for (size_t i = 0; i < 3; ++i) {
+            if (dims[i] / 2 >= std::max(minDimension, size_t{1})) next[i] = dims[i] / 2;
+        }
+        if (next == dims) break;
+        res.push_back(next);
+        dims = next;
+    }
+    return res;
+}
+
+namespace {
+
+// Give level the same spatial extent and data map as base. The sub sampling drops the voxels that
+// do not fill a whole block, hence the basis is scaled to cover the voxels that are left.
+void matchBase(const Volume& base, Volume& level) {
+    const size3_t baseDims = base.getDimensions();
+    const size3_t dims = level.getDimensions();
+    const dvec3 covered = dvec3(dims * (baseDims / dims)) / dvec3(baseDims);
+    mat3 basis = base.getBasis();
+    for (size_t i = 0; i < 3; ++i) basis[i] *= static_cast<float>(covered[i]);
+    level.setBasis(basis);
+    level.setOffset(base.getOffset());
+    level.setWorldMatrix(base.getWorldMatrix());
+    level.dataMap_ = base.dataMap_;
+}
+
+std::shared_ptr<Volume> subSampleLevel(const Volume& base, const Volume& prev,
+                                       const size3_t& dims) {
+    const size3_t factors = prev.getDimensions() / dims;
+    auto level = std::make_shared<Volume>(
+        util::volumeSubSample(prev.getRepresentation<VolumeRAM>(), factors));
+    matchBase(base, *level);
+    return level;
+}
+
+// Key of the StringMetaData holding the source stamp of cached levels
+const std::string sourceStampKey = "PyramidSourceStamp";
+
+bool isValidLevel(const Volume& level, const Volume& base, const size3_t& dims,
+                  const std::string& stamp) {
+    return level.getDimensions() == dims && level.getDataFormat() == base.getDataFormat() &&
+           level.getMetaData<StringMetaData>(sourceStampKey, std::string{}) == stamp;
+}
+
+std::string fileStamp(const std::string& file) {
+    if (!filesystem::fileExists(file)) return "";
+    return toString(filesystem::fileSize(file)) + ":" +
+           toString(filesystem::fileModificationTime(file));
+}
+
+}  // namespace
+
+std::shared_ptr<VolumePyramid> buildVolumePyramid(std::shared_ptr<Volume> volume,
+                                                  size_t minDimension) {
+    const auto dims = volumePyramidDimensions(volume->getDimensions(), minDimension);
+    std::vector<std::shared_ptr<Volume>> levels{volume};
+    for (size_t i = 1; i < dims.size(); ++i) {
+        levels.push_back(subSampleLevel(*volume, *levels.back(), dims[i]));
+    }
+    return std::make_shared<VolumePyramid>(std::move(levels));
+}
+
+std::string volumePyramidCacheFile(const std::string& cacheBase, size_t level) {
+    return cacheBase + ".pyramid" + toString(level) + ".ivf";
+}
+
+std::string volumePyramidSourceStamp(const std::string& sourceFile, const Volume& volume) {
+    auto stamp = fileStamp(sourceFile);
+    if (stamp.empty()) return stamp;
+    if (volume.hasRepresentation<VolumeDisk>()) {
+        const auto disk = volume.getRepresentation<VolumeDisk>();
+        if (auto loader = dynamic_cast<const RawVolumeRAMLoader*>(disk->getLoader())) {
+            if (loader->getRawFile() != sourceFile) stamp += ";" + fileStamp(loader->getRawFile());
+        }
+    }
+    return stamp;
+}
+
+std::shared_ptr<VolumePyramid> loadOrBuildVolumePyramid(std::shared_ptr<Volume> volume,
+                                                        const std::string& cacheBase,
+                                                        const std::string& sourceFile,
+                                                        size_t minDimension) {
+    const auto stamp = volumePyramidSourceStamp(sourceFile, *volume);
+    const auto dims = volumePyramidDimensions(volume->getDimensions(), minDimension);
+    std::vector<std::shared_ptr<Volume>> levels{volume};
+    bool writable = true;
+    for (size_t i = 1; i < dims.size(); ++i) {
+        const auto file = volumePyramidCacheFile(cacheBase, i);
+        std::shared_ptr<Volume> level;
+        if (filesystem::fileExists(file)) {
+            try {
+                level = IvfVolumeReader().readData(file);
+                if (level && isValidLevel(*level, *volume, dims[i], stamp)) {
+                    matchBase(*volume, *level);
+                } else {
+                    level.reset();
+                }
+            } catch (const DataReaderException& e) {
+                LogWarnCustom("VolumePyramid", "Could not read cached level: " << e.getMessage());
+            }
+        }
+
+        if (!level) {
+            level = subSampleLevel(*volume, *levels.back(), dims[i]);
+            level->setMetaData<StringMetaData>(sourceStampKey, stamp);
+            if (writable) {
+                try {
+                    IvfVolumeWriter writer;
+                    writer.setOverwrite(true);
+                    writer.writeData(level.get(), file);
+                } catch (const DataWriterException& e) {
+                    LogWarnCustom("VolumePyramid",
+                                  "Could not cache level: " << e.getMessage());
+                    writable = false;
+                }
+            }
+        }
+        levels.push_back(level);
+    }
+    return std::make_shared<VolumePyramid>(std::move(levels));
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,137 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEPYRAMID_H
+#define IVW_VOLUMEPYRAMID_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/ports/datainport.h>
+#include <inviwo/core/ports/dataoutport.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vector>
+#include <memory>
+#include <string>
+#include <warn/pop>
+
+namespace inviwo {
+
+class Volume;
+
+namespace util {
+
+/**
+ * A chain of volumes of decreasing resolution. Level 0 is the full resolution volume and each
+ * following level halves the dimensions of the previous one using util::volumeSubSample.
+ * All levels share the basis, offset, world matrix and data map of level 0, hence they cover the
+ * same region in space and can be used interchangeably.
+ */
+class IVW_MODULE_BASE_API VolumePyramid {
+public:
+    explicit VolumePyramid(std::vector<std::shared_ptr<Volume>> levels);
+
+    size_t size() const;
+    std::shared_ptr<Volume> getLevel(size_t level) const;
+    const std::vector<std::shared_ptr<Volume>>& getLevels() const;
+
+    /**
+     * Select the coarsest level whose voxels project to at most maxError pixels on screen.
+     * @param voxelScreenSize the projected size in pixels of a voxel of level 0
+     * @param maxError the largest acceptable voxel size in pixels
+     * @return the selected level, 0 if even level 0 exceeds the error.
+     */
+    size_t selectLevel(double voxelScreenSize, double maxError = 1.0) const;
+
+private:
+    std::vector<std::shared_ptr<Volume>> levels_;
+};
+
+/**
+ * The dimensions of each level of a pyramid for a volume of dimensions dims. Each dimension is
+ * halved as long as the result is at least minDimension. The first entry is dims.
+ */
+IVW_MODULE_BASE_API std::vector<size3_t> volumePyramidDimensions(size3_t dims,
+                                                                 size_t minDimension = 32);
+
+/**
+ * Build a pyramid for volume. Every level is computed from the previous one, and each level is
+ * computed in parallel on the thread pool.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<VolumePyramid> buildVolumePyramid(
+    std::shared_ptr<Volume> volume, size_t minDimension = 32);
+
+/**
+ * The file name used to cache level of a pyramid. The levels are stored as ivf files next to
+ * the source, i.e. "<cacheBase>.pyramid<level>.ivf".
+ */
+IVW_MODULE_BASE_API std::string volumePyramidCacheFile(const std::string& cacheBase,
+                                                       size_t level);
+
+/**
+ * A stamp identifying the version of the file a volume was loaded from, made of the size and
+ * modification time of sourceFile, and of the raw file if volume is read from a separate one.
+ * Empty if sourceFile does not exist.
+ */
+IVW_MODULE_BASE_API std::string volumePyramidSourceStamp(const std::string& sourceFile,
+                                                         const Volume& volume);
+
+/**
+ * Load the pyramid of volume from the ivf files given by volumePyramidCacheFile. Levels that are
+ * missing, that do not match the dimensions and format of volume, or that were built from
+ * another version of sourceFile according to volumePyramidSourceStamp, are built and written
+ * back to the cache. Cached levels are loaded lazily from disk. If the cache can not be written
+ * the built levels are kept in memory only.
+ * @param volume the full resolution volume, level 0
+ * @param cacheBase the base name of the cached level files
+ * @param sourceFile the file volume was loaded from, used to detect stale cached levels
+ * @param minDimension see volumePyramidDimensions
+ */
+IVW_MODULE_BASE_API std::shared_ptr<VolumePyramid> loadOrBuildVolumePyramid(
+    std::shared_ptr<Volume> volume, const std::string& cacheBase, const std::string& sourceFile,
+    size_t minDimension = 32);
+
+}  // namespace util
+
+using VolumePyramidInport = DataInport<util::VolumePyramid>;
+using VolumePyramidOutport = DataOutport<util::VolumePyramid>;
+
+template <>
+struct port_traits<util::VolumePyramid> {
+    static std::string class_identifier() { return "VolumePyramid"; }
+    static uvec3 color_code() { return uvec3(218, 131, 131); }
+    static std::string data_info(const util::VolumePyramid* data) {
+        return "Volume pyramid with " + toString(data->size()) + " levels";
+    }
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMEPYRAMID_H
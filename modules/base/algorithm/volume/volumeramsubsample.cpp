@@ -31,6 +31,7 @@
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/parallel.h>
 
 namespace inviwo {
 
@@ -57,9 +58,7 @@ std::shared_ptr<VolumeRAM> util::volumeSubSample(const VolumeRAM* volume, size3_
             util::IndexMapper3D n(destDims);
 
             const double samplesInv = 1.0 / (f.x * f.y * f.z);
-#pragma omp parallel for
-            for (long long z_ = 0; z_ < static_cast<long long>(destDims.z); ++z_) {
-                const size_t z = static_cast<size_t>(z_);  // OpenMP need signed integral type.
+            util::parallelFor(destDims.z, [&](size_t z) {
                 for (size_t y = 0; y < destDims.y; ++y) {
                     for (size_t x = 0; x < destDims.x; ++x) {
                         const size_t px{x * f.x};
@@ -81,7 +80,7 @@ std::shared_ptr<VolumeRAM> util::volumeSubSample(const VolumeRAM* volume, size3_
 #include <warn/pop>
                     }
                 }
-            }
+            });
 
             return destVol;
         });
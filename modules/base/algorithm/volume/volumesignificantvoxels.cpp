@@ -30,8 +30,7 @@
 #include <modules/base/algorithm/volume/volumesignificantvoxels.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
-
-#include <algorithm>
+#include <modules/base/algorithm/dataminmax.h>
 
 namespace inviwo {
 
@@ -40,17 +39,25 @@ size_t util::volumeSignificantVoxels(const VolumeRAM* volume, IgnoreSpecialValue
         using ValueType = util::PrecsionValueType<decltype(vr)>;
 
         const auto data = vr->getDataTyped();
-        const auto dim = vr->getDimensions();
-        const auto size = dim.x * dim.y * dim.z;
+        const auto size = glm::compMul(vr->getDimensions());
 
-        if (ignore == IgnoreSpecialValues::Yes) {
-            return std::count_if(data, data + size, [](const auto& v) {
-                return util::all(v != v + ValueType(1)) && util::any(v != ValueType(0));
-            });
-        } else {
-            return std::count_if(data, data + size,
-                                 [](const auto& v) { return util::any(v != ValueType(0)); });
-        }
+        return util::parallelReduce(
+            size, size_t{0},
+            [&](size_t begin, size_t end, size_t count) {
+                // Branch free counting, lets the compiler vectorize the scalar formats
+                if (ignore == IgnoreSpecialValues::Yes) {
+                    for (size_t i = begin; i < end; ++i) {
+                        count += static_cast<size_t>(detail::isFinite(data[i]) &&
+                                                     util::any(data[i] != ValueType(0)));
+                    }
+                } else {
+                    for (size_t i = begin; i < end; ++i) {
+                        count += static_cast<size_t>(util::any(data[i] != ValueType(0)));
+                    }
+                }
+                return count;
+            },
+            [](size_t a, size_t b) { return a + b; });
     });
 }
 
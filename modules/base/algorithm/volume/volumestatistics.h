@@ -0,0 +1,64 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMESTATISTICS_H
+#define IVW_VOLUMESTATISTICS_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+
+namespace inviwo {
+
+class Volume;
+class VolumeRAM;
+
+namespace util {
+
+/**
+ * Compute min, max, number of significant voxels and a histogram per channel in one parallel pass
+ * over the data, instead of using volumeMinMax, volumeSignificantVoxels and the histogram
+ * calculation separately. Values outside of histogramRange are not binned.
+ * @see calculateVolumeStatistics
+ */
+IVW_MODULE_BASE_API VolumeStatistics volumeStatistics(const VolumeRAM* volume,
+                                                      dvec2 histogramRange, size_t bins = 2048,
+                                                      size3_t sampleRate = size3_t(1));
+
+/**
+ * Same as above using the data range of the volume as histogram range.
+ */
+IVW_MODULE_BASE_API VolumeStatistics volumeStatistics(const Volume* volume, size_t bins = 2048,
+                                                      size3_t sampleRate = size3_t(1));
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMESTATISTICS_H
@@ -0,0 +1,154 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMESTENCIL_H
+#define IVW_VOLUMESTENCIL_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <array>
+#include <algorithm>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * \brief The value of a voxel and of its six face neighbors.
+ *
+ * At the boundary of the volume a missing neighbor is replaced by the voxel itself. steps holds
+ * the number of voxels between the minus and plus neighbor along each axis, i.e. 2 in the
+ * interior, 1 at the boundary and 0 if the volume is only one voxel thick along that axis.
+ */
+template <typename V>
+struct VolumeStencil {
+    V center;
+    std::array<V, 3> minus;
+    std::array<V, 3> plus;
+    size3_t steps;
+
+    /**
+     * First derivative along axis in index space. Central difference in the interior and
+     * one-sided difference at the boundary.
+     */
+    V firstDerivative(size_t axis) const {
+        if (steps[axis] == 0) return V{0};
+        return (plus[axis] - minus[axis]) / static_cast<double>(steps[axis]);
+    }
+
+    /**
+     * Second derivative along axis in index space, assuming zero flux across the boundary.
+     */
+    V secondDerivative(size_t axis) const { return plus[axis] - center - center + minus[axis]; }
+};
+
+/**
+ * Calls func(index, stencil) for each voxel of the volume data with dimensions dims, where stencil
+ * is a VolumeStencil<V> and voxel values are converted to V with conv. The volume is processed in
+ * z-slabs in parallel on the thread pool, hence func is called concurrently for different voxels.
+ * Interior voxels are read using fixed offsets, while voxels at the boundary of the volume are
+ * handled separately using clamped neighbors.
+ */
+template <typename V, typename T, typename Conv, typename Func>
+void forEachVoxelStencil(const T* data, const size3_t& dims, Conv conv, Func func) {
+    const std::array<size_t, 3> strides{{1, dims.x, dims.x * dims.y}};
+
+    auto boundary = [&](size_t x, size_t y, size_t z) {
+        const size3_t pos{x, y, z};
+        const size_t i = x + y * strides[1] + z * strides[2];
+        VolumeStencil<V> s;
+        s.center = conv(data[i]);
+        for (size_t axis = 0; axis < 3; ++axis) {
+            const size_t lo = pos[axis] > 0 ? 1 : 0;
+            const size_t hi = pos[axis] + 1 < dims[axis] ? 1 : 0;
+            s.minus[axis] = lo ? conv(data[i - strides[axis]]) : s.center;
+            s.plus[axis] = hi ? conv(data[i + strides[axis]]) : s.center;
+            s.steps[axis] = lo + hi;
+        }
+        func(i, s);
+    };
+
+    auto slice = [&](size_t z) {
+        if (z == 0 || z + 1 >= dims.z || dims.y < 3 || dims.x < 3) {
+            for (size_t y = 0; y < dims.y; ++y) {
+                for (size_t x = 0; x < dims.x; ++x) boundary(x, y, z);
+            }
+            return;
+        }
+        for (size_t x = 0; x < dims.x; ++x) boundary(x, 0, z);
+
+        VolumeStencil<V> s;
+        s.steps = size3_t(2);
+        for (size_t y = 1; y + 1 < dims.y; ++y) {
+            boundary(0, y, z);
+            const size_t rowEnd = (dims.x - 1) + y * strides[1] + z * strides[2];
+            for (size_t i = rowEnd - dims.x + 2; i < rowEnd; ++i) {
+                s.center = conv(data[i]);
+                s.minus[0] = conv(data[i - 1]);
+                s.plus[0] = conv(data[i + 1]);
+                s.minus[1] = conv(data[i - strides[1]]);
+                s.plus[1] = conv(data[i + strides[1]]);
+                s.minus[2] = conv(data[i - strides[2]]);
+                s.plus[2] = conv(data[i + strides[2]]);
+                func(i, s);
+            }
+            boundary(dims.x - 1, y, z);
+        }
+
+        for (size_t x = 0; x < dims.x; ++x) boundary(x, dims.y - 1, z);
+    };
+
+    const size_t slabs = util::parallelChunks(dims.z);
+    util::parallelFor(slabs, [&](size_t slab) {
+        for (size_t z = slab * dims.z / slabs; z < (slab + 1) * dims.z / slabs; ++z) slice(z);
+    });
+}
+
+/**
+ * Returns the matrix transforming voxel index offsets into world space offsets for a volume,
+ * i.e. the Jacobian of the index to world transformation.
+ */
+inline dmat3 indexToWorldJacobian(const Volume& volume) {
+    const dmat3 dataToWorld{dmat4{volume.getCoordinateTransformer().getDataToWorldMatrix()}};
+    const dvec3 scale{dvec3(1.0) /
+                      dvec3(glm::max(volume.getDimensions(), size3_t(2)) - size3_t(1))};
+    return dataToWorld * glm::diagonal3x3(scale);
+}
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMESTENCIL_H
@@ -54,6 +54,7 @@
 #include <modules/base/processors/imagesequenceelementselectorprocessor.h>
 #include <modules/base/processors/meshsequenceelementselectorprocessor.h>
 #include <modules/base/processors/volumesource.h>
+#include <modules/base/processors/volumepyramidlevel.h>
 #include <modules/base/processors/volumeexport.h>
 #include <modules/base/processors/volumebasistransformer.h>
 #include <modules/base/processors/volumeslice.h>
@@ -134,6 +135,7 @@ BaseModule::BaseModule(InviwoApplication* app) : InviwoModule(app, "Base") {
     registerProcessor<WorldTransformVolume>();
     registerProcessor<VolumeSlice>();
     registerProcessor<VolumeSubsample>();
+    registerProcessor<VolumePyramidLevel>();
     registerProcessor<VolumeSubset>();
     registerProcessor<ImageContourProcessor>();
     registerProcessor<VolumeSequenceSource>();
@@ -173,6 +175,8 @@ BaseModule::BaseModule(InviwoApplication* app) : InviwoModule(app, "Base") {
     registerPort<DataOutport<LightSource>>("LightSourceOutport");
     registerPort<BufferInport>("BufferInport");
     registerPort<BufferOutport>("BufferOutport");
+    registerPort<VolumePyramidInport>("VolumePyramidInport");
+    registerPort<VolumePyramidOutport>("VolumePyramidOutport");
     
     registerDataWriter(util::make_unique<StlWriter>());
     registerDataWriter(util::make_unique<BinarySTLWriter>());
@@ -0,0 +1,334 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_FLATKDTREE_H
+#define IVW_FLATKDTREE_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/glm.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <warn/pop>
+
+namespace inviwo {
+
+/**
+ * \class FlatKDTree
+ * \brief A static KD-tree stored in flat arrays.
+ *
+ * In contrast to KDTree the FlatKDTree is built once from all points. The points are reordered
+ * such that each leaf is a contiguous range, and the internal nodes form an implicit balanced
+ * binary tree (children of node i at 2i+1 and 2i+2) split at the median along the axis of
+ * largest extent. Building and the batch queries are parallelized over the thread pool.
+ *
+ * All query results refer to points by their index in the vectors given to build().
+ */
+template <unsigned char N, typename T = char, typename P = double>
+class FlatKDTree {
+public:
+    using Point = Vector<N, P>;
+
+    struct Neighbor {
+        size_t index;
+        P sqDist;
+        bool operator<(const Neighbor &rhs) const { return sqDist < rhs.sqDist; }
+    };
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    FlatKDTree() = default;
+    FlatKDTree(std::vector<Point> points, std::vector<T> data = {}, size_t leafSize = 16);
+
+    /**
+     * Builds the tree from the given points. data is optional, if given it must have the same
+     * size as points.
+     */
+    void build(std::vector<Point> points, std::vector<T> data = {}, size_t leafSize = 16);
+
+    size_t size() const { return points_.size(); }
+    bool empty() const { return points_.empty(); }
+    size_t depth() const { return levels_; }
+
+    const Point &getPosition(size_t index) const { return points_[slots_[index]]; }
+    const T &getData(size_t index) const { return data_[index]; }
+    T &getData(size_t index) { return data_[index]; }
+
+    /**
+     * Returns the nearest point, with index npos if the tree is empty.
+     */
+    Neighbor findNearest(const Point &pos) const;
+    /**
+     * Returns the (at most) amount nearest points sorted by distance.
+     */
+    std::vector<Neighbor> findNNearest(const Point &pos, size_t amount) const;
+    /**
+     * Returns all points closer than distance, in no particular order.
+     */
+    std::vector<Neighbor> findCloseTo(const Point &pos, P distance) const;
+
+    std::vector<Neighbor> findNearest(const std::vector<Point> &positions) const;
+    std::vector<std::vector<Neighbor>> findNNearest(const std::vector<Point> &positions,
+                                                    size_t amount) const;
+    std::vector<std::vector<Neighbor>> findCloseTo(const std::vector<Point> &positions,
+                                                   P distance) const;
+
+private:
+    static P sqDist(const Point &a, const Point &b) {
+        const auto d = a - b;
+        return glm::dot(d, d);
+    }
+
+    template <typename Visitor>
+    void visit(const Point &pos, size_t node, size_t begin, size_t end, size_t level,
+               Visitor &visitor) const;
+
+    template <typename R, typename F>
+    static std::vector<R> batch(size_t count, F func);
+
+    std::vector<Point> points_;      // reordered into tree order
+    std::vector<size_t> indices_;    // tree order -> input index
+    std::vector<size_t> slots_;      // input index -> tree order
+    std::vector<T> data_;            // input order
+    std::vector<P> splits_;          // split value for each internal node
+    std::vector<unsigned char> axes_;  // split axis for each internal node
+    size_t levels_ = 0;
+};
+
+template <typename T = char, typename P = double>
+using FlatK2DTree = FlatKDTree<2, T, P>;
+template <typename T = char, typename P = double>
+using FlatK3DTree = FlatKDTree<3, T, P>;
+template <typename T = char, typename P = double>
+using FlatK4DTree = FlatKDTree<4, T, P>;
+
+template <unsigned char N, typename T, typename P>
+constexpr size_t FlatKDTree<N, T, P>::npos;
+
+template <unsigned char N, typename T, typename P>
+FlatKDTree<N, T, P>::FlatKDTree(std::vector<Point> points, std::vector<T> data,
+                                size_t leafSize) {
+    build(std::move(points), std::move(data), leafSize);
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::build(std::vector<Point> points, std::vector<T> data,
+                                size_t leafSize) {
+    if (!data.empty() && data.size() != points.size()) {
+        throw Exception("KD-tree data and points must have the same size",
+                        IvwContextCustom("FlatKDTree"));
+    }
+    leafSize = std::max<size_t>(leafSize, 1);
+
+    levels_ = 0;
+    while ((points.size() >> levels_) > leafSize) ++levels_;
+
+    const size_t internalNodes = (size_t{1} << levels_) - 1;
+    splits_.assign(internalNodes, P{0});
+    axes_.assign(internalNodes, 0);
+
+    indices_.resize(points.size());
+    std::iota(indices_.begin(), indices_.end(), size_t{0});
+
+    // Split all nodes of one level in parallel, the ranges of a level do not overlap.
+    std::vector<std::pair<size_t, size_t>> ranges{{0, points.size()}};
+    std::vector<std::pair<size_t, size_t>> next;
+    for (size_t level = 0; level < levels_; ++level) {
+        const size_t first = (size_t{1} << level) - 1;
+        util::parallelFor(ranges.size(), [&](size_t i) {
+            const size_t node = first + i;
+            const size_t begin = ranges[i].first;
+            const size_t end = ranges[i].second;
+            const size_t mid = begin + (end - begin) / 2;
+
+            Point minPos{std::numeric_limits<P>::max()};
+            Point maxPos{std::numeric_limits<P>::lowest()};
+            for (size_t j = begin; j < end; ++j) {
+                minPos = glm::min(minPos, points[indices_[j]]);
+                maxPos = glm::max(maxPos, points[indices_[j]]);
+            }
+            const auto extent = maxPos - minPos;
+            unsigned char axis = 0;
+            for (unsigned char d = 1; d < N; ++d) {
+                if (extent[d] > extent[axis]) axis = d;
+            }
+
+            std::nth_element(indices_.begin() + begin, indices_.begin() + mid,
+                             indices_.begin() + end, [&](size_t a, size_t b) {
+                                 return points[a][axis] < points[b][axis];
+                             });
+            axes_[node] = axis;
+            splits_[node] = points[indices_[mid]][axis];
+        });
+
+        next.clear();
+        for (const auto &range : ranges) {
+            const size_t mid = range.first + (range.second - range.first) / 2;
+            next.emplace_back(range.first, mid);
+            next.emplace_back(mid, range.second);
+        }
+        std::swap(ranges, next);
+    }
+
+    points_.resize(points.size());
+    slots_.resize(points.size());
+    for (size_t i = 0; i < indices_.size(); ++i) {
+        points_[i] = points[indices_[i]];
+        slots_[indices_[i]] = i;
+    }
+    data_ = std::move(data);
+}
+
+template <unsigned char N, typename T, typename P>
+template <typename Visitor>
+void FlatKDTree<N, T, P>::visit(const Point &pos, size_t node, size_t begin, size_t end,
+                                size_t level, Visitor &visitor) const {
+    if (level == levels_) {
+        for (size_t i = begin; i < end; ++i) visitor.add(i, sqDist(pos, points_[i]));
+        return;
+    }
+
+    // Node ranges follow from the implicit layout: each level halves the range of its parent.
+    const size_t mid = begin + (end - begin) / 2;
+    const P diff = pos[axes_[node]] - splits_[node];
+    if (diff < 0) {
+        visit(pos, 2 * node + 1, begin, mid, level + 1, visitor);
+        if (diff * diff <= visitor.bound()) visit(pos, 2 * node + 2, mid, end, level + 1, visitor);
+    } else {
+        visit(pos, 2 * node + 2, mid, end, level + 1, visitor);
+        if (diff * diff <= visitor.bound()) visit(pos, 2 * node + 1, begin, mid, level + 1, visitor);
+    }
+}
+
+template <unsigned char N, typename T, typename P>
+auto FlatKDTree<N, T, P>::findNearest(const Point &pos) const -> Neighbor {
+    struct Nearest {
+        void add(size_t i, P d) {
+            if (d < best.sqDist) best = {i, d};
+        }
+        P bound() const { return best.sqDist; }
+        Neighbor best{npos, std::numeric_limits<P>::max()};
+    } visitor;
+
+    if (empty()) return visitor.best;
+    visit(pos, 0, 0, size(), 0, visitor);
+    visitor.best.index = indices_[visitor.best.index];
+    return visitor.best;
+}
+
+template <unsigned char N, typename T, typename P>
+auto FlatKDTree<N, T, P>::findNNearest(const Point &pos, size_t amount) const
+    -> std::vector<Neighbor> {
+    // max heap on distance, the root is the furthest of the current candidates
+    struct NNearest {
+        void add(size_t i, P d) {
+            if (heap.size() < amount) {
+                heap.push_back({i, d});
+                std::push_heap(heap.begin(), heap.end());
+            } else if (d < heap.front().sqDist) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = {i, d};
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        P bound() const {
+            return heap.size() < amount ? std::numeric_limits<P>::max() : heap.front().sqDist;
+        }
+        size_t amount;
+        std::vector<Neighbor> heap;
+    } visitor{amount, {}};
+
+    if (empty() || amount == 0) return {};
+    visitor.heap.reserve(amount);
+    visit(pos, 0, 0, size(), 0, visitor);
+    std::sort_heap(visitor.heap.begin(), visitor.heap.end());
+    for (auto &n : visitor.heap) n.index = indices_[n.index];
+    return std::move(visitor.heap);
+}
+
+template <unsigned char N, typename T, typename P>
+auto FlatKDTree<N, T, P>::findCloseTo(const Point &pos, P distance) const
+    -> std::vector<Neighbor> {
+    struct CloseTo {
+        void add(size_t i, P d) {
+            if (d < sqDistance) res.push_back({i, d});
+        }
+        P bound() const { return sqDistance; }
+        P sqDistance;
+        std::vector<Neighbor> res;
+    } visitor{distance * distance, {}};
+
+    if (empty()) return {};
+    visit(pos, 0, 0, size(), 0, visitor);
+    for (auto &n : visitor.res) n.index = indices_[n.index];
+    return std::move(visitor.res);
+}
+
+template <unsigned char N, typename T, typename P>
+template <typename R, typename F>
+std::vector<R> FlatKDTree<N, T, P>::batch(size_t count, F func) {
+    std::vector<R> res(count);
+    const size_t chunkSize = 256;
+    util::parallelFor((count + chunkSize - 1) / chunkSize, [&](size_t chunk) {
+        const size_t end = std::min(count, (chunk + 1) * chunkSize);
+        for (size_t i = chunk * chunkSize; i < end; ++i) res[i] = func(i);
+    });
+    return res;
+}
+
+template <unsigned char N, typename T, typename P>
+auto FlatKDTree<N, T, P>::findNearest(const std::vector<Point> &positions) const
+    -> std::vector<Neighbor> {
+    return batch<Neighbor>(positions.size(),
+                           [&](size_t i) { return findNearest(positions[i]); });
+}
+
+template <unsigned char N, typename T, typename P>
+auto FlatKDTree<N, T, P>::findNNearest(const std::vector<Point> &positions, size_t amount) const
+    -> std::vector<std::vector<Neighbor>> {
+    return batch<std::vector<Neighbor>>(
+        positions.size(), [&](size_t i) { return findNNearest(positions[i], amount); });
+}
+
+template <unsigned char N, typename T, typename P>
+auto FlatKDTree<N, T, P>::findCloseTo(const std::vector<Point> &positions, P distance) const
+    -> std::vector<std::vector<Neighbor>> {
+    return batch<std::vector<Neighbor>>(
+        positions.size(), [&](size_t i) { return findCloseTo(positions[i], distance); });
+}
+
+}  // namespace inviwo
+
+#endif  // IVW_FLATKDTREE_H
@@ -106,7 +106,8 @@ void SurfaceExtraction::process() {
         if (!result_[i].result.valid() && (util::contains(changed, data[i].first) ||
                                            !result_[i].isSame(iso, color, invert, enclose))) {
             result_[i].set(iso, color, invert, enclose, 0.0f,
-                           dispatchPool([this, vol, iso, color, invert, enclose,
+                           dispatchPool(ThreadPool::Priority::Background,
+                                        [this, vol, iso, color, invert, enclose,
                                          i]() -> std::shared_ptr<Mesh> {
                                auto m = MarchingTetrahedron::apply(
                                    vol, iso, color, invert, enclose, [this, i](float s) {
@@ -0,0 +1,80 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/processors/volumepyramidlevel.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+
+namespace inviwo {
+
+const ProcessorInfo VolumePyramidLevel::processorInfo_{
+    "org.inviwo.VolumePyramidLevel",  // Class identifier
+    "Volume Pyramid Level",           // Display name
+    "Volume Operation",               // Category
+    CodeState::Experimental,          // Code state
+    Tags::CPU,                        // Tags
+};
+const ProcessorInfo VolumePyramidLevel::getProcessorInfo() const { return processorInfo_; }
+
+VolumePyramidLevel::VolumePyramidLevel()
+    : Processor()
+    , inport_("pyramid")
+    , outport_("volume")
+    , automatic_("automatic", "Automatic", false)
+    , level_("level", "Level", 0, 0, 16)
+    , voxelScreenSize_("voxelScreenSize", "Voxel Screen Size", 1.0, 0.0, 16.0)
+    , maxError_("maxError", "Max Voxel Size", 1.0, 0.1, 16.0) {
+    addPort(inport_);
+    addPort(outport_);
+    addProperty(automatic_);
+    addProperty(level_);
+    addProperty(voxelScreenSize_);
+    addProperty(maxError_);
+
+    voxelScreenSize_.setVisible(false);
+    maxError_.setVisible(false);
+    automatic_.onChange([this]() {
+        level_.setVisible(!automatic_.get());
+        voxelScreenSize_.setVisible(automatic_.get());
+        maxError_.setVisible(automatic_.get());
+    });
+}
+
+void VolumePyramidLevel::process() {
+    auto pyramid = inport_.getData();
+    if (pyramid->size() == 0) return;
+
+    if (inport_.isChanged()) level_.setMaxValue(pyramid->size() - 1);
+
+    const size_t level = automatic_.get()
+                             ? pyramid->selectLevel(voxelScreenSize_.get(), maxError_.get())
+                             : std::min(level_.get(), pyramid->size() - 1);
+    outport_.setData(pyramid->getLevel(level));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,82 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEPYRAMIDLEVEL_H
+#define IVW_VOLUMEPYRAMIDLEVEL_H
+
+#include <modules/base/basemoduledefine.h>
+#include <modules/base/algorithm/volume/volumepyramid.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/ports/volumeport.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.VolumePyramidLevel, Volume Pyramid Level}
+ * ![](org.inviwo.VolumePyramidLevel.png?classIdentifier=org.inviwo.VolumePyramidLevel)
+ * Selects one level of a volume pyramid, either a given level or the coarsest level that is
+ * still fine enough for the size of the voxels on screen, see util::VolumePyramid::selectLevel.
+ *
+ * ### Inports
+ *   * __pyramid__ The pyramid to select from.
+ *
+ * ### Outports
+ *   * __volume__ The selected level.
+ *
+ * ### Properties
+ *   * __Automatic__ Select the level from the voxel screen size instead of the given level.
+ *   * __Level__ The level to use, 0 is the full resolution.
+ *   * __Voxel Screen Size__ The size in pixels of a full resolution voxel on screen.
+ *   * __Max Voxel Size__ The largest acceptable size in pixels of a voxel of the selected level.
+ */
+class IVW_MODULE_BASE_API VolumePyramidLevel : public Processor {
+public:
+    VolumePyramidLevel();
+    virtual ~VolumePyramidLevel() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    VolumePyramidInport inport_;
+    VolumeOutport outport_;
+
+    BoolProperty automatic_;
+    IntSizeTProperty level_;
+    DoubleProperty voxelScreenSize_;
+    DoubleProperty maxError_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMEPYRAMIDLEVEL_H
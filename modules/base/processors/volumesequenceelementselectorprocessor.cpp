@@ -42,9 +42,44 @@ const ProcessorInfo VolumeSequenceElementSelectorProcessor::getProcessorInfo() c
     return processorInfo_;
 }
 VolumeSequenceElementSelectorProcessor::VolumeSequenceElementSelectorProcessor()
-    : VectorElementSelectorProcessor<Volume>() {
+    : VectorElementSelectorProcessor<Volume>()
+    , prefetch_("prefetch", "Prefetch next time step", false, InvalidationLevel::Valid) {
     timeStep_.index_.autoLinkToProperty<VolumeSequenceElementSelectorProcessor>(
         "timeStep.selectedSequenceIndex");
+
+    addProperty(prefetch_);
+    prefetch_.onChange([this]() {
+        if (!prefetch_) token_.cancel();
+    });
+}
+
+VolumeSequenceElementSelectorProcessor::~VolumeSequenceElementSelectorProcessor() {
+    token_.cancel();
+    for (auto& request : requests_) request.future.wait();
+}
+
+void VolumeSequenceElementSelectorProcessor::process() {
+    VectorElementSelectorProcessor<Volume>::process();
+
+    if (!prefetch_) return;
+    if (auto data = inport_.getData()) {
+        const auto next = static_cast<size_t>(timeStep_.index_.get());
+        if (next < data->size()) prefetch((*data)[next]);
+    }
+}
+
+void VolumeSequenceElementSelectorProcessor::prefetch(std::shared_ptr<Volume> volume) {
+    // Forget finished requests and discard the ones that have not started yet, the user has
+    // moved on to another time step.
+    util::erase_remove_if(requests_, [](const Request& request) {
+        return request.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    token_.cancel();
+    token_ = CancellationToken();
+
+    if (!volume || volume->hasRepresentation<VolumeRAM>()) return;
+    requests_.push_back(
+        {volume, volume->requestRepresentation<VolumeRAM>(ThreadPool::Priority::IO, token_)});
 }
 
 }  // namespace
@@ -33,7 +33,9 @@
 #include <modules/base/basemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <modules/base/processors/vectorelementselectorprocessor.h>
 
 
@@ -51,15 +53,31 @@ namespace inviwo {
  *
  * ### Properties
  *   * __Step__ The volume sequence index to extract
+ *   * __Prefetch next time step__ Load the next volume of the sequence into memory in the
+ *     background while the current one is used
  */
 class IVW_MODULE_BASE_API VolumeSequenceElementSelectorProcessor
     : public VectorElementSelectorProcessor<Volume> {
 public:
     VolumeSequenceElementSelectorProcessor();
-    virtual ~VolumeSequenceElementSelectorProcessor() = default;
+    virtual ~VolumeSequenceElementSelectorProcessor();
+
+    virtual void process() override;
 
     virtual const ProcessorInfo getProcessorInfo() const override;
     static const ProcessorInfo processorInfo_;
+
+private:
+    void prefetch(std::shared_ptr<Volume> volume);
+
+    BoolProperty prefetch_;
+
+    struct Request {
+        std::shared_ptr<Volume> volume;  // Keeps the volume alive until the request is done
+        std::future<const VolumeRAM*> future;
+    };
+    std::vector<Request> requests_;
+    CancellationToken token_;
 };
 
 }  // namespace
@@ -39,6 +39,7 @@
 
 
 #include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/volumeutils.h>
 
 namespace inviwo {
 
@@ -138,11 +139,24 @@ void VolumeSlice::process() {
             break;
     }
 
+    const auto axis = static_cast<CartesianCoordinateAxis>(sliceAlongAxis_.get());
+    auto slice = static_cast<size_t>(sliceNumber_.get() - 1);
+
+    // If the volume is not in memory, try to read only the slice from disk.
+    const auto axisIndex = static_cast<size_t>(axis);
+    size3_t sliceOffset(0);
+    size3_t sliceDims(dims);
+    sliceOffset[axisIndex] = glm::clamp(slice, size_t{0}, dims[axisIndex] - 1);
+    sliceDims[axisIndex] = 1;
+    const auto sliceVolume = util::readVolumeRegion(*vol, sliceOffset, sliceDims);
+    if (sliceVolume) slice = 0;
+    const VolumeRAM* volumeRAM =
+        sliceVolume ? sliceVolume.get() : vol->getRepresentation<VolumeRAM>();
+
     auto image =
-        vol->getRepresentation<VolumeRAM>()
+        volumeRAM
             ->dispatch<std::shared_ptr<Image>, dispatching::filter::All>([
-                axis = static_cast<CartesianCoordinateAxis>(sliceAlongAxis_.get()),
-                slice = static_cast<size_t>(sliceNumber_.get() - 1), &cache = imageCache_
+                axis, slice, &cache = imageCache_
             ](const auto vrprecision) {
                 using T = util::PrecsionValueType<decltype(vrprecision)>;
 
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include "volumesource.h"
+#include <modules/base/algorithm/volume/volumepyramid.h>
 #include <inviwo/core/resources/resourcemanager.h>
 #include <inviwo/core/resources/templateresource.h>
 #include <inviwo/core/common/inviwoapplication.h>
@@ -58,11 +59,13 @@ const ProcessorInfo VolumeSource::getProcessorInfo() const {
 VolumeSource::VolumeSource()
     : Processor()
     , outport_("data")
+    , pyramidOutport_("pyramid")
     , file_("filename", "File")
     , reload_("reload", "Reload data")
     , basis_("Basis", "Basis and offset")
     , information_("Information", "Data information")
-    , volumeSequence_("Sequence", "Sequence") {
+    , volumeSequence_("Sequence", "Sequence")
+    , pyramid_("pyramid", "Build Resolution Pyramid", false) {
     
     file_.setContentType("volume");
     file_.setDisplayName("Volume file");
@@ -72,12 +75,14 @@ VolumeSource::VolumeSource()
     addFileNameFilters();
 
     addPort(outport_);
+    addPort(pyramidOutport_);
 
     addProperty(file_);
     addProperty(reload_);
     addProperty(information_);
     addProperty(basis_);
     addProperty(volumeSequence_);
+    addProperty(pyramid_);
 }
 
 void VolumeSource::load(bool deserialize) {
@@ -101,6 +106,7 @@ void VolumeSource::load(bool deserialize) {
     } catch (DataReaderException const& e) {
         LogProcessorError(e.getMessage());
     }
+    pyramids_.clear();
 
     if (volumes_ && !volumes_->empty() && (*volumes_)[0]) {
         basis_.updateForNewEntity(*(*volumes_)[0], deserialize);
@@ -137,11 +143,31 @@ void VolumeSource::process() {
 
         basis_.updateEntity(*(*volumes_)[index]);
         information_.updateVolume(*(*volumes_)[index]);
+        updatePyramid(index);
 
         outport_.setData((*volumes_)[index]);
     }
 }
 
+void VolumeSource::updatePyramid(size_t index) {
+    // Levels take their basis from the volume, reload them from the cache when it changes.
+    if (!pyramid_.get() || basis_.isModified()) pyramids_.clear();
+    if (!pyramid_.get()) {
+        pyramidOutport_.detachData();
+        return;
+    }
+
+    pyramids_.resize(volumes_->size());
+    if (!pyramids_[index]) {
+        // Cache the levels next to the source file, one set per volume in a sequence.
+        const auto cacheBase =
+            volumes_->size() > 1 ? file_.get() + "." + toString(index) : file_.get();
+        pyramids_[index] =
+            util::loadOrBuildVolumePyramid((*volumes_)[index], cacheBase, file_.get());
+    }
+    pyramidOutport_.setData(pyramids_[index]);
+}
+
 void VolumeSource::deserialize(Deserializer& d) {
     Processor::deserialize(d);
     addFileNameFilters();
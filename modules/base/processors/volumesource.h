@@ -38,7 +38,9 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/ports/volumeport.h>
+#include <modules/base/algorithm/volume/volumepyramid.h>
 
 namespace inviwo {
 
@@ -49,9 +51,12 @@ namespace inviwo {
  *
  * ### Outports
  *   * __Outport__ The loaded volume
+ *   * __Pyramid__ Lower resolution levels of the loaded volume, when enabled
  *
  * ### Properties
  *   * __File name__ File to load.
+ *   * __Build Resolution Pyramid__ Build a pyramid of lower resolution levels of the volume,
+ *     see util::VolumePyramid. The levels are cached as ivf files next to the loaded file.
  */
 class IVW_MODULE_BASE_API VolumeSource : public Processor {
 public:
@@ -68,18 +73,22 @@ public:
 private:
     void load(bool deserialize = false);
     void addFileNameFilters();
+    void updatePyramid(size_t index);
 
     virtual bool isSink() const override;
 
     std::shared_ptr<VolumeSequence> volumes_;
+    std::vector<std::shared_ptr<util::VolumePyramid>> pyramids_;
 
     VolumeOutport outport_;
+    VolumePyramidOutport pyramidOutport_;
     FileProperty file_;
     ButtonProperty reload_;
 
     BasisProperty basis_;
     VolumeInformationProperty information_;
     SequenceTimerProperty volumeSequence_;
+    BoolProperty pyramid_;
 
     bool deserialized_ = false;
 };
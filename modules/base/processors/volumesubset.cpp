@@ -30,6 +30,7 @@
 #include "volumesubset.h"
 #include <modules/base/algorithm/volume/volumeramsubset.h>
 #include <inviwo/core/network/networklock.h>
+#include <inviwo/core/util/volumeutils.h>
 #include <glm/gtx/vector_angle.hpp>
 
 namespace inviwo {
@@ -76,7 +77,6 @@ VolumeSubset::~VolumeSubset() {}
 
 void VolumeSubset::process() {
     if (enabled_.get()) {
-        const VolumeRAM* vol = inport_.getData()->getRepresentation<VolumeRAM>();
         size3_t dim = size3_t(static_cast<unsigned int>(rangeX_.get().y),
                           static_cast<unsigned int>(rangeY_.get().y),
                           static_cast<unsigned int>(rangeZ_.get().y));
@@ -88,7 +88,13 @@ void VolumeSubset::process() {
         if (dim == dims_)
             outport_.setData(inport_.getData());
         else {
-            Volume* volume = new Volume(VolumeRAMSubSet::apply(vol, dim, offset));
+            // Read only the subset from disk if the volume is not in memory
+            auto subset = util::readVolumeRegion(*inport_.getData(), offset, dim);
+            if (!subset) {
+                subset = VolumeRAMSubSet::apply(
+                    inport_.getData()->getRepresentation<VolumeRAM>(), dim, offset);
+            }
+            Volume* volume = new Volume(subset);
             // pass meta data on
             volume->copyMetaDataFrom(*inport_.getData());
             volume->dataMap_ = inport_.getData()->dataMap_;
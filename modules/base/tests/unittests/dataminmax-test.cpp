@@ -0,0 +1,135 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/dataminmax.h>
+#include <modules/base/algorithm/volume/volumesignificantvoxels.h>
+#include <modules/base/algorithm/volume/volumestatistics.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <limits>
+
+namespace inviwo {
+
+TEST(DataMinMax, ScalarIntegers) {
+    // Not a multiple of the number of lanes, to also cover the tail
+    std::vector<int> data(1003);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<int>((i * 37) % 1001) - 500;
+    data[517] = -1000;
+    data[1002] = 1000;
+
+    const auto minmax = util::dataMinMax(data.data(), data.size());
+    EXPECT_EQ(-1000.0, minmax.first.x);
+    EXPECT_EQ(1000.0, minmax.second.x);
+}
+
+TEST(DataMinMax, ScalarFloatsIgnoreSpecialValues) {
+    std::vector<float> data(100, 1.0f);
+    data[3] = -2.0f;
+    data[50] = 5.0f;
+    data[10] = std::numeric_limits<float>::infinity();
+    data[11] = -std::numeric_limits<float>::infinity();
+    data[12] = std::numeric_limits<float>::quiet_NaN();
+    data[99] = 1.0e30f;
+
+    const auto ignored = util::dataMinMax(data.data(), data.size(), IgnoreSpecialValues::Yes);
+    EXPECT_EQ(-2.0, ignored.first.x);
+    EXPECT_EQ(static_cast<double>(1.0e30f), ignored.second.x);
+
+    const auto all = util::dataMinMax(data.data(), data.size(), IgnoreSpecialValues::No);
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), all.first.x);
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), all.second.x);
+}
+
+TEST(DataMinMax, Vectors) {
+    std::vector<vec2> data{{1.0f, 4.0f}, {-1.0f, 8.0f}, {3.0f, -2.0f}};
+    data.emplace_back(std::numeric_limits<float>::quiet_NaN(), 100.0f);
+
+    const auto minmax = util::dataMinMax(data.data(), data.size(), IgnoreSpecialValues::Yes);
+    EXPECT_EQ(dvec2(-1.0, -2.0), dvec2(minmax.first));
+    EXPECT_EQ(dvec2(3.0, 8.0), dvec2(minmax.second));
+}
+
+TEST(VolumeSignificantVoxels, Count) {
+    auto ram = std::make_shared<VolumeRAMPrecision<vec2>>(size3_t{3, 3, 3});
+    auto data = ram->getDataTyped();
+    std::fill(data, data + 27, vec2(0.0f));
+    data[0] = vec2(1.0f, 0.0f);
+    data[5] = vec2(0.0f, -1.0f);
+    data[7] = vec2(std::numeric_limits<float>::infinity(), 0.0f);
+
+    EXPECT_EQ(3, util::volumeSignificantVoxels(ram.get(), IgnoreSpecialValues::No));
+    EXPECT_EQ(2, util::volumeSignificantVoxels(ram.get(), IgnoreSpecialValues::Yes));
+}
+
+TEST(VolumeStatistics, SinglePass) {
+    auto ram = std::make_shared<VolumeRAMPrecision<glm::u8vec2>>(size3_t{4, 4, 4});
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < 64; ++i) {
+        data[i] = glm::u8vec2(static_cast<unsigned char>(i), static_cast<unsigned char>(2 * i));
+    }
+
+    const auto stats = util::volumeStatistics(ram.get(), dvec2(0.0, 63.0), 64);
+    EXPECT_EQ(dvec2(0.0, 0.0), dvec2(stats.min));
+    EXPECT_EQ(dvec2(63.0, 126.0), dvec2(stats.max));
+    EXPECT_EQ(63, stats.significantVoxels);
+
+    ASSERT_EQ(2, stats.histograms.size());
+    ASSERT_EQ(64, stats.histograms[0].getData()->size());
+    for (size_t bin = 0; bin < 64; ++bin) {
+        EXPECT_DOUBLE_EQ(1.0, stats.histograms[0][bin]);
+        // The second channel only has even values and half of them are out of range
+        EXPECT_DOUBLE_EQ(bin % 2 == 0 ? 1.0 : 0.0, stats.histograms[1][bin]);
+    }
+    EXPECT_DOUBLE_EQ(0.0, stats.histograms[0].stats_.min);
+    EXPECT_DOUBLE_EQ(63.0, stats.histograms[0].stats_.max);
+}
+
+TEST(VolumeStatistics, ValueCounts) {
+    auto ram = std::make_shared<VolumeRAMPrecision<unsigned short>>(size3_t{4, 4, 4});
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < 64; ++i) data[i] = static_cast<unsigned short>(i % 8 == 0 ? 0 : i);
+
+    // The number of bins is clamped to the number of integer values in the range
+    const auto stats = util::volumeStatistics(ram.get(), dvec2(0.0, 63.0), 2048);
+    EXPECT_EQ(0.0, stats.min.x);
+    EXPECT_EQ(63.0, stats.max.x);
+    EXPECT_EQ(56, stats.significantVoxels);
+    ASSERT_EQ(1, stats.histograms.size());
+    ASSERT_EQ(64, stats.histograms[0].getData()->size());
+    EXPECT_DOUBLE_EQ(1.0, stats.histograms[0][0]);
+    EXPECT_DOUBLE_EQ(0.0, stats.histograms[0][8]);
+    EXPECT_DOUBLE_EQ(1.0 / 8.0, stats.histograms[0][1]);
+}
+
+}  // namespace inviwo
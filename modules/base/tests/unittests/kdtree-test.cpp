@@ -33,6 +33,7 @@
 #include <warn/pop>
 
 #include <modules/base/datastructures/kdtree.h>
+#include <modules/base/datastructures/flatkdtree.h>
 
 namespace inviwo{
 
@@ -144,4 +145,93 @@ TEST(KDTreeTests, findNClosests) {
 
 
 
-}
\ No newline at end of file
+
+namespace {
+std::vector<glm::vec3> randomPoints(size_t size) {
+    std::vector<glm::vec3> points;
+    for (size_t i = 0; i < size; i++) {
+        points.emplace_back(rand() / float(RAND_MAX), rand() / float(RAND_MAX),
+                            rand() / float(RAND_MAX));
+    }
+    return points;
+}
+
+std::vector<std::pair<float, size_t>> bruteForce(const std::vector<glm::vec3>& points,
+                                                 const glm::vec3& p) {
+    std::vector<std::pair<float, size_t>> dists;
+    for (size_t i = 0; i < points.size(); i++) {
+        dists.emplace_back(glm::distance2(points[i], p), i);
+    }
+    std::sort(dists.begin(), dists.end());
+    return dists;
+}
+}  // namespace
+
+TEST(FlatKDTreeTests, findNearest) {
+    srand(0);
+    auto points = randomPoints(1000);
+    auto queries = randomPoints(100);
+
+    FlatK3DTree<int, float> tree(points, {}, 8);
+    EXPECT_EQ(tree.size(), points.size());
+
+    auto res = tree.findNearest(queries);
+    ASSERT_EQ(res.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        auto expected = bruteForce(points, queries[i]).front();
+        EXPECT_EQ(res[i].index, expected.second);
+        EXPECT_FLOAT_EQ(res[i].sqDist, expected.first);
+        EXPECT_EQ(tree.getPosition(res[i].index), points[expected.second]);
+    }
+}
+
+TEST(FlatKDTreeTests, findNNearest) {
+    srand(0);
+    auto points = randomPoints(1000);
+    auto queries = randomPoints(50);
+
+    FlatK3DTree<int, float> tree(points);
+    auto res = tree.findNNearest(queries, 20);
+    ASSERT_EQ(res.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        auto expected = bruteForce(points, queries[i]);
+        ASSERT_EQ(res[i].size(), 20);
+        for (size_t j = 0; j < 20; j++) {
+            EXPECT_EQ(res[i][j].index, expected[j].second);
+        }
+    }
+    EXPECT_EQ(tree.findNNearest(queries[0], 2000).size(), 1000);
+}
+
+TEST(FlatKDTreeTests, findCloseTo) {
+    srand(0);
+    auto points = randomPoints(1000);
+    auto queries = randomPoints(50);
+
+    FlatK3DTree<int, float> tree(points);
+    auto res = tree.findCloseTo(queries, 0.2f);
+    ASSERT_EQ(res.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        auto expected = bruteForce(points, queries[i]);
+        auto count = std::count_if(expected.begin(), expected.end(),
+                                   [](const std::pair<float, size_t>& d) { return d.first < 0.04f; });
+        EXPECT_EQ(res[i].size(), count);
+    }
+}
+
+TEST(FlatKDTreeTests, data) {
+    std::vector<glm::vec2> points{{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+    std::vector<int> data{10, 20, 30, 40};
+    FlatK2DTree<int, float> tree(points, data, 1);
+    EXPECT_EQ(tree.depth(), 2);
+
+    auto n = tree.findNearest(glm::vec2(0.9f, 0.8f));
+    EXPECT_EQ(n.index, 3);
+    EXPECT_EQ(tree.getData(n.index), 40);
+
+    FlatK2DTree<int, float> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.findNearest(glm::vec2(0.0f)).index, (FlatK2DTree<int, float>::npos));
+}
+
+}
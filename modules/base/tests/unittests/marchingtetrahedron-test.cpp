@@ -0,0 +1,133 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/marchingtetrahedron.h>
+#include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <set>
+#include <utility>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+// Distance to the center of the volume
+std::shared_ptr<Volume> createSphereVolume(size3_t dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto volume = std::make_shared<Volume>(ram);
+    const util::IndexMapper3D index(dims);
+    const vec3 center{vec3(dims - size3_t(1)) * 0.5f};
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[index(x, y, z)] = glm::distance(vec3(x, y, z), center);
+            }
+        }
+    }
+    return volume;
+}
+
+// Serial reference, counts the distinct tetrahedron edges crossed by the iso surface, i.e. the
+// number of welded vertices, and the number of triangles.
+std::pair<size_t, size_t> countCrossings(const Volume& volume, double iso) {
+    const auto ram = static_cast<const VolumeRAMPrecision<float>*>(
+        volume.getRepresentation<VolumeRAM>());
+    const auto data = ram->getDataTyped();
+    const auto dim = ram->getDimensions();
+    const util::IndexMapper3D index(dim);
+    const size_t tetras[6][4] = {{0, 1, 3, 5}, {1, 2, 3, 5}, {2, 3, 5, 6},
+                                 {0, 3, 4, 5}, {7, 4, 3, 5}, {7, 6, 5, 3}};
+    std::set<std::pair<size_t, size_t>> edges;
+    size_t triangles = 0;
+    for (size_t z = 0; z + 1 < dim.z; ++z) {
+        for (size_t y = 0; y + 1 < dim.y; ++y) {
+            for (size_t x = 0; x + 1 < dim.x; ++x) {
+                const size_t p[8] = {index(x, y, z),         index(x + 1, y, z),
+                                     index(x + 1, y + 1, z), index(x, y + 1, z),
+                                     index(x, y, z + 1),     index(x + 1, y, z + 1),
+                                     index(x + 1, y + 1, z + 1), index(x, y + 1, z + 1)};
+                for (const auto& tetra : tetras) {
+                    size_t inside = 0;
+                    for (size_t a = 0; a < 4; ++a) {
+                        const auto pa = p[tetra[a]];
+                        inside += data[pa] <= iso;
+                        for (size_t b = a + 1; b < 4; ++b) {
+                            const auto pb = p[tetra[b]];
+                            if ((data[pa] <= iso) != (data[pb] <= iso)) {
+                                edges.emplace(std::min(pa, pb), std::max(pa, pb));
+                            }
+                        }
+                    }
+                    triangles += inside == 2 ? 2 : (inside == 1 || inside == 3 ? 1 : 0);
+                }
+            }
+        }
+    }
+    return {edges.size(), triangles};
+}
+
+}  // namespace
+
+TEST(MarchingTetrahedronTest, weldedSphere) {
+    // Several z slabs are extracted separately and welded when merged
+    for (const auto dims : {size3_t(16, 16, 16), size3_t(9, 13, 23)}) {
+        auto volume = createSphereVolume(dims);
+        const double iso = 3.3;
+        auto mesh = std::dynamic_pointer_cast<BasicMesh>(
+            MarchingTetrahedron::apply(volume, iso, vec4(1.0f), false, false));
+        ASSERT_TRUE(mesh != nullptr);
+
+        const auto vertices =
+            mesh->getVertices()->getRAMRepresentation()->getDataContainer().size();
+        ASSERT_EQ(1u, mesh->getNumberOfIndicies());
+        const auto indices =
+            mesh->getIndices(0)->getRAMRepresentation()->getDataContainer().size();
+
+        const auto expected = countCrossings(*volume, iso);
+        EXPECT_EQ(expected.first, vertices);
+        EXPECT_EQ(3 * expected.second, indices);
+
+        // A closed welded sphere has Euler characteristic V - E + F = 2, with E = 3F / 2
+        EXPECT_EQ(2 * vertices, indices / 3 + 4);
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,134 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/volumepyramid.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstdio>
+#include <fstream>
+#include <warn/pop>
+
+namespace inviwo {
+
+TEST(VolumePyramid, Dimensions) {
+    const auto dims = util::volumePyramidDimensions(size3_t(256, 100, 20), 16);
+    ASSERT_EQ(5u, dims.size());
+    EXPECT_EQ(size3_t(256, 100, 20), dims[0]);
+    EXPECT_EQ(size3_t(128, 50, 20), dims[1]);
+    EXPECT_EQ(size3_t(64, 25, 20), dims[2]);
+    EXPECT_EQ(size3_t(32, 25, 20), dims[3]);
+    EXPECT_EQ(size3_t(16, 25, 20), dims[4]);
+}
+
+TEST(VolumePyramid, Build) {
+    const size3_t dims(9, 8, 8);
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < dims.x * dims.y * dims.z; ++i) data[i] = static_cast<float>(i % 2);
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(mat3(9.0f));
+    volume->setOffset(vec3(-1.0f));
+
+    auto pyramid = util::buildVolumePyramid(volume, 2);
+    ASSERT_EQ(3u, pyramid->size());
+    EXPECT_EQ(volume, pyramid->getLevel(0));
+
+    auto level = pyramid->getLevel(1);
+    EXPECT_EQ(size3_t(4, 4, 4), level->getDimensions());
+    // The last column of voxels is dropped
+    EXPECT_FLOAT_EQ(8.0f, level->getBasis()[0][0]);
+    EXPECT_FLOAT_EQ(9.0f, level->getBasis()[1][1]);
+    EXPECT_FLOAT_EQ(9.0f, level->getBasis()[2][2]);
+    EXPECT_EQ(vec3(-1.0f), level->getOffset());
+
+    auto levelRam =
+        static_cast<const VolumeRAMPrecision<float>*>(level->getRepresentation<VolumeRAM>());
+    const auto levelData = levelRam->getDataTyped();
+    for (size_t i = 0; i < 4 * 4 * 4; ++i) EXPECT_FLOAT_EQ(0.5f, levelData[i]);
+
+    EXPECT_EQ(size3_t(2, 2, 2), pyramid->getLevel(2)->getDimensions());
+}
+
+TEST(VolumePyramid, SelectLevel) {
+    auto volume = std::make_shared<Volume>(size3_t(64, 64, 64), DataUInt8::get());
+    auto pyramid = util::buildVolumePyramid(volume, 8);
+    ASSERT_EQ(4u, pyramid->size());
+
+    EXPECT_EQ(0u, pyramid->selectLevel(2.0));
+    EXPECT_EQ(0u, pyramid->selectLevel(0.75));
+    EXPECT_EQ(1u, pyramid->selectLevel(0.5));
+    EXPECT_EQ(2u, pyramid->selectLevel(0.25));
+    EXPECT_EQ(3u, pyramid->selectLevel(0.01));
+    EXPECT_EQ(1u, pyramid->selectLevel(0.01, 0.02));
+}
+
+TEST(VolumePyramid, SourceStamp) {
+    const auto dir = filesystem::getWorkingDirectory();
+    const auto dat = dir + "/volumepyramid-test.dat";
+    const auto raw = dir + "/volumepyramid-test.raw";
+    const size3_t dims(4, 4, 4);
+
+    auto disk = std::make_shared<VolumeDisk>(dat, dims, DataUInt8::get());
+    disk->setLoader(new RawVolumeRAMLoader(raw, 0, dims, true, DataUInt8::get()));
+    Volume volume(disk);
+
+    EXPECT_EQ("", util::volumePyramidSourceStamp(dat, volume));
+    {
+        std::ofstream out(dat.c_str());
+        out << "RawFile: volumepyramid-test.raw\n";
+        std::ofstream outRaw(raw.c_str(), std::ios::binary);
+        outRaw << std::string(64, 'a');
+    }
+    const auto stamp = util::volumePyramidSourceStamp(dat, volume);
+    EXPECT_FALSE(stamp.empty());
+    EXPECT_EQ(stamp, util::volumePyramidSourceStamp(dat, volume));
+
+    // Replacing the raw data invalidates the stamp even if the dat file is unchanged
+    {
+        std::ofstream outRaw(raw.c_str(), std::ios::binary);
+        outRaw << std::string(128, 'b');
+    }
+    EXPECT_NE(stamp, util::volumePyramidSourceStamp(dat, volume));
+
+    std::remove(dat.c_str());
+    std::remove(raw.c_str());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,137 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/volumegradient.h>
+#include <modules/base/algorithm/volume/volumecurl.h>
+#include <modules/base/algorithm/volume/volumedivergence.h>
+#include <modules/base/algorithm/volume/volumelaplacian.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/indexmapper.h>
+
+namespace inviwo {
+
+namespace {
+
+// Creates a volume with a sheared basis, where voxel i has the value func(world position of i)
+template <typename T, typename F>
+std::shared_ptr<Volume> createVolume(const mat3& basis, F func) {
+    const size3_t dims{6, 5, 4};
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(basis);
+    volume->setOffset(vec3(-1.0f, 0.5f, 2.0f));
+
+    const dmat4 m{volume->getCoordinateTransformer().getDataToWorldMatrix()};
+    const util::IndexMapper3D index(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const size3_t pos{x, y, z};
+                const dvec3 world{m * dvec4(dvec3(pos) / dvec3(dims - size3_t(1)), 1.0)};
+                data[index(pos)] = static_cast<T>(func(world));
+            }
+        }
+    }
+    return volume;
+}
+
+}  // namespace
+
+TEST(VolumeStencilTest, gradient) {
+    const mat3 basis{vec3(2.0f, 0.0f, 0.0f), vec3(0.5f, 3.0f, 0.0f), vec3(0.0f, 0.0f, 1.5f)};
+    const dvec3 k{1.0, -2.0, 0.5};
+    auto volume = createVolume<float>(basis, [&](const dvec3& p) { return glm::dot(k, p); });
+
+    auto gradient = util::gradientVolume(volume, 0);
+    auto data = static_cast<const vec3*>(gradient->getRepresentation<VolumeRAM>()->getData());
+    // exact for linear functions, also at the boundary
+    for (size_t i = 0; i < glm::compMul(volume->getDimensions()); ++i) {
+        EXPECT_NEAR(k.x, data[i].x, 1e-4);
+        EXPECT_NEAR(k.y, data[i].y, 1e-4);
+        EXPECT_NEAR(k.z, data[i].z, 1e-4);
+    }
+}
+
+TEST(VolumeStencilTest, curlAndDivergence) {
+    const mat3 basis{vec3(2.0f, 0.0f, 0.0f), vec3(0.0f, 3.0f, 1.0f), vec3(0.0f, 0.0f, 1.5f)};
+    const dmat3 a{dvec3(1.0, 2.0, 3.0), dvec3(-1.0, 0.5, 2.0), dvec3(0.0, 4.0, -2.0)};
+    auto volume = createVolume<vec3>(basis, [&](const dvec3& p) { return a * p; });
+
+    auto curl = util::curlVolume(volume);
+    auto divergence = util::divergenceVolume(volume);
+    auto curlData = static_cast<const vec3*>(curl->getRepresentation<VolumeRAM>()->getData());
+    auto divData = static_cast<const float*>(divergence->getRepresentation<VolumeRAM>()->getData());
+
+    // a[j] is the derivative along world axis j
+    const dvec3 expectedCurl{a[1].z - a[2].y, a[2].x - a[0].z, a[0].y - a[1].x};
+    const double expectedDivergence = a[0].x + a[1].y + a[2].z;
+    for (size_t i = 0; i < glm::compMul(volume->getDimensions()); ++i) {
+        EXPECT_NEAR(expectedCurl.x, curlData[i].x, 1e-4);
+        EXPECT_NEAR(expectedCurl.y, curlData[i].y, 1e-4);
+        EXPECT_NEAR(expectedCurl.z, curlData[i].z, 1e-4);
+        EXPECT_NEAR(expectedDivergence, divData[i], 1e-4);
+    }
+}
+
+TEST(VolumeStencilTest, laplacian) {
+    const mat3 basis{vec3(2.0f, 0.0f, 0.0f), vec3(0.0f, 3.0f, 0.0f), vec3(0.0f, 0.0f, 1.5f)};
+    auto volume = createVolume<float>(
+        basis, [&](const dvec3& p) { return p.x * p.x + 3.0 * p.y * p.y - 0.5 * p.z * p.z; });
+
+    auto laplacian =
+        util::volumeLaplacian(volume, util::VolumeLaplacianPostProcessing::None, 1.0);
+    auto data = static_cast<const float*>(laplacian->getRepresentation<VolumeRAM>()->getData());
+
+    const auto dims = volume->getDimensions();
+    const util::IndexMapper3D index(dims);
+    for (size_t z = 1; z + 1 < dims.z; ++z) {
+        for (size_t y = 1; y + 1 < dims.y; ++y) {
+            for (size_t x = 1; x + 1 < dims.x; ++x) {
+                EXPECT_NEAR(2.0 + 6.0 - 1.0, data[index(size3_t(x, y, z))], 1e-3);
+            }
+        }
+    }
+}
+
+TEST(VolumeStencilTest, laplacianRejectsShearedBasis) {
+    const mat3 basis{vec3(2.0f, 0.0f, 0.0f), vec3(0.5f, 3.0f, 0.0f), vec3(0.0f, 0.0f, 1.5f)};
+    auto volume = createVolume<float>(basis, [&](const dvec3& p) { return p.x * p.x; });
+
+    EXPECT_THROW(util::volumeLaplacian(volume, util::VolumeLaplacianPostProcessing::None, 1.0),
+                 Exception);
+}
+
+}  // namespace inviwo
@@ -64,21 +64,31 @@ bool BrushingAndLinkingManager::isFiltered(size_t idx) const { return filtered_.
 bool BrushingAndLinkingManager::isSelected(size_t idx) const { return selected_.has(idx); }
 
 void BrushingAndLinkingManager::setSelected(const BrushingAndLinkingInport* src,
-                                            const std::unordered_set<size_t>& indices) {
-    selected_.set(src, indices);
+                                            std::shared_ptr<const IndexSet> indices) {
+    selected_.set(src, std::move(indices));
 }
 
 void BrushingAndLinkingManager::setFiltered(const BrushingAndLinkingInport* src,
-                                            const std::unordered_set<size_t>& indices) {
-    filtered_.set(src, indices);
+                                            std::shared_ptr<const IndexSet> indices) {
+    filtered_.set(src, std::move(indices));
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getSelectedIndices() const {
+const IndexSet& BrushingAndLinkingManager::getSelectedIndices() const {
     return selected_.getIndices();
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getFilteredIndices() const {
+const IndexSet& BrushingAndLinkingManager::getFilteredIndices() const {
     return filtered_.getIndices();
 }
 
+std::shared_ptr<IndexList::DiffCallback> BrushingAndLinkingManager::onSelectionChange(
+    IndexList::DiffCallback callback) const {
+    return selected_.onDiff(std::move(callback));
+}
+
+std::shared_ptr<IndexList::DiffCallback> BrushingAndLinkingManager::onFilterChange(
+    IndexList::DiffCallback callback) const {
+    return filtered_.onDiff(std::move(callback));
+}
+
 }  // namespace
@@ -40,8 +40,8 @@ class BrushingAndLinkingInport;
 class BrushingAndLinkingProcessor;
 /**
  * \class BrushingAndLinkingManager
- * \brief VERY_BRIEFLY_DESCRIBE_THE_CLASS
- * DESCRIBE_THE_CLASS
+ * \brief Keeps the selected and filtered indices set by the connected BrushingAndLinkingInports.
+ * The index sets are shared with the ports and their processors without copying.
  */
 class IVW_MODULE_BRUSHINGANDLINKING_API BrushingAndLinkingManager {
 public:
@@ -57,14 +57,21 @@ public:
     bool isFiltered(size_t idx) const;
     bool isSelected(size_t idx) const;
 
-    void setSelected(const BrushingAndLinkingInport* src,
-                     const std::unordered_set<size_t>& indices);
+    void setSelected(const BrushingAndLinkingInport* src, std::shared_ptr<const IndexSet> indices);
 
-    void setFiltered(const BrushingAndLinkingInport* src,
-        const std::unordered_set<size_t>& indices);
+    void setFiltered(const BrushingAndLinkingInport* src, std::shared_ptr<const IndexSet> indices);
 
-    const std::unordered_set<size_t> &getSelectedIndices() const;
-    const std::unordered_set<size_t> &getFilteredIndices() const;
+    const IndexSet& getSelectedIndices() const;
+    const IndexSet& getFilteredIndices() const;
+
+    /**
+     * Register callbacks for incremental updates, called with the added and removed indices
+     * whenever the selection or the filtering changes. Registering does not change the manager,
+     * hence consumers can subscribe through their inport. @see IndexList::onDiff
+     */
+    std::shared_ptr<IndexList::DiffCallback> onSelectionChange(
+        IndexList::DiffCallback callback) const;
+    std::shared_ptr<IndexList::DiffCallback> onFilterChange(IndexList::DiffCallback callback) const;
 
 private:
     IndexList selected_;
@@ -32,17 +32,16 @@
 
 namespace inviwo {
 
-IndexList::IndexList() {}
+IndexList::IndexList() : indices_(std::make_shared<IndexSet>()) {}
 
 IndexList::~IndexList() {}
 
-size_t IndexList::getSize() const { return indices_.size(); }
+size_t IndexList::getSize() const { return indices_->size(); }
 
-bool IndexList::has(size_t idx) const { return indices_.find(idx) != indices_.end(); }
+bool IndexList::has(size_t idx) const { return indices_->has(idx); }
 
-void IndexList::set(const BrushingAndLinkingInport *src,
-                    const std::unordered_set<size_t> &indices) {
-    indicesBySource_[src] = indices;
+void IndexList::set(const BrushingAndLinkingInport *src, std::shared_ptr<const IndexSet> indices) {
+    indicesBySource_[src] = std::move(indices);
     update();
 }
 
@@ -55,22 +54,37 @@ std::shared_ptr<std::function<void()>> IndexList::onChange(std::function<void()>
     return onUpdate_.add(V);
 }
 
-void IndexList::update() {
-    indices_.clear();
+std::shared_ptr<IndexList::DiffCallback> IndexList::onDiff(DiffCallback callback) const {
+    return onDiff_.add(std::move(callback));
+}
 
-    using T = std::unordered_map<const BrushingAndLinkingInport *, std::unordered_set<size_t>>::value_type;
+void IndexList::update() {
+    using T = decltype(indicesBySource_)::value_type;
     util::map_erase_remove_if(indicesBySource_, [](const T & p) {
-        return !p.first->isConnected() || p.second.empty(); //remove if port is disconnected or if the set is empty
+        return !p.first->isConnected() || !p.second || p.second->empty(); //remove if port is disconnected or if the set is empty
     });
 
-    for (auto p : indicesBySource_) {
-        indices_.insert(p.second.begin(), p.second.end());
+    std::shared_ptr<const IndexSet> indices;
+    if (indicesBySource_.empty()) {
+        indices = std::make_shared<IndexSet>();
+    } else if (indicesBySource_.size() == 1) {
+        indices = indicesBySource_.begin()->second;
+    } else {
+        auto all = std::make_shared<IndexSet>();
+        for (const auto &p : indicesBySource_) *all |= *p.second;
+        indices = all;
     }
+
+    auto old = std::move(indices_);
+    indices_ = std::move(indices);
+    if (*old == *indices_) return;
+
+    if (!onDiff_.empty()) onDiff_.invoke(*indices_ - *old, *old - *indices_);
     onUpdate_.invoke();
 }
 
 void IndexList::clear() {
-    indices_.clear();
+    indicesBySource_.clear();
     update();
 }
 
@@ -33,35 +33,55 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/util/dispatcher.h>
 #include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <modules/brushingandlinking/datastructures/indexset.h>
 
 namespace inviwo {
 class BrushingAndLinkingInport;
 class BrushingAndLinkingManager;
 
+/**
+ * \class IndexList
+ * \brief The union of the indices set by a number of sources.
+ *
+ * The union is immutable once computed and replaced on every change, so it can be shared without
+ * copying. With a single source the union is the source's own set.
+ */
 class IVW_MODULE_BRUSHINGANDLINKING_API IndexList {
 public:
+    using DiffCallback = std::function<void(const IndexSet &added, const IndexSet &removed)>;
+
     IndexList();
     virtual ~IndexList();
 
     size_t getSize() const;
     bool has(size_t idx) const;
 
-    void set(const BrushingAndLinkingInport *src, const std::unordered_set<size_t> &incices);
+    void set(const BrushingAndLinkingInport *src, std::shared_ptr<const IndexSet> indices);
     void remove(const BrushingAndLinkingInport *src);
 
+    /**
+     * Called whenever the union has changed.
+     */
     std::shared_ptr<std::function<void()>> onChange(std::function<void()> V);
 
+    /**
+     * Called with the indices added to and removed from the union whenever it has changed, for
+     * consumers that update incrementally. The differences are only computed while there is a
+     * registered callback.
+     */
+    std::shared_ptr<DiffCallback> onDiff(DiffCallback callback) const;
+
     void update();
     void clear();
-    const std::unordered_set<size_t> &getIndices() const {
-        return indices_;
-    }
+    const IndexSet &getIndices() const { return *indices_; }
+    std::shared_ptr<const IndexSet> getSharedIndices() const { return indices_; }
 
 private:
-    std::unordered_map<const BrushingAndLinkingInport *, std::unordered_set<size_t>>
+    std::unordered_map<const BrushingAndLinkingInport *, std::shared_ptr<const IndexSet>>
         indicesBySource_;
-    std::unordered_set<size_t> indices_;
+    std::shared_ptr<const IndexSet> indices_;
     Dispatcher<void()> onUpdate_;
+    mutable Dispatcher<void(const IndexSet &, const IndexSet &)> onDiff_;
 };
 
 }  // namespace
@@ -0,0 +1,312 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/brushingandlinking/datastructures/indexset.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+struct Union {
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const { return a | b; }
+    template <typename It, typename Out>
+    Out operator()(It a0, It a1, It b0, It b1, Out out) const {
+        return std::set_union(a0, a1, b0, b1, out);
+    }
+};
+
+struct Intersection {
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const { return a & b; }
+    template <typename It, typename Out>
+    Out operator()(It a0, It a1, It b0, It b1, Out out) const {
+        return std::set_intersection(a0, a1, b0, b1, out);
+    }
+};
+
+struct Difference {
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const { return a & ~b; }
+    template <typename It, typename Out>
+    Out operator()(It a0, It a1, It b0, It b1, Out out) const {
+        return std::set_difference(a0, a1, b0, b1, out);
+    }
+};
+
+template <typename Chunks>
+auto findChunk(Chunks& chunks, size_t key) {
+    return std::lower_bound(chunks.begin(), chunks.end(), key,
+                            [](const auto& chunk, size_t k) { return chunk.key < k; });
+}
+
+std::vector<size_t> sorted(std::vector<size_t> indices) {
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+}  // namespace
+
+IndexSet::IndexSet(std::initializer_list<size_t> indices)
+    : IndexSet(std::vector<size_t>(indices)) {}
+
+IndexSet::IndexSet(const std::unordered_set<size_t>& indices)
+    : IndexSet(std::vector<size_t>(indices.begin(), indices.end())) {}
+
+IndexSet::IndexSet(const std::vector<size_t>& indices) {
+    // Inserting in increasing order only ever appends
+    for (auto idx : sorted(indices)) insert(idx);
+}
+
+size_t IndexSet::size() const { return size_; }
+
+bool IndexSet::empty() const { return size_ == 0; }
+
+bool IndexSet::has(size_t idx) const {
+    const size_t key = idx >> chunkBits;
+    auto it = findChunk(chunks_, key);
+    if (it == chunks_.end() || it->key != key) return false;
+
+    const auto offset = static_cast<std::uint16_t>(idx & (chunkSize - 1));
+    if (it->isBitmap()) {
+        return (it->bitmap[offset / 64] >> (offset % 64)) & 1;
+    } else {
+        return std::binary_search(it->array.begin(), it->array.end(), offset);
+    }
+}
+
+void IndexSet::insert(size_t idx) {
+    const size_t key = idx >> chunkBits;
+    auto it = findChunk(chunks_, key);
+    if (it == chunks_.end() || it->key != key) it = chunks_.insert(it, Chunk{key, 0, {}, {}});
+    auto& chunk = *it;
+
+    const auto offset = static_cast<std::uint16_t>(idx & (chunkSize - 1));
+    if (chunk.isBitmap()) {
+        auto& word = chunk.bitmap[offset / 64];
+        const auto mask = std::uint64_t{1} << (offset % 64);
+        if (word & mask) return;
+        word |= mask;
+    } else if (chunk.array.empty() || chunk.array.back() < offset) {
+        chunk.array.push_back(offset);
+    } else {
+        auto pos = std::lower_bound(chunk.array.begin(), chunk.array.end(), offset);
+        if (*pos == offset) return;
+        chunk.array.insert(pos, offset);
+    }
+    ++chunk.count;
+    ++size_;
+    normalize(chunk);
+}
+
+bool IndexSet::erase(size_t idx) {
+    const size_t key = idx >> chunkBits;
+    auto it = findChunk(chunks_, key);
+    if (it == chunks_.end() || it->key != key) return false;
+    auto& chunk = *it;
+
+    const auto offset = static_cast<std::uint16_t>(idx & (chunkSize - 1));
+    if (chunk.isBitmap()) {
+        auto& word = chunk.bitmap[offset / 64];
+        const auto mask = std::uint64_t{1} << (offset % 64);
+        if (!(word & mask)) return false;
+        word &= ~mask;
+    } else {
+        auto pos = std::lower_bound(chunk.array.begin(), chunk.array.end(), offset);
+        if (pos == chunk.array.end() || *pos != offset) return false;
+        chunk.array.erase(pos);
+    }
+    --chunk.count;
+    --size_;
+    if (chunk.count == 0) {
+        chunks_.erase(it);
+    } else {
+        normalize(chunk);
+    }
+    return true;
+}
+
+void IndexSet::clear() {
+    chunks_.clear();
+    size_ = 0;
+}
+
+IndexSet& IndexSet::operator|=(const IndexSet& rhs) {
+    std::vector<Chunk> result;
+    result.reserve(chunks_.size() + rhs.chunks_.size());
+    auto a = chunks_.begin();
+    auto b = rhs.chunks_.begin();
+    while (a != chunks_.end() || b != rhs.chunks_.end()) {
+        if (b == rhs.chunks_.end() || (a != chunks_.end() && a->key < b->key)) {
+            result.push_back(std::move(*a++));
+        } else if (a == chunks_.end() || b->key < a->key) {
+            result.push_back(*b++);
+        } else {
+            result.push_back(combine(*a++, *b++, Union{}));
+        }
+    }
+    chunks_ = std::move(result);
+    size_ = std::accumulate(chunks_.begin(), chunks_.end(), size_t{0},
+                            [](size_t s, const Chunk& c) { return s + c.count; });
+    return *this;
+}
+
+IndexSet& IndexSet::operator&=(const IndexSet& rhs) {
+    std::vector<Chunk> result;
+    auto a = chunks_.begin();
+    auto b = rhs.chunks_.begin();
+    while (a != chunks_.end() && b != rhs.chunks_.end()) {
+        if (a->key < b->key) {
+            ++a;
+        } else if (b->key < a->key) {
+            ++b;
+        } else {
+            auto chunk = combine(*a++, *b++, Intersection{});
+            if (chunk.count > 0) result.push_back(std::move(chunk));
+        }
+    }
+    chunks_ = std::move(result);
+    size_ = std::accumulate(chunks_.begin(), chunks_.end(), size_t{0},
+                            [](size_t s, const Chunk& c) { return s + c.count; });
+    return *this;
+}
+
+IndexSet& IndexSet::operator-=(const IndexSet& rhs) {
+    std::vector<Chunk> result;
+    result.reserve(chunks_.size());
+    auto b = rhs.chunks_.begin();
+    for (auto& chunk : chunks_) {
+        b = std::lower_bound(b, rhs.chunks_.end(), chunk.key,
+                             [](const Chunk& c, size_t k) { return c.key < k; });
+        if (b == rhs.chunks_.end() || b->key != chunk.key) {
+            result.push_back(std::move(chunk));
+        } else {
+            auto diff = combine(chunk, *b, Difference{});
+            if (diff.count > 0) result.push_back(std::move(diff));
+        }
+    }
+    chunks_ = std::move(result);
+    size_ = std::accumulate(chunks_.begin(), chunks_.end(), size_t{0},
+                            [](size_t s, const Chunk& c) { return s + c.count; });
+    return *this;
+}
+
+std::vector<size_t> IndexSet::toVector() const {
+    std::vector<size_t> result;
+    result.reserve(size_);
+    forEach([&](size_t idx) { result.push_back(idx); });
+    return result;
+}
+
+size_t IndexSet::getMemoryUsage() const {
+    return std::accumulate(chunks_.begin(), chunks_.end(), chunks_.capacity() * sizeof(Chunk),
+                           [](size_t s, const Chunk& c) {
+                               return s + c.array.capacity() * sizeof(std::uint16_t) +
+                                      c.bitmap.capacity() * sizeof(std::uint64_t);
+                           });
+}
+
+std::vector<std::uint64_t> IndexSet::toBitmap(const Chunk& chunk) {
+    if (chunk.isBitmap()) return chunk.bitmap;
+    std::vector<std::uint64_t> bitmap(bitmapWords, 0);
+    for (auto offset : chunk.array) bitmap[offset / 64] |= std::uint64_t{1} << (offset % 64);
+    return bitmap;
+}
+
+void IndexSet::normalize(Chunk& chunk) {
+    if (chunk.isBitmap() && chunk.count <= maxArraySize) {
+        std::vector<std::uint16_t> array;
+        array.reserve(chunk.count);
+        for (size_t i = 0; i < bitmapWords; ++i) {
+            for (auto word = chunk.bitmap[i]; word; word &= word - 1) {
+                const auto lowest = word & (~word + 1);
+                array.push_back(static_cast<std::uint16_t>(64 * i +
+                                                           std::bitset<64>(lowest - 1).count()));
+            }
+        }
+        chunk.array = std::move(array);
+        chunk.bitmap = std::vector<std::uint64_t>();
+    } else if (!chunk.isBitmap() && chunk.count > maxArraySize) {
+        chunk.bitmap = toBitmap(chunk);
+        chunk.array = std::vector<std::uint16_t>();
+    }
+}
+
+template <typename Op>
+IndexSet::Chunk IndexSet::combine(const Chunk& a, const Chunk& b, Op op) {
+    Chunk result{a.key, 0, {}, {}};
+    if (!a.isBitmap() && !b.isBitmap()) {
+        op(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+           std::back_inserter(result.array));
+        result.count = result.array.size();
+    } else {
+        const auto wordsA = toBitmap(a);
+        const auto wordsB = toBitmap(b);
+        result.bitmap.resize(bitmapWords);
+        for (size_t i = 0; i < bitmapWords; ++i) {
+            result.bitmap[i] = op(wordsA[i], wordsB[i]);
+            result.count += std::bitset<64>(result.bitmap[i]).count();
+        }
+    }
+    normalize(result);
+    return result;
+}
+
+bool operator==(const IndexSet& a, const IndexSet& b) {
+    // Chunks are always normalized, so equal sets have equal representations
+    if (a.size_ != b.size_ || a.chunks_.size() != b.chunks_.size()) return false;
+    return std::equal(a.chunks_.begin(), a.chunks_.end(), b.chunks_.begin(),
+                      [](const IndexSet::Chunk& ca, const IndexSet::Chunk& cb) {
+                          return ca.key == cb.key && ca.count == cb.count &&
+                                 ca.array == cb.array && ca.bitmap == cb.bitmap;
+                      });
+}
+
+bool operator!=(const IndexSet& a, const IndexSet& b) { return !(a == b); }
+
+IndexSet operator|(IndexSet a, const IndexSet& b) {
+    a |= b;
+    return a;
+}
+
+IndexSet operator&(IndexSet a, const IndexSet& b) {
+    a &= b;
+    return a;
+}
+
+IndexSet operator-(IndexSet a, const IndexSet& b) {
+    a -= b;
+    return a;
+}
+
+}  // namespace inviwo
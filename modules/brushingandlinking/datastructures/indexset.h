@@ -0,0 +1,145 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_INDEXSET_H
+#define IVW_INDEXSET_H
+
+#include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_set>
+#include <vector>
+#include <warn/pop>
+
+namespace inviwo {
+
+/**
+ * \class IndexSet
+ * \brief A compressed set of indices, used for selections and filters.
+ *
+ * The index space is split into chunks of 2^16 indices. Each chunk that contains any index is
+ * stored either as a sorted array of 16 bit offsets, while it is sparse, or as a bitmap of 2^16
+ * bits once it holds more than 4096 indices. Lookups are a binary search over the chunks
+ * followed by a bit test or a binary search, and union, intersection and difference work chunk
+ * by chunk and word by word. Hence a selection of millions of rows takes a few bits per row
+ * instead of a hash set node.
+ */
+class IVW_MODULE_BRUSHINGANDLINKING_API IndexSet {
+public:
+    IndexSet() = default;
+    IndexSet(std::initializer_list<size_t> indices);
+    explicit IndexSet(const std::unordered_set<size_t>& indices);
+    explicit IndexSet(const std::vector<size_t>& indices);
+
+    size_t size() const;
+    bool empty() const;
+    bool has(size_t idx) const;
+
+    void insert(size_t idx);
+    bool erase(size_t idx);
+    void clear();
+
+    IndexSet& operator|=(const IndexSet& rhs);
+    IndexSet& operator&=(const IndexSet& rhs);
+    IndexSet& operator-=(const IndexSet& rhs);
+
+    /**
+     * Calls callback(index) for each index in increasing order.
+     */
+    template <typename Callback>
+    void forEach(Callback callback) const;
+
+    /**
+     * All indices in increasing order.
+     */
+    std::vector<size_t> toVector() const;
+
+    /**
+     * Bytes used by the chunks of the set.
+     */
+    size_t getMemoryUsage() const;
+
+    friend IVW_MODULE_BRUSHINGANDLINKING_API bool operator==(const IndexSet& a,
+                                                             const IndexSet& b);
+
+private:
+    static constexpr size_t chunkBits = 16;
+    static constexpr size_t chunkSize = size_t{1} << chunkBits;
+    static constexpr size_t maxArraySize = 4096;
+    static constexpr size_t bitmapWords = chunkSize / 64;
+
+    struct Chunk {
+        size_t key;                          ///< The index divided by chunkSize
+        size_t count;                        ///< Number of indices in the chunk
+        std::vector<std::uint16_t> array;    ///< Sorted offsets while the chunk is sparse
+        std::vector<std::uint64_t> bitmap;   ///< bitmapWords words once the chunk is dense
+        bool isBitmap() const { return !bitmap.empty(); }
+    };
+
+    static std::vector<std::uint64_t> toBitmap(const Chunk& chunk);
+    static void normalize(Chunk& chunk);
+    template <typename Op>
+    static Chunk combine(const Chunk& a, const Chunk& b, Op op);
+
+    std::vector<Chunk> chunks_;  ///< Sorted by key, never empty chunks
+    size_t size_ = 0;
+};
+
+IVW_MODULE_BRUSHINGANDLINKING_API IndexSet operator|(IndexSet a, const IndexSet& b);
+IVW_MODULE_BRUSHINGANDLINKING_API IndexSet operator&(IndexSet a, const IndexSet& b);
+IVW_MODULE_BRUSHINGANDLINKING_API IndexSet operator-(IndexSet a, const IndexSet& b);
+IVW_MODULE_BRUSHINGANDLINKING_API bool operator!=(const IndexSet& a, const IndexSet& b);
+
+template <typename Callback>
+void IndexSet::forEach(Callback callback) const {
+    for (const auto& chunk : chunks_) {
+        const size_t base = chunk.key << chunkBits;
+        if (chunk.isBitmap()) {
+            for (size_t i = 0; i < bitmapWords; ++i) {
+                auto word = chunk.bitmap[i];
+                while (word) {
+                    const auto lowest = word & (~word + 1);
+                    callback(base + 64 * i + std::bitset<64>(lowest - 1).count());
+                    word ^= lowest;
+                }
+            }
+        } else {
+            for (auto offset : chunk.array) callback(base + offset);
+        }
+    }
+}
+
+}  // namespace inviwo
+
+#endif  // IVW_INDEXSET_H
@@ -31,8 +31,8 @@
 namespace inviwo {
 
 BrushingAndLinkingEvent::BrushingAndLinkingEvent(const BrushingAndLinkingInport* src,
-                                                 const std::unordered_set<size_t>& indices)
-    : source_(src), indices_(indices) {}
+                                                 std::shared_ptr<const IndexSet> indices)
+    : source_(src), indices_(std::move(indices)) {}
 
 BrushingAndLinkingEvent* BrushingAndLinkingEvent::clone() const {
     return new BrushingAndLinkingEvent(*this);
@@ -42,7 +42,11 @@ const inviwo::BrushingAndLinkingInport* BrushingAndLinkingEvent::getSource() con
     return source_;
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingEvent::getIndices() const { return indices_; }
+const IndexSet& BrushingAndLinkingEvent::getIndices() const { return *indices_; }
+
+std::shared_ptr<const IndexSet> BrushingAndLinkingEvent::getSharedIndices() const {
+    return indices_;
+}
 
 
 uint64_t BrushingAndLinkingEvent::hash() const {
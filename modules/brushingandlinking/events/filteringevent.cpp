@@ -32,7 +32,7 @@
 namespace inviwo {
 
 FilteringEvent::FilteringEvent(const BrushingAndLinkingInport* src,
-                               const std::unordered_set<size_t>& indices)
-    : BrushingAndLinkingEvent(src, indices) {}
+                               std::shared_ptr<const IndexSet> indices)
+    : BrushingAndLinkingEvent(src, std::move(indices)) {}
 
 }  // namespace
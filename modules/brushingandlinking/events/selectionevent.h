@@ -43,7 +43,7 @@ namespace inviwo {
  */
 class IVW_MODULE_BRUSHINGANDLINKING_API SelectionEvent : public BrushingAndLinkingEvent {
 public:
-    SelectionEvent(const BrushingAndLinkingInport* src, const std::unordered_set<size_t>& indices);
+    SelectionEvent(const BrushingAndLinkingInport* src, std::shared_ptr<const IndexSet> indices);
     virtual ~SelectionEvent() = default;
 };
 
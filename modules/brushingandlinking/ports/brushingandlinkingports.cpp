@@ -32,7 +32,9 @@
 namespace inviwo{
 
 BrushingAndLinkingInport::BrushingAndLinkingInport(std::string identifier)
-    : DataInport<BrushingAndLinkingManager>(identifier) {
+    : DataInport<BrushingAndLinkingManager>(identifier)
+    , filterCache_(std::make_shared<IndexSet>())
+    , selctionCache_(std::make_shared<IndexSet>()) {
     setOptional(true);
 
     onConnect([&]() {
@@ -41,14 +43,22 @@ BrushingAndLinkingInport::BrushingAndLinkingInport(std::string identifier)
     });
 }
 
-void BrushingAndLinkingInport::sendFilterEvent(const std::unordered_set<size_t> &indices) {
-    filterCache_ = indices;
+void BrushingAndLinkingInport::sendFilterEvent(IndexSet indices) {
+    sendFilterEvent(std::make_shared<const IndexSet>(std::move(indices)));
+}
+
+void BrushingAndLinkingInport::sendFilterEvent(std::shared_ptr<const IndexSet> indices) {
+    filterCache_ = std::move(indices);
     FilteringEvent event(this, filterCache_);
     getProcessor()->propagateEvent(&event, nullptr);
 }
 
-void BrushingAndLinkingInport::sendSelectionEvent(const std::unordered_set<size_t> &indices) {
-    selctionCache_ = indices;
+void BrushingAndLinkingInport::sendSelectionEvent(IndexSet indices) {
+    sendSelectionEvent(std::make_shared<const IndexSet>(std::move(indices)));
+}
+
+void BrushingAndLinkingInport::sendSelectionEvent(std::shared_ptr<const IndexSet> indices) {
+    selctionCache_ = std::move(indices);
     SelectionEvent event(this, selctionCache_);
     getProcessor()->propagateEvent(&event, nullptr);
 }
@@ -57,7 +67,7 @@ bool BrushingAndLinkingInport::isFiltered(size_t idx) const {
     if (isConnected()) {
         return getData()->isFiltered(idx);
     } else {
-        return filterCache_.find(idx) != filterCache_.end();
+        return filterCache_->has(idx);
     }
 }
 
@@ -65,26 +75,26 @@ bool BrushingAndLinkingInport::isSelected(size_t idx) const {
     if (isConnected()) {
         return getData()->isSelected(idx);
     } else {
-        return selctionCache_.find(idx) != selctionCache_.end();
+        return selctionCache_->has(idx);
     }
 }
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getSelectedIndices() const {
+const IndexSet &BrushingAndLinkingInport::getSelectedIndices() const {
     if (isConnected()) {
         return getData()->getSelectedIndices();
     }
     else {
-        return selctionCache_;
+        return *selctionCache_;
     }
 }
 
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getFilteredIndices() const {
+const IndexSet &BrushingAndLinkingInport::getFilteredIndices() const {
     if (isConnected()) {
         return getData()->getFilteredIndices();
     }
     else {
-        return filterCache_;
+        return *filterCache_;
     }
 }
 
@@ -47,18 +47,20 @@ public:
     BrushingAndLinkingInport(std::string identifier);
     virtual ~BrushingAndLinkingInport() = default;
 
-    void sendFilterEvent(const std::unordered_set<size_t> &indices);
+    void sendFilterEvent(IndexSet indices);
+    void sendFilterEvent(std::shared_ptr<const IndexSet> indices);
 
-    void sendSelectionEvent(const std::unordered_set<size_t> &indices);
+    void sendSelectionEvent(IndexSet indices);
+    void sendSelectionEvent(std::shared_ptr<const IndexSet> indices);
 
     bool isFiltered(size_t idx) const;
     bool isSelected(size_t idx) const;
 
-    const std::unordered_set<size_t> &getSelectedIndices()const;
-    const std::unordered_set<size_t> &getFilteredIndices()const;
+    const IndexSet &getSelectedIndices()const;
+    const IndexSet &getFilteredIndices()const;
 
-    std::unordered_set<size_t> filterCache_;
-    std::unordered_set<size_t> selctionCache_;
+    std::shared_ptr<const IndexSet> filterCache_;
+    std::shared_ptr<const IndexSet> selctionCache_;
 };
 
 class IVW_MODULE_BRUSHINGANDLINKING_API BrushingAndLinkingOutport
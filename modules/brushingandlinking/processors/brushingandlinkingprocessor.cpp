@@ -47,10 +47,10 @@ const ProcessorInfo BrushingAndLinkingProcessor::getProcessorInfo() const { retu
 void BrushingAndLinkingProcessor::invokeEvent(Event* event) {
     if (auto brushingEvent = dynamic_cast<BrushingAndLinkingEvent*>(event)) {
         if (dynamic_cast<FilteringEvent*>(event)) {
-            manager_->setFiltered(brushingEvent->getSource(), brushingEvent->getIndices());
+            manager_->setFiltered(brushingEvent->getSource(), brushingEvent->getSharedIndices());
             event->markAsUsed();
         } else if (dynamic_cast<SelectionEvent*>(event)) {
-            manager_->setSelected(brushingEvent->getSource(), brushingEvent->getIndices());
+            manager_->setSelected(brushingEvent->getSource(), brushingEvent->getSharedIndices());
             event->markAsUsed();
         }
     }
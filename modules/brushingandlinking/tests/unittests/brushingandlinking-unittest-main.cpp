@@ -2,7 +2,7 @@
  *
  * Inviwo - Interactive Visualization Workshop
  *
- * Copyright (c) 2015-2017 Inviwo Foundation
+ * Copyright (c) 2017 Inviwo Foundation
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,32 +27,31 @@
  *
  *********************************************************************************/
 
-#include <inviwo/core/util/volumesampler.h>
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
 
-namespace inviwo {
+#include <inviwo/core/common/inviwo.h>
 
-template <>
-Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDouble(p);
-}
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
 
-template <>
-Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec2(p);
-}
+using namespace inviwo;
 
-template <>
-Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec3(p);
-}
+int main(int argc, char** argv) {
+    int ret = -1;
+    {
+#ifdef IVW_ENABLE_MSVC_MEM_LEAK_TEST
+        VLDDisable();
+        ::testing::InitGoogleTest(&argc, argv);
+        VLDEnable();
+#else
+        ::testing::InitGoogleTest(&argc, argv);
+#endif
+        ret = RUN_ALL_TESTS();
+    }
 
-template <>
-Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec4(p);
-}
-
-}  // namespace inviwo
+    return ret;
+}
\ No newline at end of file
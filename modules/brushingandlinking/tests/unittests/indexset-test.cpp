@@ -0,0 +1,138 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/brushingandlinking/datastructures/indexset.h>
+
+#include <set>
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+// Sparse and dense chunks, and indices beyond 32 bits
+std::vector<size_t> makeIndices(size_t seed) {
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(seed));
+    std::vector<size_t> indices;
+    std::uniform_int_distribution<size_t> sparse(0, 1000000);
+    for (int i = 0; i < 3000; ++i) indices.push_back(sparse(gen));
+    std::uniform_int_distribution<size_t> dense(200000, 220000);
+    for (int i = 0; i < 15000; ++i) indices.push_back(dense(gen));
+    indices.push_back(size_t{1} << 40);
+    return indices;
+}
+
+std::vector<size_t> toSortedVector(const std::set<size_t>& set) {
+    return std::vector<size_t>(set.begin(), set.end());
+}
+
+}  // namespace
+
+TEST(IndexSetTest, InsertEraseHas) {
+    IndexSet set;
+    EXPECT_TRUE(set.empty());
+    set.insert(5);
+    set.insert(70000);
+    set.insert(5);
+    EXPECT_EQ(2, set.size());
+    EXPECT_TRUE(set.has(5));
+    EXPECT_TRUE(set.has(70000));
+    EXPECT_FALSE(set.has(6));
+    EXPECT_TRUE(set.erase(5));
+    EXPECT_FALSE(set.erase(5));
+    EXPECT_FALSE(set.has(5));
+    EXPECT_EQ(1, set.size());
+
+    // Fill a chunk beyond the array limit and empty it again
+    for (size_t i = 0; i < 10000; ++i) set.insert(2 * i);
+    EXPECT_EQ(10001, set.size());
+    EXPECT_TRUE(set.has(19998));
+    EXPECT_FALSE(set.has(19999));
+    for (size_t i = 0; i < 10000; ++i) set.erase(2 * i);
+    EXPECT_EQ(IndexSet({70000}), set);
+}
+
+TEST(IndexSetTest, MatchesStdSet) {
+    const auto a = makeIndices(1);
+    const auto b = makeIndices(2);
+    const std::set<size_t> sa(a.begin(), a.end());
+    const std::set<size_t> sb(b.begin(), b.end());
+    const IndexSet ia(a);
+    const IndexSet ib(b);
+
+    EXPECT_EQ(sa.size(), ia.size());
+    EXPECT_EQ(toSortedVector(sa), ia.toVector());
+    for (size_t i = 199990; i < 200100; ++i) EXPECT_EQ(sa.count(i) != 0, ia.has(i));
+
+    std::set<size_t> expected;
+    std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                   std::inserter(expected, expected.end()));
+    EXPECT_EQ(toSortedVector(expected), (ia | ib).toVector());
+
+    expected.clear();
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                          std::inserter(expected, expected.end()));
+    EXPECT_EQ(toSortedVector(expected), (ia & ib).toVector());
+
+    expected.clear();
+    std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                        std::inserter(expected, expected.end()));
+    EXPECT_EQ(toSortedVector(expected), (ia - ib).toVector());
+    EXPECT_EQ(expected.size(), (ia - ib).size());
+}
+
+TEST(IndexSetTest, Equality) {
+    const auto a = makeIndices(3);
+    IndexSet forward;
+    for (auto i : a) forward.insert(i);
+    const IndexSet sorted(a);
+    EXPECT_EQ(sorted, forward);
+
+    auto other = sorted;
+    other.insert(1234567);
+    EXPECT_NE(sorted, other);
+    EXPECT_EQ(sorted, other - IndexSet({1234567}));
+    EXPECT_TRUE((sorted - sorted).empty());
+}
+
+TEST(IndexSetTest, DenseIsCompact) {
+    IndexSet set;
+    const size_t n = 2000000;
+    for (size_t i = 0; i < n; ++i) set.insert(i);
+    EXPECT_EQ(n, set.size());
+    // About a bit per index
+    EXPECT_LT(set.getMemoryUsage(), 2 * n / 8);
+}
+
+}  // namespace inviwo
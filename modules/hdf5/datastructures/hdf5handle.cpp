@@ -31,9 +31,8 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/formatdispatching.h>
 #include <inviwo/core/util/raiiutils.h>
-#include <inviwo/core/datastructures/volume/volumeramprecision.h>
-
-#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <modules/hdf5/datastructures/hdf5volumeramloader.h>
 
 #include <algorithm>
 
@@ -136,7 +135,6 @@ std::shared_ptr<Volume> Handle::getVolumeAtPathAsType(const Path& path,
 
     std::vector<hsize_t> dataDimensions(rank);
     dataSpace.getSimpleExtentDims(dataDimensions.data());
-    const hsize_t dataSize = dataSpace.getSelectNpoints();
 
     std::vector<hsize_t> start(rank);
     std::vector<hsize_t> count(rank);
@@ -154,72 +152,32 @@ std::shared_ptr<Volume> Handle::getVolumeAtPathAsType(const Path& path,
      */
     std::reverse(selection.begin(), selection.end());
 
-    size3_t volumeDimensions(1);
-    int resRank = 0;
-    std::vector<hsize_t> memoryDimensions{ 1, 1, 1 };
-
     for (size_t i = 0; i < rank; ++i) {
         start[i] = selection[i].start;
         count[i] =
             static_cast<hsize_t>((selection[i].end - selection[i].start) / selection[i].stride);
         stride[i] = selection[i].stride;
-
-        if (count[i] > 1) {
-            if (resRank > 2) throw Exception("Invalid selection, resulting rank > 3", IvwContext);
-            memoryDimensions[resRank] = count[i];
-            volumeDimensions[resRank] = count[i];
-            resRank++;
-        }
     }
 
-    dataSpace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data(), stride.data(), nullptr);
-
-    H5::DataSpace memorySpace(3, memoryDimensions.data());
-    memorySpace.selectAll();
-
-    hsize_t selectionSize = memorySpace.getSelectNpoints();
-
-    LogInfo("Data rank: " << rank << " dims " << joinString(dataDimensions, " x ") << " size "
-                          << dataSize << " selection " << dataSpace.getSelectNpoints()
-                          << " memory size " << memorySpace.getSelectNpoints() << " memory dim "
-                          << volumeDimensions);
-
     const DataFormatBase* format = type ? type : util::getDataFormatFromDataSet(dataset);
 
-    // Reverse back the Column major
-    std::reverse(&volumeDimensions[0], &volumeDimensions[0] + volumeDimensions.length());
-    auto volumeram = createVolumeRAM(volumeDimensions, format);
-
-    auto minmax = volumeram->dispatch<std::pair<dvec4, dvec4>, dispatching::filter::Scalars>([&](
-        auto vrprecision) {
-        using ValueType = ::inviwo::util::PrecsionValueType<decltype(vrprecision)>;
-
-        ValueType* data = vrprecision->getDataTyped();
-
-        try {
-            dataset.read(data, TypeMap<ValueType>::getType(), memorySpace, dataSpace);
-        } catch (H5::DataSetIException& e) {
-            throw Exception("HDF: unable to read data: " + e.getDetailMsg(), IvwContext);
-        }
-
-        auto res = ::inviwo::util::dataMinMax(data, selectionSize);
+    // Nothing is read here, the loader reads the data when a representation is requested.
+    auto loader = ::inviwo::util::make_unique<HDF5VolumeRAMLoader>(filename_, path, start, count,
+                                                                    stride, format);
+    const auto volumeDimensions = loader->getDimensions();
 
-        LogInfo("Read HDF volume type: " << DataFormat<ValueType>::str()
-                                         << " data range: " << res.first << ", " << res.second
-                                         << " file: " << dataset.getFileName());
+    LogInfo("Data rank: " << rank << " dims " << joinString(dataDimensions, " x ")
+                          << " selection dim " << volumeDimensions << " type "
+                          << format->getString() << " file: " << filename_);
 
-        return res;
-    });
+    auto disk = std::make_shared<VolumeDisk>(filename_, volumeDimensions, format);
+    disk->setLoader(loader.release());
 
-    auto volume = std::make_shared<Volume>();
-    volume->dataMap_.dataRange.x = glm::compMin(minmax.first);
-    volume->dataMap_.dataRange.y = glm::compMax(minmax.second);
+    // The actual data range is not known until the data is read, use the range of the format.
+    auto volume = std::make_shared<Volume>(disk);
+    volume->dataMap_.dataRange = dvec2(getMin(format), getMax(format));
     volume->dataMap_.valueRange = volume->dataMap_.dataRange;
 
-    volume->setDimensions(volumeram->getDimensions());
-    volume->setDataFormat(volumeram->getDataFormat());
-    volume->addRepresentation(volumeram);
-  
     return volume;
 }
 
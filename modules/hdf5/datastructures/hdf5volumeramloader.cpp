@@ -0,0 +1,259 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/hdf5/datastructures/hdf5volumeramloader.h>
+#include <modules/hdf5/hdf5types.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/formatdispatching.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <array>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace hdf5 {
+
+namespace {
+
+H5::FileAccPropList chunkCacheAccess() {
+    H5::FileAccPropList access;
+    // A prime number of slots well above the number of chunks that fit in the cache, and evict
+    // fully read chunks first.
+    access.setCache(0, 10007, HDF5VolumeRAMLoader::chunkCacheSize, 1.0);
+    return access;
+}
+
+struct Segment {
+    size_t begin;
+    size_t count;
+};
+
+// Split [begin, begin + count) along a dataset dimension into segments that each lie within a
+// single chunk, the segments are relative to begin.
+std::vector<Segment> chunkSegments(size_t begin, size_t count, hsize_t start, hsize_t stride,
+                                   hsize_t chunk) {
+    std::vector<Segment> segments;
+    hsize_t current = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const hsize_t id = chunk > 0 ? (start + (begin + i) * stride) / chunk : 0;
+        if (segments.empty() || id != current) {
+            segments.push_back({i, 1});
+            current = id;
+        } else {
+            ++segments.back().count;
+        }
+    }
+    return segments;
+}
+
+}  // namespace
+
+HDF5VolumeRAMLoader::File::File(const std::string& filename, const Path& path)
+    : file(filename, H5F_ACC_RDONLY, H5::FileCreatPropList::DEFAULT, chunkCacheAccess())
+    , dataset(file.openDataSet(path)) {
+    const auto plist = dataset.getCreatePlist();
+    if (plist.getLayout() == H5D_CHUNKED) {
+        chunk.resize(dataset.getSpace().getSimpleExtentNdims());
+        plist.getChunk(static_cast<int>(chunk.size()), chunk.data());
+    }
+}
+
+HDF5VolumeRAMLoader::HDF5VolumeRAMLoader(const std::string& filename, const Path& path,
+                                         std::vector<hsize_t> start, std::vector<hsize_t> count,
+                                         std::vector<hsize_t> stride,
+                                         const DataFormatBase* format)
+    : start_(std::move(start))
+    , count_(std::move(count))
+    , stride_(std::move(stride))
+    , dimensions_(1)
+    , format_(format) {
+
+    try {
+        file_ = std::make_shared<File>(filename, path);
+    } catch (const H5::Exception& e) {
+        throw Exception("HDF: unable to open data set: " + e.getDetailMsg(), IvwContext);
+    }
+
+    const size_t rank = file_->dataset.getSpace().getSimpleExtentNdims();
+    if (start_.size() != rank || count_.size() != rank || stride_.size() != rank) {
+        throw Exception("Selection not of the same rank as the data", IvwContext);
+    }
+    for (size_t i = 0; i < rank; ++i) {
+        if (count_[i] > 1) {
+            if (axes_.size() > 2) throw Exception("Invalid selection, resulting rank > 3", IvwContext);
+            axes_.push_back(i);
+        } else {
+            count_[i] = 1;
+        }
+    }
+    // Row major dataset dimensions, the last one is x.
+    for (size_t i = 0; i < axes_.size(); ++i) {
+        dimensions_[2 - i] = static_cast<size_t>(count_[axes_[i]]);
+    }
+}
+
+HDF5VolumeRAMLoader* HDF5VolumeRAMLoader::clone() const { return new HDF5VolumeRAMLoader(*this); }
+
+std::shared_ptr<VolumeRepresentation> HDF5VolumeRAMLoader::createRepresentation() const {
+    auto volumeram = readRegion(size3_t(0), dimensions_);
+    notifyRead(*volumeram);
+    return volumeram;
+}
+
+void HDF5VolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const {
+    auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
+    if (volumeDst->getDimensions() != dimensions_) volumeDst->setDimensions(dimensions_);
+    read(size3_t(0), dimensions_, volumeDst.get());
+    notifyRead(*volumeDst);
+}
+
+std::shared_ptr<VolumeRAM> HDF5VolumeRAMLoader::readRegion(const size3_t& offset,
+                                                           const size3_t& dimensions) const {
+    auto volumeram = createVolumeRAM(dimensions, format_);
+    read(offset, dimensions, volumeram.get());
+    return volumeram;
+}
+
+const size3_t& HDF5VolumeRAMLoader::getDimensions() const { return dimensions_; }
+
+const DataFormatBase* HDF5VolumeRAMLoader::getDataFormat() const { return format_; }
+
+bool HDF5VolumeRAMLoader::readDataRange(dvec2& range) const {
+    std::lock_guard<std::mutex> lock(file_->mutex);
+    const auto& dataset = file_->dataset;
+    auto readAttribute = [&](const char* name) {
+        std::vector<double> values;
+        if (H5Aexists(dataset.getId(), name) <= 0) return values;
+        try {
+            const auto attribute = dataset.openAttribute(name);
+            values.resize(attribute.getSpace().getSimpleExtentNpoints());
+            attribute.read(H5::PredType::NATIVE_DOUBLE, values.data());
+        } catch (const H5::Exception&) {  // Not a numeric attribute
+            values.clear();
+        }
+        return values;
+    };
+
+    for (const auto name : {"actual_range", "valid_range"}) {
+        const auto values = readAttribute(name);
+        if (values.size() == 2) {
+            range = dvec2(values[0], values[1]);
+            return true;
+        }
+    }
+    for (const auto& names :
+         {std::make_pair("min", "max"), std::make_pair("valid_min", "valid_max")}) {
+        const auto min = readAttribute(names.first);
+        const auto max = readAttribute(names.second);
+        if (min.size() == 1 && max.size() == 1) {
+            range = dvec2(min[0], max[0]);
+            return true;
+        }
+    }
+    return false;
+}
+
+void HDF5VolumeRAMLoader::setReadCallback(std::weak_ptr<ReadCallback> callback) const {
+    std::lock_guard<std::mutex> lock(file_->mutex);
+    file_->onRead = std::move(callback);
+}
+
+void HDF5VolumeRAMLoader::notifyRead(const VolumeRAM& volume) const {
+    std::shared_ptr<ReadCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(file_->mutex);
+        callback = file_->onRead.lock();
+    }
+    if (callback) (*callback)(volume);
+}
+
+void HDF5VolumeRAMLoader::read(const size3_t& offset, const size3_t& dimensions,
+                               VolumeRAM* dest) const {
+    // Memory is row major as well, i.e. z, y, x.
+    const std::vector<hsize_t> memoryDimensions{dimensions.z, dimensions.y, dimensions.x};
+    H5::DataSpace memorySpace(3, memoryDimensions.data());
+
+    std::lock_guard<std::mutex> lock(file_->mutex);
+    H5::DataSpace dataSpace = file_->dataset.getSpace();
+
+    std::array<std::vector<Segment>, 3> segments;
+    for (size_t i = 0; i < 3; ++i) {
+        if (i < axes_.size()) {
+            const auto axis = axes_[i];
+            segments[i] = chunkSegments(offset[2 - i], dimensions[2 - i], start_[axis],
+                                        stride_[axis],
+                                        file_->chunk.empty() ? 0 : file_->chunk[axis]);
+        } else {
+            segments[i].push_back({0, 1});
+        }
+    }
+
+    dest->dispatch<void, dispatching::filter::Scalars>([&](auto vrprecision) {
+        using ValueType = ::inviwo::util::PrecsionValueType<decltype(vrprecision)>;
+        const auto type = TypeMap<ValueType>::getType();
+
+        auto fileStart = start_;
+        auto fileCount = count_;
+        try {
+            for (const auto& s0 : segments[0]) {
+                for (const auto& s1 : segments[1]) {
+                    for (const auto& s2 : segments[2]) {
+                        const std::array<const Segment*, 3> s{{&s0, &s1, &s2}};
+                        std::array<hsize_t, 3> memoryStart;
+                        std::array<hsize_t, 3> memoryCount;
+                        for (size_t i = 0; i < 3; ++i) {
+                            memoryStart[i] = s[i]->begin;
+                            memoryCount[i] = s[i]->count;
+                            if (i < axes_.size()) {
+                                const auto axis = axes_[i];
+                                fileStart[axis] =
+                                    start_[axis] + (offset[2 - i] + s[i]->begin) * stride_[axis];
+                                fileCount[axis] = s[i]->count;
+                            }
+                        }
+                        dataSpace.selectHyperslab(H5S_SELECT_SET, fileCount.data(),
+                                                  fileStart.data(), stride_.data());
+                        memorySpace.selectHyperslab(H5S_SELECT_SET, memoryCount.data(),
+                                                    memoryStart.data());
+                        file_->dataset.read(vrprecision->getDataTyped(), type, memorySpace,
+                                            dataSpace);
+                    }
+                }
+            }
+        } catch (const H5::Exception& e) {
+            throw Exception("HDF: unable to read data: " + e.getDetailMsg(), IvwContext);
+        }
+    });
+}
+
+}  // namespace hdf5
+
+}  // namespace inviwo
@@ -0,0 +1,132 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_HDF5VOLUMERAMLOADER_H
+#define IVW_HDF5VOLUMERAMLOADER_H
+
+#include <modules/hdf5/hdf5moduledefine.h>
+#include <modules/hdf5/datastructures/hdf5path.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/diskrepresentation.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+
+#include <H5Cpp.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace hdf5 {
+
+/**
+ * \class HDF5VolumeRAMLoader
+ * \brief Creates VolumeRAM representations from a hyperslab of an HDF5 dataset on demand.
+ *
+ * Nothing is read until a representation or a region is requested. The selection is then read
+ * chunk by chunk following the native chunk layout of the dataset, which makes sure that every
+ * chunk is decoded only once, and for a region only the chunks overlapping it are read. The file
+ * is kept open and shared between clones of the loader, together with a cache of recently decoded
+ * chunks, which makes repeated region reads, like scrolling through slices, cheap.
+ */
+class IVW_MODULE_HDF5_API HDF5VolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                                                public VolumeRegionLoader {
+public:
+    using ReadCallback = std::function<void(const VolumeRAM&)>;
+
+    /**
+     * The hyperslab is given in the order of the dataset dimensions, i.e. row major. At most three
+     * dimensions can have a count larger than one, they become the volume dimensions with the
+     * last, fastest varying, one as x.
+     * @throw Exception if the dataset can not be opened or the selection is invalid
+     */
+    HDF5VolumeRAMLoader(const std::string& filename, const Path& path, std::vector<hsize_t> start,
+                        std::vector<hsize_t> count, std::vector<hsize_t> stride,
+                        const DataFormatBase* format);
+    virtual HDF5VolumeRAMLoader* clone() const override;
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override;
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override;
+    virtual std::shared_ptr<VolumeRAM> readRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const override;
+
+    const size3_t& getDimensions() const;
+    const DataFormatBase* getDataFormat() const;
+
+    /**
+     * Read the data range from the attributes of the dataset, without reading any data. Either a
+     * two element "actual_range" or "valid_range" attribute, or scalar "min" and "max" or
+     * "valid_min" and "valid_max" attributes are used.
+     * @return false if the dataset has no range attributes
+     */
+    bool readDataRange(dvec2& range) const;
+
+    /**
+     * Set a callback that is called with the new representation every time the full selection
+     * has been read, on the thread that read it. The callback is shared by all copies of the
+     * loader and is only called while it is alive.
+     */
+    void setReadCallback(std::weak_ptr<ReadCallback> callback) const;
+
+    /**
+     * Size of the cache for decoded chunks of each open file.
+     */
+    static const size_t chunkCacheSize = 64 * 1024 * 1024;
+
+private:
+    void read(const size3_t& offset, const size3_t& dimensions, VolumeRAM* dest) const;
+    void notifyRead(const VolumeRAM& volume) const;
+
+    struct File {
+        File(const std::string& filename, const Path& path);
+        std::mutex mutex;  // The HDF5 library is in general not thread safe
+        H5::H5File file;
+        H5::DataSet dataset;
+        std::vector<hsize_t> chunk;  // Chunk dimensions, empty if the dataset is not chunked
+        std::weak_ptr<ReadCallback> onRead;
+    };
+
+    std::shared_ptr<File> file_;
+    std::vector<hsize_t> start_;
+    std::vector<hsize_t> count_;
+    std::vector<hsize_t> stride_;
+    std::vector<size_t> axes_;  // The dataset dimension of each volume dimension, z first
+    size3_t dimensions_;
+    const DataFormatBase* format_;
+};
+
+}  // namespace hdf5
+
+}  // namespace inviwo
+
+#endif  // IVW_HDF5VOLUMERAMLOADER_H
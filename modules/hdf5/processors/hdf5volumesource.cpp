@@ -32,6 +32,8 @@
 #include <modules/hdf5/datastructures/hdf5path.h>
 #include <inviwo/core/io/datareader.h>
 #include <inviwo/core/io/datareaderexception.h>
+#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
 #include <functional>
 #include <numeric>
 #include <limits>
@@ -323,6 +325,7 @@ void HDF5ToVolume::makeVolume() {
     if (inport_.hasData()) {
         const auto data = inport_.getData();
         MetaData volumeMeta = volumeMatches_[volumeSelection_.getSelectedIndex()];
+        onVolumeRead_.reset();
 
         try {
             const DataFormatBase* format = nullptr;
@@ -348,6 +351,33 @@ void HDF5ToVolume::makeVolume() {
                 data->getVolumeAtPathAsType(Path(data->getGroup().getObjName()) + volumeMeta.path_,
                                             selection_.getSelection(), format));
 
+            // Nothing is read here. Use the data range stored in the file if there is one,
+            // otherwise the range of the format is used until the full volume has been read the
+            // first time. The processor is then invalidated, such that process() sets the actual
+            // range on the volume and dependent processors are evaluated again with it.
+            const auto loader = dynamic_cast<const hdf5::HDF5VolumeRAMLoader*>(
+                volume_->getRepresentation<VolumeDisk>()->getLoader());
+            dvec2 range;
+            if (loader && loader->readDataRange(range)) {
+                volume_->dataMap_.dataRange = range;
+            } else if (loader && overrideRange_.getSelectedIndex() == 0) {
+                onVolumeRead_ = std::make_shared<hdf5::HDF5VolumeRAMLoader::ReadCallback>();
+                std::weak_ptr<hdf5::HDF5VolumeRAMLoader::ReadCallback> alive = onVolumeRead_;
+                *onVolumeRead_ = [this, alive](const VolumeRAM& volumeram) {
+                    const auto minmax = ::inviwo::util::volumeMinMax(&volumeram);
+                    const dvec2 dataRange(glm::compMin(minmax.first),
+                                          glm::compMax(minmax.second));
+                    dispatchFront([this, alive, dataRange]() {
+                        // The processor or the selection might have changed since
+                        const auto callback = alive.lock();
+                        if (!callback || callback != onVolumeRead_) return;
+                        onVolumeRead_.reset();
+                        dataRange_.set(dataRange);
+                        invalidate(InvalidationLevel::InvalidOutput);
+                    });
+                };
+                loader->setReadCallback(onVolumeRead_);
+            }
             dataRange_.set(volume_->dataMap_.dataRange);
 
             outport_.setData(volume_);
@@ -36,6 +36,7 @@
 #include <modules/hdf5/ports/hdf5port.h>
 #include <modules/hdf5/datastructures/hdf5metadata.h>
 #include <modules/hdf5/hdf5utils.h>
+#include <modules/hdf5/datastructures/hdf5volumeramloader.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/ports/volumeport.h>
 #include <inviwo/core/properties/minmaxproperty.h>
@@ -172,6 +173,8 @@ private:
     DimSelections selection_;
 
     bool dirty_;
+    // Computes the data range when the volume is read, if it is not stored in the file
+    std::shared_ptr<hdf5::HDF5VolumeRAMLoader::ReadCallback> onVolumeRead_;
 };
 
 }  // namespace
@@ -48,6 +48,8 @@ class IVW_MODULE_OPENCL_API BufferCLGL : public BufferCLBase,
                                          public BufferRepresentation,
                                          public BufferObjectObserver {
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     BufferCLGL(size_t size, const DataFormatBase* format, BufferUsage usage,
                std::shared_ptr<BufferObject> data, cl_mem_flags readWriteFlag = CL_MEM_READ_WRITE);
     BufferCLGL(const BufferCLGL& rhs);
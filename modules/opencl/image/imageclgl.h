@@ -40,6 +40,8 @@ namespace inviwo {
 
 class IVW_MODULE_OPENCL_API ImageCLGL : public ImageRepresentation {
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     ImageCLGL();
     ImageCLGL(const ImageCLGL& other);
     virtual ~ImageCLGL();
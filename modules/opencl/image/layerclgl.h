@@ -57,6 +57,8 @@ class IVW_MODULE_OPENCL_API LayerCLGL : public LayerCLBase,
                                         public LayerRepresentation,
                                         public TextureObserver {
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     LayerCLGL(size2_t dimensions, LayerType type, const DataFormatBase* format,
               std::shared_ptr<Texture2D> data, const SwizzleMask& swizzleMask = swizzlemasks::rgba);
     virtual ~LayerCLGL();
@@ -56,6 +56,8 @@ class IVW_MODULE_OPENCL_API VolumeCLGL : public VolumeCLBase,
                                          public VolumeRepresentation,
                                          public TextureObserver {
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     VolumeCLGL(const DataFormatBase* format = DataFormatBase::get(), Texture3D* data = nullptr);
     VolumeCLGL(const size3_t& dimensions, const DataFormatBase* format, std::shared_ptr<Texture3D> data);
     VolumeCLGL(const VolumeCLGL& rhs);
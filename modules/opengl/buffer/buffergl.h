@@ -44,6 +44,8 @@ namespace inviwo {
  */
 class IVW_MODULE_OPENGL_API BufferGL : public BufferRepresentation {
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     /**
      * \brief Create a buffer stored on the GPU.
      *
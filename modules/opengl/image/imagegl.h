@@ -50,6 +50,8 @@ class Image;
 class IVW_MODULE_OPENGL_API ImageGL : public ImageRepresentation {
 
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     ImageGL();
     ImageGL(const ImageGL& rhs);
     virtual ~ImageGL();
@@ -46,6 +46,8 @@ class Texture2D;
  */
 class IVW_MODULE_OPENGL_API LayerGL : public LayerRepresentation {
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     LayerGL(size2_t dimensions = size2_t(256, 256), LayerType type = LayerType::Color,
             const DataFormatBase* format = DataVec4UInt8::get(),
             std::shared_ptr<Texture2D> tex = std::shared_ptr<Texture2D>(nullptr),
@@ -51,6 +51,8 @@ namespace kind {
 class IVW_MODULE_OPENGL_API VolumeGL : public VolumeRepresentation {
 
 public:
+    static constexpr bool REQUIRES_GRAPHICS_CONTEXT = true;
+
     VolumeGL(size3_t dimensions = size3_t(128,128,128), const DataFormatBase* format = DataFormatBase::get(), bool initializeTexture = true);
     VolumeGL(std::shared_ptr<Texture3D> tex, const DataFormatBase* format);
     VolumeGL(const VolumeGL& rhs);
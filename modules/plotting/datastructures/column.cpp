@@ -61,6 +61,14 @@ void CategoricalColumn::add(const std::string &value) {
     getTypedBuffer()->getEditableRAMRepresentation()->add(id);
 }
 
+const std::vector<std::string> &CategoricalColumn::getCategories() const {
+    return lookUpTable_;
+}
+
+void CategoricalColumn::setCategories(std::vector<std::string> categories) {
+    lookUpTable_ = std::move(categories);
+}
+
 glm::uint32_t CategoricalColumn::addOrGetID(const std::string &str) {
     auto it = std::find(lookUpTable_.begin(), lookUpTable_.end(), str);
     if (it != lookUpTable_.end()) {
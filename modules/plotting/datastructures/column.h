@@ -202,6 +202,17 @@ public:
 
     virtual void add(const std::string &value) override;
 
+    /**
+     * \brief returns the unique string values, the internal representation of a value is its
+     * position in this list
+     */
+    const std::vector<std::string> &getCategories() const;
+    /**
+     * \brief replaces the unique string values. The existing internal representation is not
+     * changed, i.e. all stored numbers need to be valid indices into \p categories.
+     */
+    void setCategories(std::vector<std::string> categories);
+
 private:
     virtual glm::uint32_t addOrGetID(const std::string &str);
 
@@ -0,0 +1,157 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2014-2016 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/plotting/utils/csvreader.h>
+#include <modules/plotting/datastructures/column.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<plot::DataFrame> parseCSV(const std::string& str, bool header = true) {
+    CSVReader reader;
+    reader.setFirstRowHeader(header);
+    return reader.parse(str.data(), str.data() + str.size());
+}
+
+}  // namespace
+
+TEST(CSVReaderTest, types) {
+    auto df = parseCSV("a,b,c\n1,x,2.5\r\n\n,,\n3e2,\"y,\"\"z\"\"\",-1\n");
+    ASSERT_EQ(4u, df->getNumberOfColumns());  // including index column
+    ASSERT_EQ(2u, df->getNumberOfRows());
+
+    auto a = std::dynamic_pointer_cast<plot::TemplateColumn<float>>(df->getColumn(1));
+    ASSERT_TRUE(a != nullptr);
+    EXPECT_EQ("a", a->getHeader());
+    EXPECT_FLOAT_EQ(1.0f, a->get(0));
+    EXPECT_FLOAT_EQ(300.0f, a->get(1));
+
+    auto b = std::dynamic_pointer_cast<plot::CategoricalColumn>(df->getColumn(2));
+    ASSERT_TRUE(b != nullptr);
+    EXPECT_EQ("x", b->getAsString(0));
+    EXPECT_EQ("y,\"z\"", b->getAsString(1));
+
+    auto c = std::dynamic_pointer_cast<plot::TemplateColumn<float>>(df->getColumn(3));
+    ASSERT_TRUE(c != nullptr);
+    EXPECT_FLOAT_EQ(2.5f, c->get(0));
+    EXPECT_FLOAT_EQ(-1.0f, c->get(1));
+}
+
+TEST(CSVReaderTest, noHeader) {
+    auto df = parseCSV("1;a\n2;b", false);
+    ASSERT_EQ(2u, df->getNumberOfColumns());
+    ASSERT_EQ(2u, df->getNumberOfRows());
+    EXPECT_EQ("2;b", df->getColumn(1)->getAsString(1));
+
+    CSVReader reader;
+    reader.setFirstRowHeader(false);
+    reader.setDelimiters(";");
+    const std::string str = "1;a\n2;b";
+    df = reader.parse(str.data(), str.data() + str.size());
+    ASSERT_EQ(3u, df->getNumberOfColumns());
+    ASSERT_EQ(2u, df->getNumberOfRows());
+    EXPECT_EQ("Column 1", df->getHeader(1));
+    EXPECT_EQ("b", df->getColumn(2)->getAsString(1));
+}
+
+TEST(CSVReaderTest, errors) {
+    EXPECT_THROW(parseCSV("a,b\n1,\"2\n"), Exception);
+    EXPECT_THROW(parseCSV("a,b\n1,2\n3\n"), plot::InvalidColCount);
+    EXPECT_THROW(parseCSV("a,b\n"), Exception);
+}
+
+TEST(CSVReaderTest, chunks) {
+    // large enough to be split into several chunks, with quoted line breaks and delimiters
+    const size_t rows = 100000;
+    std::string str = "id,name,value\n";
+    for (size_t i = 0; i < rows; ++i) {
+        str += std::to_string(i) + ",\"line\nbreak, " + std::to_string(i % 7) + "\"," +
+               std::to_string(i % 3) + ".5\n";
+    }
+    auto df = parseCSV(str);
+    ASSERT_EQ(rows, df->getNumberOfRows());
+
+    auto id = std::dynamic_pointer_cast<plot::TemplateColumn<float>>(df->getColumn(1));
+    auto name = std::dynamic_pointer_cast<plot::CategoricalColumn>(df->getColumn(2));
+    auto value = std::dynamic_pointer_cast<plot::TemplateColumn<float>>(df->getColumn(3));
+    ASSERT_TRUE(id && name && value);
+    ASSERT_EQ(7u, name->getCategories().size());
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_FLOAT_EQ(static_cast<float>(i), id->get(i));
+        ASSERT_EQ("line\nbreak, " + std::to_string(i % 7), name->getAsString(i));
+        ASSERT_FLOAT_EQ(static_cast<float>(i % 3) + 0.5f, value->get(i));
+    }
+}
+
+TEST(CSVReaderTest, oddQuotesPerChunk) {
+    // between 4 and 5 MiB of data results in exactly four chunks. The padding is chosen such
+    // that the second chunk contains an odd number of quotes, i.e. exactly one of its bounds is
+    // located within a quoted field.
+    const std::string header = "id,name,value\n";
+    const size_t rows = 4 * (1 << 20) / 40 + 1000;
+    std::string str;
+    for (size_t pad = 0; pad < 64; ++pad) {
+        str = header;
+        str += std::string(pad, '0') + "0,\"padding\",0\n";
+        for (size_t i = 0; i < rows; ++i) {
+            str += std::to_string(i) + ",\"quoted\nfield, " + std::to_string(i % 5) +
+                   " with some text\"," + std::to_string(i % 3) + "\n";
+        }
+        const size_t dataSize = str.size() - header.size();
+        ASSERT_EQ(4u, dataSize / (1 << 20));
+        const auto chunkBegin = str.data() + header.size() + dataSize / 4;
+        if (std::count(chunkBegin, chunkBegin + dataSize / 4, '"') % 2 == 1) break;
+    }
+    auto df = parseCSV(str);
+    ASSERT_EQ(rows + 1, df->getNumberOfRows());
+
+    auto id = std::dynamic_pointer_cast<plot::TemplateColumn<float>>(df->getColumn(1));
+    auto name = std::dynamic_pointer_cast<plot::CategoricalColumn>(df->getColumn(2));
+    auto value = std::dynamic_pointer_cast<plot::TemplateColumn<float>>(df->getColumn(3));
+    ASSERT_TRUE(id && name && value);
+    ASSERT_EQ(6u, name->getCategories().size());
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_FLOAT_EQ(static_cast<float>(i), id->get(i + 1));
+        ASSERT_EQ("quoted\nfield, " + std::to_string(i % 5) + " with some text",
+                  name->getAsString(i + 1));
+        ASSERT_FLOAT_EQ(static_cast<float>(i % 3), value->get(i + 1));
+    }
+}
+
+}  // namespace inviwo
@@ -32,144 +32,464 @@
 #include <modules/plotting/datastructures/column.h>
 #include <modules/plotting/datastructures/dataframe.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/memorymappedfile.h>
+#include <inviwo/core/util/parallel.h>
 
-#include <fstream>
+#include <warn/push>
+#include <warn/ignore/all>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <warn/pop>
 
 namespace inviwo {
 
-CSVReader::CSVReader() : delimiters_(","), firstRowHeader_(true) {}
+namespace {
 
-CSVReader* CSVReader::clone() const { return new CSVReader(*this); }
+// A field of a row, refers directly into the parsed data.
+struct Field {
+    const char* begin;
+    const char* end;
+    bool quoted;
+    bool escaped;  // contains pairs of double quotes representing a single quote
 
-void CSVReader::setDelimiters(const std::string& delim) { delimiters_ = delim; }
+    bool empty() const { return !quoted && begin == end; }
+    std::string str() const {
+        if (!escaped) return std::string(begin, end);
+        std::string res;
+        res.reserve(end - begin);
+        for (auto p = begin; p != end; ++p) {
+            res += *p;
+            if (*p == '"') ++p;
+        }
+        return res;
+    }
+};
 
-void CSVReader::setFirstRowHeader(bool hasHeader) {
-    firstRowHeader_ = true;
-}
+class Tokenizer {
+public:
+    enum Type : char { Regular = 0, Delimiter = 1, LineBreak = 2 };
 
-std::shared_ptr<plot::DataFrame> CSVReader::readData(const std::string& fileName) {
-    std::ifstream file(fileName);
+    Tokenizer(const std::string& delimiters, const char* begin) : begin_(begin) {
+        types_.fill(Regular);
+        for (auto c : delimiters) types_[static_cast<unsigned char>(c)] = Delimiter;
+        types_[static_cast<unsigned char>('\n')] = LineBreak;
+        types_[static_cast<unsigned char>('\r')] = LineBreak;
+    }
 
-    if (!file.is_open()) {
-        throw FileException(std::string("CSVReader: Could not open file \"" + fileName + "\"."));
+    /**
+     * Parses the row starting at p and calls onField(column, field) for each field.
+     * Returns the start of the next row.
+     */
+    template <typename F>
+    const char* row(const char* p, const char* end, F onField) const {
+        for (size_t col = 0;; ++col) {
+            Field field{p, p, false, false};
+            if (p != end && *p == '"') {
+                field.quoted = true;
+                field.begin = ++p;
+                for (;;) {
+                    p = static_cast<const char*>(std::memchr(p, '"', end - p));
+                    if (!p) {
+                        throw Exception("CSVReader: unmatched quotes (line " +
+                                        std::to_string(lineNumber(field.begin)) + ")");
+                    }
+                    if (p + 1 != end && p[1] == '"') {
+                        field.escaped = true;
+                        p += 2;
+                    } else {
+                        break;
+                    }
+                }
+                field.end = p++;
+                // ignore anything between the closing quote and the next delimiter
+                while (p != end && type(*p) == Regular) ++p;
+            } else {
+                while (p != end && type(*p) == Regular) ++p;
+                field.end = p;
+            }
+            onField(col, field);
+
+            if (p == end) return end;
+            if (type(*p++) == Delimiter) continue;
+            if (p[-1] == '\r' && p != end && *p == '\n') ++p;
+            return p;
+        }
     }
 
-    file.seekg(0, std::ios::end);
-    std::streampos len = file.tellg();
-    file.seekg(0, std::ios::beg);
+    /**
+     * Returns the start of the first row beginning after p, inQuotes refers to the quote state
+     * at p.
+     */
+    const char* nextRow(const char* p, const char* end, bool inQuotes) const {
+        for (; p != end; ++p) {
+            if (*p == '"') {
+                inQuotes = !inQuotes;
+            } else if (!inQuotes && type(*p) == LineBreak) {
+                if (*p++ == '\r' && p != end && *p == '\n') ++p;
+                return p;
+            }
+        }
+        return end;
+    }
 
-    std::vector<char> buffer(len);
-    // read in entire file
-    file.read(buffer.data(), len);
+    size_t lineNumber(const char* pos) const {
+        return 1 + static_cast<size_t>(std::count(begin_, pos, '\n'));
+    }
 
-    // create a string stream for easier handling
-    std::stringstream in(buffer.data());
+private:
+    Type type(char c) const { return types_[static_cast<unsigned char>(c)]; }
 
-    // current line
-    size_t lineNumber = 1u;
+    std::array<Type, 256> types_;
+    const char* begin_;
+};
 
-    auto extractColumn = [&]() -> std::pair<std::string, bool> {
-        std::string value;
-        size_t quoteCount = 0;
-        char prev = 0;
-        const size_t start = lineNumber;
+bool parseFloat(const char* first, const char* last, float& result) {
+    static const std::array<double, 23> pow10 = {
+        {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22}};
+    auto isSpace = [](char c) { return c == ' ' || c == '\t'; };
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
 
-        auto isLineBreak = [](const char ch, auto& in) {
-            if (ch == '\r') {
-                // consume potential LF (\n) following CR (\r)
-                if (in.peek() == '\n') {
-                    in.get();
-                }
-                return true;
-            } else {
-                return (ch == '\n');
-            }
-        };
-
-        char ch;
-        while (in.get(ch)) {
-            bool linebreak = isLineBreak(ch, in);
-            if (linebreak) {
-                ++lineNumber;  // increase line counter
-                // ensure that ch is equal to '\n'
-                ch = '\n';
-                // consume line break, if inside quotes
-                if ((quoteCount & 1) != 0) {
-                    value += ch;
-                    prev = ch;
-                    continue;
-                }
-            }
-            if (ch == '"') {
-                ++quoteCount;
-            } else if (util::contains(delimiters_, ch) || linebreak) {
-                // found a delimiter/newline, ensure that it isn't enclosed by quotes,
-                // i.e. an even count of quotes
-                if ((quoteCount == 0) || ((prev == '"') && ((quoteCount & 1) == 0))) {
-                    return{ value, linebreak };
-                }
+    while (first != last && isSpace(*first)) ++first;
+    while (last != first && isSpace(last[-1])) --last;
+    if (first == last) return false;
+
+    auto p = first;
+    const bool negative = *p == '-';
+    if (*p == '-' || *p == '+') ++p;
+
+    std::uint64_t mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for (; p != last && isDigit(*p); ++p) {
+        hasDigits = true;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) ++significant;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p != last && *p == '.') {
+        for (++p; p != last && isDigit(*p); ++p) {
+            hasDigits = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) ++significant;
+                --exponent;
             }
-            prev = ch;
-            value += ch;
         }
-        if (((quoteCount & 1) != 0) && in.eof()) {
-            throw Exception("CSVReader: unmatched quotes (line " + std::to_string(lineNumber) + ")");
+    }
+    if (hasDigits && p != last && (*p == 'e' || *p == 'E')) {
+        ++p;
+        const bool negativeExp = p != last && *p == '-';
+        if (p != last && (*p == '-' || *p == '+')) ++p;
+        if (p == last || !isDigit(*p)) return false;
+        int exp = 0;
+        for (; p != last && isDigit(*p); ++p) {
+            if (exp < 10000) exp = exp * 10 + (*p - '0');
         }
-        return {value, false};
-    };
+        exponent += negativeExp ? -exp : exp;
+    }
 
-    auto extractRow = [&]() -> std::vector<std::string> {        
-        auto val = extractColumn();
-        if (in.eof() && val.first.empty()) {
-            // reached end of file, no more data
-            return{};
+    if (!hasDigits || p != last) {
+        // rare cases like "nan", "inf", or hexadecimal numbers
+        std::array<char, 64> buf;
+        const auto len = static_cast<size_t>(last - first);
+        if (len >= buf.size()) return false;
+        std::copy(first, last, buf.begin());
+        buf[len] = '\0';
+        char* parsedEnd = nullptr;
+        const auto value = std::strtod(buf.data(), &parsedEnd);
+        if (parsedEnd != buf.data() + len) return false;
+        result = static_cast<float>(value);
+        return true;
+    }
+
+    auto value = static_cast<double>(mantissa);
+    if (exponent < 0 && exponent >= -22) {
+        value /= pow10[-exponent];
+    } else if (exponent > 0 && exponent <= 22) {
+        value *= pow10[exponent];
+    } else if (exponent != 0) {
+        value *= std::pow(10.0, exponent);
+    }
+    result = static_cast<float>(negative ? -value : value);
+    return true;
+}
+
+// A string referring to either the parsed data or to storage of unescaped strings.
+struct Key {
+    const char* data;
+    size_t size;
+
+    bool operator==(const Key& rhs) const {
+        return size == rhs.size && std::memcmp(data, rhs.data, size) == 0;
+    }
+};
+
+struct KeyHash {
+    size_t operator()(const Key& key) const {
+        // FNV-1a
+        std::uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < key.size; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(key.data[i])) * 1099511628211ull;
         }
-        std::vector<std::string> values;
-        values.push_back(val.first);
-        while (!val.second && !in.eof()) {
-            val = extractColumn();
-            values.push_back(val.first);
+        return static_cast<size_t>(hash);
+    }
+};
+
+// Categories of one column found in one chunk, in order of first appearance.
+struct Categories {
+    std::uint32_t getID(const Field& field, std::deque<std::string>& storage) {
+        Key key{field.begin, static_cast<size_t>(field.end - field.begin)};
+        if (field.escaped) {
+            storage.push_back(field.str());
+            key = Key{storage.back().data(), storage.back().size()};
+        }
+        auto res = ids.emplace(key, static_cast<std::uint32_t>(keys.size()));
+        if (res.second) {
+            keys.push_back(key);
+        } else if (field.escaped) {
+            storage.pop_back();
         }
-        return values;
-    };
+        return res.first->second;
+    }
+
+    std::unordered_map<Key, std::uint32_t, KeyHash> ids;
+    std::vector<Key> keys;
+};
+
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    size_t rowOffset = 0;
+    size_t rows = 0;
+
+    std::vector<Categories> categories;
+    std::deque<std::string> storage;
+    size_t invalidValues = 0;
+    const char* firstInvalid = nullptr;
+};
+
+}  // namespace
+
+CSVReader::CSVReader() : delimiters_(","), firstRowHeader_(true) {}
+
+CSVReader* CSVReader::clone() const { return new CSVReader(*this); }
+
+void CSVReader::setDelimiters(const std::string& delim) { delimiters_ = delim; }
+
+void CSVReader::setFirstRowHeader(bool hasHeader) { firstRowHeader_ = hasHeader; }
+
+std::shared_ptr<plot::DataFrame> CSVReader::readData(const std::string& fileName) {
+    if (!filesystem::fileExists(fileName)) {
+        throw FileException(std::string("CSVReader: Could not open file \"" + fileName + "\"."));
+    }
+    MemoryMappedFile file(fileName);
+    return parse(file.begin(), file.end());
+}
+
+std::shared_ptr<plot::DataFrame> CSVReader::parse(const char* begin, const char* end) const {
+    // number of rows used for inferring the column types
+    const size_t sampleRows = 1000;
+    // chunks smaller than this are not worth parsing in parallel
+    const size_t minChunkSize = 1 << 20;
+
+    // skip UTF-8 byte order mark
+    if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) begin += 3;
+
+    const Tokenizer tokenizer(delimiters_, begin);
+    const char* dataBegin = begin;
 
     std::vector<std::string> headers;
     if (firstRowHeader_) {
-        // read headers
-        headers = extractRow();
-        if (headers.empty()) {
+        if (begin == end) {
             throw Exception("CSVReader: no column headers found.");
         }
+        dataBegin = tokenizer.row(begin, end, [&](size_t, const Field& field) {
+            headers.push_back(field.str());
+        });
     }
 
-    std::vector<std::string> data = extractRow();
-    if (data.empty()) {
+    // infer column types from the first rows, a column is numeric if all its non-empty values
+    // are numbers
+    std::vector<char> isNumeric;
+    std::vector<char> hasValues;
+    size_t sampled = 0;
+    for (auto p = dataBegin; p != end && sampled < sampleRows;) {
+        std::vector<Field> fields;
+        p = tokenizer.row(p, end, [&](size_t, const Field& field) { fields.push_back(field); });
+        if (std::all_of(fields.begin(), fields.end(), [](const Field& f) { return f.empty(); })) {
+            continue;
+        }
+        if (headers.empty()) {
+            // assign default column headers
+            for (size_t i = 0; i < fields.size(); ++i) {
+                headers.push_back(std::string("Column ") + std::to_string(i + 1));
+            }
+        }
+        isNumeric.resize(headers.size(), 1);
+        hasValues.resize(headers.size(), 0);
+        for (size_t i = 0; i < std::min(fields.size(), headers.size()); ++i) {
+            if (fields[i].empty()) continue;
+            float value;
+            hasValues[i] = 1;
+            isNumeric[i] &= parseFloat(fields[i].begin, fields[i].end, value) ? 1 : 0;
+        }
+        ++sampled;
+    }
+    if (sampled == 0) {
         throw Exception("CSVReader: empty file, no data");
     }
+    const size_t numCols = headers.size();
 
-    if (!firstRowHeader_) {
-        // assign default column headers
-        for (size_t i = 0; i < data.size(); ++i) {
-            headers.push_back(std::string("Column ") + std::to_string(i + 1));
+    // split the data into chunks starting at row boundaries. Quotes are counted in each chunk
+    // to know whether a chunk starts within a quoted field.
+    const size_t dataSize = static_cast<size_t>(end - dataBegin);
+    const size_t numChunks = util::parallelChunks(dataSize, minChunkSize);
+    std::vector<Chunk> chunks(numChunks);
+    std::vector<size_t> quotes(numChunks, 0);
+    auto approxBegin = [&](size_t i) { return dataBegin + i * (dataSize / numChunks); };
+    if (numChunks > 1) {
+        util::parallelFor(numChunks - 1, [&](size_t i) {
+            quotes[i] = std::count(approxBegin(i), approxBegin(i + 1), '"');
+        });
+        // exclusive prefix sum, the number of quotes preceding each chunk
+        size_t count = 0;
+        for (size_t i = 0; i < numChunks; ++i) {
+            const size_t chunkQuotes = quotes[i];
+            quotes[i] = count;
+            count += chunkQuotes;
         }
     }
-    // figure out column types
-    auto dataFrame = plot::createDataFrame(data, headers);
-    size_t rowIndex = firstRowHeader_ ? 1 : 0;
-    while (!data.empty()) {
-        try {
-            // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
-            auto emptyIt = std::find_if(std::begin(data), std::end(data), [](const auto& a) { return !a.empty(); });
-            if (emptyIt != data.end()) {
-                dataFrame->addRow(data);
+    chunks.front().begin = dataBegin;
+    util::parallelFor(numChunks - 1, [&](size_t i) {
+        chunks[i + 1].begin =
+            tokenizer.nextRow(approxBegin(i + 1), end, (quotes[i + 1] & 1) != 0);
+    });
+    for (size_t i = 0; i + 1 < numChunks; ++i) {
+        chunks[i].end = chunks[i + 1].begin;
+    }
+    chunks.back().end = end;
+
+    // count the non-empty rows of each chunk
+    util::parallelFor(numChunks, [&](size_t i) {
+        auto& chunk = chunks[i];
+        for (auto p = chunk.begin; p < chunk.end;) {
+            const auto row = p;
+            size_t cols = 0;
+            bool empty = true;
+            p = tokenizer.row(p, end, [&](size_t, const Field& field) {
+                ++cols;
+                empty &= field.empty();
+            });
+            if (empty) continue;
+            if (cols != numCols) {
+                throw plot::InvalidColCount(
+                    "CSVReader: line " + std::to_string(tokenizer.lineNumber(row)) + " has " +
+                    std::to_string(cols) + " columns, expected " + std::to_string(numCols));
             }
-        } catch (plot::DataTypeMismatch& e) {
-            // Continue reading data since it is not a fatal error
-            LogError("Row " << rowIndex << ": " << e.what());
+            ++chunk.rows;
         }
-        data = extractRow();
-        ++rowIndex;
+    });
+    size_t numRows = 0;
+    for (auto& chunk : chunks) {
+        chunk.rowOffset = numRows;
+        numRows += chunk.rows;
     }
+
+    auto dataFrame = std::make_shared<plot::DataFrame>(0u);
+    std::vector<float*> floatData(numCols, nullptr);
+    std::vector<std::uint32_t*> categoricalData(numCols, nullptr);
+    std::vector<std::shared_ptr<plot::CategoricalColumn>> categoricalColumns(numCols);
+    for (size_t i = 0; i < numCols; ++i) {
+        if (hasValues[i] && isNumeric[i]) {
+            auto col = dataFrame->addColumn<float>(headers[i], numRows);
+            floatData[i] = col->getTypedBuffer()
+                               ->getEditableRAMRepresentation()
+                               ->getDataContainer()
+                               .data();
+        } else {
+            auto col = dataFrame->addCategoricalColumn(headers[i], numRows);
+            categoricalData[i] = col->getTypedBuffer()
+                                     ->getEditableRAMRepresentation()
+                                     ->getDataContainer()
+                                     .data();
+            categoricalColumns[i] = col;
+        }
+    }
+
+    // parse the values into the columns, categorical values get IDs local to each chunk
+    util::parallelFor(numChunks, [&](size_t i) {
+        auto& chunk = chunks[i];
+        chunk.categories.resize(numCols);
+        std::vector<Field> fields;
+        fields.reserve(numCols);
+        size_t row = chunk.rowOffset;
+        for (auto p = chunk.begin; p < chunk.end;) {
+            fields.clear();
+            p = tokenizer.row(p, end, [&](size_t, const Field& field) { fields.push_back(field); });
+            if (std::all_of(fields.begin(), fields.end(), [](const Field& f) { return f.empty(); })) {
+                continue;
+            }
+            for (size_t col = 0; col < numCols; ++col) {
+                const auto& field = fields[col];
+                if (floatData[col]) {
+                    float value = std::numeric_limits<float>::quiet_NaN();
+                    if (!field.empty() && !parseFloat(field.begin, field.end, value)) {
+                        value = std::numeric_limits<float>::quiet_NaN();
+                        if (chunk.invalidValues++ == 0) chunk.firstInvalid = field.begin;
+                    }
+                    floatData[col][row] = value;
+                } else {
+                    categoricalData[col][row] = chunk.categories[col].getID(field, chunk.storage);
+                }
+            }
+            ++row;
+        }
+    });
+
+    // merge the categories of all chunks in order, giving the same IDs as a serial pass
+    for (size_t col = 0; col < numCols; ++col) {
+        if (!categoricalColumns[col]) continue;
+        std::unordered_map<Key, std::uint32_t, KeyHash> ids;
+        std::vector<std::string> categories;
+        std::vector<std::vector<std::uint32_t>> remap(numChunks);
+        for (size_t i = 0; i < numChunks; ++i) {
+            for (const auto& key : chunks[i].categories[col].keys) {
+                auto res = ids.emplace(key, static_cast<std::uint32_t>(categories.size()));
+                if (res.second) categories.emplace_back(key.data, key.size);
+                remap[i].push_back(res.first->second);
+            }
+        }
+        util::parallelFor(numChunks, [&](size_t i) {
+            auto data = categoricalData[col] + chunks[i].rowOffset;
+            std::transform(data, data + chunks[i].rows, data,
+                           [&](std::uint32_t id) { return remap[i][id]; });
+        });
+        categoricalColumns[col]->setCategories(std::move(categories));
+    }
+
+    size_t invalidValues = 0;
+    const char* firstInvalid = nullptr;
+    for (const auto& chunk : chunks) {
+        if (chunk.invalidValues > 0 && !firstInvalid) firstInvalid = chunk.firstInvalid;
+        invalidValues += chunk.invalidValues;
+    }
+    if (invalidValues > 0) {
+        // Not a fatal error, the values are set to NaN
+        LogWarn(invalidValues << " values could not be converted to numbers (first on line "
+                              << tokenizer.lineNumber(firstInvalid) << ")");
+    }
+
     dataFrame->updateIndexBuffer();
     return dataFrame;
 }
@@ -43,6 +43,12 @@ namespace inviwo {
  * \ingroup dataio
  *
  * \brief A reader for comma separated value (CSV) files with customizable delimiters.
+ *
+ * The file is memory mapped and split into chunks at row boundaries which are parsed in
+ * parallel directly into the columns of the resulting DataFrame. Column types are inferred from
+ * the first rows, columns where all values are numbers become float columns, all other columns
+ * are categorical. Fields may be enclosed in double quotes, in which case they can contain
+ * delimiters and line breaks, and a pair of double quotes represents a single quote.
  */
 class IVW_MODULE_PLOTTING_API CSVReader : public DataReaderType<plot::DataFrame> { 
 public:
@@ -57,8 +63,19 @@ public:
     void setDelimiters(const std::string &delim);
     void setFirstRowHeader(bool hasHeader);
 
+    /**
+     * @throws FileException if the file cannot be opened
+     * @throws Exception on unmatched quotes or missing data
+     * @throws plot::InvalidColCount if a row does not match the number of columns
+     */
     virtual std::shared_ptr<plot::DataFrame> readData(const std::string& fileName) override;
 
+    /**
+     * \brief parse CSV data in memory, the range [begin, end) is only accessed during the call.
+     * @see readData
+     */
+    std::shared_ptr<plot::DataFrame> parse(const char* begin, const char* end) const;
+
 private:
     std::string delimiters_;
     bool firstRowHeader_;
@@ -1,15 +1,13 @@
 in vec3 lpickColor;
-in vec2 ltexCoord;
+in vec3 ltexCoord;
 in float lfalloffAlpha;
 
 uniform bool additiveBlend;
 uniform float alpha;
 uniform float lineWidth;
 
-uniform int selected;
 uniform vec4 selectedColor = vec4(1, 0, 0, 1);
 
-uniform int filtered;
 uniform int subtractiveBelnding;
 uniform vec4 filterColor;
 uniform float filterIntensity;
@@ -20,8 +18,9 @@ uniform sampler2D tfSelection;
 
 void main() {
     vec4 res = vec4(1);
+    int state = int(ltexCoord.z + 0.5);  // 0 regular, 1 filtered, 2 selected
 
-    if (selected > 0) {
+    if (state == 2) {
         res = texture(tfSelection, vec2(ltexCoord.y,0.5f));
         //res.rgb = selectedColor.rgb;
     } else {
@@ -29,7 +28,7 @@ void main() {
         if(subtractiveBelnding == 1){
             res.rgb = 1-res.rgb;
         }
-        if (filtered == 1) 
+        if (state == 1) 
              res.xyz = mix(res.xyz, filterColor.xyz, filterIntensity);
         if (additiveBlend) {
             res.a *= alpha * pow(lfalloffAlpha, falllofPower);
@@ -1,11 +1,11 @@
 #include "pcp_common.glsl"
 
 out vec3 pickColor;
-out vec2 texCoord;
+out vec3 texCoord;
 
 
 void main() {
     pickColor = in_Normal.rgb;
-    texCoord = in_TexCoord.xy;
+    texCoord = in_TexCoord.xyz;  // z is the state of the line
     gl_Position = vec4(getPosWithSpacing(vec2(in_Vertex.xy)), 0, 1);
 }
\ No newline at end of file
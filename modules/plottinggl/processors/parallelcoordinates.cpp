@@ -31,7 +31,6 @@
 #include <modules/plottinggl/plottingglmodule.h>
 
 #include <inviwo/core/common/inviwoapplication.h>
-#include <inviwo/core/datastructures/geometry/basicmesh.h>
 #include <inviwo/core/datastructures/geometry/simplemesh.h>
 #include <inviwo/core/datastructures/image/layer.h>
 #include <inviwo/core/datastructures/image/imageram.h>
@@ -40,6 +39,7 @@
 #include <inviwo/core/rendering/meshdrawerfactory.h>
 #include <inviwo/core/util/imagesampler.h>
 #include <inviwo/core/util/rendercontext.h>
+#include <inviwo/core/util/parallel.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <modules/opengl/image/imagegl.h>
 #include <modules/opengl/openglutils.h>
@@ -49,6 +49,11 @@
 #include <modules/opengl/texture/textureutils.h>
 #include <inviwo/core/io/datareaderfactory.h>
 
+#include <warn/push>
+#include <warn/ignore/all>
+#include <numeric>
+#include <warn/pop>
+
 namespace inviwo {
 
 namespace plot {
@@ -71,12 +76,16 @@ struct Axis : public ParallelCoordinates::AxisBase {
         : AxisBase(columnId, name, boolCompositeProperty, usePercentiles, buffer)
         , range_(range)
         , dataVector_(dataVector) {
+        // Only the quartiles are needed, partitioning around them is enough
         auto copy = *dataVector;
-        std::sort(copy.begin(), copy.end());
-        p0_ = copy.front();
-        p25_ = copy[copy.size() * 0.25];
-        p75_ = copy[copy.size() * 0.75];
-        p100_ = copy.back();
+        auto q25 = copy.begin() + static_cast<size_t>(copy.size() * 0.25);
+        auto q75 = copy.begin() + static_cast<size_t>(copy.size() * 0.75);
+        std::nth_element(copy.begin(), q25, copy.end());
+        std::nth_element(q25, q75, copy.end());
+        p0_ = *std::min_element(copy.begin(), q25 + 1);
+        p25_ = *q25;
+        p75_ = *q75;
+        p100_ = *std::max_element(q75, copy.end());
     }
     virtual ~Axis() = default;
 
@@ -146,7 +155,7 @@ struct Axis : public ParallelCoordinates::AxisBase {
     virtual float getRangeMin() const override { return range_->getRangeMin(); }
     virtual float getRangeMax() const override { return range_->getRangeMax(); }
 
-    virtual void updateBrushing(std::unordered_set<size_t> &brushed) override {
+    virtual void updateBrushing(IndexSet &brushed) override {
         auto range = range_->get();
         auto &vec = *dataVector_;
         for (size_t i = 0; i < vec.size(); i++) {
@@ -392,6 +401,7 @@ void ParallelCoordinates::process() {
     if (!lines_ || recreateLines_) {
         buildLineMesh();
     }
+    updateLineStates();
     if (!handleDrawer_) {
         handleDrawer_ =
             getNetwork()->getApplication()->getMeshDrawerFactory()->create(handle_.get());
@@ -541,7 +551,10 @@ void ParallelCoordinates::createOrUpdateProperties() {
 }
 
 void ParallelCoordinates::buildLineMesh() {
-    lines_ = util::make_unique<BasicMesh>();
+    lines_ = util::make_unique<Mesh>(DrawType::Lines, ConnectivityType::None);
+    lineTexCoords_.reset();
+    lineIndices_.reset();
+    lineStates_.clear();
 
     std::vector<AxisBase *> enabledAxis;
     for (auto &p : axisVector_) {
@@ -551,25 +564,27 @@ void ParallelCoordinates::buildLineMesh() {
     }
 
     if (!enabledAxis.size()) {
-        auto mesh = static_cast<BasicMesh *>(lines_.get());
-        linesDrawer_ = std::make_unique<MeshDrawerGL>(mesh);
+        linesDrawer_ = std::make_unique<MeshDrawerGL>(lines_.get());
         recreateLines_ = false;
         LogWarn("DataFrame is empty. No axis to draw.");
         return;
     }
 
-    auto numberOfAxis = enabledAxis.size();
-    auto numberOfLines = dataFrame_.getData()->getNumberOfRows();
-
-    auto mesh = static_cast<BasicMesh *>(lines_.get());
-    mesh->reserveIndexBuffers(numberOfLines);
+    const auto numberOfAxis = enabledAxis.size();
+    const auto numberOfLines = dataFrame_.getData()->getNumberOfRows();
+    const auto numberOfVertices = numberOfAxis * numberOfLines;
+    // All lines share one vertex layout. Row i on axis a is vertex i * numberOfAxis + a. The
+    // brushing state of each line is set in updateLineStates, so brushing and linking never
+    // requires the other attributes to be rebuilt.
+    std::vector<vec3> positions(numberOfVertices);
+    std::vector<vec3> pickColors(numberOfVertices);
+    std::vector<vec3> texCoords(numberOfVertices);
+    std::vector<vec4> colors(numberOfVertices);
 
-    std::vector<BasicMesh::Vertex> vertices;
-    vertices.reserve(numberOfAxis * numberOfLines);
+    linePicking_.resize(numberOfLines);
 
-    linePicking_.resize(dataFrame_.getData()->getNumberOfRows());
-
-    auto sampler = tf_.get();
+    const auto &sampler = tf_.get();
+    const bool subtractive = blendMode_.get() == BlendMode::Sutractive;
 
     auto colorAxisId = selectedColorAxis_.get();
 
@@ -579,37 +594,207 @@ void ParallelCoordinates::buildLineMesh() {
     auto selectionAxes =
         axisVector_[std::min(selectedAxisId_.get(), (int)axisVector_.size() - 1)].get();
 
-    float dx = 1.0f / (numberOfAxis - 1);
-    for (size_t i = 0; i < numberOfLines; i++) {
-        //   if (brushingAndLinking_.isFiltered(i)) continue;
-        auto ib = mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::Strip);
-        auto &ivVector = ib->getDataContainer();
-        ivVector.reserve(enabledAxis.size());
-        size_t col = 0;
+    const float dx = numberOfAxis > 1 ? 1.0f / (numberOfAxis - 1) : 0.0f;
+    util::parallelFor(numberOfAxis, [&](size_t col) {
+        const auto axes = enabledAxis[col];
+        const float x = col * dx;
+        for (size_t i = 0; i < numberOfLines; i++) {
+            positions[i * numberOfAxis + col] = vec3(x, axes->getNormalizedAt(i), 0);
+        }
+    });
 
-        float valueForColor = colorAxes->getNormalizedAt(i);
-        float valueForSelectionColor = selectionAxes->getNormalizedAt(i);
+    const size_t rowsPerTask = 4096;
+    util::parallelFor((numberOfLines + rowsPerTask - 1) / rowsPerTask, [&](size_t task) {
+        const auto end = std::min(numberOfLines, (task + 1) * rowsPerTask);
+        for (size_t i = task * rowsPerTask; i < end; i++) {
+            float valueForColor = colorAxes->getNormalizedAt(i);
+            float valueForSelectionColor = selectionAxes->getNormalizedAt(i);
+
+            vec3 texCoord(valueForColor, valueForSelectionColor, 0.0f);
+            auto color = sampler.sample(valueForColor);
+            if (subtractive) {
+                color.r = 1 - color.r;
+                color.g = 1 - color.g;
+                color.b = 1 - color.b;
+            }
+            vec3 pickColor = linePicking_.getColor(i);
 
-        vec3 texCoord(valueForColor, valueForSelectionColor, 0.0f);
-        auto color = sampler.sample(valueForColor);
-        if (blendMode_.get() == BlendMode::Sutractive) {
-            color.r = 1 - color.r;
-            color.g = 1 - color.g;
-            color.b = 1 - color.b;
+            const auto first = i * numberOfAxis;
+            for (size_t v = first; v < first + numberOfAxis; v++) {
+                pickColors[v] = pickColor;
+                texCoords[v] = texCoord;
+                colors[v] = color;
+            }
         }
-        vec3 pickColor = linePicking_.getColor(i);
+    });
+
+    lines_->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
+    lines_->addBuffer(BufferType::NormalAttrib, util::makeBuffer(std::move(pickColors)));
+    lineTexCoords_ = util::makeBuffer(std::move(texCoords));
+    lines_->addBuffer(BufferType::TexcoordAttrib, lineTexCoords_);
+    lines_->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
+    // Filled in by sortLineSegments
+    lineIndices_ = util::makeIndexBuffer(std::vector<std::uint32_t>{});
+    lines_->addIndicies(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None), lineIndices_);
+    axesPerLine_ = numberOfAxis;
+
+    linesDrawer_ = std::make_unique<MeshDrawerGL>(lines_.get());
+    recreateLines_ = false;
+}
 
-        for (auto &axes : enabledAxis) {
-            vec3 pos(col++ * dx, axes->getNormalizedAt(i), 0);
-            // vec3 pos(col++ * dx, std::log(axes->getNormalizedAt(i) + 1) / std::log(2), 0);
-            ivVector.push_back(static_cast<glm::uint32_t>(vertices.size()));
-            vertices.push_back({pos, pickColor, texCoord, color});
+void ParallelCoordinates::updateLineStates() {
+    if (!lineIndices_ || !dataFrame_.hasData()) return;
+
+    // Subscribe to the changes of the selection and filtering, so that only the lines of the
+    // changed indices have to be updated instead of all lines.
+    auto manager = brushingAndLinking_.getData();
+    if (manager != linkedManager_.lock()) {
+        linkedManager_ = manager;
+        lineStates_.clear();
+        onSelectionChange_.reset();
+        onFilterChange_.reset();
+        if (manager) {
+            auto changed = [this](const IndexSet &added, const IndexSet &removed) {
+                if (lineStates_.empty()) return;  // All lines will be updated anyway
+                if (changedIndices_.size() + added.size() + removed.size() > lineStates_.size()) {
+                    lineStates_.clear();
+                    return;
+                }
+                added.forEach([&](size_t i) { changedIndices_.push_back(i); });
+                removed.forEach([&](size_t i) { changedIndices_.push_back(i); });
+            };
+            onSelectionChange_ = manager->onSelectionChange(changed);
+            onFilterChange_ = manager->onFilterChange(changed);
         }
     }
-    mesh->addVertices(vertices);
 
-    linesDrawer_ = std::make_unique<MeshDrawerGL>(mesh);
-    recreateLines_ = false;
+    auto iCol = dataFrame_.getData()->getIndexColumn();
+    auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
+    const auto numberOfLines = indexCol.size();
+
+    auto stateOf = [&](size_t row) {
+        if (brushingAndLinking_.isFiltered(indexCol[row])) {
+            return LineState::Filtered;
+        } else if (brushingAndLinking_.isSelected(indexCol[row])) {
+            return LineState::Selected;
+        } else {
+            return LineState::Regular;
+        }
+    };
+
+    if (lineStates_.size() != numberOfLines) {
+        rowOfIndex_.clear();
+        bool identity = true;
+        for (size_t i = 0; i < numberOfLines && identity; i++) identity = indexCol[i] == i;
+        if (!identity) {
+            for (size_t i = 0; i < numberOfLines; i++) rowOfIndex_[indexCol[i]] = i;
+        }
+
+        std::vector<LineState> states(numberOfLines);
+        auto &texCoords = lineTexCoords_->getEditableRAMRepresentation()->getDataContainer();
+        const size_t rowsPerTask = 4096;
+        util::parallelFor((numberOfLines + rowsPerTask - 1) / rowsPerTask, [&](size_t task) {
+            const auto end = std::min(numberOfLines, (task + 1) * rowsPerTask);
+            for (size_t i = task * rowsPerTask; i < end; i++) {
+                states[i] = stateOf(i);
+                for (size_t v = i * axesPerLine_; v < (i + 1) * axesPerLine_; v++) {
+                    texCoords[v].z = static_cast<float>(states[i]);
+                }
+            }
+        });
+        lineStates_ = std::move(states);
+        sortLineSegments();
+    } else {
+        for (auto index : changedIndices_) {
+            size_t row = index;
+            if (!rowOfIndex_.empty()) {
+                auto it = rowOfIndex_.find(static_cast<std::uint32_t>(index));
+                if (it == rowOfIndex_.end()) continue;
+                row = it->second;
+            } else if (row >= numberOfLines) {
+                continue;
+            }
+            setLineState(row, stateOf(row));
+        }
+    }
+    changedIndices_.clear();
+
+    // Additive and subtractive blending do not depend on the order in which the lines are drawn,
+    // the other blend modes draw the lines of each state in row order as before they changed.
+    if (!linesInRowOrder_ &&
+        (blendMode_.get() == BlendMode::Regular || blendMode_.get() == BlendMode::None)) {
+        sortLineSegments();
+    }
+}
+
+void ParallelCoordinates::sortLineSegments() {
+    // Sort the lines by state with a counting sort, keeping the row order within each state
+    const auto numberOfLines = lineStates_.size();
+    std::array<size_t, 3> counts{{0, 0, 0}};
+    for (auto state : lineStates_) ++counts[static_cast<size_t>(state)];
+    std::partial_sum(counts.begin(), counts.end(), stateEnds_.begin());
+
+    slotOfLine_.resize(numberOfLines);
+    lineInSlot_.resize(numberOfLines);
+    std::array<size_t, 3> next{{0, stateEnds_[0], stateEnds_[1]}};
+    for (size_t i = 0; i < numberOfLines; i++) {
+        const auto slot = next[static_cast<size_t>(lineStates_[i])]++;
+        slotOfLine_[i] = static_cast<std::uint32_t>(slot);
+        lineInSlot_[slot] = static_cast<std::uint32_t>(i);
+    }
+
+    auto &indices = lineIndices_->getEditableRAMRepresentation()->getDataContainer();
+    indices.resize(2 * (axesPerLine_ > 1 ? axesPerLine_ - 1 : 0) * numberOfLines);
+    const size_t slotsPerTask = 4096;
+    util::parallelFor((numberOfLines + slotsPerTask - 1) / slotsPerTask, [&](size_t task) {
+        const auto end = std::min(numberOfLines, (task + 1) * slotsPerTask);
+        for (size_t slot = task * slotsPerTask; slot < end; slot++) {
+            writeLineSegments(indices, slot);
+        }
+    });
+    linesInRowOrder_ = true;
+}
+
+void ParallelCoordinates::setLineState(size_t line, LineState state) {
+    const auto from = static_cast<size_t>(lineStates_[line]);
+    const auto to = static_cast<size_t>(state);
+    if (from == to) return;
+
+    // Move the line one state at a time by swapping it with the line at the border of its
+    // current state and moving the border, only the slots of these lines are rewritten.
+    auto &indices = lineIndices_->getEditableRAMRepresentation()->getDataContainer();
+    auto swapSlots = [&](size_t a, size_t b) {
+        if (a == b) return;
+        linesInRowOrder_ = false;
+        std::swap(lineInSlot_[a], lineInSlot_[b]);
+        slotOfLine_[lineInSlot_[a]] = static_cast<std::uint32_t>(a);
+        slotOfLine_[lineInSlot_[b]] = static_cast<std::uint32_t>(b);
+        writeLineSegments(indices, a);
+        writeLineSegments(indices, b);
+    };
+    for (size_t s = from; s < to; s++) {
+        swapSlots(slotOfLine_[line], --stateEnds_[s]);
+    }
+    for (size_t s = from; s > to; s--) {
+        swapSlots(slotOfLine_[line], stateEnds_[s - 1]++);
+    }
+
+    lineStates_[line] = state;
+    auto &texCoords = lineTexCoords_->getEditableRAMRepresentation()->getDataContainer();
+    for (size_t v = line * axesPerLine_; v < (line + 1) * axesPerLine_; v++) {
+        texCoords[v].z = static_cast<float>(to);
+    }
+}
+
+void ParallelCoordinates::writeLineSegments(std::vector<std::uint32_t> &indices,
+                                            size_t slot) const {
+    const auto segmentsPerLine = axesPerLine_ > 1 ? axesPerLine_ - 1 : 0;
+    auto out = indices.data() + 2 * segmentsPerLine * slot;
+    const auto first = lineInSlot_[slot] * axesPerLine_;
+    for (size_t v = first; v + 1 < first + axesPerLine_; v++) {
+        *out++ = static_cast<std::uint32_t>(v);
+        *out++ = static_cast<std::uint32_t>(v + 1);
+    }
 }
 
 void ParallelCoordinates::drawAxis(size2_t size, std::vector<AxisBase *> enabledAxis,
@@ -726,46 +911,11 @@ void ParallelCoordinates::drawLines(size2_t size, std::vector<AxisBase *> enable
     lineShader_.setUniform("filterColor", filterColor_.get());
     lineShader_.setUniform("filterIntensity", filterIntensity_.get());
 
-    auto numLines = lines_->getIndexBuffers().size();
-
-    auto drawObject = linesDrawer_->getDrawObject();
-
-    auto iCol = dataFrame_.getData()->getIndexColumn();
-    auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
-
-    std::vector<size_t> filteredIndices;
-    std::vector<size_t> selectIndices;
+    lineShader_.setUniform("showFiltered", showFiltered_.get() ? 1 : 0);
 
-    lineShader_.setUniform("selected", 0);
-    lineShader_.setUniform("filtered", 0);
-    for (size_t i = 0; i < numLines; i++) {
-        if (brushingAndLinking_.isFiltered(indexCol[i])) {
-            if (showFiltered_) {
-                filteredIndices.push_back(i);
-            }
-            continue;
-        }
-        if (brushingAndLinking_.isSelected(indexCol[i])) {
-            selectIndices.push_back(i);
-            continue;
-        }
-        drawObject.draw(i);
-    }
-
-    if (showFiltered_) {
-        lineShader_.setUniform("selected", 0);
-        lineShader_.setUniform("filtered", 1);
-        for (const auto &i : filteredIndices) {
-            drawObject.draw(i);
-        }
-    }
-
-    lineShader_.setUniform("selected", 1);
-    lineShader_.setUniform("filtered", 0);
-    for (const auto &i : selectIndices) {
-        if (brushingAndLinking_.isFiltered(indexCol[i])) continue;
-        drawObject.draw(i);
-    }
+    // The shaders take the state of each line from its vertices, and the segments are sorted by
+    // state, hence a single draw call puts the selected lines on top.
+    if (lineIndices_ && lineIndices_->getSize() > 0) linesDrawer_->draw();
 
     lineShader_.deactivate();
 }
@@ -914,20 +1064,19 @@ void ParallelCoordinates::handlePicked(PickingEvent *p) {
 
 void ParallelCoordinates::updateBrushing() {
     brushingDirty_ = false;
-    std::unordered_set<size_t> brushed;
+    IndexSet brushed;
 
     for (auto &axes : axisVector_) {
         axes->updateBrushing(brushed);
     }
 
-    std::unordered_set<size_t> brushedID;
+    IndexSet brushedID;
     auto iCol = dataFrame_.getData()->getIndexColumn();
     auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-    std::for_each(brushed.begin(), brushed.end(),
-                  [&](const auto &id) { brushedID.insert(indexCol[id]); });
+    brushed.forEach([&](size_t id) { brushedID.insert(indexCol[id]); });
 
-    brushingAndLinking_.sendFilterEvent(brushedID);
+    brushingAndLinking_.sendFilterEvent(std::move(brushedID));
 }
 
 }  // namespace plot
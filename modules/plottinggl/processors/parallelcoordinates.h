@@ -44,6 +44,7 @@
 #include <inviwo/core/properties/transferfunctionproperty.h>
 #include <inviwo/core/rendering/meshdrawer.h>
 #include <modules/brushingandlinking/ports/brushingandlinkingports.h>
+#include <modules/brushingandlinking/brushingandlinkingmanager.h>
 #include <modules/plotting/datastructures/dataframe.h>
 #include <modules/opengl/rendering/meshdrawergl.h>
 #include <modules/opengl/shader/shader.h>
@@ -52,6 +53,11 @@
 #include <modules/plotting/properties/dataframeproperty.h>
 #include <modules/plotting/properties/marginproperty.h>
 
+#include <warn/push>
+#include <warn/ignore/all>
+#include <array>
+#include <warn/pop>
+
 namespace inviwo {
 class Mesh;
 class PickingEvent;
@@ -105,7 +111,7 @@ public:
 
         float getNormalizedAt(size_t idx) const { return getNormalized(at(idx)); }
 
-        virtual void updateBrushing(std::unordered_set<size_t> &brushed) = 0;
+        virtual void updateBrushing(IndexSet &brushed) = 0;
         virtual void updateRange(bool upper, float y) = 0;
     };
 
@@ -113,6 +119,9 @@ public:
 
     enum class LabelPosition { None, Above, Below };
 
+    /// Brushing state of a line, lines are drawn in this order such that selected ones are on top
+    enum class LineState : std::uint8_t { Regular = 0, Filtered = 1, Selected = 2 };
+
 public:
     ParallelCoordinates();
     virtual ~ParallelCoordinates();
@@ -130,6 +139,10 @@ private:
     void createOrUpdateProperties();
 
     void buildLineMesh();
+    void updateLineStates();
+    void sortLineSegments();
+    void setLineState(size_t line, LineState state);
+    void writeLineSegments(std::vector<std::uint32_t> &indices, size_t slot) const;
     void drawAxis(size2_t size, std::vector<AxisBase *> enabledAxis, vec4 extraMargins);
     void drawHandles(size2_t size, std::vector<AxisBase *> enabledAxis, vec4 extraMargins);
     void drawLines(size2_t size, std::vector<AxisBase *> enabledAxis, vec4 extraMargins);
@@ -190,6 +203,26 @@ private:
 
     std::unique_ptr<Mesh> lines_;
     std::unique_ptr<MeshDrawerGL> linesDrawer_;
+    /// The z coordinate holds the LineState of the line of each vertex
+    std::shared_ptr<Buffer<vec3>> lineTexCoords_;
+    /// Segments of all lines, grouped by LineState in the order of the states. Each line has a
+    /// slot of axesPerLine_ - 1 segments, a line changing state is moved by swapping slots.
+    std::shared_ptr<IndexBuffer> lineIndices_;
+    /// False if swapping slots broke the row order of the lines within a state
+    bool linesInRowOrder_ = true;
+    size_t axesPerLine_ = 0;
+    std::vector<LineState> lineStates_;
+    std::vector<std::uint32_t> slotOfLine_;
+    std::vector<std::uint32_t> lineInSlot_;
+    /// One past the last slot of each LineState
+    std::array<size_t, 3> stateEnds_;
+    /// Row of each index of the index column, empty if every index equals its row
+    std::unordered_map<std::uint32_t, size_t> rowOfIndex_;
+    /// Indices whose selection or filtering changed since the last updateLineStates
+    std::vector<size_t> changedIndices_;
+    std::weak_ptr<const BrushingAndLinkingManager> linkedManager_;
+    std::shared_ptr<IndexList::DiffCallback> onSelectionChange_;
+    std::shared_ptr<IndexList::DiffCallback> onFilterChange_;
 
     std::vector<std::unique_ptr<AxisBase>> axisVector_;
 
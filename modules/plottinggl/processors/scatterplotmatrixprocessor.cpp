@@ -199,7 +199,7 @@ void ScatterPlotMatrixProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto brushedIndicies = brushing_.getFilteredIndices();
+        const auto &brushedIndicies = brushing_.getFilteredIndices();
         indicies = std::make_unique<IndexBuffer>();
         auto &vec = indicies->getEditableRAMRepresentation()->getDataContainer();
         vec.reserve(dfSize - brushedIndicies.size());
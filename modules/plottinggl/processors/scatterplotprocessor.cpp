@@ -91,7 +91,7 @@ void ScatterPlotProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto brushedIndicies = brushing_.getFilteredIndices();
+        const auto &brushedIndicies = brushing_.getFilteredIndices();
         IndexBuffer indicies;
         auto &vec = indicies.getEditableRAMRepresentation()->getDataContainer();
         vec.reserve(dfSize - brushedIndicies.size());
@@ -34,6 +34,7 @@
 #include <modules/qtwidgets/properties/transferfunctioneditorcontrolpoint.h>
 #include <modules/qtwidgets/properties/transferfunctioneditor.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/io/rawvolumehistogram.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -144,6 +145,7 @@ void TransferFunctionEditorView::drawForeground(QPainter* painter, const QRectF&
 
 void TransferFunctionEditorView::onVolumeInportInvalid() {
     stopHistCalculation_ = true;
+    volumeHistograms_.reset();
     resetCachedContent();
     update();
 }
@@ -206,29 +208,37 @@ void TransferFunctionEditorView::updateHistogram() {
 
 const HistogramContainer* TransferFunctionEditorView::getNormalizedHistograms() {
     if (volumeInport_ && volumeInport_->hasData()) {
-        if (const auto volumeRAM = volumeInport_->getData()->getRepresentation<VolumeRAM>()) {
-            if (volumeRAM->hasHistograms()) {
-                return volumeRAM->getHistograms(2048, size3_t(1));
-            } else if (!histCalculation_.valid()) {
-
-                const auto done = [this]() {
-                    histCalculation_.get();
-                    updateHistogram();
-                    resetCachedContent();
-                    update();
-                };
-
-                const auto histcalc =
-                    [& stop = stopHistCalculation_, volume = volumeInport_->getData(), done ]()
-                        ->void {
-                    auto ram = volume->getRepresentation<VolumeRAM>();
-                    ram->calculateHistograms(2048, size3_t(1), stop);
-                    dispatchFront(done);
-                    return;
-                };
-                stopHistCalculation_ = false;
-                histCalculation_ = dispatchPool(histcalc);
-            }
+        const auto volume = volumeInport_->getData();
+        if (volume->hasRepresentation<VolumeRAM>()) {
+            const auto volumeRAM = volume->getRepresentation<VolumeRAM>();
+            if (volumeRAM->hasHistograms()) return volumeRAM->getHistograms(2048, size3_t(1));
+        } else if (volumeHistograms_ && histogramVolume_.lock() == volume) {
+            return volumeHistograms_.get();
+        }
+
+        if (!histCalculation_.valid()) {
+            // Volumes that are only on disk are streamed from the raw file if possible, instead
+            // of creating a VolumeRAM representation just for the histograms.
+            const auto done = [this](std::weak_ptr<const Volume> volume,
+                                     std::shared_ptr<const HistogramContainer> histograms) {
+                histCalculation_.get();
+                if (histograms->isValid()) {
+                    histogramVolume_ = volume;
+                    volumeHistograms_ = histograms;
+                }
+                updateHistogram();
+                resetCachedContent();
+                update();
+            };
+
+            const auto histcalc = [& stop = stopHistCalculation_, volume, done ]()->void {
+                auto histograms = std::make_shared<const HistogramContainer>(
+                    util::calculateVolumeHistogram(*volume, stop, 2048, size3_t(1)));
+                dispatchFront(done, std::weak_ptr<const Volume>(volume), histograms);
+                return;
+            };
+            stopHistCalculation_ = false;
+            histCalculation_ = dispatchPool(ThreadPool::Priority::Background, histcalc);
         }
     }
 
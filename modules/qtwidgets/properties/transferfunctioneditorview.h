@@ -79,6 +79,9 @@ private:
 
     bool stopHistCalculation_ = false;
     std::future<void> histCalculation_;
+    // Histograms of volumes without a VolumeRAM representation, calculated from the raw file
+    std::weak_ptr<const Volume> histogramVolume_;
+    std::shared_ptr<const HistogramContainer> volumeHistograms_;
 
     vec2 maskHorizontal_;
 };
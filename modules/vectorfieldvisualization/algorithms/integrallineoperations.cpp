@@ -85,8 +85,31 @@ void curvature(IntegralLine &line, dmat4 toWorld) {
     }
 }
 void curvature(IntegralLineSet &lines) {
-    for (auto &line : lines) {
-        curvature(line, dmat4(lines.getModelMatrix()));
+    if (lines.hasMetaData("curvature")) return;
+    auto &K = lines.addMetaData("curvature", 1, IntegralLineSet::Precision::Float);
+    const auto toWorld = dmat4(lines.getModelMatrix());
+    const auto world = [&](const dvec3 &pos) {
+        dvec4 P = toWorld * dvec4(pos, 1);
+        return dvec3(P) / P.w;
+    };
+
+    const auto &positions = lines.getPositions();
+    for (auto line : lines) {
+        // The first and last point keep zero curvature
+        for (size_t i = line.getOffset() + 1; i + 1 < line.getEnd(); ++i) {
+            auto p = world(positions[i]);
+            auto pm = world(positions[i - 1]);
+            auto pp = world(positions[i + 1]);
+
+            auto nt1 = glm::normalize(pm - p);
+            auto nt2 = glm::normalize(p - pp);
+            auto angle = std::acos(glm::dot(nt1, nt2));
+
+            double a = std::abs(0.5 * glm::length(pp - p));
+            double b = std::abs(0.5 * glm::length(p - pm));
+
+            K.set(i, dvec3(angle / (a + b)));
+        }
     }
 }
 
@@ -130,8 +153,27 @@ void tortuosity(IntegralLine &line, dmat4 toWorld) {
     }
 }
 void tortuosity(IntegralLineSet &lines) {
-    for (auto &line : lines) {
-        tortuosity(line, dmat4(lines.getModelMatrix()));
+    if (lines.hasMetaData("tortuosity")) return;
+    auto &K = lines.addMetaData("tortuosity", 1, IntegralLineSet::Precision::Float);
+    const auto toWorld = dmat4(lines.getModelMatrix());
+    const auto world = [&](const dvec3 &pos) {
+        dvec4 P = toWorld * dvec4(pos, 1);
+        return dvec3(P) / P.w;
+    };
+
+    const auto &positions = lines.getPositions();
+    for (auto line : lines) {
+        if (line.size() == 0) continue;
+        double acuDist = 0;
+        const dvec3 start = world(positions[line.getOffset()]);
+        dvec3 prev = start;
+        for (size_t i = line.getOffset(); i < line.getEnd(); ++i) {
+            const auto p = world(positions[i]);
+            acuDist += glm::distance(prev, p);
+            prev = p;
+            const auto d = glm::distance(start, p);
+            K.set(i, dvec3(d == 0 ? 1.0 : acuDist / d));
+        }
     }
 }
 
@@ -0,0 +1,199 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/vectorfieldvisualization/algorithms/rbfinterpolation.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace util {
+
+double RBFKernel::getSupport(double tolerance) const {
+    if (type == Type::Wendland) return radius;
+    // h * exp(-x^2 / s) < tolerance * h for |x| > sqrt(s * ln(1 / tolerance))
+    return std::abs(center) + std::sqrt(2.0 * M_PI * sigma * sigma * std::log(1.0 / tolerance));
+}
+
+size3_t RBFInterpolation::cellOf(const dvec3 &pos) const {
+    const auto cell = glm::floor((pos - gridMin_) / cellSize_);
+    return size3_t(glm::clamp(cell, dvec3(0.0), dvec3(gridDims_ - size3_t(1))));
+}
+
+template <typename F>
+void RBFInterpolation::forEachNear(const dvec3 &pos, F &&func) const {
+    const auto lo = glm::floor((pos - support_ - gridMin_) / cellSize_);
+    const auto hi = glm::floor((pos + support_ - gridMin_) / cellSize_);
+    if (glm::any(glm::lessThan(hi, dvec3(0.0))) ||
+        glm::any(glm::greaterThanEqual(lo, dvec3(gridDims_)))) {
+        return;
+    }
+    const auto first = size3_t(glm::max(lo, dvec3(0.0)));
+    const auto last = size3_t(glm::min(hi, dvec3(gridDims_ - size3_t(1))));
+
+    for (size_t z = first.z; z <= last.z; ++z) {
+        for (size_t y = first.y; y <= last.y; ++y) {
+            // Cells along x are consecutive
+            const auto begin = cellStart_[cellIndex(size3_t(first.x, y, z))];
+            const auto end = cellStart_[cellIndex(size3_t(last.x, y, z)) + 1];
+            for (size_t k = begin; k < end; ++k) {
+                const auto r = glm::distance(pos, centers_[k]);
+                if (r <= support_) func(k, r);
+            }
+        }
+    }
+}
+
+RBFInterpolation::RBFInterpolation(const std::vector<dvec3> &centers,
+                                   const std::vector<dvec3> &values, const RBFKernel &kernel,
+                                   double shape)
+    : kernel_(kernel), support_(kernel.getSupport()) {
+    if (centers.size() != values.size()) {
+        throw Exception("RBF interpolation needs one value per center", IvwContext);
+    }
+    if (centers.empty()) return;
+
+    // Merge coincident centers, they would give identical rows in the interpolation matrix
+    std::vector<size_t> byPosition(centers.size());
+    std::iota(byPosition.begin(), byPosition.end(), size_t{0});
+    std::sort(byPosition.begin(), byPosition.end(), [&](size_t a, size_t b) {
+        const auto &pa = centers[a];
+        const auto &pb = centers[b];
+        return std::tie(pa.x, pa.y, pa.z) < std::tie(pb.x, pb.y, pb.z);
+    });
+    std::vector<dvec3> uniqueCenters;
+    std::vector<dvec3> uniqueValues;
+    for (size_t first = 0; first < byPosition.size();) {
+        const auto &c = centers[byPosition[first]];
+        size_t last = first;
+        dvec3 sum(0.0);
+        while (last < byPosition.size() && centers[byPosition[last]] == c) {
+            sum += values[byPosition[last++]];
+        }
+        uniqueCenters.push_back(c);
+        uniqueValues.push_back(sum / static_cast<double>(last - first));
+        first = last;
+    }
+    const size_t n = uniqueCenters.size();
+
+    // Sort the centers into a grid, at most 64 cells along each axis
+    dvec3 gridMax = uniqueCenters.front();
+    gridMin_ = uniqueCenters.front();
+    for (const auto &c : uniqueCenters) {
+        gridMin_ = glm::min(gridMin_, c);
+        gridMax = glm::max(gridMax, c);
+    }
+    const dvec3 extent = gridMax - gridMin_;
+    cellSize_ = glm::max(dvec3(support_), extent / 64.0);
+    // Both the extent and the support are zero along such axes, any cell size works then
+    for (size_t i = 0; i < 3; ++i) {
+        if (!(cellSize_[i] > 0.0)) cellSize_[i] = 1.0;
+    }
+    gridDims_ = size3_t(extent / cellSize_) + size3_t(1);
+
+    std::vector<size_t> cells(n);
+    cellStart_.assign(gridDims_.x * gridDims_.y * gridDims_.z + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        cells[i] = cellIndex(cellOf(uniqueCenters[i]));
+        ++cellStart_[cells[i] + 1];
+    }
+    std::partial_sum(cellStart_.begin(), cellStart_.end(), cellStart_.begin());
+
+    std::vector<size_t> order(n);
+    auto next = cellStart_;
+    for (size_t i = 0; i < n; ++i) order[next[cells[i]]++] = i;
+
+    centers_.resize(n);
+    Eigen::MatrixXd b(n, 3);
+    for (size_t k = 0; k < n; ++k) {
+        centers_[k] = uniqueCenters[order[k]];
+        const auto &v = uniqueValues[order[k]];
+        b(k, 0) = v.x;
+        b(k, 1) = v.y;
+        b(k, 2) = v.z;
+    }
+
+    // One factorization for all three components
+    Eigen::MatrixXd x;
+    if (kernel_.type == RBFKernel::Type::Wendland) {
+        std::vector<Eigen::Triplet<double>> triplets;
+        for (size_t k = 0; k < n; ++k) {
+            forEachNear(centers_[k], [&](size_t j, double r) {
+                triplets.emplace_back(static_cast<int>(k), static_cast<int>(j), kernel_(r));
+            });
+        }
+        Eigen::SparseMatrix<double> A(static_cast<int>(n), static_cast<int>(n));
+        A.setFromTriplets(triplets.begin(), triplets.end());
+
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(A);
+        if (solver.info() != Eigen::Success) {
+            throw Exception("Failed to factorize the RBF interpolation matrix", IvwContext);
+        }
+        x = solver.solve(b);
+    } else {
+        Eigen::MatrixXd A(n, n);
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t j = 0; j < n; ++j) {
+                A(k, j) = shape + kernel_(glm::distance(centers_[k], centers_[j]));
+            }
+        }
+        // The Gaussian matrix is positive definite in theory, but close centers make it
+        // numerically semi definite, LDLT then still works where LLT fails.
+        Eigen::LLT<Eigen::MatrixXd> llt(A);
+        if (llt.info() == Eigen::Success) {
+            x = llt.solve(b);
+        } else {
+            Eigen::LDLT<Eigen::MatrixXd> ldlt(A);
+            if (ldlt.info() != Eigen::Success) {
+                throw Exception("Failed to factorize the RBF interpolation matrix", IvwContext);
+            }
+            x = ldlt.solve(b);
+        }
+    }
+
+    weights_.resize(n);
+    for (size_t k = 0; k < n; ++k) weights_[k] = dvec3(x(k, 0), x(k, 1), x(k, 2));
+}
+
+dvec3 RBFInterpolation::evaluate(const dvec3 &pos) const {
+    dvec3 v(0.0);
+    forEachNear(pos, [&](size_t k, double r) { v += weights_[k] * kernel_(r); });
+    return v;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
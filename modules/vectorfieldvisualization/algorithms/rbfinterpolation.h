@@ -0,0 +1,124 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_RBFINTERPOLATION_H
+#define IVW_RBFINTERPOLATION_H
+
+#include <modules/vectorfieldvisualization/vectorfieldvisualizationmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Radial kernel used by RBFInterpolation.
+ * The Gaussian matches Gaussian1DProperty::evaluate, i.e. h * exp(-(r - c)^2 / (2 pi sigma^2)),
+ * and has global support. The Wendland C2 kernel (1 - r/R)^4 (4 r/R + 1) is zero beyond the
+ * radius R, which gives a sparse interpolation matrix.
+ */
+struct IVW_MODULE_VECTORFIELDVISUALIZATION_API RBFKernel {
+    enum class Type { Gaussian, Wendland };
+
+    Type type = Type::Gaussian;
+    double height = 1.0;
+    double center = 0.0;
+    double sigma = 1.0;
+    double radius = 0.5;
+
+    double operator()(double r) const {
+        // A zero radius or sigma degenerates into a spike of the given height
+        if (type == Type::Wendland) {
+            if (r >= radius) return r == 0.0 ? height : 0.0;
+            const double q = r / radius;
+            const double t = 1.0 - q;
+            return height * t * t * t * t * (4.0 * q + 1.0);
+        } else {
+            const double x = r - center;
+            if (sigma == 0.0) return x == 0.0 ? height : 0.0;
+            return height * std::exp(-x * x / (2.0 * M_PI * sigma * sigma));
+        }
+    }
+
+    /**
+     * Distance beyond which the kernel is zero, or below tolerance * height for the Gaussian.
+     */
+    double getSupport(double tolerance = 1e-9) const;
+};
+
+/**
+ * \class RBFInterpolation
+ * \brief Interpolates vector valued samples with radial basis functions.
+ *
+ * The weights of all components are found with a single factorization of the interpolation
+ * matrix, solved for a right hand side with one column per component. Gaussian kernels give a
+ * dense matrix that is factorized with a Cholesky decomposition, where shape is added to every
+ * element as in the RBF vector field generators. Wendland kernels give a sparse matrix that is
+ * factorized with a sparse LDLT and shape is ignored.
+ *
+ * Coincident centers would make the matrix singular, they are merged into one center with the
+ * mean of their values.
+ *
+ * The centers are sorted into a uniform grid with cells the size of the kernel support, so
+ * evaluate only visits the centers close to the position. Note that the support of a Gaussian
+ * is large compared to typical domains, e.g. about 11 for sigma = 1, in which case the grid is a
+ * single cell and every center is visited. evaluate is thread safe.
+ */
+class IVW_MODULE_VECTORFIELDVISUALIZATION_API RBFInterpolation {
+public:
+    RBFInterpolation(const std::vector<dvec3> &centers, const std::vector<dvec3> &values,
+                     const RBFKernel &kernel, double shape = 0.0);
+
+    dvec3 evaluate(const dvec3 &pos) const;
+
+private:
+    size3_t cellOf(const dvec3 &pos) const;
+    size_t cellIndex(const size3_t &cell) const {
+        return cell.x + gridDims_.x * (cell.y + gridDims_.y * cell.z);
+    }
+    template <typename F>
+    void forEachNear(const dvec3 &pos, F &&func) const;
+
+    RBFKernel kernel_;
+    double support_;
+
+    // Centers and weights sorted by grid cell, cell i holds [cellStart_[i], cellStart_[i+1])
+    std::vector<dvec3> centers_;
+    std::vector<dvec3> weights_;
+    std::vector<size_t> cellStart_;
+    dvec3 gridMin_;
+    dvec3 cellSize_;
+    size3_t gridDims_;
+};
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_RBFINTERPOLATION_H
@@ -52,14 +52,17 @@ public:
 
     IntegralLine();
     IntegralLine(const IntegralLine &rhs);
+    IntegralLine(IntegralLine &&rhs) = default;
 
     IntegralLine &operator=(const IntegralLine &that);
+    IntegralLine &operator=(IntegralLine &&that) = default;
 
     virtual ~IntegralLine();
 
     void setTerminationReason(TerminationReason terminationReason) {
         terminationReason_ = terminationReason;
     }
+    TerminationReason getTerminationReason() const { return terminationReason_; }
 
     const std::vector<dvec3> &getPositions() const;
     std::vector<dvec3> &getPositions();
@@ -31,49 +31,277 @@
 
 namespace inviwo {
 
-IntegralLineSet::IntegralLineSet(mat4 modelMatrix) : lines_(), modelMatrix_(modelMatrix) {}
+IntegralLineSet::MetaData::MetaData(const std::string& name, size_t components,
+                                    Precision precision)
+    : name_(name), components_(components), precision_(precision) {
+    if (components_ != 1 && components_ != 3) {
+        throw Exception("Integral line meta data has to have 1 or 3 components, got " +
+                            toString(components) + " for " + name,
+                        IvwContextCustom("IntegralLineSet"));
+    }
+}
+
+size_t IntegralLineSet::MetaData::size() const {
+    return (precision_ == Precision::Float ? floats_.size() : doubles_.size()) / components_;
+}
+
+dvec3 IntegralLineSet::MetaData::get(size_t point) const {
+    const auto i = point * components_;
+    if (precision_ == Precision::Float) {
+        return components_ == 1 ? dvec3(floats_[i])
+                                : dvec3(floats_[i], floats_[i + 1], floats_[i + 2]);
+    } else {
+        return components_ == 1 ? dvec3(doubles_[i])
+                                : dvec3(doubles_[i], doubles_[i + 1], doubles_[i + 2]);
+    }
+}
+
+double IntegralLineSet::MetaData::getScalar(size_t point) const {
+    const auto i = point * components_;
+    return precision_ == Precision::Float ? floats_[i] : doubles_[i];
+}
+
+void IntegralLineSet::MetaData::set(size_t point, const dvec3& value) {
+    const auto i = point * components_;
+    for (size_t c = 0; c < components_; ++c) {
+        if (precision_ == Precision::Float) {
+            floats_[i + c] = static_cast<float>(value[c]);
+        } else {
+            doubles_[i + c] = value[c];
+        }
+    }
+}
+
+void IntegralLineSet::MetaData::push_back(const dvec3& value) {
+    for (size_t c = 0; c < components_; ++c) {
+        if (precision_ == Precision::Float) {
+            floats_.push_back(static_cast<float>(value[c]));
+        } else {
+            doubles_.push_back(value[c]);
+        }
+    }
+}
+
+void IntegralLineSet::MetaData::append(const MetaData& src, size_t begin, size_t end) {
+    if (src.components_ == components_ && src.precision_ == precision_) {
+        if (precision_ == Precision::Float) {
+            floats_.insert(floats_.end(), src.floats_.begin() + begin * components_,
+                           src.floats_.begin() + end * components_);
+        } else {
+            doubles_.insert(doubles_.end(), src.doubles_.begin() + begin * components_,
+                            src.doubles_.begin() + end * components_);
+        }
+    } else {
+        for (size_t i = begin; i < end; ++i) push_back(src.get(i));
+    }
+}
+
+void IntegralLineSet::MetaData::resize(size_t points) {
+    if (precision_ == Precision::Float) {
+        floats_.resize(points * components_, 0.0f);
+    } else {
+        doubles_.resize(points * components_, 0.0);
+    }
+}
+
+void IntegralLineSet::MetaData::reserve(size_t points) {
+    if (precision_ == Precision::Float) {
+        floats_.reserve(points * components_);
+    } else {
+        doubles_.reserve(points * components_);
+    }
+}
+
+size_t IntegralLineSet::MetaData::getMemoryUsage() const {
+    return floats_.capacity() * sizeof(float) + doubles_.capacity() * sizeof(double);
+}
+
+util::iter_range<std::vector<dvec3>::const_iterator> IntegralLineSet::Line::getPositions() const {
+    return util::as_range(set_->positions_.begin() + getOffset(),
+                          set_->positions_.begin() + getEnd());
+}
+
+dvec3 IntegralLineSet::Line::getMetaData(const MetaData& column, size_t i) const {
+    return column.get(getOffset() + i);
+}
+
+IntegralLineSet::TerminationReason IntegralLineSet::Line::getTerminationReason() const {
+    return set_->terminationReasons_[line_];
+}
+
+IntegralLine IntegralLineSet::Line::toIntegralLine() const {
+    IntegralLine line;
+    line.getPositions().assign(set_->positions_.begin() + getOffset(),
+                               set_->positions_.begin() + getEnd());
+    for (const auto& column : set_->metaData_) {
+        auto& m = line.createMetaData(column.getName());
+        m.reserve(size());
+        for (size_t i = getOffset(); i < getEnd(); ++i) m.push_back(column.get(i));
+    }
+    line.setTerminationReason(getTerminationReason());
+    line.setIndex(getIndex());
+    return line;
+}
+
+IntegralLineSet::IntegralLineSet(mat4 modelMatrix)
+    : positions_(), offsets_(1, 0), modelMatrix_(modelMatrix) {}
 
 IntegralLineSet::~IntegralLineSet() {}
 
+IntegralLineSet IntegralLineSet::createEmpty() const {
+    IntegralLineSet set(modelMatrix_);
+    for (const auto& m : metaData_) {
+        set.addMetaData(m.getName(), m.getComponents(), m.getPrecision());
+    }
+    return set;
+}
+
 inviwo::mat4 IntegralLineSet::getModelMatrix() const { return modelMatrix_; }
 
-std::vector<IntegralLine>::const_iterator IntegralLineSet::begin() const { return lines_.begin(); }
+IntegralLineSet::const_iterator IntegralLineSet::begin() const { return const_iterator(this, 0); }
+
+IntegralLineSet::const_iterator IntegralLineSet::end() const {
+    return const_iterator(this, size());
+}
+
+size_t IntegralLineSet::size() const { return indices_.size(); }
+
+bool IntegralLineSet::empty() const { return indices_.empty(); }
+
+size_t IntegralLineSet::getNumberOfPoints() const { return positions_.size(); }
 
-std::vector<IntegralLine>::iterator IntegralLineSet::begin() { return lines_.begin(); }
+IntegralLineSet::Line IntegralLineSet::operator[](size_t idx) const { return Line(*this, idx); }
 
-std::vector<IntegralLine>::const_iterator IntegralLineSet::end() const { return lines_.end(); }
+IntegralLineSet::Line IntegralLineSet::at(size_t idx) const {
+    if (idx >= size()) throw std::out_of_range("Integral line index out of range");
+    return Line(*this, idx);
+}
 
-std::vector<IntegralLine>::iterator IntegralLineSet::end() { return lines_.end(); }
+const std::vector<dvec3>& IntegralLineSet::getPositions() const { return positions_; }
 
-size_t IntegralLineSet::size() const { return lines_.size(); }
+size_t IntegralLineSet::getOffset(size_t line) const { return offsets_[line]; }
 
-inviwo::IntegralLine& IntegralLineSet::operator[](size_t idx) { return lines_[idx]; }
+IntegralLineSet::MetaData& IntegralLineSet::addMetaData(const std::string& name,
+                                                        size_t components,
+                                                        Precision precision) {
+    if (findMetaData(name)) {
+        throw Exception("Meta data already exists: " + name, IvwContext);
+    }
+    metaData_.emplace_back(name, components, precision);
+    metaData_.back().resize(positions_.size());
+    return metaData_.back();
+}
 
-const inviwo::IntegralLine& IntegralLineSet::operator[](size_t idx) const { return lines_[idx]; }
+bool IntegralLineSet::hasMetaData(const std::string& name) const {
+    return findMetaData(name) != nullptr;
+}
 
-inviwo::IntegralLine& IntegralLineSet::at(size_t idx) { return lines_.at(idx); }
+const IntegralLineSet::MetaData& IntegralLineSet::getMetaData(const std::string& name) const {
+    if (auto m = findMetaData(name)) return *m;
+    throw Exception("No meta data with name: " + name, IvwContext);
+}
 
-const inviwo::IntegralLine& IntegralLineSet::at(size_t idx) const { return lines_.at(idx); }
+IntegralLineSet::MetaData& IntegralLineSet::getMetaData(const std::string& name) {
+    if (auto m = findMetaData(name)) return *m;
+    throw Exception("No meta data with name: " + name, IvwContext);
+}
+
+std::vector<std::string> IntegralLineSet::getMetaDataKeys() const {
+    std::vector<std::string> keys;
+    for (const auto& m : metaData_) keys.push_back(m.getName());
+    return keys;
+}
 
-void IntegralLineSet::push_back(IntegralLine &line) {
-    line.setIndex(lines_.size());
-    lines_.push_back(line);
+void IntegralLineSet::reserve(size_t lines, size_t points) {
+    positions_.reserve(points);
+    offsets_.reserve(lines + 1);
+    indices_.reserve(lines);
+    terminationReasons_.reserve(lines);
+    lengths_.reserve(lines);
+    for (auto& m : metaData_) m.reserve(points);
 }
 
-void IntegralLineSet::push_back(IntegralLine &line, size_t idx)
-{
+void IntegralLineSet::push_back(const IntegralLine& line) { push_back(line, line.getIndex()); }
+
+void IntegralLineSet::push_back(IntegralLine& line) { push_back(line, size()); }
+
+void IntegralLineSet::push_back(IntegralLine& line, size_t idx) {
     line.setIndex(idx);
-    lines_.push_back(line);
+    push_back(static_cast<const IntegralLine&>(line), idx);
+}
+
+void IntegralLineSet::push_back(const IntegralLine& line, size_t idx) {
+    const auto& positions = line.getPositions();
+    const auto points = positions.size();
+
+    for (const auto& key : line.getMetaDataKeys()) {
+        if (!findMetaData(key)) addMetaData(key);
+    }
+    for (auto& m : metaData_) {
+        if (line.hasMetaData(m.getName())) {
+            const auto& values = line.getMetaData(m.getName());
+            const auto n = std::min(values.size(), points);
+            for (size_t i = 0; i < n; ++i) m.push_back(values[i]);
+        }
+        m.resize(positions_.size() + points);
+    }
+
+    positions_.insert(positions_.end(), positions.begin(), positions.end());
+    pushLineInfo(idx, line.getTerminationReason(), line.getLength());
+}
+
+void IntegralLineSet::push_back(const Line& line) { push_back(line, line.getIndex()); }
+
+void IntegralLineSet::push_back(const Line& line, size_t idx) {
+    const auto& src = *line.set_;
+    if (&src == this) {  // Our arrays might be reallocated while copying
+        push_back(line.toIntegralLine(), idx);
+        return;
+    }
+    for (const auto& m : src.metaData_) {
+        if (!findMetaData(m.getName())) {
+            addMetaData(m.getName(), m.getComponents(), m.getPrecision());
+        }
+    }
+    for (auto& m : metaData_) {
+        if (auto srcMetaData = src.findMetaData(m.getName())) {
+            m.append(*srcMetaData, line.getOffset(), line.getEnd());
+        } else {
+            m.resize(positions_.size() + line.size());
+        }
+    }
+
+    positions_.insert(positions_.end(), src.positions_.begin() + line.getOffset(),
+                      src.positions_.begin() + line.getEnd());
+    pushLineInfo(idx, line.getTerminationReason(), line.getLength());
+}
+
+size_t IntegralLineSet::getMemoryUsage() const {
+    size_t bytes = positions_.capacity() * sizeof(dvec3) + offsets_.capacity() * sizeof(size_t) +
+                   indices_.capacity() * sizeof(size_t) +
+                   terminationReasons_.capacity() * sizeof(TerminationReason) +
+                   lengths_.capacity() * sizeof(double);
+    for (const auto& m : metaData_) bytes += m.getMemoryUsage();
+    return bytes;
+}
+
+IntegralLineSet::MetaData* IntegralLineSet::findMetaData(const std::string& name) {
+    auto it = std::find_if(metaData_.begin(), metaData_.end(),
+                           [&](const MetaData& m) { return m.getName() == name; });
+    return it != metaData_.end() ? &*it : nullptr;
 }
 
-void IntegralLineSet::push_back(const IntegralLine &line) {
-    lines_.emplace_back(line);
+const IntegralLineSet::MetaData* IntegralLineSet::findMetaData(const std::string& name) const {
+    auto it = std::find_if(metaData_.begin(), metaData_.end(),
+                           [&](const MetaData& m) { return m.getName() == name; });
+    return it != metaData_.end() ? &*it : nullptr;
 }
 
-void IntegralLineSet::push_back(const IntegralLine &line, size_t idx)
-{
-    IntegralLine copy(line);
-    push_back(copy,idx);
+void IntegralLineSet::pushLineInfo(size_t idx, TerminationReason reason, double length) {
+    offsets_.push_back(positions_.size());
+    indices_.push_back(idx);
+    terminationReasons_.push_back(reason);
+    lengths_.push_back(length);
 }
 
 }  // namespace
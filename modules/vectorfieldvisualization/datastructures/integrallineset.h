@@ -36,47 +36,194 @@
 #include <inviwo/core/ports/datainport.h>
 #include <inviwo/core/ports/dataoutport.h>
 #include <inviwo/core/ports/port.h>
+#include <inviwo/core/util/stdextensions.h>
 
 namespace inviwo {
 
 /**
  * \class IntegralLineSet
- * \brief VERY_BRIEFLY_DESCRIBE_THE_CLASS
- * DESCRIBE_THE_CLASS
+ * \brief A set of integral lines stored as a structure of arrays.
+ *
+ * The positions of all lines are stored in one contiguous array, line i covers the points
+ * [getOffset(i), getOffset(i + 1)). Meta data such as velocity or timestamps is stored in
+ * columns with one value per point. Each column is registered once per set with a number of
+ * components (1 or 3) and a precision, so look it up once by name and then index it by point:
+ * \code{.cpp}
+ *     const auto& velocity = lines.getMetaData("velocity");
+ *     for (auto line : lines) {
+ *         for (size_t i = 0; i < line.size(); ++i) {
+ *             auto v = velocity.get(line.getOffset() + i);
+ *         }
+ *     }
+ * \endcode
+ * IntegralLine is still used while tracing, push_back appends its data to the arrays. Meta data
+ * of a line that has no column yet gets a new three component column in double precision.
  */
 class IVW_MODULE_VECTORFIELDVISUALIZATION_API IntegralLineSet {
 public:
+    using TerminationReason = IntegralLine::TerminationReason;
+    enum class Precision { Float, Double };
+
+    /**
+     * A meta data column with one scalar or 3D value per point. Scalars are returned as
+     * dvec3(value) by get, which matches how IntegralLine stores them.
+     */
+    class IVW_MODULE_VECTORFIELDVISUALIZATION_API MetaData {
+    public:
+        MetaData(const std::string& name, size_t components, Precision precision);
+
+        const std::string& getName() const { return name_; }
+        size_t getComponents() const { return components_; }
+        Precision getPrecision() const { return precision_; }
+        size_t size() const;
+
+        dvec3 get(size_t point) const;
+        double getScalar(size_t point) const;
+        void set(size_t point, const dvec3& value);
+
+        void push_back(const dvec3& value);
+        void append(const MetaData& src, size_t begin, size_t end);
+        void resize(size_t points);
+        void reserve(size_t points);
+
+        size_t getMemoryUsage() const;
+
+    private:
+        std::string name_;
+        size_t components_;
+        Precision precision_;
+        std::vector<float> floats_;
+        std::vector<double> doubles_;
+    };
+
+    /**
+     * A view of a single line in the set. It is only valid as long as the set is not modified.
+     */
+    class IVW_MODULE_VECTORFIELDVISUALIZATION_API Line {
+    public:
+        Line(const IntegralLineSet& set, size_t line) : set_(&set), line_(line) {}
+
+        size_t size() const { return getEnd() - getOffset(); }
+        size_t getOffset() const { return set_->offsets_[line_]; }
+        size_t getEnd() const { return set_->offsets_[line_ + 1]; }
+
+        util::iter_range<std::vector<dvec3>::const_iterator> getPositions() const;
+        const dvec3& getPosition(size_t i) const { return set_->positions_[getOffset() + i]; }
+        dvec3 getMetaData(const MetaData& column, size_t i) const;
+
+        size_t getIndex() const { return set_->indices_[line_]; }
+        TerminationReason getTerminationReason() const;
+        double getLength() const { return set_->lengths_[line_]; }
+
+        IntegralLine toIntegralLine() const;
+
+    private:
+        friend class IntegralLineSet;
+        const IntegralLineSet* set_;
+        size_t line_;
+    };
+
+    class IVW_MODULE_VECTORFIELDVISUALIZATION_API const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Line;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Line;
+
+        const_iterator(const IntegralLineSet* set, size_t line) : set_(set), line_(line) {}
+        Line operator*() const { return Line(*set_, line_); }
+        const_iterator& operator++() {
+            ++line_;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto prev = *this;
+            ++line_;
+            return prev;
+        }
+        bool operator==(const const_iterator& rhs) const { return line_ == rhs.line_; }
+        bool operator!=(const const_iterator& rhs) const { return line_ != rhs.line_; }
+
+    private:
+        const IntegralLineSet* set_;
+        size_t line_;
+    };
+
     IntegralLineSet(mat4 modelMatrix);
     virtual ~IntegralLineSet();
 
-    mat4 getModelMatrix() const;
-
-    std::vector<IntegralLine>::const_iterator begin() const;
-    std::vector<IntegralLine>::const_iterator end() const;
+    /**
+     * Create an empty set with the same model matrix and meta data columns as this set
+     */
+    IntegralLineSet createEmpty() const;
 
-    std::vector<IntegralLine>::iterator begin();
-    std::vector<IntegralLine>::iterator end();
+    mat4 getModelMatrix() const;
 
-    const IntegralLine& back() const { return lines_.back(); }
-    IntegralLine& back() { return lines_.back(); }
+    const_iterator begin() const;
+    const_iterator end() const;
 
-    const IntegralLine& front() const { return lines_.front(); }
-    IntegralLine& front() { return lines_.front(); }
+    Line front() const { return Line(*this, 0); }
+    Line back() const { return Line(*this, size() - 1); }
 
+    /**
+     * Number of lines in the set
+     */
     size_t size() const;
+    bool empty() const;
+    size_t getNumberOfPoints() const;
+
+    Line operator[](size_t idx) const;
+    Line at(size_t idx) const;
+
+    const std::vector<dvec3>& getPositions() const;
+    size_t getOffset(size_t line) const;
+
+    /**
+     * Register a meta data column, existing points get zeros. Throws if a column with that name
+     * already exists. References to columns are invalidated when a column is added.
+     */
+    MetaData& addMetaData(const std::string& name, size_t components = 3,
+                          Precision precision = Precision::Double);
+    bool hasMetaData(const std::string& name) const;
+    const MetaData& getMetaData(const std::string& name) const;
+    MetaData& getMetaData(const std::string& name);
+    std::vector<std::string> getMetaDataKeys() const;
+
+    void reserve(size_t lines, size_t points);
+
+    /**
+     * Append a traced line. Its meta data is converted to the registered columns, columns that
+     * the line does not have are filled with zeros. A const line keeps its index unless a new
+     * one is given. A non-const line gets the index size(), or the given one, and is updated to
+     * match.
+     */
+    void push_back(IntegralLine& line);
+    void push_back(IntegralLine& line, size_t idx);
+    void push_back(const IntegralLine& line);
+    void push_back(const IntegralLine& line, size_t idx);
+
+    /**
+     * Append a line from another set by copying its ranges in all columns. The index of the
+     * line is kept unless a new one is given.
+     */
+    void push_back(const Line& line);
+    void push_back(const Line& line, size_t idx);
+
+    size_t getMemoryUsage() const;
 
-    IntegralLine& operator[](size_t idx);
-    const IntegralLine& operator[](size_t idx) const;
+private:
+    MetaData* findMetaData(const std::string& name);
+    const MetaData* findMetaData(const std::string& name) const;
+    void pushLineInfo(size_t idx, TerminationReason reason, double length);
 
-    IntegralLine& at(size_t idx);
-    const IntegralLine& at(size_t idx) const;
-    void push_back(IntegralLine &line);
-    void push_back(IntegralLine &line, size_t idx);
-    void push_back(const IntegralLine &line);
-    void push_back(const IntegralLine &line, size_t idx);
+    std::vector<dvec3> positions_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> indices_;
+    std::vector<TerminationReason> terminationReasons_;
+    std::vector<double> lengths_;
+    std::vector<MetaData> metaData_;
 
-private:
-    std::vector<IntegralLine> lines_;
     mat4 modelMatrix_;
 };
 
@@ -89,7 +236,8 @@ struct port_traits<IntegralLineSet> {
     static uvec3 color_code() { return uvec3(255, 150, 0); }
     static std::string data_info(const IntegralLineSet* data) {
         std::ostringstream oss;
-        oss << "Integral Line Set with " << data->size() << " lines";
+        oss << "Integral Line Set with " << data->size() << " lines and "
+            << data->getNumberOfPoints() << " points";
         return oss.str();
     }
 };
@@ -30,6 +30,13 @@
 #include "pathlinetracer.h"
 #include <inviwo/core/util/volumesequenceutils.h>
 #include <inviwo/core/util/interpolation.h>
+#include <inviwo/core/util/streamingvolumesequencesampler.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <numeric>
+#include <warn/pop>
 
 namespace inviwo {
 
@@ -63,15 +70,7 @@ inviwo::IntegralLine PathLineTracer::traceFrom(const dvec4 &p) {
         step(steps_ / (both ? 2 : 1), p, line, false);
     }
     if (both && !positions.empty()) {
-        std::reverse(positions.begin(),
-            positions.end());  // reverse is faster than insert first
-        positions.pop_back();           // dont repeat first step
-        auto keys = line.getMetaDataKeys();
-        for (auto &key : keys) {
-            auto m = line.getMetaData(key);
-            std::reverse(m.begin(), m.end());  // reverse is faster than insert first
-            m.pop_back();                             // dont repeat first step
-        }
+        reverse(line);
     }
     if (fwd) {
         step(steps_ / (both ? 2 : 1), p, line, true);
@@ -80,42 +79,129 @@ inviwo::IntegralLine PathLineTracer::traceFrom(const dvec4 &p) {
     return line;
 }
 
-void PathLineTracer::step(int steps, dvec4 curPos, IntegralLine &line, bool fwd) {
-    auto& positions = line.getPositions();
+std::vector<IntegralLine> PathLineTracer::traceFrom(const std::vector<dvec4> &seeds) {
+    std::vector<IntegralLine> lines(seeds.size());
 
-    for (int i = 0; i <= steps; i++) {
-        if (!sampler_->withinBounds(curPos)) {
-            line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
-            return;
-        }
-        dvec3 v;
-        switch (integrationScheme_) {
-            case IntegralLineProperties::IntegrationScheme::RK4:
-                v = rk4(curPos, fwd);
-                break;
-            case IntegralLineProperties::IntegrationScheme::Euler:
-            default:
-                v = euler(curPos);
-                break;
-        }
+    auto direction = dir_;
+    bool fwd = direction == IntegralLineProperties::Direction::BOTH ||
+               direction == IntegralLineProperties::Direction::FWD;
+    bool bwd = direction == IntegralLineProperties::Direction::BOTH ||
+               direction == IntegralLineProperties::Direction::BWD;
+    bool both = fwd && bwd;
 
-        if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
-            line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
-            return;
+    for (auto &line : lines) {
+        line.getPositions().reserve(steps_ + 2);
+        line.getMetaData("velocity").reserve(steps_ + 2);
+        line.getMetaData("timestamp").reserve(steps_ + 2);
+    }
+
+    if (bwd) {
+        stepLockstep(steps_ / (both ? 2 : 1), seeds, lines, false);
+    }
+    if (both) {
+        for (auto &line : lines) {
+            if (!line.getPositions().empty()) reverse(line);
         }
+    }
+    if (fwd) {
+        stepLockstep(steps_ / (both ? 2 : 1), seeds, lines, true);
+    }
+
+    return lines;
+}
 
-        dvec3 worldVelocty = sample(curPos);
+void PathLineTracer::traceInto(const std::vector<dvec4> &seeds, IntegralLineSet &lines) {
+    auto traced = traceFrom(seeds);
+    for (size_t i = 0; i < traced.size(); ++i) {
+        if (traced[i].getPositions().size() > 1) lines.push_back(traced[i], lines.size());
+        traced[i] = IntegralLine();  // release the memory as we go
+    }
+}
 
-        dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
+void PathLineTracer::reverse(IntegralLine &line) {
+    auto &positions = line.getPositions();
+    std::reverse(positions.begin(), positions.end());  // reverse is faster than insert first
+    positions.pop_back();                              // dont repeat first step
+    for (auto &key : line.getMetaDataKeys()) {
+        auto &m = line.getMetaData(key);
+        std::reverse(m.begin(), m.end());
+        m.pop_back();
+    }
+}
 
-        positions.push_back(vec3(curPos));
-        line.getMetaData("velocity").push_back(worldVelocty);
-        line.getMetaData("timestamp").push_back(dvec3(curPos.a));
+void PathLineTracer::step(int steps, dvec4 curPos, IntegralLine &line, bool fwd) {
+    for (int i = 0; i <= steps; i++) {
+        if (!advance(curPos, line, fwd)) return;
+    }
+}
+
+void PathLineTracer::stepLockstep(int steps, std::vector<dvec4> curPos,
+                                  std::vector<IntegralLine> &lines, bool fwd) {
+    auto streaming = dynamic_cast<const StreamingVolumeSequenceSampler *>(sampler_.get());
+    const double dt = stepSize_ * (fwd ? 1.0 : -1.0);
+
+    std::vector<size_t> active(lines.size());
+    std::iota(active.begin(), active.end(), 0);
+    std::vector<char> alive(lines.size(), 1);
+
+    for (int i = 0; i <= steps && !active.empty(); i++) {
+        if (streaming) {
+            auto minmax = std::minmax_element(
+                active.begin(), active.end(),
+                [&](size_t a, size_t b) { return curPos[a].w < curPos[b].w; });
+            // An RK4 step samples up to one step size ahead in time
+            streaming->setWindow(curPos[*minmax.first].w + std::min(dt, 0.0),
+                                 curPos[*minmax.second].w + std::max(dt, 0.0), fwd);
+        }
 
-        curPos += dvec4(velocity, stepSize_* (fwd ? 1.0 : -1.0));
+        const size_t chunks = util::parallelChunks(active.size());
+        util::parallelFor(chunks, [&](size_t chunk) {
+            const size_t end = (chunk + 1) * active.size() / chunks;
+            for (size_t j = chunk * active.size() / chunks; j < end; j++) {
+                const auto id = active[j];
+                alive[id] = advance(curPos[id], lines[id], fwd) ? 1 : 0;
+            }
+        });
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](size_t id) { return alive[id] == 0; }),
+                     active.end());
     }
 }
 
+bool PathLineTracer::advance(dvec4 &curPos, IntegralLine &line, bool fwd) {
+    if (!sampler_->withinBounds(curPos)) {
+        line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
+        return false;
+    }
+    dvec3 v;
+    switch (integrationScheme_) {
+        case IntegralLineProperties::IntegrationScheme::RK4:
+            v = rk4(curPos, fwd);
+            break;
+        case IntegralLineProperties::IntegrationScheme::Euler:
+        default:
+            v = euler(curPos);
+            break;
+    }
+
+    if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
+        line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
+        return false;
+    }
+
+    dvec3 worldVelocty = sample(curPos);
+
+    dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
+
+    line.getPositions().push_back(vec3(curPos));
+    line.getMetaData("velocity").push_back(worldVelocty);
+    line.getMetaData("timestamp").push_back(dvec3(curPos.a));
+
+    curPos += dvec4(velocity, stepSize_ * (fwd ? 1.0 : -1.0));
+    return true;
+}
+
 dvec3 PathLineTracer::sample(const dvec4 &pos) {
     return sampler_->sample(pos);
 }
@@ -33,6 +33,7 @@
 #include <modules/vectorfieldvisualization/vectorfieldvisualizationmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <modules/vectorfieldvisualization/datastructures/integralline.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
 #include <modules/vectorfieldvisualization/integrallinetracer.h>
 #include <modules/vectorfieldvisualization/properties/pathlineproperties.h>
 #include <inviwo/core/util/volumesequencesampler.h>
@@ -54,8 +55,28 @@ public:
     IntegralLine traceFrom(const vec4 &p);
     IntegralLine traceFrom(const dvec4 &p);
 
+    /**
+     * Trace all seeds together, one integration step at a time, such that every time step of
+     * the field is only needed while the seeds pass through it. If the sampler is a
+     * StreamingVolumeSequenceSampler its window is moved along with the seeds, so each time step
+     * is read once. The lines are returned in the same order as the seeds.
+     */
+    std::vector<IntegralLine> traceFrom(const std::vector<dvec4> &seeds);
+
+    /**
+     * Trace all seeds together like traceFrom, and append the lines with more than one point to
+     * lines, indexed by their position in the set. Each traced line is released as soon as it
+     * has been appended and lines is not reserved up front, hence the points are moved into the
+     * set instead of being held twice.
+     */
+    void traceInto(const std::vector<dvec4> &seeds, IntegralLineSet &lines);
+
 private:
     void step(int steps, dvec4 curPos, IntegralLine &line, bool fwd);
+    void stepLockstep(int steps, std::vector<dvec4> curPos, std::vector<IntegralLine> &lines,
+                      bool fwd);
+    bool advance(dvec4 &curPos, IntegralLine &line, bool fwd);
+    static void reverse(IntegralLine &line);
 
     dvec3 sample(const dvec4 &pos);
 
@@ -29,6 +29,7 @@
 
 #include "pathlines.h"
 #include <inviwo/core/util/volumesequencesampler.h>
+#include <inviwo/core/util/streamingvolumesequencesampler.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
 #include <inviwo/core/util/imagesampler.h>
 #include <inviwo/core/io/serialization/versionconverter.h>
@@ -67,6 +68,8 @@ PathLines::PathLines()
     , maxVelocity_("minMaxVelocity", "Velocity Range", "0", InvalidationLevel::Valid)
 
     , allowLooping_("allowLooping","Allow looping",true)
+    , streamTimeSteps_("streamTimeSteps", "Stream time steps", false)
+    , prefetchTimeSteps_("prefetchTimeSteps", "Prefetched time steps", 2, 0, 16)
 
 {
 
@@ -90,6 +93,13 @@ PathLines::PathLines()
 
     addProperty(allowLooping_);
     allowLooping_.setVisible(false);
+    addProperty(streamTimeSteps_);
+    streamTimeSteps_.setVisible(false);
+    addProperty(prefetchTimeSteps_);
+    prefetchTimeSteps_.setVisible(false);
+    streamTimeSteps_.onChange([this]() {
+        prefetchTimeSteps_.setVisible(streamTimeSteps_.getVisible() && streamTimeSteps_);
+    });
 
     tf_.get().clearPoints();
     tf_.get().addPoint(vec2(0, 1), vec4(0, 0, 1, 1));
@@ -108,12 +118,21 @@ void PathLines::process() {
         if (sampler_.isConnected()) {
             if (allowLooping_.getVisible()) {
                 allowLooping_.setVisible(false);
+                streamTimeSteps_.setVisible(false);
+                prefetchTimeSteps_.setVisible(false);
             }
             return sampler_.getData();
         }
         else {
             if (!allowLooping_.getVisible()) {
                 allowLooping_.setVisible(true);
+                streamTimeSteps_.setVisible(true);
+                prefetchTimeSteps_.setVisible(streamTimeSteps_);
+            }
+            if (streamTimeSteps_) {
+                // Only keep the time steps around the seeds in memory
+                return std::make_shared<StreamingVolumeSequenceSampler>(
+                    volume_.getData(), prefetchTimeSteps_.get(), allowLooping_.get());
             }
             auto s = std::make_shared<VolumeSequenceSampler>(volume_.getData());
             s->setAllowedLooping(allowLooping_.get());
@@ -142,30 +161,27 @@ void PathLines::process() {
 
     auto lines = std::make_shared<IntegralLineSet>(sampler->getModelMatrix());
     std::vector<BasicMesh::Vertex> vertices;
-    size_t startID = 0;
+    std::vector<dvec4> seedPositions;
     for (const auto &seeds : seedPoints_) {
-#pragma omp parallel for
-        for (long long j = 0; j < static_cast<long long>(seeds->size());j++){
-            const auto &p = (*seeds)[j];
+        for (const auto &p : *seeds) {
             vec4 P = m * vec4(p, 1.0f);
-            auto line = tracer.traceFrom(vec4(vec3(P), pathLineProperties_.getStartT()));
-            auto size = line.getPositions().size();
-            if (size>1) {  
-                #pragma omp critical
-                //lines->push_back(line, startID + j);
-                lines->push_back(line, lines->size());
-            };
+            seedPositions.emplace_back(vec3(P), pathLineProperties_.getStartT());
         }
-        startID += seeds->size();
     }
-
-    for (auto &line : *lines) {
-        auto size = line.getPositions().size();
+    lines->addMetaData("velocity", 3, IntegralLineSet::Precision::Float);
+    lines->addMetaData("timestamp", 1, IntegralLineSet::Precision::Double);
+    // All seeds are traced together such that each time step only is visited once
+    tracer.traceInto(seedPositions, *lines);
+
+    const auto &velocities = lines->getMetaData("velocity");
+    const auto &timestamps = lines->getMetaData("timestamp");
+    vertices.reserve(lines->getNumberOfPoints());
+    for (auto line : *lines) {
+        auto size = line.size();
         if (size <= 1) continue;
 
         auto position = line.getPositions().begin();
-        auto velocity = line.getMetaData("velocity").begin();
-        auto timestamp = line.getMetaData("timestamp").begin();
+        auto point = line.getOffset();
 
         auto indexBuffer =
             mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
@@ -186,8 +202,8 @@ void PathLines::process() {
 
         for (size_t ii = 0; ii < size; ii++) {
             vec3 pos(*position);
-            vec3 v(*velocity);
-            float t = static_cast<float>((*timestamp).x);
+            vec3 v(velocities.get(point));
+            float t = static_cast<float>(timestamps.getScalar(point));
 
             float l = glm::length(v);
             float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
@@ -219,8 +235,7 @@ void PathLines::process() {
             vertices.push_back({ pos,glm::normalize(v),pos,c });
 
             position++;
-            velocity++;
-            timestamp++;
+            point++;
         }
         indexBuffer->add(static_cast<std::uint32_t>(vertices.size() - 1));
     }
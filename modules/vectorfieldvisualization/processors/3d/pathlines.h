@@ -40,6 +40,7 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 
 #include <modules/vectorfieldvisualization/ports/seedpointsport.h>
 #include <modules/vectorfieldvisualization/properties/pathlineproperties.h>
@@ -115,6 +116,8 @@ private:
     StringProperty maxVelocity_;
 
     BoolProperty allowLooping_;
+    BoolProperty streamTimeSteps_;
+    IntSizeTProperty prefetchTimeSteps_;
 };
 
 } // namespace
@@ -34,7 +34,7 @@ StreamLines::StreamLines()
     , tf_("transferFunction", "Transfer Function")
     , velocityScale_("velocityScale_", "Velocity Scale (inverse)", 1, 0, 10)
     , maxVelocity_("minMaxVelocity", "Velocity Range", "0", InvalidationLevel::Valid)
-    , useOpenMP_("useOpenMP","Use OpenMP",true)
+    , useMultipleThreads_("useOpenMP","Use Multiple Threads",true)
 {
 
 
@@ -49,7 +49,7 @@ StreamLines::StreamLines()
 
     addProperty(streamLineProperties_);
 
-    addProperty(useOpenMP_);
+    addProperty(useMultipleThreads_);
     addProperty(tf_);
     addProperty(velocityScale_);
     addProperty(maxVelocity_);
@@ -90,45 +90,21 @@ void StreamLines::process() {
 
     std::vector<BasicMesh::Vertex> vertices;
 
-    if (useOpenMP_) {
-        size_t startID = 0;
-        for (const auto &seeds : seedPoints_) {
-#pragma omp parallel for
-            for (long long j = 0; j < static_cast<long long>(seeds->size()); j++) {
-                auto p = seeds->at(j);
-                vec4 P = m * vec4(p, 1.0f);
-                auto line = tracer.traceFrom(vec3(P));
-                auto size = line.getPositions().size();
-                if (size > 1) {
-#pragma omp critical
-                    lines->push_back(line, startID + j);
-                };
-            }
-            startID += seeds->size();
-        }
-    }
-    else {
-        size_t startID = 0;
-        for (const auto &seeds : seedPoints_) {
-            for(const auto &p : *seeds.get()){
-                vec4 P = m * vec4(p, 1.0f);
-                auto line = tracer.traceFrom(vec3(P));
-                auto size = line.getPositions().size();
-                if (size > 1) {
-                    lines->push_back(line, startID);
-                }
-                startID++;
-            }
-        }
+    std::vector<dvec3> seeds;
+    for (const auto &points : seedPoints_) {
+        for (const auto &p : *points) seeds.push_back(dvec3(vec3(m * vec4(p, 1.0f))));
     }
 
+    lines->addMetaData("velocity", 3, IntegralLineSet::Precision::Float);
+    tracer.traceInto(seeds, *lines, useMultipleThreads_.get());
 
-
-    for (auto &line : *lines) {
+    const auto &velocities = lines->getMetaData("velocity");
+    vertices.reserve(lines->getNumberOfPoints());
+    for (auto line : *lines) {
             auto position = line.getPositions().begin();
-            auto velocity = line.getMetaData("velocity").begin();
+            auto point = line.getOffset();
 
-            auto size = line.getPositions().size();
+            auto size = line.size();
             if (size <= 1) continue;
 
             auto indexBuffer =
@@ -138,9 +114,9 @@ void StreamLines::process() {
 
             for (size_t i = 0; i < size; i++) {
                 vec3 pos(*position);
-                vec3 v(*velocity);
+                vec3 v(velocities.get(point));
 
-                float l = glm::length(vec3(*velocity));
+                float l = glm::length(v);
                 float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
                 maxVelocity = std::max(maxVelocity, l);
                 auto c = vec4(tf_.get().sample(d));
@@ -150,7 +126,7 @@ void StreamLines::process() {
                 vertices.push_back({pos, glm::normalize(v), pos, c});
 
                 position++;
-                velocity++;
+                point++;
             }
             indexBuffer->add(static_cast<std::uint32_t>(vertices.size() - 1));
         }
@@ -81,7 +81,7 @@ protected:
     FloatProperty velocityScale_;
     StringProperty maxVelocity_;
 
-    BoolProperty useOpenMP_;
+    BoolProperty useMultipleThreads_;
 };
 
 }  // namespace
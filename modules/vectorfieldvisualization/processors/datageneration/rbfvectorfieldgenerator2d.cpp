@@ -33,11 +33,7 @@
 #include <inviwo/core/datastructures/image/image.h>
 #include <inviwo/core/datastructures/image/layerram.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
-
-#include <warn/push>
-#include <warn/ignore/all>
-#include <Eigen/Dense>
-#include <warn/pop>
+#include <inviwo/core/util/parallel.h>
 
 namespace inviwo {
 
@@ -56,12 +52,14 @@ RBFVectorFieldGenerator2D::RBFVectorFieldGenerator2D()
     : Processor()
     , vectorField_("vectorField", DataVec2Float32::get(), false)
     , size_("size", "Volume size", ivec2(700, 700), ivec2(1, 1), ivec2(1024, 1024))
-    , seeds_("seeds", "Number of seeds", 9, 1, 100)
+    , seeds_("seeds", "Number of seeds", 9, 1, 1000)
     , randomness_("randomness", "Randomness")
     , useSameSeed_("useSameSeed", "Use same seed", true)
     , seed_("seed", "Seed", 1, 0, std::numeric_limits<int>::max())
+    , kernel_("kernel", "Kernel")
     , shape_("shape", "Shape Parameter", 1.2f, 0.0001f, 10.0f, 0.0001f)
     , gaussian_("gaussian", "Gaussian")
+    , supportRadius_("supportRadius", "Support Radius", 0.5f, 0.01f, 4.0f, 0.01f)
 
     , rd_()
     , mt_(rd_())
@@ -71,8 +69,22 @@ RBFVectorFieldGenerator2D::RBFVectorFieldGenerator2D()
 
     addProperty(size_);
     addProperty(seeds_);
+    addProperty(kernel_);
     addProperty(shape_);
     addProperty(gaussian_);
+    addProperty(supportRadius_);
+
+    kernel_.addOption("gaussian", "Gaussian", util::RBFKernel::Type::Gaussian);
+    kernel_.addOption("wendland", "Wendland (compact support)", util::RBFKernel::Type::Wendland);
+    kernel_.setCurrentStateAsDefault();
+    auto updateVisibility = [this]() {
+        const bool gaussian = kernel_.get() == util::RBFKernel::Type::Gaussian;
+        shape_.setVisible(gaussian);
+        gaussian_.setVisible(gaussian);
+        supportRadius_.setVisible(!gaussian);
+    };
+    kernel_.onChange(updateVisibility);
+    updateVisibility();
 
     addProperty(randomness_);
     randomness_.addProperty(useSameSeed_);
@@ -88,26 +100,22 @@ void RBFVectorFieldGenerator2D::process() {
         createSamples();
     }
 
-    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(seeds_.get(), seeds_.get());
-    Eigen::VectorXd bx = Eigen::VectorXd::Zero(seeds_.get()), by(seeds_.get());
-    Eigen::VectorXd xx = Eigen::VectorXd::Zero(seeds_.get()), xy(seeds_.get());
-
-    int row = 0;
-    for (auto &a : samples_) {
-        int col = 0;
-        for (auto &b : samples_) {
-            auto r = glm::distance(a.first, b.first);
-            A(row, col++) = shape_.get() + gaussian_.evaluate(r);
-        }
-        bx(row) = a.second.x;
-        by(row++) = a.second.y;
+    util::RBFKernel kernel;
+    kernel.type = kernel_.get();
+    // The Gaussian properties are hidden for the Wendland kernel, which uses a height of one
+    if (kernel.type == util::RBFKernel::Type::Gaussian) {
+        kernel.height = gaussian_.height_.get();
+        kernel.center = gaussian_.center_.get();
+        kernel.sigma = gaussian_.sigma_.get();
     }
+    kernel.radius = supportRadius_.get();
 
-    auto solverX = A.llt();
-    auto solverY = A.llt();
-
-    xx = solverX.solve(bx);
-    xy = solverY.solve(by);
+    std::vector<dvec3> centers, values;
+    for (auto &sample : samples_) {
+        centers.emplace_back(sample.first, 0.0);
+        values.emplace_back(sample.second, 0.0);
+    }
+    const util::RBFInterpolation rbf(centers, values, kernel, shape_.get());
 
     auto img = std::make_shared<Image>(size_.get(), DataVec2Float32::get());
     img->getColorLayer()->setSwizzleMask(
@@ -115,25 +123,18 @@ void RBFVectorFieldGenerator2D::process() {
     auto data =
         static_cast<vec2 *>(img->getColorLayer()->getEditableRepresentation<LayerRAM>()->getData());
 
-    int i = 0;
-    for (int y = 0; y < size_.get().y; y++) {
-        for (int x = 0; x < size_.get().x; x++) {
+    const auto dims = size_.get();
+    util::parallelFor(dims.y, [&](size_t y) {
+        auto row = data + y * dims.x;
+        for (int x = 0; x < dims.x; x++) {
             dvec2 p(x, y);
-            p /= size_.get();
+            p /= dims;
             p *= 2;
             p -= 1;
 
-            vec2 v(0, 0);
-            int s = 0;
-            for (; s < seeds_.get(); s++) {
-                double r = glm::distance(p, samples_[s].first);
-                auto w = gaussian_.evaluate(r);
-                v.x += static_cast<float>(xx(s) * w);
-                v.y += static_cast<float>(xy(s) * w);
-            }
-            data[i++] = v;
+            *row++ = vec2(rbf.evaluate(dvec3(p, 0.0)));
         }
-    }
+    });
     vectorField_.setData(img);
 }
 
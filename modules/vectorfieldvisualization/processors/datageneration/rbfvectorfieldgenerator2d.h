@@ -38,6 +38,8 @@
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/ports/meshport.h>
 #include <modules/base/properties/gaussianproperty.h>
+#include <modules/vectorfieldvisualization/algorithms/rbfinterpolation.h>
+#include <inviwo/core/properties/optionproperty.h>
 #include <random>
 
 namespace inviwo {
@@ -72,8 +74,10 @@ protected:
     CompositeProperty randomness_;
     BoolProperty useSameSeed_;
     IntProperty seed_;
+    TemplateOptionProperty<util::RBFKernel::Type> kernel_;
     FloatProperty shape_;
     Gaussian1DProperty gaussian_;
+    FloatProperty supportRadius_;
 
     std::random_device rd_;
     std::mt19937 mt_;
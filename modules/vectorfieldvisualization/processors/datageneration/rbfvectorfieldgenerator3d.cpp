@@ -33,11 +33,7 @@
 #include <inviwo/core/datastructures/image/image.h>
 #include <inviwo/core/datastructures/image/layerram.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
-
-#include <warn/push>
-#include <warn/ignore/all>
-#include <Eigen/Dense>
-#include <warn/pop>
+#include <inviwo/core/util/parallel.h>
 
 namespace inviwo {
 const ProcessorInfo RBFVectorFieldGenerator3D::processorInfo_{
@@ -55,13 +51,15 @@ RBFVectorFieldGenerator3D::RBFVectorFieldGenerator3D()
     , volume_("volume")
     , mesh_("mesh")
     , size_("size", "Volume size", size3_t(32, 32, 32), size3_t(1, 1, 1), size3_t(1024, 1024, 1024))
-    , seeds_("seeds", "Number of seeds", 6, 1, 100)
+    , seeds_("seeds", "Number of seeds", 6, 1, 1000)
 
     , randomness_("randomness", "Randomness")
     , useSameSeed_("useSameSeed", "Use same seed", true)
     , seed_("seed", "Seed", 1, 0, std::numeric_limits<int>::max())
+    , kernel_("kernel", "Kernel")
     , shape_("shape", "Shape Parameter", 1.2f, 0.0001f, 10.0f, 0.0001f)
     , gaussian_("gaussian", "Gaussian")
+    , supportRadius_("supportRadius", "Support Radius", 0.5f, 0.01f, 4.0f, 0.01f)
 
     , debugMesh_("debug", "Debug Mesh Settings")
     , sphereRadius_("radius", "Radius", 0.1f)
@@ -77,8 +75,22 @@ RBFVectorFieldGenerator3D::RBFVectorFieldGenerator3D()
 
     addProperty(size_);
     addProperty(seeds_);
+    addProperty(kernel_);
     addProperty(shape_);
     addProperty(gaussian_);
+    addProperty(supportRadius_);
+
+    kernel_.addOption("gaussian", "Gaussian", util::RBFKernel::Type::Gaussian);
+    kernel_.addOption("wendland", "Wendland (compact support)", util::RBFKernel::Type::Wendland);
+    kernel_.setCurrentStateAsDefault();
+    auto updateVisibility = [this]() {
+        const bool gaussian = kernel_.get() == util::RBFKernel::Type::Gaussian;
+        shape_.setVisible(gaussian);
+        gaussian_.setVisible(gaussian);
+        supportRadius_.setVisible(!gaussian);
+    };
+    kernel_.onChange(updateVisibility);
+    updateVisibility();
 
     addProperty(randomness_);
     randomness_.addProperty(useSameSeed_);
@@ -129,29 +141,22 @@ void RBFVectorFieldGenerator3D::process() {
         mesh_.setData(mesh);
     }
 
-    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(seeds_.get(), seeds_.get());
-    Eigen::VectorXd bx = Eigen::VectorXd::Zero(seeds_.get()), by(seeds_.get()), bz(seeds_.get());
-    Eigen::VectorXd xx = Eigen::VectorXd::Zero(seeds_.get()), xy(seeds_.get()), xz(seeds_.get());
-
-    int row = 0;
-    for (auto &a : samples) {
-        int col = 0;
-        for (auto &b : samples) {
-            auto r = glm::distance(a.first, b.first);
-            A(row, col++) = shape_.get() + gaussian_.evaluate(r);
-        }
-        bx(row) = a.second.x;
-        by(row) = a.second.y;
-        bz(row++) = a.second.z;
+    util::RBFKernel kernel;
+    kernel.type = kernel_.get();
+    // The Gaussian properties are hidden for the Wendland kernel, which uses a height of one
+    if (kernel.type == util::RBFKernel::Type::Gaussian) {
+        kernel.height = gaussian_.height_.get();
+        kernel.center = gaussian_.center_.get();
+        kernel.sigma = gaussian_.sigma_.get();
     }
+    kernel.radius = supportRadius_.get();
 
-    auto solverX = A.llt();
-    auto solverY = A.llt();
-    auto solverZ = A.llt();
-
-    xx = solverX.solve(bx);
-    xy = solverY.solve(by);
-    xz = solverZ.solve(bz);
+    std::vector<dvec3> centers, values;
+    for (auto &sample : samples) {
+        centers.push_back(sample.first);
+        values.push_back(sample.second);
+    }
+    const util::RBFInterpolation rbf(centers, values, kernel, shape_.get());
 
     auto volume = std::make_shared<Volume>(size_.get(), DataVec3Float32::get());
     volume->dataMap_.dataRange = vec2(0, 1);
@@ -161,28 +166,20 @@ void RBFVectorFieldGenerator3D::process() {
 
     auto data = static_cast<vec3 *>(volume->getEditableRepresentation<VolumeRAM>()->getData());
 
-    int i = 0;
-    for (size_t z = 0; z < size_.get().z; z++) {
-        for (size_t y = 0; y < size_.get().y; y++) {
-            for (size_t x = 0; x < size_.get().x; x++) {
+    const auto dims = size_.get();
+    util::parallelFor(dims.z, [&](size_t z) {
+        auto slice = data + z * dims.x * dims.y;
+        for (size_t y = 0; y < dims.y; y++) {
+            for (size_t x = 0; x < dims.x; x++) {
                 dvec3 p(x, y, z);
-                p /= size_.get();
+                p /= dims;
                 p *= 2;
                 p -= 1;
 
-                vec3 v(0, 0, 0);
-                int s = 0;
-                for (; s < seeds_.get(); s++) {
-                    double r = glm::distance(p, samples[s].first);
-                    v.x += static_cast<float>(xx(s) * gaussian_.evaluate(r));
-                    v.y += static_cast<float>(xy(s) * gaussian_.evaluate(r));
-                    v.z += static_cast<float>(xz(s) * gaussian_.evaluate(r));
-                }
-
-                data[i++] = v;
+                *slice++ = vec3(rbf.evaluate(p));
             }
         }
-    }
+    });
 
     volume_.setData(volume);
 }
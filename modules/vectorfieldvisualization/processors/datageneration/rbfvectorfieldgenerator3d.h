@@ -37,6 +37,8 @@
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/ports/meshport.h>
 #include <modules/base/properties/gaussianproperty.h>
+#include <modules/vectorfieldvisualization/algorithms/rbfinterpolation.h>
+#include <inviwo/core/properties/optionproperty.h>
 #include <random>
 
 namespace inviwo {
@@ -67,8 +69,10 @@ protected:
     CompositeProperty randomness_;
     BoolProperty useSameSeed_;
     IntProperty seed_;
+    TemplateOptionProperty<util::RBFKernel::Type> kernel_;
     FloatProperty shape_;
     Gaussian1DProperty gaussian_;
+    FloatProperty supportRadius_;
 
     CompositeProperty debugMesh_;
     FloatProperty sphereRadius_;
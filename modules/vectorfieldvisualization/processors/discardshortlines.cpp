@@ -73,7 +73,7 @@ DiscardShortLines::DiscardShortLines()
 
         double maxL = 0;
         double minL = std::numeric_limits<double>::max();
-        for (const auto &line : lines) {
+        for (auto line : lines) {
             auto l = line.getLength();
             maxL = std::max(maxL, l);
             minL = std::min(minL, l);
@@ -95,13 +95,26 @@ void DiscardShortLines::process() {
     auto linesData = linesIn_.getData();
     auto &lines = *linesData;
 
-    auto outLinesData = std::make_shared<IntegralLineSet>(lines.getModelMatrix());
-    auto filteredLinesData = std::make_shared<IntegralLineSet>(lines.getModelMatrix());
+    const auto minLength = minLength_.get();
+    const auto kept = std::count_if(lines.begin(), lines.end(), [&](IntegralLineSet::Line line) {
+        return line.getLength() >= minLength;
+    });
+
+    // Pass the input through when nothing is discarded
+    if (static_cast<size_t>(kept) == lines.size()) {
+        linesOut_.setData(linesData);
+        removedLines_.setData(std::make_shared<IntegralLineSet>(lines.createEmpty()));
+        return;
+    }
+
+    // Keep the columns of the input even if all lines end up in one of the outputs
+    auto outLinesData = std::make_shared<IntegralLineSet>(lines.createEmpty());
+    auto filteredLinesData = std::make_shared<IntegralLineSet>(lines.createEmpty());
     auto &outLines = *outLinesData;
     auto &filteredLines = *filteredLinesData;
 
-    for (const auto &line : lines) {
-        bool keep = line.getLength() >= minLength_.get();
+    for (auto line : lines) {
+        bool keep = line.getLength() >= minLength;
 
         if (keep) {
             outLines.push_back(line, line.getIndex());
@@ -36,11 +36,10 @@
 namespace inviwo {
 namespace {
 struct MetaDataSampler {
-    MetaDataSampler(const IntegralLine &line, std::string name)
-        : hasMetaData_(line.hasMetaData(name)), v(0), dv(0) {
-        if (hasMetaData_) {
-            it = line.getMetaData(name).begin();
-            v = *it;
+    MetaDataSampler(const IntegralLineSet::MetaData *column, const IntegralLineSet::Line &line)
+        : column_(column), point_(line.getOffset()), end_(line.getEnd()), v(0), dv(0) {
+        if (column_) {
+            v = column_->get(point_);
         }
     }
 
@@ -48,9 +47,8 @@ struct MetaDataSampler {
     operator const dvec3 &() const { return v; }
 
     dvec3 operator++() {
-        if (hasMetaData_) {
-            it++;
-            v = *it;
+        if (column_) {
+            if (point_ + 1 < end_) v = column_->get(++point_);
         } else {
             v += dv;
         }
@@ -63,23 +61,29 @@ struct MetaDataSampler {
     }
 
 protected:
-    std::vector<dvec3>::const_iterator it;
-    bool hasMetaData_;
+    const IntegralLineSet::MetaData *column_;
+    size_t point_;
+    size_t end_;
     dvec3 v;
     dvec3 dv;
 };
 
 struct Timestep : public MetaDataSampler {
-    Timestep(const IntegralLine &line) : MetaDataSampler(line, "timestamp") {
-        hasMetaData_ = line.hasMetaData("timestamp");
-        if (!hasMetaData_) {
-            dv = dvec3(1.0 / (line.getPositions().size() - 1));
+    Timestep(const IntegralLineSet::MetaData *column, const IntegralLineSet::Line &line)
+        : MetaDataSampler(column, line) {
+        if (!column_) {
+            dv = dvec3(1.0 / (line.size() - 1));
         }
     }
 
     operator double &() { return v.x; }
     operator const double &() const { return v.x; }
 };
+
+const IntegralLineSet::MetaData *findMetaData(const IntegralLineSet &lines,
+                                              const std::string &name) {
+    return lines.hasMetaData(name) ? &lines.getMetaData(name) : nullptr;
+}
 }  // namespace
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -157,15 +161,17 @@ IntegralLineVectorToMesh::IntegralLineVectorToMesh()
             float minT = std::numeric_limits<float>::max();
             float maxT = std::numeric_limits<float>::lowest();
 
-            for (auto &line : (*lines_.getData())) {
-                auto size = line.getPositions().size();
+            const auto &lines = *lines_.getData();
+            const auto timestamps = findMetaData(lines, "timestamp");
+            for (auto line : lines) {
+                auto size = line.size();
                 if (size == 0) continue;
 
                 if (!ignoreBrushingList_.get() && brushingList_.isFiltered(line.getIndex())) {
                     continue;
                 }
 
-                Timestep t(line);
+                Timestep t(timestamps, line);
                 for (size_t ii = 0; ii < size; ii++) {
                     float tt = static_cast<float>((t++).x);
                     minT = std::min(minT, tt);
@@ -183,13 +189,14 @@ IntegralLineVectorToMesh::IntegralLineVectorToMesh()
 void IntegralLineVectorToMesh::process() {
     auto mesh = std::make_shared<BasicMesh>();
 
-    mesh->setModelMatrix(lines_.getData()->getModelMatrix());
+    const auto &lines = *lines_.getData();
+    mesh->setModelMatrix(lines.getModelMatrix());
 
     std::vector<BasicMesh::Vertex> vertices;
     float maxVelocity = 0;
     float maxCurvature = 0;
 
-    vertices.reserve(lines_.getData()->size() * 2000);
+    vertices.reserve(lines.getNumberOfPoints());
 
     bool hasColors = colors_.hasData();
 
@@ -204,9 +211,14 @@ void IntegralLineVectorToMesh::process() {
 
     bool warnOnce = true;
 
+    // Look up the columns once, all lines are stored in the same arrays
+    const auto velocities = findMetaData(lines, "velocity");
+    const auto timestamps = findMetaData(lines, "timestamp");
+    const auto curvatures = findMetaData(lines, "curvature");
+
     size_t idx = 0;
-    for (auto &line : (*lines_.getData())) {
-        auto size = line.getPositions().size();
+    for (auto line : lines) {
+        auto size = line.size();
         if (size == 0) continue;
 
         if (!ignoreBrushingList_.get() && brushingList_.isFiltered(line.getIndex())) {
@@ -215,9 +227,9 @@ void IntegralLineVectorToMesh::process() {
         }
 
         auto position = line.getPositions().begin();
-        auto velocity = line.getMetaData("velocity").begin();
-        Timestep t(line);
-        MetaDataSampler k(line, "curvature");
+        MetaDataSampler velocity(velocities, line);
+        Timestep t(timestamps, line);
+        MetaDataSampler k(curvatures, line);
 
         auto indexBuffer = mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
 
@@ -241,7 +253,9 @@ void IntegralLineVectorToMesh::process() {
         bool first = true;
         for (size_t ii = 0; ii < size - 1; ii++) {
             vec3 pos(*position);
-            vec3 v(*velocity);
+            // Without velocities use the direction of the line
+            vec3 v(velocities ? static_cast<const dvec3 &>(velocity)
+                              : *std::next(position) - *position);
 
             position++;
             velocity++;
@@ -31,6 +31,12 @@
 #include <inviwo/core/util/volumesampler.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <numeric>
+#include <warn/pop>
 
 namespace inviwo {
 
@@ -53,121 +59,203 @@ void StreamLineTracer::addMetaSampler(const std::string &name,
     metaSamplers_.insert(std::make_pair(name, sampler));
 }
 
-inviwo::IntegralLine StreamLineTracer::traceFrom(const dvec3 &p) {
+inviwo::IntegralLine StreamLineTracer::traceFrom(const dvec3 &p) const {
     IntegralLine line;
-    auto& positions = line.getPositions();
+    traceBatch(&p, &line, 1);
+    return line;
+}
+
+inviwo::IntegralLine StreamLineTracer::traceFrom(const vec3 &p) const {
+    return traceFrom(dvec3(p));
+}
+
+std::vector<IntegralLine> StreamLineTracer::traceFrom(const std::vector<dvec3> &seeds,
+                                                      bool parallel, size_t batchSize) const {
+    std::vector<IntegralLine> lines(seeds.size());
+    traceRange(seeds.data(), lines.data(), seeds.size(), parallel, batchSize);
+    return lines;
+}
+
+void StreamLineTracer::traceInto(const std::vector<dvec3> &seeds, IntegralLineSet &lines,
+                                 bool parallel, size_t batchSize) const {
+    batchSize = std::max<size_t>(batchSize, 1);
+    const size_t groupSize = batchSize * (parallel ? util::getPoolSize() + 1 : 1);
+
+    std::vector<IntegralLine> traced;
+    for (size_t begin = 0; begin < seeds.size(); begin += groupSize) {
+        const size_t count = std::min(groupSize, seeds.size() - begin);
+        traced.assign(count, IntegralLine());
+        traceRange(seeds.data() + begin, traced.data(), count, parallel, batchSize);
+        for (size_t i = 0; i < count; ++i) {
+            if (traced[i].getPositions().size() > 1) lines.push_back(traced[i], begin + i);
+        }
+    }
+}
 
+void StreamLineTracer::traceRange(const dvec3 *seeds, IntegralLine *lines, size_t count,
+                                  bool parallel, size_t batchSize) const {
+    batchSize = std::max<size_t>(batchSize, 1);
+    const size_t batches = (count + batchSize - 1) / batchSize;
+
+    auto trace = [&](size_t batch) {
+        const size_t begin = batch * batchSize;
+        traceBatch(seeds + begin, lines + begin, std::min(batchSize, count - begin));
+    };
+
+    if (parallel) {
+        util::parallelFor(batches, trace);
+    } else {
+        for (size_t batch = 0; batch < batches; ++batch) trace(batch);
+    }
+}
+
+void StreamLineTracer::traceBatch(const dvec3 *seeds, IntegralLine *lines, size_t count) const {
     bool fwd = dir_ == IntegralLineProperties::Direction::BOTH ||
                dir_ == IntegralLineProperties::Direction::FWD;
     bool bwd = dir_ == IntegralLineProperties::Direction::BOTH ||
                dir_ == IntegralLineProperties::Direction::BWD;
     bool both = fwd && bwd;
 
-    positions.reserve(steps_ + 2);
-    line.getMetaData("velocity").reserve(steps_ + 2);
-    for (auto &m : metaSamplers_) {
-        line.getMetaData(m.first).reserve(steps_ + 2);
+    std::vector<dvec3> seedPositions(seeds, seeds + count);
+    std::vector<IntegralLine *> batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto &line = lines[i];
+        line.getPositions().reserve(steps_ + 2);
+        line.getMetaData("velocity").reserve(steps_ + 2);
+        for (auto &m : metaSamplers_) {
+            line.getMetaData(m.first).reserve(steps_ + 2);
+        }
+        batch.push_back(&line);
     }
 
     if (bwd) {
-        step(steps_ / (both ? 2 : 1), p, line, false);
+        step(steps_ / (both ? 2 : 1), seedPositions, batch, false);
     }
-    if (both && !positions.empty()) {
-        std::reverse(positions.begin(),
-            positions.end());  // reverse is faster than insert first
-        positions.pop_back();           // dont repeat first step
-        auto keys = line.getMetaDataKeys();
-        for (auto &key : keys) {
-            auto m = line.getMetaData(key);
-            std::reverse(m.begin(), m.end());  // reverse is faster than insert first
-            m.pop_back();                             // dont repeat first step
+    if (both) {
+        for (auto line : batch) {
+            auto &positions = line->getPositions();
+            if (positions.empty()) continue;
+            std::reverse(positions.begin(),
+                         positions.end());  // reverse is faster than insert first
+            positions.pop_back();           // dont repeat first step
+            for (auto &key : line->getMetaDataKeys()) {
+                auto &m = line->getMetaData(key);
+                std::reverse(m.begin(), m.end());
+                m.pop_back();
+            }
         }
     }
     if (fwd) {
-        step(steps_ / (both ? 2 : 1), p, line, true);
+        step(steps_ / (both ? 2 : 1), seedPositions, batch, true);
     }
-
-    return line;
-}
-
-inviwo::IntegralLine StreamLineTracer::traceFrom(const vec3 &p) {
-    return traceFrom(dvec3(p));
 }
 
-void StreamLineTracer::step(int steps, dvec3 curPos, IntegralLine &line,bool fwd) {
-    auto& positions = line.getPositions();
-
-    for (int i = 0; i <= steps; i++) {
-        if (!volumeSampler_->withinBounds(curPos)) {
-            line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
-            break;
-        }
-
-        dvec3 v;
-        switch (integrationScheme_)
-        {
-        case IntegralLineProperties::IntegrationScheme::RK4:
-            v = rk4(curPos, invBasis_ , fwd);
-            break;
-        case IntegralLineProperties::IntegrationScheme::Euler:
-        default:
-            v = euler(curPos);
-            break;
-        }
-        
-        if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
-            line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
-            break;
-        }
-
-        
-        const dvec3 worldVelocty{volumeSampler_->sample(curPos)};
+void StreamLineTracer::step(int steps, const std::vector<dvec3> &seeds,
+                            std::vector<IntegralLine *> &lines, bool fwd) const {
+    const size_t count = lines.size();
+    const size_t metaCount = metaSamplers_.size();
 
-
-        if (normalizeSample_) v = glm::normalize(v);
-        dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
-        positions.push_back(curPos);
-        line.getMetaData("velocity").push_back(worldVelocty);
+    // Look up the meta data channels once instead of once per step.
+    std::vector<std::vector<dvec3> *> velocities(count);
+    std::vector<std::vector<dvec3> *> metaData(count * metaCount);
+    for (size_t i = 0; i < count; ++i) {
+        velocities[i] = &lines[i]->getMetaData("velocity");
+        size_t j = 0;
         for (auto &m : metaSamplers_) {
-            line.getMetaData(m.first).push_back(m.second->sample(curPos));
+            metaData[i * metaCount + j++] = &lines[i]->getMetaData(m.first);
         }
-
-        curPos += velocity;
     }
-}
 
-dvec3 StreamLineTracer::euler(const dvec3 &curPos) {
-    return dvec3(volumeSampler_->sample(curPos));
-}
+    std::vector<dvec3> curPos(seeds);
+    std::vector<size_t> active(count);
+    std::iota(active.begin(), active.end(), size_t{0});
+
+    std::vector<dvec3> pos, tmp, k1, k2, k3, k4, v;
+    pos.reserve(count);
+    for (auto buffer : {&tmp, &k1, &k2, &k3, &k4, &v}) buffer->resize(count);
+    std::vector<dvec3> metaSamples(count * metaCount);
 
-dvec3 StreamLineTracer::rk4(const dvec3 &curPos ,const  dmat3 &m , bool fwd ) {
-    auto h = stepSize_;
-    if (!fwd) h = -h;
-    auto h2 = h / 2;
+    const double h = fwd ? stepSize_ : -stepSize_;
 
     auto normalize = [](dvec3 k) {
         auto l = glm::length(k);
         if (l == 0) {
             return k;
-        }
-        else {
+        } else {
             return k / l;
         }
     };
+    // samples the next rk4 stage at pos + invBasis * k * scale
+    auto stage = [&](const std::vector<dvec3> &k, double scale, std::vector<dvec3> &res) {
+        const size_t n = pos.size();
+        for (size_t j = 0; j < n; ++j) tmp[j] = pos[j] + invBasis_ * k[j] * scale;
+        volumeSampler_->sample(tmp.data(), res.data(), n);
+        if (normalizeSample_) {
+            for (size_t j = 0; j < n; ++j) res[j] = normalize(res[j]);
+        }
+    };
+
+    for (int i = 0; i <= steps && !active.empty(); i++) {
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](size_t l) {
+                                        if (volumeSampler_->withinBounds(curPos[l])) return false;
+                                        lines[l]->setTerminationReason(
+                                            IntegralLine::TerminationReason::OutOfBounds);
+                                        return true;
+                                    }),
+                     active.end());
+        const size_t n = active.size();
+        pos.resize(n);
+        for (size_t j = 0; j < n; ++j) pos[j] = curPos[active[j]];
+
+        // k1 is also the world velocity stored in the line
+        volumeSampler_->sample(pos.data(), k1.data(), n);
+
+        switch (integrationScheme_) {
+            case IntegralLineProperties::IntegrationScheme::RK4:
+                for (size_t j = 0; j < n; ++j) {
+                    tmp[j] = normalizeSample_ ? normalize(k1[j]) : k1[j];
+                }
+                std::swap(tmp, v);
+                stage(v, h / 2, k2);
+                stage(k2, h / 2, k3);
+                stage(k3, h, k4);
+                for (size_t j = 0; j < n; ++j) {
+                    v[j] = (v[j] + 2.0 * (k2[j] + k3[j]) + k4[j]) / 6.0;
+                }
+                break;
+            case IntegralLineProperties::IntegrationScheme::Euler:
+            default:
+                std::copy(k1.begin(), k1.begin() + n, v.begin());
+                break;
+        }
 
-    auto k1 = dvec3(volumeSampler_->sample(curPos));
-    if (normalizeSample_) k1 = normalize(k1);
-    auto K1 = m * k1;
-    auto k2 = dvec3(volumeSampler_->sample(curPos + K1 * h2));
-    if (normalizeSample_) k2 = normalize(k2);
-    auto K2 = m * k2;
-    auto k3 = dvec3(volumeSampler_->sample(curPos + K2 * h2));
-    if (normalizeSample_) k3 = normalize(k3);
-    auto K3 = m * k3;
-    auto k4 = dvec3(volumeSampler_->sample(curPos + K3 * h));
-    if (normalizeSample_) k4 = normalize(k4);
-
-    return (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
+        size_t m = 0;
+        for (auto &sampler : metaSamplers_) {
+            sampler.second->sample(pos.data(), metaSamples.data() + m++ * count, n);
+        }
+
+        size_t alive = 0;
+        for (size_t j = 0; j < n; ++j) {
+            const size_t l = active[j];
+            if (glm::length(v[j]) < std::numeric_limits<double>::epsilon()) {
+                lines[l]->setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
+                continue;
+            }
+            if (normalizeSample_) v[j] = glm::normalize(v[j]);
+
+            lines[l]->getPositions().push_back(curPos[l]);
+            velocities[l]->push_back(k1[j]);
+            for (m = 0; m < metaCount; ++m) {
+                metaData[l * metaCount + m]->push_back(metaSamples[m * count + j]);
+            }
+
+            curPos[l] += invBasis_ * (v[j] * h);
+            active[alive++] = l;
+        }
+        active.resize(alive);
+    }
 }
 
 }  // namespace
@@ -33,6 +33,7 @@
 #include <modules/vectorfieldvisualization/vectorfieldvisualizationmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <modules/vectorfieldvisualization/datastructures/integralline.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
 #include <modules/vectorfieldvisualization/integrallinetracer.h>
 #include <inviwo/core/util/volumesampler.h>
 #include <modules/vectorfieldvisualization/properties/streamlineproperties.h>
@@ -56,14 +57,32 @@ public:
     void addMetaVolume(const std::string &name, std::shared_ptr<const Volume> vol);
     void addMetaSampler(const std::string &name, std::shared_ptr<const SpatialSampler<3, 3, double>> sampler);
 
-    IntegralLine traceFrom(const dvec3 &p);
-    IntegralLine traceFrom(const vec3 &p);
+    IntegralLine traceFrom(const dvec3 &p) const;
+    IntegralLine traceFrom(const vec3 &p) const;
 
+    /**
+     * Traces a line from each seed. The seeds are traced in batches of batchSize lines on the
+     * thread pool if parallel is true. All lines in a batch are advanced together with one
+     * batched sample call per integration stage. The result is in seed order and does not
+     * depend on the number of threads.
+     */
+    std::vector<IntegralLine> traceFrom(const std::vector<dvec3> &seeds, bool parallel = true,
+                                        size_t batchSize = 256) const;
+
+    /**
+     * Traces a line from each seed like traceFrom, and appends the lines with more than one point
+     * to lines with the index of their seed. Only one batch per thread is traced at a time, hence
+     * at most that many lines are kept as IntegralLine besides the set.
+     */
+    void traceInto(const std::vector<dvec3> &seeds, IntegralLineSet &lines, bool parallel = true,
+                   size_t batchSize = 256) const;
 
 private:
-    void step(int steps, dvec3 curPos, IntegralLine &line,bool fwd);
-    dvec3 euler(const dvec3 &curPos);
-    dvec3 rk4(const dvec3 &curPos , const dmat3 &m , bool fwd);
+    void traceRange(const dvec3 *seeds, IntegralLine *lines, size_t count, bool parallel,
+                    size_t batchSize) const;
+    void traceBatch(const dvec3 *seeds, IntegralLine *lines, size_t count) const;
+    void step(int steps, const std::vector<dvec3> &seeds, std::vector<IntegralLine *> &lines,
+              bool fwd) const;
 
     dmat3 invBasis_;
     std::map<std::string, std::shared_ptr<const SpatialSampler<3,3,double>>> metaSamplers_;
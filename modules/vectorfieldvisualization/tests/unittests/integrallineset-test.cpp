@@ -0,0 +1,170 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+
+namespace inviwo {
+
+namespace {
+
+IntegralLine makeLine(size_t points, double offset, size_t idx) {
+    IntegralLine line;
+    auto& velocity = line.createMetaData("velocity");
+    auto& timestamp = line.createMetaData("timestamp");
+    for (size_t i = 0; i < points; ++i) {
+        line.getPositions().emplace_back(offset + i, 0.0, 0.0);
+        velocity.emplace_back(1.0, offset, static_cast<double>(i));
+        timestamp.emplace_back(0.5 * i);
+    }
+    line.setIndex(idx);
+    line.setTerminationReason(IntegralLine::TerminationReason::Steps);
+    return line;
+}
+
+}  // namespace
+
+TEST(IntegralLineSetTest, PushBackAndLineViews) {
+    IntegralLineSet set(mat4(1.0f));
+    set.addMetaData("timestamp", 1, IntegralLineSet::Precision::Double);
+    set.addMetaData("velocity", 3, IntegralLineSet::Precision::Float);
+
+    set.push_back(makeLine(3, 0.0, 7));
+    EXPECT_EQ(7u, set[0].getIndex());  // const lines keep their index
+    set.push_back(makeLine(5, 10.0, 3), 8);
+    ASSERT_EQ(2u, set.size());
+    EXPECT_EQ(8u, set.getNumberOfPoints());
+    EXPECT_EQ(0u, set.getOffset(0));
+    EXPECT_EQ(3u, set.getOffset(1));
+
+    const auto& velocity = set.getMetaData("velocity");
+    const auto& timestamp = set.getMetaData("timestamp");
+    EXPECT_EQ(3u, velocity.getComponents());
+    EXPECT_EQ(1u, timestamp.getComponents());
+    EXPECT_EQ(8u, velocity.size());
+
+    auto line = set[1];
+    EXPECT_EQ(5u, line.size());
+    EXPECT_EQ(3u, line.getOffset());
+    EXPECT_EQ(8u, line.getEnd());
+    EXPECT_EQ(8u, line.getIndex());
+    EXPECT_EQ(IntegralLine::TerminationReason::Steps, line.getTerminationReason());
+    EXPECT_DOUBLE_EQ(4.0, line.getLength());
+    EXPECT_EQ(dvec3(12.0, 0.0, 0.0), line.getPosition(2));
+    EXPECT_EQ(dvec3(1.0, 10.0, 2.0), line.getMetaData(velocity, 2));
+    EXPECT_DOUBLE_EQ(1.0, timestamp.getScalar(line.getOffset() + 2));
+    EXPECT_EQ(dvec3(1.0), line.getMetaData(timestamp, 2));
+
+    size_t points = 0;
+    for (auto l : set) points += l.size();
+    EXPECT_EQ(set.getNumberOfPoints(), points);
+
+    auto copy = line.toIntegralLine();
+    EXPECT_EQ(5u, copy.getPositions().size());
+    EXPECT_EQ(dvec3(1.0, 10.0, 4.0), copy.getMetaData("velocity")[4]);
+    EXPECT_EQ(8u, copy.getIndex());
+
+    // Non-const lines get their position in the set as index
+    auto third = makeLine(2, 20.0, 9);
+    set.push_back(third);
+    EXPECT_EQ(2u, third.getIndex());
+    EXPECT_EQ(2u, set[2].getIndex());
+    auto fourth = makeLine(2, 30.0, 9);
+    set.push_back(fourth, 5);
+    EXPECT_EQ(5u, fourth.getIndex());
+    EXPECT_EQ(5u, set[3].getIndex());
+
+    EXPECT_THROW(set.getMetaData("vorticity"), Exception);
+    EXPECT_THROW(set.addMetaData("velocity"), Exception);
+    EXPECT_THROW(set.at(4), std::out_of_range);
+}
+
+TEST(IntegralLineSetTest, ColumnAppend) {
+    IntegralLineSet src(mat4(1.0f));
+    src.push_back(makeLine(4, 0.0, 0));
+    src.push_back(makeLine(2, 5.0, 1));
+    src.addMetaData("curvature", 1, IntegralLineSet::Precision::Float);
+
+    // Columns missing in the destination are added with the source layout, columns missing in
+    // the source are filled with zeros
+    IntegralLineSet dst(mat4(1.0f));
+    dst.addMetaData("vorticity", 3, IntegralLineSet::Precision::Double);
+    dst.push_back(src[1]);
+    dst.push_back(src[0], 42);
+    ASSERT_EQ(2u, dst.size());
+    EXPECT_EQ(6u, dst.getNumberOfPoints());
+    EXPECT_EQ(1u, dst[0].getIndex());
+    EXPECT_EQ(42u, dst[1].getIndex());
+
+    ASSERT_TRUE(dst.hasMetaData("curvature"));
+    EXPECT_EQ(1u, dst.getMetaData("curvature").getComponents());
+    EXPECT_EQ(IntegralLineSet::Precision::Float, dst.getMetaData("curvature").getPrecision());
+    for (const auto& key : dst.getMetaDataKeys()) {
+        EXPECT_EQ(dst.getNumberOfPoints(), dst.getMetaData(key).size()) << key;
+    }
+
+    const auto& velocity = dst.getMetaData("velocity");
+    EXPECT_EQ(dvec3(1.0, 5.0, 1.0), dst[0].getMetaData(velocity, 1));
+    EXPECT_EQ(dvec3(1.0, 0.0, 3.0), dst[1].getMetaData(velocity, 3));
+    EXPECT_EQ(dvec3(0.0), dst[1].getMetaData(dst.getMetaData("vorticity"), 3));
+    EXPECT_EQ(dvec3(6.0, 0.0, 0.0), dst[0].getPosition(1));
+
+    // Appending from the same set
+    dst.push_back(dst[0]);
+    ASSERT_EQ(3u, dst.size());
+    EXPECT_EQ(dvec3(1.0, 5.0, 1.0), dst[2].getMetaData(velocity, 1));
+}
+
+TEST(IntegralLineSetTest, EmptySets) {
+    IntegralLineSet set(mat4(2.0f));
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(0u, set.size());
+    EXPECT_EQ(0u, set.getNumberOfPoints());
+    EXPECT_TRUE(set.begin() == set.end());
+    EXPECT_TRUE(set.getMetaDataKeys().empty());
+
+    // Empty lines
+    set.push_back(IntegralLine{});
+    ASSERT_EQ(1u, set.size());
+    EXPECT_EQ(0u, set[0].size());
+    EXPECT_EQ(0u, set.getNumberOfPoints());
+
+    set.push_back(makeLine(3, 0.0, 1));
+    auto empty = set.createEmpty();
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(set.getModelMatrix(), empty.getModelMatrix());
+    EXPECT_EQ(set.getMetaDataKeys(), empty.getMetaDataKeys());
+    EXPECT_EQ(0u, empty.getMetaData("velocity").size());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,146 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <random>
+#include <warn/pop>
+
+#include <modules/vectorfieldvisualization/algorithms/rbfinterpolation.h>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<dvec3> randomPoints(size_t count, std::mt19937& gen) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<dvec3> points(count);
+    for (auto& p : points) p = dvec3(dist(gen), dist(gen), dist(gen));
+    return points;
+}
+
+void expectNear(const dvec3& expected, const dvec3& actual, double tolerance) {
+    EXPECT_NEAR(expected.x, actual.x, tolerance);
+    EXPECT_NEAR(expected.y, actual.y, tolerance);
+    EXPECT_NEAR(expected.z, actual.z, tolerance);
+}
+
+}  // namespace
+
+TEST(RBFInterpolationTest, GaussianMatchesPerComponentSolve) {
+    std::mt19937 gen(42);
+    const auto centers = randomPoints(20, gen);
+    const auto values = randomPoints(20, gen);
+    util::RBFKernel kernel;
+    kernel.sigma = 0.2;
+    const double shape = 0.1;
+
+    // One dense solve per component over all centers
+    const auto n = static_cast<Eigen::Index>(centers.size());
+    Eigen::MatrixXd A(n, n);
+    Eigen::VectorXd bx(n), by(n), bz(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        for (Eigen::Index j = 0; j < n; ++j) {
+            A(i, j) = shape + kernel(glm::distance(centers[i], centers[j]));
+        }
+        bx(i) = values[i].x;
+        by(i) = values[i].y;
+        bz(i) = values[i].z;
+    }
+    const Eigen::VectorXd wx = A.llt().solve(bx);
+    const Eigen::VectorXd wy = A.llt().solve(by);
+    const Eigen::VectorXd wz = A.llt().solve(bz);
+
+    const util::RBFInterpolation rbf(centers, values, kernel, shape);
+    for (const auto& p : randomPoints(50, gen)) {
+        dvec3 expected(0.0);
+        for (Eigen::Index i = 0; i < n; ++i) {
+            const auto k = kernel(glm::distance(p, centers[i]));
+            expected += dvec3(wx(i), wy(i), wz(i)) * k;
+        }
+        expectNear(expected, rbf.evaluate(p), 1e-6);
+    }
+}
+
+TEST(RBFInterpolationTest, WendlandReproducesSamples) {
+    std::mt19937 gen(7);
+    const auto centers = randomPoints(200, gen);
+    const auto values = randomPoints(200, gen);
+    util::RBFKernel kernel;
+    kernel.type = util::RBFKernel::Type::Wendland;
+    kernel.radius = 0.4;
+
+    const util::RBFInterpolation rbf(centers, values, kernel);
+    for (size_t i = 0; i < centers.size(); ++i) {
+        expectNear(values[i], rbf.evaluate(centers[i]), 1e-9);
+    }
+    // Zero outside of the support of all centers
+    expectNear(dvec3(0.0), rbf.evaluate(dvec3(5.0)), 0.0);
+}
+
+TEST(RBFInterpolationTest, SingleCenter) {
+    const std::vector<dvec3> centers{dvec3(0.25, 0.5, -0.5)};
+    const std::vector<dvec3> values{dvec3(1.0, 2.0, 3.0)};
+
+    util::RBFKernel gaussian;
+    util::RBFKernel wendland;
+    wendland.type = util::RBFKernel::Type::Wendland;
+    for (double size : {1.0, 1e-3, 0.0}) {
+        gaussian.sigma = size;
+        wendland.radius = size;
+        for (const auto& kernel : {gaussian, wendland}) {
+            const util::RBFInterpolation rbf(centers, values, kernel);
+            expectNear(values[0], rbf.evaluate(centers[0]), 1e-12);
+        }
+    }
+}
+
+TEST(RBFInterpolationTest, CoincidentCenters) {
+    const std::vector<dvec3> centers{dvec3(0.5), dvec3(-0.5), dvec3(0.5), dvec3(0.5)};
+    const std::vector<dvec3> values{dvec3(1.0), dvec3(-1.0), dvec3(2.0), dvec3(3.0)};
+
+    util::RBFKernel wendland;
+    wendland.type = util::RBFKernel::Type::Wendland;
+    util::RBFKernel gaussian;
+    gaussian.sigma = 0.1;
+    for (const auto& kernel : {gaussian, wendland}) {
+        const util::RBFInterpolation rbf(centers, values, kernel);
+        expectNear(dvec3(2.0), rbf.evaluate(dvec3(0.5)), 1e-9);
+        expectNear(dvec3(-1.0), rbf.evaluate(dvec3(-0.5)), 1e-9);
+
+        // All centers in one point
+        const util::RBFInterpolation same(std::vector<dvec3>(3, dvec3(0.5)),
+                                          {dvec3(1.0), dvec3(2.0), dvec3(3.0)}, kernel);
+        expectNear(dvec3(2.0), same.evaluate(dvec3(0.5)), 1e-9);
+    }
+}
+
+}  // namespace inviwo
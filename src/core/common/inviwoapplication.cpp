@@ -145,6 +145,12 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
             resizePool(static_cast<size_t>(sys->poolSize_.get()));
         });
     }
+    if (sys) {
+        processorNetworkEvaluator_->setParallelEvaluation(sys->parallelEvaluation_.get());
+        sys->parallelEvaluation_.onChange([this, sys]() {
+            processorNetworkEvaluator_->setParallelEvaluation(sys->parallelEvaluation_.get());
+        });
+    }
 
     workspaceManager_->registerFactory(getProcessorFactory());
     workspaceManager_->registerFactory(getMetaDataFactory());
@@ -408,6 +414,8 @@ void InviwoApplication::waitForPool() {
 }
 
 
+size_t InviwoApplication::getPoolSize() const { return pool_.getSize(); }
+
 TimerThread& InviwoApplication::getTimerThread() {
     if(!timerThread_) {
         timerThread_ = util::make_unique<TimerThread>();
@@ -36,6 +36,7 @@
 
 //Data Structures
 #include <inviwo/core/datastructures/volume/volumeramconverter.h>
+#include <inviwo/core/datastructures/volume/volumebrickedconverter.h>
 #include <inviwo/core/datastructures/image/layerramconverter.h>
 #include <inviwo/core/datastructures/representationconverterfactory.h>
 
@@ -110,6 +111,12 @@ InviwoCore::InviwoCore(InviwoApplication* app) : InviwoModule(app, "Core") {
     // Register Converters
     registerRepresentationConverter<VolumeRepresentation>(
         util::make_unique<VolumeDisk2RAMConverter>());
+    registerRepresentationConverter<VolumeRepresentation>(
+        util::make_unique<VolumeRAM2BrickedConverter>());
+    registerRepresentationConverter<VolumeRepresentation>(
+        util::make_unique<VolumeBricked2RAMConverter>());
+    registerRepresentationConverter<VolumeRepresentation>(
+        util::make_unique<VolumeDisk2BrickedConverter>());
     registerRepresentationConverter<LayerRepresentation>(
         util::make_unique<LayerDisk2RAMConverter>());
 
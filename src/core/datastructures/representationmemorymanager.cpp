@@ -0,0 +1,144 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+
+namespace inviwo {
+
+RepresentationMemoryManager* RepresentationMemoryManager::getPtr() {
+    // Never destroyed, Data objects with static storage duration might outlive any local static.
+    static auto manager = new RepresentationMemoryManager();
+    return manager;
+}
+
+void RepresentationMemoryManager::setBudget(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    budget_ = bytes;
+}
+
+size_t RepresentationMemoryManager::getBudget() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t RepresentationMemoryManager::getUsage() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return usage_;
+}
+
+bool RepresentationMemoryManager::isOverBudget() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return budget_ != 0 && usage_ > budget_;
+}
+
+void RepresentationMemoryManager::track(const void* owner, std::type_index type, size_t bytes,
+                                        Evictor evictor) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(Key{owner, type});
+    if (it != entries_.end()) erase(it->second);
+
+    lru_.push_front(Entry{owner, type, bytes, std::move(evictor)});
+    entries_.emplace(Key{owner, type}, lru_.begin());
+    usage_ += bytes;
+    stats_[type].bytes += bytes;
+}
+
+void RepresentationMemoryManager::touch(const void* owner, std::type_index type) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(Key{owner, type});
+    if (it != entries_.end()) lru_.splice(lru_.begin(), lru_, it->second);
+    ++stats_[type].hits;
+}
+
+void RepresentationMemoryManager::remove(const void* owner, std::type_index type) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(Key{owner, type});
+    if (it != entries_.end()) erase(it->second);
+}
+
+void RepresentationMemoryManager::removeAll(const void* owner) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        auto current = it++;
+        if (current->owner == owner) erase(current);
+    }
+}
+
+void RepresentationMemoryManager::countMiss(std::type_index type) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++stats_[type].misses;
+}
+
+void RepresentationMemoryManager::enforceBudget(
+    const std::unordered_set<const void*>& evictable) {
+    std::vector<std::shared_ptr<void>> evicted;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (budget_ == 0 || usage_ <= budget_) return;
+
+        auto it = lru_.end();
+        while (it != lru_.begin() && usage_ > budget_) {
+            --it;
+            if (it->bytes == 0 || evictable.count(it->owner) == 0) continue;
+            // The evictor only try-locks its Data object, so calling it with our lock held can
+            // not deadlock against a Data object calling track or touch while holding its own
+            // lock.
+            if (auto repr = it->evictor()) {
+                evicted.push_back(std::move(repr));
+                ++stats_[it->type].evictions;
+                auto next = std::next(it);
+                erase(it);
+                it = next;
+            }
+        }
+    }
+    // Representations are destroyed here, outside of the lock.
+}
+
+std::unordered_map<std::type_index, RepresentationMemoryManager::Stats>
+RepresentationMemoryManager::getStats() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t RepresentationMemoryManager::KeyHash::operator()(
+    const std::pair<const void*, std::type_index>& key) const {
+    const auto h1 = std::hash<const void*>{}(key.first);
+    const auto h2 = std::hash<std::type_index>{}(key.second);
+    return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+}
+
+void RepresentationMemoryManager::erase(std::list<Entry>::iterator it) {
+    usage_ -= it->bytes;
+    stats_[it->type].bytes -= it->bytes;
+    entries_.erase(Key{it->owner, it->type});
+    lru_.erase(it);
+}
+
+}  // namespace inviwo
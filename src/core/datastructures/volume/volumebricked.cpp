@@ -0,0 +1,396 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/formatdispatching.h>
+#include <inviwo/core/util/parallel.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstring>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+constexpr size_t defaultCacheLimit = 512 * 1024 * 1024;
+
+size_t sizeInBytes(const VolumeRAM& ram) {
+    const auto dims = ram.getDimensions();
+    return dims.x * dims.y * dims.z * ram.getDataFormat()->getSize();
+}
+
+// Copy the voxels [srcOffset, srcOffset + extent) of src to dstOffset in dst, row by row.
+void copyVoxels(const VolumeRAM& src, const size3_t& srcOffset, VolumeRAM& dst,
+                const size3_t& dstOffset, const size3_t& extent) {
+    const size_t bytes = src.getDataFormat()->getSize();
+    const auto srcDims = src.getDimensions();
+    const auto dstDims = dst.getDimensions();
+    const auto srcData = static_cast<const unsigned char*>(src.getData());
+    auto dstData = static_cast<unsigned char*>(dst.getData());
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            const size_t s =
+                srcOffset.x + srcDims.x * ((srcOffset.y + y) + srcDims.y * (srcOffset.z + z));
+            const size_t d =
+                dstOffset.x + dstDims.x * ((dstOffset.y + y) + dstDims.y * (dstOffset.z + z));
+            std::memcpy(dstData + d * bytes, srcData + s * bytes, extent.x * bytes);
+        }
+    }
+}
+
+std::pair<dvec4, dvec4> regionMinMax(const VolumeRAM& ram, const size3_t& offset,
+                                     const size3_t& extent) {
+    return ram.dispatch<std::pair<dvec4, dvec4>>([&](auto vr) {
+        using T = util::PrecsionValueType<decltype(vr)>;
+        const auto data = vr->getDataTyped();
+        const auto dims = vr->getDimensions();
+        T min = DataFormat<T>::max();
+        T max = DataFormat<T>::lowest();
+        for (size_t z = offset.z; z < offset.z + extent.z; ++z) {
+            for (size_t y = offset.y; y < offset.y + extent.y; ++y) {
+                const size_t row = dims.x * (y + dims.y * z);
+                for (size_t x = offset.x; x < offset.x + extent.x; ++x) {
+                    min = glm::min(min, data[row + x]);
+                    max = glm::max(max, data[row + x]);
+                }
+            }
+        }
+        return std::make_pair(util::glm_convert<dvec4>(min), util::glm_convert<dvec4>(max));
+    });
+}
+
+}  // namespace
+
+VolumeBricked::VolumeBricked(size3_t dimensions, const DataFormatBase* format, size3_t brickSize,
+                             size_t ghostLayers)
+    : VolumeRepresentation(format)
+    , dimensions_(dimensions)
+    , brickSize_(glm::max(brickSize, size3_t(1)))
+    , ghostLayers_(ghostLayers)
+    , disk_()
+    , cacheLimit_(defaultCacheLimit) {
+    initBricks();
+}
+
+VolumeBricked::VolumeBricked(std::shared_ptr<const VolumeDisk> disk, size3_t brickSize,
+                             size_t ghostLayers)
+    : VolumeRepresentation(disk->getDataFormat())
+    , dimensions_(disk->getDimensions())
+    , brickSize_(glm::max(brickSize, size3_t(1)))
+    , ghostLayers_(ghostLayers)
+    , disk_(disk)
+    , cacheLimit_(defaultCacheLimit) {
+    if (!dynamic_cast<const VolumeRegionLoader*>(disk_->getLoader())) {
+        throw Exception("The loader of the disk representation can not read regions",
+                        IvwContext);
+    }
+    initBricks();
+}
+
+VolumeBricked::VolumeBricked(const VolumeBricked& rhs)
+    : VolumeRepresentation(rhs)
+    , dimensions_(rhs.dimensions_)
+    , brickSize_(rhs.brickSize_)
+    , ghostLayers_(rhs.ghostLayers_)
+    , brickCount_(rhs.brickCount_)
+    , disk_(rhs.disk_)
+    , cacheLimit_(rhs.cacheLimit_) {
+    // Brick data is never modified after it has been set, hence it can be shared.
+    std::unique_lock<std::mutex> lock(rhs.mutex_);
+    bricks_ = rhs.bricks_;
+    // Bricks that rhs is reading are read again by this copy when needed.
+    for (auto& b : bricks_) b.loading = false;
+    for (auto i : rhs.lru_) {
+        lru_.push_back(i);
+        bricks_[i].lru = std::prev(lru_.end());
+    }
+    cachedBytes_ = rhs.cachedBytes_;
+}
+
+VolumeBricked& VolumeBricked::operator=(const VolumeBricked& that) {
+    if (this != &that) {
+        VolumeBricked tmp(that);
+        std::unique_lock<std::mutex> lock(mutex_);
+        VolumeRepresentation::operator=(that);
+        dimensions_ = tmp.dimensions_;
+        brickSize_ = tmp.brickSize_;
+        ghostLayers_ = tmp.ghostLayers_;
+        brickCount_ = tmp.brickCount_;
+        disk_ = tmp.disk_;
+        cacheLimit_ = tmp.cacheLimit_;
+        // Splicing keeps the list iterators stored in the bricks valid.
+        bricks_ = std::move(tmp.bricks_);
+        lru_.clear();
+        lru_.splice(lru_.begin(), tmp.lru_);
+        cachedBytes_ = tmp.cachedBytes_;
+        ++generation_;
+        loaded_.notify_all();
+    }
+    return *this;
+}
+
+VolumeBricked* VolumeBricked::clone() const { return new VolumeBricked(*this); }
+
+std::type_index VolumeBricked::getTypeIndex() const {
+    return std::type_index(typeid(VolumeBricked));
+}
+
+void VolumeBricked::setDimensions(size3_t dimensions) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    dimensions_ = dimensions;
+    disk_.reset();
+    initBricks();
+}
+
+const size3_t& VolumeBricked::getDimensions() const { return dimensions_; }
+
+const size3_t& VolumeBricked::getBrickSize() const { return brickSize_; }
+
+size_t VolumeBricked::getGhostLayers() const { return ghostLayers_; }
+
+const size3_t& VolumeBricked::getBrickCount() const { return brickCount_; }
+
+size_t VolumeBricked::getNumberOfBricks() const {
+    return brickCount_.x * brickCount_.y * brickCount_.z;
+}
+
+size3_t VolumeBricked::getBrickForVoxel(const size3_t& voxel) const { return voxel / brickSize_; }
+
+VolumeBricked::Region VolumeBricked::getBrickInterior(const size3_t& brick) const {
+    const size3_t offset = brick * brickSize_;
+    return {offset, glm::min(brickSize_, dimensions_ - offset)};
+}
+
+VolumeBricked::Region VolumeBricked::getBrickRegion(const size3_t& brick) const {
+    const auto interior = getBrickInterior(brick);
+    const size3_t begin = interior.offset - glm::min(size3_t(ghostLayers_), interior.offset);
+    const size3_t end =
+        glm::min(interior.offset + interior.dimensions + size3_t(ghostLayers_), dimensions_);
+    return {begin, end - begin};
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::getBrick(const size3_t& brick) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return load(lock, brick);
+}
+
+void VolumeBricked::setBrick(const size3_t& brick, std::shared_ptr<const VolumeRAM> data) {
+    const auto region = getBrickRegion(brick);
+    if (data->getDimensions() != region.dimensions || data->getDataFormat() != getDataFormat()) {
+        throw Exception("Brick data does not match the brick region and format", IvwContext);
+    }
+    const auto interior = getBrickInterior(brick);
+    const auto minMax =
+        regionMinMax(*data, interior.offset - region.offset, interior.dimensions);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& b = bricks_[index(brick)];
+    if (b.data && b.evictable) {
+        lru_.erase(b.lru);
+        cachedBytes_ -= sizeInBytes(*b.data);
+    }
+    b.data = std::move(data);
+    b.evictable = false;
+    b.hasMinMax = true;
+    b.minMax = minMax;
+}
+
+void VolumeBricked::setBricks(const VolumeRAM& volume) {
+    if (volume.getDimensions() != dimensions_ || volume.getDataFormat() != getDataFormat()) {
+        throw Exception("Volume does not match the dimensions and format", IvwContext);
+    }
+    util::parallelFor(getNumberOfBricks(), [&](size_t i) {
+        const size3_t brick(i % brickCount_.x, (i / brickCount_.x) % brickCount_.y,
+                            i / (brickCount_.x * brickCount_.y));
+        const auto region = getBrickRegion(brick);
+        auto data = createVolumeRAM(region.dimensions, getDataFormat());
+        copyVoxels(volume, region.offset, *data, size3_t(0), region.dimensions);
+        setBrick(brick, data);
+    });
+}
+
+bool VolumeBricked::isBrickInMemory(const size3_t& brick) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return static_cast<bool>(bricks_[index(brick)].data);
+}
+
+bool VolumeBricked::hasBrickMinMax(const size3_t& brick) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return bricks_[index(brick)].hasMinMax;
+}
+
+std::pair<dvec4, dvec4> VolumeBricked::getBrickMinMax(const size3_t& brick) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto& b = bricks_[index(brick)];
+    if (b.hasMinMax) return b.minMax;
+    return {dvec4(getDataFormat()->getLowest()), dvec4(getDataFormat()->getMax())};
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked::readRegion(const size3_t& offset,
+                                                     const size3_t& dimensions) const {
+    if (glm::any(glm::greaterThan(offset + dimensions, dimensions_))) {
+        throw Exception("Region outside of the volume", IvwContext);
+    }
+    auto dst = createVolumeRAM(dimensions, getDataFormat());
+    if (glm::compMul(dimensions) == 0) return dst;
+
+    const size3_t first = getBrickForVoxel(offset);
+    const size3_t count = getBrickForVoxel(offset + dimensions - size3_t(1)) - first + size3_t(1);
+    // Bricks write to disjoint parts of dst.
+    util::parallelFor(count.x * count.y * count.z, [&](size_t i) {
+        const size3_t brick = first + size3_t(i % count.x, (i / count.x) % count.y,
+                                              i / (count.x * count.y));
+        const auto interior = getBrickInterior(brick);
+        const size3_t begin = glm::max(offset, interior.offset);
+        const size3_t end =
+            glm::min(offset + dimensions, interior.offset + interior.dimensions);
+        const auto data = getBrick(brick);
+        copyVoxels(*data, begin - getBrickRegion(brick).offset, *dst, begin - offset,
+                   end - begin);
+    });
+    return dst;
+}
+
+void VolumeBricked::setCacheLimit(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cacheLimit_ = bytes;
+    enforceCacheLimit();
+}
+
+size_t VolumeBricked::getCacheLimit() const { return cacheLimit_; }
+
+size_t VolumeBricked::getCachedBytes() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cachedBytes_;
+}
+
+size_t VolumeBricked::index(const size3_t& brick) const {
+    if (glm::any(glm::greaterThanEqual(brick, brickCount_))) {
+        throw Exception("Brick index out of range", IvwContext);
+    }
+    return brick.x + brickCount_.x * (brick.y + brickCount_.y * brick.z);
+}
+
+void VolumeBricked::initBricks() {
+    brickCount_ = (dimensions_ + brickSize_ - size3_t(1)) / brickSize_;
+    bricks_.clear();
+    bricks_.resize(getNumberOfBricks());
+    // Bricks that are not read from disk start out as zero.
+    if (!disk_) {
+        for (auto& b : bricks_) {
+            b.hasMinMax = true;
+            b.minMax = {dvec4(0.0), dvec4(0.0)};
+        }
+    }
+    lru_.clear();
+    cachedBytes_ = 0;
+    ++generation_;
+    loaded_.notify_all();
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::load(std::unique_lock<std::mutex>& lock,
+                                                     const size3_t& brick) const {
+    // Wait for other threads reading the brick instead of reading it again. The bricks might be
+    // replaced while waiting, hence the index is looked up again.
+    while (bricks_[index(brick)].loading) loaded_.wait(lock);
+    const auto i = index(brick);
+
+    if (bricks_[i].data) {
+        if (bricks_[i].evictable) lru_.splice(lru_.begin(), lru_, bricks_[i].lru);
+        return bricks_[i].data;
+    }
+
+    const auto region = getBrickRegion(brick);
+    const auto interior = getBrickInterior(brick);
+    if (!disk_) {
+        auto& b = bricks_[i];
+        b.data = createVolumeRAM(region.dimensions, getDataFormat());
+        b.evictable = false;
+        return b.data;
+    }
+
+    // Read without holding the lock such that other bricks can be read in parallel.
+    bricks_[i].loading = true;
+    const auto disk = disk_;
+    const auto generation = generation_;
+    lock.unlock();
+
+    std::shared_ptr<const VolumeRAM> data;
+    std::pair<dvec4, dvec4> minMax;
+    try {
+        data = disk->readRegion(region.offset, region.dimensions);
+        minMax = regionMinMax(*data, interior.offset - region.offset, interior.dimensions);
+    } catch (...) {
+        lock.lock();
+        if (generation == generation_) bricks_[i].loading = false;
+        loaded_.notify_all();
+        throw;
+    }
+
+    lock.lock();
+    // The bricks were replaced while reading, the data does not belong to them.
+    if (generation != generation_) return data;
+
+    auto& b = bricks_[i];
+    b.loading = false;
+    loaded_.notify_all();
+    if (b.data) {  // set with setBrick while reading
+        if (b.evictable) lru_.splice(lru_.begin(), lru_, b.lru);
+        return b.data;
+    }
+    b.data = data;
+    b.evictable = true;
+    lru_.push_front(i);
+    b.lru = lru_.begin();
+    cachedBytes_ += sizeInBytes(*data);
+    if (!b.hasMinMax) {
+        b.minMax = minMax;
+        b.hasMinMax = true;
+    }
+
+    enforceCacheLimit();
+    return data;
+}
+
+void VolumeBricked::enforceCacheLimit() const {
+    // Always keep the most recently used brick.
+    while (cachedBytes_ > cacheLimit_ && lru_.size() > 1) {
+        auto& b = bricks_[lru_.back()];
+        lru_.pop_back();
+        cachedBytes_ -= sizeInBytes(*b.data);
+        b.data.reset();
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,97 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebrickedconverter.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstring>
+#include <warn/pop>
+
+namespace inviwo {
+
+std::shared_ptr<VolumeBricked> VolumeRAM2BrickedConverter::createFrom(
+    std::shared_ptr<const VolumeRAM> source) const {
+    auto bricked =
+        std::make_shared<VolumeBricked>(source->getDimensions(), source->getDataFormat());
+    bricked->setBricks(*source);
+    return bricked;
+}
+
+void VolumeRAM2BrickedConverter::update(std::shared_ptr<const VolumeRAM> source,
+                                        std::shared_ptr<VolumeBricked> destination) const {
+    if (destination->getDimensions() != source->getDimensions() ||
+        destination->getDataFormat() != source->getDataFormat()) {
+        *destination = VolumeBricked(source->getDimensions(), source->getDataFormat(),
+                                     destination->getBrickSize(), destination->getGhostLayers());
+    }
+    destination->setBricks(*source);
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked2RAMConverter::createFrom(
+    std::shared_ptr<const VolumeBricked> source) const {
+    return source->readRegion(size3_t(0), source->getDimensions());
+}
+
+void VolumeBricked2RAMConverter::update(std::shared_ptr<const VolumeBricked> source,
+                                        std::shared_ptr<VolumeRAM> destination) const {
+    if (destination->getDimensions() != source->getDimensions()) {
+        destination->setDimensions(source->getDimensions());
+    }
+    const auto ram = source->readRegion(size3_t(0), source->getDimensions());
+    const auto dims = source->getDimensions();
+    std::memcpy(destination->getData(), ram->getData(),
+                dims.x * dims.y * dims.z * source->getDataFormat()->getSize());
+}
+
+std::shared_ptr<VolumeBricked> VolumeDisk2BrickedConverter::createFrom(
+    std::shared_ptr<const VolumeDisk> source) const {
+    if (dynamic_cast<const VolumeRegionLoader*>(source->getLoader())) {
+        return std::make_shared<VolumeBricked>(source);
+    }
+    auto ram = std::static_pointer_cast<VolumeRAM>(source->createRepresentation());
+    auto bricked = std::make_shared<VolumeBricked>(ram->getDimensions(), ram->getDataFormat());
+    bricked->setBricks(*ram);
+    return bricked;
+}
+
+void VolumeDisk2BrickedConverter::update(std::shared_ptr<const VolumeDisk> source,
+                                         std::shared_ptr<VolumeBricked> destination) const {
+    if (dynamic_cast<const VolumeRegionLoader*>(source->getLoader())) {
+        *destination =
+            VolumeBricked(source, destination->getBrickSize(), destination->getGhostLayers());
+    } else {
+        auto ram = std::static_pointer_cast<VolumeRAM>(source->createRepresentation());
+        *destination = VolumeBricked(ram->getDimensions(), ram->getDataFormat(),
+                                     destination->getBrickSize(), destination->getGhostLayers());
+        destination->setBricks(*ram);
+    }
+}
+
+}  // namespace inviwo
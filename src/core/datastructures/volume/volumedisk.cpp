@@ -53,4 +53,15 @@ void VolumeDisk::setDimensions(size3_t) {
 
 const size3_t& VolumeDisk::getDimensions() const { return dimensions_; }
 
+std::shared_ptr<VolumeRAM> VolumeDisk::readRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const {
+    if (glm::any(glm::greaterThan(offset + dimensions, dimensions_))) {
+        throw Exception("Region outside of the volume", IvwContext);
+    }
+    if (auto loader = dynamic_cast<const VolumeRegionLoader*>(getLoader())) {
+        return loader->readRegion(offset, dimensions);
+    }
+    return nullptr;
+}
+
 }  // namespace
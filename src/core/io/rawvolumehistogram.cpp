@@ -0,0 +1,194 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/rawvolumehistogram.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+#include <inviwo/core/util/parallel.h>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+void accumulateSlab(const T* data, size3_t dims, size3_t sampleRate, dvec2 dataRange,
+                    size_t bins, const bool& stop,
+                    std::vector<util::detail::VolumeHistogramPartial<T>>& partials,
+                    std::false_type) {
+    const auto chunks = std::min(partials.size(), dims.z);
+    util::parallelFor(chunks, [&](size_t chunk) {
+        util::detail::accumulateVolumeHistogram(data, dims, chunk * dims.z / chunks,
+                                                (chunk + 1) * dims.z / chunks, sampleRate,
+                                                dataRange, bins, stop, partials[chunk]);
+    });
+}
+
+template <typename T>
+void accumulateSlab(const T* data, size3_t dims, size3_t sampleRate, dvec2, size_t,
+                    const bool& stop, std::vector<std::vector<size_t>>& partials,
+                    std::true_type) {
+    const auto chunks = std::min(partials.size(), dims.z);
+    util::parallelFor(chunks, [&](size_t chunk) {
+        util::detail::countVolumeValues(data, dims, chunk * dims.z / chunks,
+                                        (chunk + 1) * dims.z / chunks, sampleRate, stop,
+                                        partials[chunk]);
+    });
+}
+
+template <typename T>
+util::detail::VolumeHistogramPartial<T> mergePartials(
+    std::vector<util::detail::VolumeHistogramPartial<T>>& partials, dvec2, size_t) {
+    auto& res = partials.front();
+    for (size_t chunk = 1; chunk < partials.size(); ++chunk) res.merge(partials[chunk]);
+    return std::move(res);
+}
+
+template <typename T>
+util::detail::VolumeHistogramPartial<T> mergePartials(std::vector<std::vector<size_t>>& partials,
+                                                      dvec2 dataRange, size_t bins) {
+    auto& counts = partials.front();
+    for (size_t chunk = 1; chunk < partials.size(); ++chunk) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += partials[chunk][i];
+    }
+    return util::detail::binValueCounts<T>(counts, dataRange, bins);
+}
+
+template <typename T>
+std::vector<util::detail::VolumeHistogramPartial<T>> makePartials(size_t chunks, size_t bins,
+                                                                  std::false_type) {
+    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    return std::vector<util::detail::VolumeHistogramPartial<T>>(
+        chunks, util::detail::VolumeHistogramPartial<T>(bins, extent));
+}
+
+template <typename T>
+std::vector<std::vector<size_t>> makePartials(size_t chunks, size_t, std::true_type) {
+    return std::vector<std::vector<size_t>>(
+        chunks, std::vector<size_t>(util::detail::valueCountSize<T>(), 0));
+}
+
+HistogramContainer stoppedHistograms(size_t components, size_t bins) {
+    HistogramContainer histograms;
+    for (size_t i = 0; i < components; ++i) histograms.add(new NormalizedHistogram(bins));
+    return histograms;
+}
+
+struct RawVolumeHistogramDispatcher {
+    using type = HistogramContainer;
+
+    template <class DF>
+    HistogramContainer dispatch() {
+        using T = typename DF::type;
+        using UseValueCounts = util::detail::UseValueCounts<T>;
+
+        const auto dims = loader.getDimensions();
+        bins = util::detail::histogramBins<T>(bins, dataRange);
+
+        // Each slab holds a batch of sampled slices. When sampling every slice they are read in
+        // one go, otherwise each sampled slice is read separately and the rest are skipped.
+        const size_t sliceSize = dims.x * dims.y;
+        const size_t sliceBytes = std::max<size_t>(1, sliceSize * sizeof(T));
+        const size_t sampledSlices = (dims.z + sampleRate.z - 1) / sampleRate.z;
+        const size_t slabDepth =
+            glm::clamp<size_t>(maxSlabBytes / sliceBytes, 1, std::max<size_t>(1, sampledSlices));
+        const size3_t slabSampleRate(sampleRate.x, sampleRate.y, 1);
+
+        std::vector<T> slab(slabDepth * sliceSize);
+        const size_t chunks = util::detail::histogramChunks<T>(
+            util::parallelChunks(slabDepth), slabDepth * sliceSize, UseValueCounts{});
+        auto partials = makePartials<T>(chunks, bins, UseValueCounts{});
+
+        for (size_t first = 0; first < sampledSlices; first += slabDepth) {
+            if (stop) return stoppedHistograms(DF::components(), bins);
+            const size_t depth = std::min(slabDepth, sampledSlices - first);
+            if (sampleRate.z == 1) {
+                loader.readSlices(first, first + depth, slab.data());
+            } else {
+                for (size_t i = 0; i < depth; ++i) {
+                    const size_t z = (first + i) * sampleRate.z;
+                    loader.readSlices(z, z + 1, slab.data() + i * sliceSize);
+                }
+            }
+            accumulateSlab(slab.data(), size3_t(dims.x, dims.y, depth), slabSampleRate,
+                           dataRange, bins, stop, partials, UseValueCounts{});
+            if (progress) {
+                progress(static_cast<float>(first + depth) / static_cast<float>(sampledSlices));
+            }
+        }
+        if (stop) return stoppedHistograms(DF::components(), bins);
+
+        auto res = mergePartials<T>(partials, dataRange, bins);
+        return util::detail::makeVolumeHistograms(res, dataRange, bins);
+    }
+
+    const RawVolumeRAMLoader& loader;
+    dvec2 dataRange;
+    const bool& stop;
+    size_t bins;
+    size3_t sampleRate;
+    std::function<void(float)> progress;
+    size_t maxSlabBytes;
+};
+
+}  // namespace
+
+HistogramContainer util::calculateVolumeHistogram(const RawVolumeRAMLoader& loader,
+                                                  dvec2 dataRange, const bool& stop, size_t bins,
+                                                  size3_t sampleRate,
+                                                  std::function<void(float)> progress,
+                                                  size_t maxSlabBytes) {
+    RawVolumeHistogramDispatcher dispatcher{loader,     dataRange,          stop,
+                                            bins,       glm::max(sampleRate, size3_t(1)),
+                                            progress,   maxSlabBytes};
+    return loader.getDataFormat()->dispatch(dispatcher);
+}
+
+HistogramContainer util::calculateVolumeHistogram(const Volume& volume, const bool& stop,
+                                                  size_t bins, size3_t sampleRate,
+                                                  std::function<void(float)> progress,
+                                                  size_t maxSlabBytes) {
+    if (!volume.hasRepresentation<VolumeRAM>() && volume.hasRepresentation<VolumeDisk>()) {
+        const auto disk = volume.getRepresentation<VolumeDisk>();
+        if (auto loader = dynamic_cast<const RawVolumeRAMLoader*>(disk->getLoader())) {
+            return calculateVolumeHistogram(*loader, volume.dataMap_.dataRange, stop, bins,
+                                            sampleRate, progress, maxSlabBytes);
+        }
+    }
+
+    const auto ram = volume.getRepresentation<VolumeRAM>();
+    ram->calculateHistograms(bins, sampleRate, stop);
+    if (stop) return stoppedHistograms(volume.getDataFormat()->getComponents(), bins);
+    if (progress) progress(1.0f);
+    return *ram->getHistograms(bins, sampleRate);
+}
+
+}  // namespace inviwo
@@ -29,8 +29,17 @@
 
 #include <inviwo/core/io/rawvolumeramloader.h>
 
+#include <warn/push>
+#include <warn/ignore/all>
+#include <atomic>
+#include <warn/pop>
+
 namespace inviwo {
 
+namespace {
+std::atomic<bool> memoryMapping{false};
+}  // namespace
+
 RawVolumeRAMLoader::RawVolumeRAMLoader(const std::string& rawFile, size_t offset,
                                        size3_t dimensions, bool littleEndian,
                                        const DataFormatBase* format)
@@ -57,4 +66,41 @@ void RawVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentati
     util::readBytesIntoBuffer(rawFile_, offset_, size * format_->getSize(), littleEndian_,
                               format_->getSize(), volumeDst->getData());
 }
+
+void RawVolumeRAMLoader::readSlices(size_t zStart, size_t zEnd, void* dest) const {
+    if (zStart > zEnd || zEnd > dimensions_.z) {
+        throw Exception("Slice range out of bounds, can't read", IvwContext);
+    }
+    const size_t sliceBytes = dimensions_.x * dimensions_.y * format_->getSize();
+    util::readBytesIntoBuffer(rawFile_, offset_ + zStart * sliceBytes, (zEnd - zStart) * sliceBytes,
+                              littleEndian_, format_->getSize(), dest);
+}
+
+void RawVolumeRAMLoader::setMemoryMapping(bool enable) { memoryMapping = enable; }
+
+bool RawVolumeRAMLoader::getMemoryMapping() { return memoryMapping; }
+
+std::shared_ptr<MemoryMappedFile> RawVolumeRAMLoader::mapFile(size_t bytes,
+                                                              size_t alignment) const {
+    if (!memoryMapping) return nullptr;
+    // util::readBytesIntoBuffer swaps bytes of big endian data
+    if (!littleEndian_ && format_->getSize() > 1) return nullptr;
+    if (offset_ % alignment != 0) return nullptr;
+    try {
+        auto file =
+            std::make_shared<MemoryMappedFile>(rawFile_, MemoryMappedFile::Access::CopyOnWrite);
+        if (file->size() < offset_ + bytes || bytes == 0) return nullptr;
+        return file;
+    } catch (const FileException&) {
+        // fall back to reading the file
+        return nullptr;
+    }
+}
+
+const std::string& RawVolumeRAMLoader::getRawFile() const { return rawFile_; }
+
+const size3_t& RawVolumeRAMLoader::getDimensions() const { return dimensions_; }
+
+const DataFormatBase* RawVolumeRAMLoader::getDataFormat() const { return format_; }
+
 }  // namespace
@@ -0,0 +1,306 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/io/serialization/serializeconstants.h>
+#include <inviwo/core/io/serialization/serializationexception.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+constexpr char magic[4] = {'I', 'V', 'W', 'B'};
+constexpr std::uint32_t formatVersion = 1;
+
+enum class Op : std::uint32_t { ElementBegin, ElementEnd, Text, Comment, Declaration };
+
+// Flattens the document into ops refering to a table of unique strings
+class Encoder : public TiXmlVisitor {
+public:
+    virtual bool VisitEnter(const TiXmlElement& element,
+                            const TiXmlAttribute* firstAttribute) override {
+        op(Op::ElementBegin);
+        str(element.Value());
+        size_t count = 0;
+        for (auto a = firstAttribute; a; a = a->Next()) ++count;
+        ops.push_back(count);
+        for (auto a = firstAttribute; a; a = a->Next()) {
+            str(a->Name());
+            str(a->Value());
+        }
+        return true;
+    }
+    virtual bool VisitExit(const TiXmlElement&) override {
+        op(Op::ElementEnd);
+        return true;
+    }
+    virtual bool Visit(const TiXmlDeclaration& declaration) override {
+        op(Op::Declaration);
+        str(declaration.Version());
+        str(declaration.Encoding());
+        str(declaration.Standalone());
+        return true;
+    }
+    virtual bool Visit(const TiXmlText& text) override {
+        op(Op::Text);
+        str(text.Value());
+        return true;
+    }
+    virtual bool Visit(const TiXmlComment& comment) override {
+        op(Op::Comment);
+        str(comment.Value());
+        return true;
+    }
+
+    std::vector<std::string> strings;
+    std::vector<size_t> ops;
+
+private:
+    void op(Op o) { ops.push_back(static_cast<size_t>(o)); }
+    void str(const char* s) {
+        auto res = index.emplace(s, strings.size());
+        if (res.second) strings.emplace_back(s);
+        ops.push_back(res.first->second);
+    }
+
+    std::unordered_map<std::string, size_t> index;
+};
+
+// Unsigned LEB128
+void writeVarint(std::ostream& stream, size_t value) {
+    do {
+        unsigned char byte = value & 0x7f;
+        value >>= 7;
+        if (value) byte |= 0x80;
+        stream.put(static_cast<char>(byte));
+    } while (value);
+}
+
+class Reader {
+public:
+    explicit Reader(std::istream& stream) : stream_(stream) {}
+
+    size_t varint() {
+        size_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const auto c = stream_.get();
+            if (c == std::char_traits<char>::eof()) fail("Unexpected end of binary document");
+            value |= static_cast<size_t>(c & 0x7f) << shift;
+            if (!(c & 0x80)) return value;
+        }
+        fail("Invalid integer in binary document");
+        return 0;
+    }
+
+    const std::string& str() {
+        const auto i = varint();
+        if (i >= strings.size()) fail("Invalid string index in binary document");
+        return strings[i];
+    }
+
+    [[noreturn]] void fail(const std::string& message) {
+        throw SerializationException(message, IvwContextCustom("BinaryDocument"));
+    }
+
+    std::vector<std::string> strings;
+
+private:
+    std::istream& stream_;
+};
+
+}  // namespace
+
+void writeBinaryDocument(const TxDocument& doc, std::ostream& stream) {
+    Encoder encoder;
+    try {
+        doc.Accept(&encoder);
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IvwContextCustom("BinaryDocument"));
+    }
+
+    stream.write(magic, sizeof(magic));
+    writeVarint(stream, formatVersion);
+    writeVarint(stream, encoder.strings.size());
+    for (const auto& s : encoder.strings) {
+        writeVarint(stream, s.size());
+        stream.write(s.data(), s.size());
+    }
+    writeVarint(stream, encoder.ops.size());
+    for (auto v : encoder.ops) writeVarint(stream, v);
+
+    if (!stream) {
+        throw SerializationException("Could not write binary document",
+                                     IvwContextCustom("BinaryDocument"));
+    }
+}
+
+void readBinaryDocument(std::istream& stream, TxDocument& doc) {
+    if (!isBinaryDocument(stream)) {
+        throw SerializationException("Not a binary document", IvwContextCustom("BinaryDocument"));
+    }
+    stream.ignore(sizeof(magic));
+
+    Reader r(stream);
+    if (r.varint() != formatVersion) r.fail("Unsupported binary document version");
+
+    r.strings.resize(r.varint());
+    for (auto& s : r.strings) {
+        s.resize(r.varint());
+        if (!s.empty() && !stream.read(&s[0], s.size())) {
+            r.fail("Unexpected end of binary document");
+        }
+    }
+
+    const size_t opsSize = r.varint();
+    // ticpp wrappers of the open elements, the nodes themselves are owned by the document
+    std::vector<std::unique_ptr<TxElement>> open;
+    auto link = [&](TxNode* node) {
+        if (open.empty()) {
+            doc.LinkEndChild(node);
+        } else {
+            open.back()->LinkEndChild(node);
+        }
+    };
+
+    try {
+        // The op count only bounds the loop, ops consume a varying number of values
+        for (size_t read = 0; read < opsSize;) {
+            const auto op = static_cast<Op>(r.varint());
+            ++read;
+            switch (op) {
+                case Op::ElementBegin: {
+                    auto element = util::make_unique<TxElement>(r.str());
+                    const auto count = r.varint();
+                    read += 2 + 2 * count;
+                    for (size_t i = 0; i < count; ++i) {
+                        const auto& name = r.str();
+                        element->SetAttribute(name, r.str());
+                    }
+                    link(element.get());
+                    open.push_back(std::move(element));
+                    break;
+                }
+                case Op::ElementEnd:
+                    if (open.empty()) r.fail("Unbalanced elements in binary document");
+                    open.pop_back();
+                    break;
+                case Op::Text: {
+                    TxText text(r.str());
+                    ++read;
+                    link(&text);
+                    break;
+                }
+                case Op::Comment: {
+                    TxComment comment(r.str());
+                    ++read;
+                    link(&comment);
+                    break;
+                }
+                case Op::Declaration: {
+                    const auto& version = r.str();
+                    const auto& encoding = r.str();
+                    TxDeclaration declaration(version, encoding, r.str());
+                    read += 3;
+                    link(&declaration);
+                    break;
+                }
+                default:
+                    r.fail("Invalid node in binary document");
+            }
+        }
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IvwContextCustom("BinaryDocument"));
+    }
+    if (!open.empty()) r.fail("Unbalanced elements in binary document");
+}
+
+bool isBinaryDocument(std::istream& stream) {
+    const auto pos = stream.tellg();
+    char header[sizeof(magic)] = {};
+    stream.read(header, sizeof(header));
+    const bool binary = stream.gcount() == sizeof(header) &&
+                        std::equal(std::begin(header), std::end(header), std::begin(magic));
+    stream.clear();
+    stream.seekg(pos);
+    return binary;
+}
+
+void readDocument(std::istream& stream, TxDocument& doc) {
+    if (isBinaryDocument(stream)) {
+        readBinaryDocument(stream, doc);
+    } else {
+        stream >> doc;
+    }
+}
+
+void convertWorkspace(const std::string& src, const std::string& dst) {
+    TxDocument doc;
+    {
+        std::ifstream in(src.c_str(), std::ios::in | std::ios::binary);
+        if (!in) {
+            throw SerializationException("Could not open workspace file: " + src,
+                                         IvwContextCustom("BinaryDocument"));
+        }
+        readDocument(in, doc);
+    }
+
+    const bool binary = toLower(filesystem::getFileExtension(dst)) ==
+                        SerializeConstants::BinaryWorkspaceExtension;
+    std::ofstream out(dst.c_str(), binary ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!out) {
+        throw SerializationException("Could not open workspace file: " + dst,
+                                     IvwContextCustom("BinaryDocument"));
+    }
+    if (binary) {
+        writeBinaryDocument(doc, out);
+    } else {
+        TiXmlPrinter printer;
+        printer.SetIndent("    ");
+        doc.Accept(&printer);
+        out << printer.Str();
+    }
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -30,6 +30,7 @@
 #include <inviwo/core/io/serialization/deserializer.h>
 #include <inviwo/core/io/serialization/serializable.h>
 #include <inviwo/core/io/serialization/versionconverter.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/processors/processorfactory.h>
 #include <inviwo/core/metadata/metadatafactory.h>
@@ -39,12 +40,22 @@
 #include <inviwo/core/util/exception.h>
 #include <inviwo/core/util/stringconversion.h>
 
+#include <warn/push>
+#include <warn/ignore/all>
+#include <fstream>
+#include <warn/pop>
+
 namespace inviwo {
 
 Deserializer::Deserializer(std::string fileName, bool allowReference)
     : SerializeBase(fileName, allowReference) {
     try {
-        doc_.LoadFile();
+        std::ifstream stream(fileName.c_str(), std::ios::in | std::ios::binary);
+        if (stream && util::isBinaryDocument(stream)) {
+            util::readBinaryDocument(stream, doc_);
+        } else {
+            doc_.LoadFile();
+        }
         rootElement_ = doc_.FirstChildElement();
         storeReferences(rootElement_);
         rootElement_->GetAttribute(SerializeConstants::VersionAttribute, &inviwoWorkspaceVersion_,
@@ -94,12 +105,33 @@ void Deserializer::setExceptionHandler(ExceptionHandler handler) {
 
 void Deserializer::convertVersion(VersionConverter* converter) {
     if (converter->convert(rootElement_)) {
-        // Re-generate the reference table
+        // Re-generate the reference table, and drop the child index since nodes might have moved
+        childIndex_.clear();
         referenceLookup_.clear();
         storeReferences(doc_.FirstChildElement());
     }
 }
 
+TxElement* Deserializer::retrieveChild(const std::string& key) {
+    // Below this many lookups a linear scan is cheaper than building the index
+    constexpr size_t indexThreshold = 8;
+
+    auto& index = childIndex_[rootElement_];
+    if (index.lookups < indexThreshold) {
+        ++index.lookups;
+        return rootElement_->FirstChildElement(key, false);
+    }
+    if (!index.indexed) {
+        TxEIt child;
+        for (child = child.begin(rootElement_); child != child.end(); ++child) {
+            index.children.emplace(child->Value(), &(*child));
+        }
+        index.indexed = true;
+    }
+    auto it = index.children.find(key);
+    return it != index.children.end() ? it->second : nullptr;
+}
+
 void Deserializer::handleError(const ExceptionContext& context) {
     if (exceptionHandler_) {
         exceptionHandler_(context);
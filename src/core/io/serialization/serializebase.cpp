@@ -29,6 +29,7 @@
 
 #include <inviwo/core/io/serialization/serializebase.h>
 #include <inviwo/core/io/serialization/serializable.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
 #include <inviwo/core/common/inviwo.h>
 
 namespace inviwo {
@@ -39,6 +40,13 @@ size_t SerializeBase::ReferenceDataContainer::insert(const void* data, TxElement
     refData.node_ = node;
     refData.isPointer_ = isPointer;
     referenceMap_.insert(RefDataPair(data, refData));
+
+    const auto type = node->GetAttributeOrDefault(SerializeConstants::TypeAttribute, "");
+    for (const auto& attribute :
+         {SerializeConstants::RefAttribute, SerializeConstants::IDAttribute}) {
+        const auto value = node->GetAttributeOrDefault(attribute, "");
+        if (!value.empty()) lookup_.emplace(std::make_pair(type, value), const_cast<void*>(data));
+    }
     return referenceMap_.count(data);
 }
 
@@ -77,6 +85,10 @@ void* SerializeBase::ReferenceDataContainer::find(const std::string& type,
 
     if (reference_or_id.empty()) return data;
 
+    auto it = lookup_.find(std::make_pair(type, reference_or_id));
+    if (it != lookup_.end()) return it->second;
+
+    // Attributes might have been added after the node was inserted
     for (auto& elem : referenceMap_) {
         std::string type_attrib("");
         std::string ref_attrib("");
@@ -121,7 +133,7 @@ SerializeBase::SerializeBase(std::string fileName, bool allowReference)
 
 SerializeBase::SerializeBase(std::istream& stream, const std::string& path, bool allowReference)
     : fileName_(path), allowRef_(allowReference), retrieveChild_(true) {
-    stream >> doc_;
+    util::readDocument(stream, doc_);
 }
 
 const std::string& SerializeBase::getFileName() const { return fileName_; }
@@ -152,6 +164,10 @@ std::string SerializeBase::nodeToString(const TxElement& node) {
     }
 }
 
+TxElement* SerializeBase::retrieveChild(const std::string& key) {
+    return rootElement_->FirstChildElement(key, false);
+}
+
 NodeSwitch::NodeSwitch(SerializeBase& serializer, TxElement* node, bool retrieveChild)
     : serializer_(serializer)
     , storedNode_(serializer_.rootElement_)
@@ -166,9 +182,8 @@ NodeSwitch::NodeSwitch(SerializeBase& serializer, const std::string& key, bool r
     , storedNode_(serializer_.rootElement_)
     , storedRetrieveChild_(serializer_.retrieveChild_) {
 
-    serializer_.rootElement_ = serializer_.retrieveChild_
-                                   ? serializer_.rootElement_->FirstChildElement(key, false)
-                                   : serializer_.rootElement_;
+    serializer_.rootElement_ = serializer_.retrieveChild_ ? serializer_.retrieveChild(key)
+                                                          : serializer_.rootElement_;
 
     serializer_.retrieveChild_ = retrieveChild;
 }
@@ -29,6 +29,7 @@
 
 #include <inviwo/core/io/serialization/serializable.h>
 #include <inviwo/core/io/serialization/serializer.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
 #include <inviwo/core/util/exception.h>
 
 namespace inviwo {
@@ -96,4 +97,13 @@ void Serializer::writeFile(std::ostream& stream, bool format) {
     }
 }
 
+void Serializer::writeBinaryFile(std::ostream& stream) {
+    try {
+        refDataContainer_.setReferenceAttributes();
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IvwContext);
+    }
+    util::writeBinaryDocument(doc_, stream);
+}
+
 }  // namespace
@@ -38,8 +38,10 @@
 #include <inviwo/core/util/utilities.h>
 #include <inviwo/core/network/processornetworkconverter.h>
 #include <inviwo/core/network/networklock.h>
+#include <inviwo/core/util/settings/systemsettings.h>
 
 #include <algorithm>
+#include <chrono>
 
 namespace inviwo {
 
@@ -352,9 +354,24 @@ int ProcessorNetwork::getVersion() const {
 
 const int ProcessorNetwork::processorNetworkVersion_ = 15;
 
+namespace {
+
+using LoadClock = std::chrono::high_resolution_clock;
+
+double secondsSince(LoadClock::time_point start) {
+    return std::chrono::duration<double>(LoadClock::now() - start).count();
+}
+
+}  // namespace
+
 void ProcessorNetwork::deserialize(Deserializer& d) {
     NetworkLock lock(this);
-    
+    const auto start = LoadClock::now();
+    auto settings = application_ ? application_->getSettingsByType<SystemSettings>() : nullptr;
+    const bool logTimes = settings && settings->logWorkspaceLoadTimes_.get();
+    // Class identifier -> number of processors and total time to create and deserialize them
+    std::map<std::string, std::pair<size_t, double>> processorTimes;
+
     // This will set deserializing_ to true while keepTrueWillAlive is in scope
     // and set it to false no matter how we leave the scope
     util::KeepTrueWhileInScope keepTrueWillAlive(&deserializing_);
@@ -385,6 +402,14 @@ void ProcessorNetwork::deserialize(Deserializer& d) {
                 .onRemove([&](const std::string& id) {
                     removeAndDeleteProcessor(getProcessorByIdentifier(id));
                 });
+        if (logTimes) {
+            des.setItemTimer([&](const std::string& /*id*/, Processor*& p, double seconds) {
+                if (!p) return;
+                auto& time = processorTimes[p->getClassIdentifier()];
+                ++time.first;
+                time.second += seconds;
+            });
+        }
         des(d, processors_);
 
     } catch (const Exception& exception) {
@@ -399,6 +424,8 @@ void ProcessorNetwork::deserialize(Deserializer& d) {
         throw AbortException("Unknown Exception during deserialization.", IvwContext);
     }
 
+    const double processorsTime = secondsSince(start);
+
     // Connections
     try {
         auto toDelete = connections_;
@@ -447,6 +474,21 @@ void ProcessorNetwork::deserialize(Deserializer& d) {
         throw AbortException("Unknown Exception during deserialization.", IvwContext);
     }
 
+    if (logTimes) {
+        std::vector<std::pair<std::string, std::pair<size_t, double>>> times(
+            processorTimes.begin(), processorTimes.end());
+        std::sort(times.begin(), times.end(),
+                  [](const auto& a, const auto& b) { return a.second.second > b.second.second; });
+        std::stringstream ss;
+        ss << "Network loaded in " << secondsSince(start) << " s, processors took "
+           << processorsTime << " s";
+        for (const auto& item : times) {
+            ss << "\n    " << item.first << " (" << item.second.first
+               << "): " << item.second.second << " s";
+        }
+        LogNetworkInfo(ss.str());
+    }
+
     notifyObserversProcessorNetworkChanged();
 }
 
@@ -35,15 +35,85 @@
 #include <inviwo/core/network/networkutils.h>
 #include <inviwo/core/network/networklock.h>
 #include <inviwo/core/util/clock.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/core/ports/volumeport.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <algorithm>
+#include <warn/pop>
 
 namespace inviwo {
 
+namespace {
+
+// Collect the Data objects that are referenced by nothing but an outport, or by a volume sequence
+// or mesh that is itself only referenced by an outport. Nothing outside of the network can hold
+// pointers to their representations between evaluations, hence those can be evicted. Data held
+// elsewhere, for example by a processor or a volume sampler, is never evicted.
+std::unordered_set<const void*> getEvictableData(const ProcessorNetwork& network) {
+    std::unordered_set<const void*> evictable;
+    // getData returns a copy, the outport and the copy are the only references if unused
+    const long outportOnly = 2;
+    for (auto processor : network.getProcessors()) {
+        for (auto outport : processor->getOutports()) {
+            if (auto port = dynamic_cast<const VolumeOutport*>(outport)) {
+                auto volume = port->getData();
+                if (volume && volume.use_count() == outportOnly) {
+                    evictable.insert(static_cast<const Data<Volume, VolumeRepresentation>*>(
+                        volume.get()));
+                }
+            } else if (auto port = dynamic_cast<const VolumeSequenceOutport*>(outport)) {
+                auto sequence = port->getData();
+                if (!sequence || sequence.use_count() != outportOnly) continue;
+                for (const auto& volume : *sequence) {
+                    if (volume && volume.use_count() == 1) {
+                        evictable.insert(static_cast<const Data<Volume, VolumeRepresentation>*>(
+                            volume.get()));
+                    }
+                }
+            } else if (auto port = dynamic_cast<const MeshOutport*>(outport)) {
+                auto mesh = port->getData();
+                if (!mesh || mesh.use_count() != outportOnly) continue;
+                auto add = [&](const BufferBase* buffer) {
+                    evictable.insert(
+                        static_cast<const Data<BufferBase, BufferRepresentation>*>(buffer));
+                };
+                for (const auto& buffer : mesh->getBuffers()) {
+                    if (buffer.second.use_count() == 1) add(buffer.second.get());
+                }
+                for (const auto& buffer : mesh->getIndexBuffers()) {
+                    if (buffer.second.use_count() == 1) add(buffer.second.get());
+                }
+            }
+        }
+    }
+    return evictable;
+}
+
+}  // namespace
+
 ProcessorNetworkEvaluator::ProcessorNetworkEvaluator(ProcessorNetwork* processorNetwork)
     : processorNetwork_(processorNetwork)
-    , processorsSorted_(util::topologicalSort(processorNetwork_))
+    , processorsSorted_()
+    , sortedIndices_()
+    , editCount_(0)
+    , sortDirty_(true)
     , evaulationQueued_(false)
+    , parallelEvaluation_(false)
     , exceptionHandler_(StandardEvaluationErrorHandler()) {
-    
+
+    sortProcessors();
     processorNetwork_->addObserver(this);
 }
 
@@ -58,6 +128,9 @@ void ProcessorNetworkEvaluator::onProcessorNetworkEvaluateRequest() {
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkUnlocked() {
+    editCount_ = 0;
+    if (sortDirty_) sortProcessors();
+
     // Only evaluate if an evaluation is queued or the network is modified
     if (evaulationQueued_) {
         evaulationQueued_ = false;
@@ -93,6 +166,12 @@ void ProcessorNetworkEvaluator::requestEvaluate() {
     evaluate();
 }
 
+void ProcessorNetworkEvaluator::setParallelEvaluation(bool enable) {
+    parallelEvaluation_ = enable;
+}
+
+bool ProcessorNetworkEvaluator::getParallelEvaluation() const { return parallelEvaluation_; }
+
 void ProcessorNetworkEvaluator::evaluate() {
     // lock processor network to avoid concurrent evaluation
     NetworkLock lock(processorNetwork_);
@@ -100,69 +179,296 @@ void ProcessorNetworkEvaluator::evaluate() {
     notifyObserversProcessorNetworkEvaluationBegin();
     
     IVW_CPU_PROFILING_IF(500, "Evaluated Processor Network");
-    
+
+    if (sortDirty_) sortProcessors();
+
+    if (parallelEvaluation_) {
+        evaluateParallel();
+    } else {
+        evaluateSerial();
+    }
+
+    // Evict representations between evaluations, and only from data that is not referenced
+    // outside of the network since anyone else might hold raw pointers to representations.
+    auto manager = RepresentationMemoryManager::getPtr();
+    if (manager->isOverBudget()) {
+        manager->enforceBudget(getEvictableData(*processorNetwork_));
+    }
+
+    notifyObserversProcessorNetworkEvaluationEnd();
+}
+
+void ProcessorNetworkEvaluator::evaluateSerial() {
     for (auto processor : processorsSorted_) {
         if (!processor->isValid()) {
             if (processor->isReady()) {
-                try {
-                    // re-initialize resources (e.g., shaders) if necessary
-                    if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
-                        processor->initializeResources();
-                    }
-                    // call onChange for all invalid inports
-                    for (auto inport : processor->getInports()) {
-                        inport->callOnChangeIfChanged();
-                    }
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::InitResource, IvwContext);
-                    processor->setValid();
-                    continue;
-                }
-
+                if (!initializeProcessor(processor)) continue;
                 processor->notifyObserversAboutToProcess(processor);
+                processProcessor(processor);
+                finishProcessor(processor);
+            } else {
+                notReadyProcessor(processor);
+            }
+        }
+    }
+}
 
-                try {
-                    IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
-                    // do the actual processing
-                    processor->process();
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::Process, IvwContext);
-                }
+void ProcessorNetworkEvaluator::evaluateParallel() {
+    // Number of direct predecessors of each processor that have not been evaluated yet. A
+    // processor becomes ready when it reaches zero.
+    std::unordered_map<Processor*, size_t> waitingFor;
+    // Processors whose predecessors have all been evaluated, seeded in topological order.
+    std::deque<Processor*> ready;
+    for (auto processor : processorsSorted_) {
+        const auto count = util::getDirectPredecessors(processor).size();
+        waitingFor[processor] = count;
+        if (count == 0) ready.push_back(processor);
+    }
+    // Processors currently processed on the pool.
+    std::unordered_map<Processor*, std::future<void>> running;
+
+    const auto evaluated = [&](Processor* processor) {
+        for (auto successor : util::getDirectSuccessors(processor)) {
+            auto it = waitingFor.find(successor);
+            if (it != waitingFor.end() && --it->second == 0) ready.push_back(successor);
+        }
+    };
 
-                // Set processor as valid only if we still are ready. 
-                // Callbacks might have made our inports invalid, if so abort
-                // the evaluation by not setting the processor valid.
-                if (processor->isReady()) processor->setValid();
+    // Workers report finished processors here, the main thread will then finish them.
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<Processor*> done;
 
-                processor->notifyObserversFinishedProcess(processor);
+    for (;;) {
+        while (!ready.empty()) {
+            auto processor = ready.front();
+            ready.pop_front();
 
+            if (processor->isValid()) {
+                evaluated(processor);
+            } else if (!processor->isReady()) {
+                notReadyProcessor(processor);
+                evaluated(processor);
+            } else if (!initializeProcessor(processor)) {
+                evaluated(processor);
+            } else if (processor->requiresMainThread()) {
+                processor->notifyObserversAboutToProcess(processor);
+                processProcessor(processor);
+                finishProcessor(processor);
+                evaluated(processor);
             } else {
-                try {
-                    processor->doIfNotReady();
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::NotReady, IvwContext);
-                }
+                processor->notifyObserversAboutToProcess(processor);
+                running[processor] = dispatchPool([processor, &mutex, &condition, &done]() {
+                    util::OnScopeExit notify{[&]() {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            done.push_back(processor);
+                        }
+                        condition.notify_one();
+                    }};
+                    IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                    processor->process();
+                });
             }
         }
+
+        if (running.empty()) break;
+
+        // Wait for at least one processor on the pool to finish before scheduling more.
+        std::vector<Processor*> finished;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&done]() { return !done.empty(); });
+            std::swap(finished, done);
+        }
+        for (auto processor : finished) {
+            auto it = running.find(processor);
+            try {
+                it->second.get();
+            } catch (...) {
+                exceptionHandler_(processor, EvaluationType::Process, IvwContext);
+            }
+            running.erase(it);
+            finishProcessor(processor);
+            evaluated(processor);
+        }
     }
-    
-    notifyObserversProcessorNetworkEvaluationEnd();
 }
 
-void ProcessorNetworkEvaluator::onProcessorNetworkDidAddProcessor(Processor*) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+bool ProcessorNetworkEvaluator::initializeProcessor(Processor* processor) {
+    try {
+        // re-initialize resources (e.g., shaders) if necessary
+        if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
+            processor->initializeResources();
+        }
+        // call onChange for all invalid inports
+        for (auto inport : processor->getInports()) {
+            inport->callOnChangeIfChanged();
+        }
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::InitResource, IvwContext);
+        processor->setValid();
+        return false;
+    }
+    return true;
 }
 
-void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveProcessor(Processor*) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+void ProcessorNetworkEvaluator::processProcessor(Processor* processor) {
+    try {
+        IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+        // do the actual processing
+        processor->process();
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::Process, IvwContext);
+    }
 }
 
-void ProcessorNetworkEvaluator::onProcessorNetworkDidAddConnection(const PortConnection&) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+void ProcessorNetworkEvaluator::finishProcessor(Processor* processor) {
+    // Set processor as valid only if we still are ready.
+    // Callbacks might have made our inports invalid, if so abort
+    // the evaluation by not setting the processor valid.
+    if (processor->isReady()) processor->setValid();
+
+    processor->notifyObserversFinishedProcess(processor);
+}
+
+void ProcessorNetworkEvaluator::notReadyProcessor(Processor* processor) {
+    try {
+        processor->doIfNotReady();
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::NotReady, IvwContext);
+    }
+}
+
+void ProcessorNetworkEvaluator::onProcessorNetworkDidAddProcessor(Processor* processor) {
+    if (!beginNetworkEdit()) return;
+    // A new processor has no connections, hence it is only part of the order if it is a sink.
+    if (processor->isSink()) {
+        sortedIndices_[processor] = processorsSorted_.size();
+        processorsSorted_.push_back(processor);
+    }
+}
+
+void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveProcessor(Processor* processor) {
+    if (!beginNetworkEdit()) return;
+    // All connections have already been removed, so no other processor depends on this one.
+    auto it = sortedIndices_.find(processor);
+    if (it != sortedIndices_.end()) {
+        const auto index = it->second;
+        sortedIndices_.erase(it);
+        processorsSorted_.erase(processorsSorted_.begin() + index);
+        updateSortedIndices(index);
+    }
+}
+
+void ProcessorNetworkEvaluator::onProcessorNetworkDidAddConnection(
+    const PortConnection& connection) {
+    if (!beginNetworkEdit()) return;
+    addSortedConnection(connection.getOutport()->getProcessor(),
+                        connection.getInport()->getProcessor());
+}
+
+void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveConnection(
+    const PortConnection& connection) {
+    if (!beginNetworkEdit()) return;
+    // Removing an edge never invalidates the order, but the source might no longer reach a sink.
+    removeUnreachableProcessor(connection.getOutport()->getProcessor());
 }
 
-void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveConnection(const PortConnection&) {
+bool ProcessorNetworkEvaluator::beginNetworkEdit() {
+    // The first edit within a lock scope is applied incrementally, any further edits will mark
+    // the order as dirty and we sort once the network gets unlocked.
+    if (++editCount_ > 1) sortDirty_ = true;
+    return !sortDirty_;
+}
+
+void ProcessorNetworkEvaluator::sortProcessors() {
     processorsSorted_ = util::topologicalSort(processorNetwork_);
+    sortedIndices_.clear();
+    updateSortedIndices(0);
+    sortDirty_ = false;
+}
+
+void ProcessorNetworkEvaluator::updateSortedIndices(size_t start) {
+    for (size_t i = start; i < processorsSorted_.size(); ++i) {
+        sortedIndices_[processorsSorted_[i]] = i;
+    }
+}
+
+void ProcessorNetworkEvaluator::addSortedConnection(Processor* src, Processor* dst) {
+    // If dst does not reach a sink, neither will src through this connection.
+    auto dstIt = sortedIndices_.find(dst);
+    if (dstIt == sortedIndices_.end()) return;
+    const auto lower = dstIt->second;
+
+    // The order is still valid if src already precedes dst.
+    auto srcIt = sortedIndices_.find(src);
+    if (srcIt != sortedIndices_.end() && srcIt->second < lower) return;
+
+    // Find all predecessors of src (including src) that are either not part of the order yet or
+    // placed after dst. Predecessors that already precede dst need not be visited further.
+    std::vector<Processor*> added;
+    std::unordered_set<Processor*> visited;
+    size_t upper = lower;
+    std::function<void(Processor*)> visit = [&](Processor* p) {
+        if (!visited.insert(p).second) return;
+        auto it = sortedIndices_.find(p);
+        if (it != sortedIndices_.end() && it->second < lower) return;
+        for (auto predecessor : util::getDirectPredecessors(p)) visit(predecessor);
+        if (it == sortedIndices_.end()) {
+            added.push_back(p);
+        } else {
+            upper = std::max(upper, it->second);
+        }
+    };
+    visit(src);
+
+    // Processors that now reach a sink are inserted in front of dst, in post order.
+    const bool misplaced = upper > lower;
+    if (!added.empty()) {
+        processorsSorted_.insert(processorsSorted_.begin() + lower, added.begin(), added.end());
+        updateSortedIndices(lower);
+        upper += added.size();
+    }
+    if (!misplaced) return;
+
+    // Some predecessors of src are placed after dst. Only the range [lower, upper] has to be
+    // reordered, everything outside of it is still correctly ordered with respect to it.
+    std::vector<Processor*> range(processorsSorted_.begin() + lower,
+                                  processorsSorted_.begin() + upper + 1);
+    std::unordered_set<Processor*> inRange(range.begin(), range.end());
+    std::vector<Processor*> sorted;
+    sorted.reserve(range.size());
+    visited.clear();
+    std::function<void(Processor*)> sortRange = [&](Processor* p) {
+        if (!visited.insert(p).second) return;
+        for (auto predecessor : util::getDirectPredecessors(p)) {
+            if (inRange.count(predecessor) != 0) sortRange(predecessor);
+        }
+        sorted.push_back(p);
+    };
+    for (auto p : range) sortRange(p);
+
+    std::copy(sorted.begin(), sorted.end(), processorsSorted_.begin() + lower);
+    updateSortedIndices(lower);
+}
+
+void ProcessorNetworkEvaluator::removeUnreachableProcessor(Processor* processor) {
+    auto it = sortedIndices_.find(processor);
+    if (it == sortedIndices_.end() || processor->isSink()) return;
+    if (util::any_of(util::getDirectSuccessors(processor),
+                     [&](Processor* p) { return sortedIndices_.count(p) != 0; })) {
+        return;
+    }
+
+    const auto index = it->second;
+    sortedIndices_.erase(it);
+    processorsSorted_.erase(processorsSorted_.begin() + index);
+    updateSortedIndices(index);
+
+    for (auto predecessor : util::getDirectPredecessors(processor)) {
+        removeUnreachableProcessor(predecessor);
+    }
 }
 
 }  // namespace
@@ -30,6 +30,8 @@
 #include <inviwo/core/network/workspacemanager.h>
 
 #include <inviwo/core/io/serialization/versionconverter.h>
+#include <inviwo/core/io/serialization/serializeconstants.h>
+#include <inviwo/core/util/filesystem.h>
 #include <inviwo/core/common/inviwomodule.h>
 #include <inviwo/core/util/inviwosetupinfo.h>
 
@@ -139,7 +141,12 @@ void WorkspaceManager::save(std::ostream& stream, const std::string& refPath,
     serializer.serialize("InviwoSetup", info);
 
     serializers_.invoke(serializer, exceptionHandler);
-    serializer.writeFile(stream, true);
+    if (toLower(filesystem::getFileExtension(refPath)) ==
+        SerializeConstants::BinaryWorkspaceExtension) {
+        serializer.writeBinaryFile(stream);
+    } else {
+        serializer.writeFile(stream, true);
+    }
 }
 
 void WorkspaceManager::load(std::istream& stream, const std::string& refPath,
@@ -156,7 +163,7 @@ void WorkspaceManager::load(std::istream& stream, const std::string& refPath,
 }
 
 void WorkspaceManager::save(const std::string& path, const ExceptionHandler& exceptionHandler) {
-    if (auto ostream = std::ofstream(path.c_str())) {
+    if (auto ostream = std::ofstream(path.c_str(), std::ios::out | std::ios::binary)) {
         save(ostream, path, exceptionHandler);
     } else {
         throw AbortException("Could not open workspace file: " + path, IvwContext);
@@ -165,7 +172,7 @@ void WorkspaceManager::save(const std::string& path, const ExceptionHandler& exc
 
 void WorkspaceManager::load(const std::string& path, const ExceptionHandler& exceptionHandler) {
 
-    if (auto istream = std::ifstream(path.c_str())) {
+    if (auto istream = std::ifstream(path.c_str(), std::ios::in | std::ios::binary)) {
         load(istream, path, exceptionHandler);
     } else {
         throw AbortException("Could not open workspace file: " + path, IvwContext);
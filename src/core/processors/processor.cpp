@@ -286,6 +286,8 @@ bool Processor::isSink() const { return outports_.empty(); }
 
 bool Processor::isReady() const { return allInportsAreReady(); }
 
+bool Processor::requiresMainThread() const { return true; }
+
 bool Processor::allInportsAreReady() const {
     return util::all_of(
         inports_, [](Inport* p) { return (p->isOptional() && !p->isConnected()) || p->isReady(); });
@@ -0,0 +1,160 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/io/serialization/serializable.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/io/serialization/serializeconstants.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstdio>
+#include <fstream>
+#include <warn/pop>
+
+namespace inviwo {
+
+TEST(BinaryDocumentTest, RoundTrip) {
+    const std::string xml =
+        "<?xml version=\"1.0\" ?>\n"
+        "<!-- a comment -->\n"
+        "<Root version=\"1\">\n"
+        "    <Item identifier=\"a\" value=\"1.5\" />\n"
+        "    <Item identifier=\"b\" value=\"unicode \xC3\xA5\xC3\xA4\xC3\xB6\">some text</Item>\n"
+        "    <Empty />\n"
+        "</Root>\n";
+
+    TxDocument src;
+    std::stringstream xmlStream(xml);
+    xmlStream >> src;
+
+    std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+    util::writeBinaryDocument(src, binary);
+    EXPECT_TRUE(util::isBinaryDocument(binary));
+
+    TxDocument dst;
+    util::readBinaryDocument(binary, dst);
+
+    TiXmlPrinter srcPrinter;
+    src.Accept(&srcPrinter);
+    TiXmlPrinter dstPrinter;
+    dst.Accept(&dstPrinter);
+    EXPECT_EQ(std::string(srcPrinter.CStr()), std::string(dstPrinter.CStr()));
+}
+
+TEST(BinaryDocumentTest, Detection) {
+    std::stringstream xml("<?xml version=\"1.0\" ?>\n<Root />\n");
+    EXPECT_FALSE(util::isBinaryDocument(xml));
+
+    TxDocument doc;
+    util::readDocument(xml, doc);
+    ASSERT_NE(doc.FirstChildElement(false), nullptr);
+    EXPECT_EQ("Root", doc.FirstChildElement(false)->Value());
+
+    std::stringstream invalid("IVWB garbage");
+    TxDocument invalidDoc;
+    EXPECT_THROW(util::readBinaryDocument(invalid, invalidDoc), SerializationException);
+}
+
+TEST(BinaryDocumentTest, SerializerRoundTrip) {
+    std::string refpath = filesystem::findBasePath();
+    std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+
+    const std::vector<vec3> values{vec3(1.0f, 2.0f, 3.0f), vec3(-4.0f, 0.5f, 1e-3f)};
+    const std::map<std::string, int> map{{"one", 1}, {"two", 2}};
+    {
+        Serializer serializer(refpath);
+        serializer.serialize("Values", values, "Value");
+        serializer.serialize("Map", map, "Item");
+        serializer.serialize("Name", std::string("binary"));
+        serializer.writeBinaryFile(ss);
+    }
+
+    Deserializer deserializer(ss, refpath);
+    std::vector<vec3> outValues;
+    std::map<std::string, int> outMap;
+    std::string name;
+    deserializer.deserialize("Values", outValues, "Value");
+    deserializer.deserialize("Map", outMap, "Item");
+    deserializer.deserialize("Name", name);
+    EXPECT_EQ(values, outValues);
+    EXPECT_EQ(map, outMap);
+    EXPECT_EQ("binary", name);
+}
+
+TEST(BinaryDocumentTest, ConvertWorkspace) {
+    const std::string xml =
+        "<?xml version=\"1.0\" ?>\n"
+        "<InviwoWorkspace version=\"2\">\n"
+        "    <Processor type=\"a\" identifier=\"A\" />\n"
+        "    <Processor type=\"b\" identifier=\"B\">\n"
+        "        <Property value=\"0.25\" />\n"
+        "    </Processor>\n"
+        "</InviwoWorkspace>\n";
+
+    const auto dir = filesystem::getWorkingDirectory();
+    const auto src = dir + "/binarydocument-test-src.inv";
+    const auto binary =
+        dir + "/binarydocument-test." + SerializeConstants::BinaryWorkspaceExtension;
+    const auto dst = dir + "/binarydocument-test-dst.inv";
+    {
+        std::ofstream out(src.c_str());
+        out << xml;
+    }
+
+    util::convertWorkspace(src, binary);
+    util::convertWorkspace(binary, dst);
+
+    std::ifstream binaryIn(binary.c_str(), std::ios::in | std::ios::binary);
+    EXPECT_TRUE(util::isBinaryDocument(binaryIn));
+    binaryIn.close();
+
+    const auto print = [](const std::string& file) {
+        std::ifstream in(file.c_str(), std::ios::in | std::ios::binary);
+        TxDocument doc;
+        util::readDocument(in, doc);
+        TiXmlPrinter printer;
+        doc.Accept(&printer);
+        return std::string(printer.CStr());
+    };
+    EXPECT_EQ(print(src), print(binary));
+    EXPECT_EQ(print(src), print(dst));
+
+    for (const auto& file : {src, binary, dst}) std::remove(file.c_str());
+
+    EXPECT_THROW(util::convertWorkspace(src, dst), SerializationException);
+}
+
+}  // namespace inviwo
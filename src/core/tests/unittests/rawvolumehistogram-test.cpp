@@ -0,0 +1,127 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/rawvolumehistogram.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstdio>
+#include <fstream>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::vector<T> makeData(size3_t dims) {
+    std::vector<T> data(dims.x * dims.y * dims.z);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<T>((i * 37 + (i / 7) * 11) % 1000);
+    }
+    return data;
+}
+
+// Writes data to a raw file in the working directory that is removed again on destruction
+template <typename T>
+class TempRawFile {
+public:
+    TempRawFile(const std::vector<T>& data)
+        : file_(filesystem::getWorkingDirectory() + "/rawvolumehistogram-test.raw") {
+        std::ofstream out(file_, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+    }
+    ~TempRawFile() { std::remove(file_.c_str()); }
+    const std::string& file() const { return file_; }
+
+private:
+    std::string file_;
+};
+
+template <typename T>
+void compareWithRAMHistogram(size3_t sampleRate, size_t maxSlabBytes) {
+    const size3_t dims(13, 11, 17);
+    const dvec2 dataRange(0.0, 1000.0);
+    const auto data = makeData<T>(dims);
+    TempRawFile<T> raw(data);
+
+    RawVolumeRAMLoader loader(raw.file(), 0, dims, true, DataFormat<T>::get());
+    const auto streamed = util::calculateVolumeHistogram(loader, dataRange, false, 256,
+                                                         sampleRate, nullptr, maxSlabBytes);
+    const auto expected =
+        util::calculateVolumeHistogram(data.data(), dims, dataRange, false, 256, sampleRate);
+
+    ASSERT_EQ(expected.size(), streamed.size());
+    ASSERT_TRUE(streamed.isValid());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const auto& e = *expected[i].getData();
+        const auto& s = *streamed[i].getData();
+        ASSERT_EQ(e.size(), s.size());
+        for (size_t bin = 0; bin < e.size(); ++bin) EXPECT_DOUBLE_EQ(e[bin], s[bin]);
+        EXPECT_DOUBLE_EQ(expected[i].stats_.min, streamed[i].stats_.min);
+        EXPECT_DOUBLE_EQ(expected[i].stats_.max, streamed[i].stats_.max);
+        EXPECT_NEAR(expected[i].stats_.mean, streamed[i].stats_.mean, 1e-9);
+    }
+}
+
+}  // namespace
+
+TEST(RawVolumeHistogram, MatchesRAMHistogram) {
+    // A small slab size makes sure the file is read in several slabs
+    compareWithRAMHistogram<float>(size3_t(1), 4096);
+    compareWithRAMHistogram<unsigned short>(size3_t(1), 4096);
+}
+
+TEST(RawVolumeHistogram, MatchesRAMHistogramStrided) {
+    compareWithRAMHistogram<float>(size3_t(2, 1, 3), 4096);
+    compareWithRAMHistogram<unsigned short>(size3_t(1, 2, 4), 1);
+}
+
+TEST(RawVolumeHistogram, StopGivesInvalidHistograms) {
+    const size3_t dims(8, 8, 8);
+    const auto data = makeData<float>(dims);
+    TempRawFile<float> raw(data);
+
+    RawVolumeRAMLoader loader(raw.file(), 0, dims, true, DataFormat<float>::get());
+    const bool stop = true;
+    const auto histograms =
+        util::calculateVolumeHistogram(loader, dvec2(0.0, 1000.0), stop, 256);
+    EXPECT_EQ(1, histograms.size());
+    EXPECT_FALSE(histograms.isValid());
+}
+
+}  // namespace inviwo
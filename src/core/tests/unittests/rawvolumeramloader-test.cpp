@@ -0,0 +1,163 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <cstdio>
+#include <fstream>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+const size3_t dims(7, 5, 3);
+
+// Raw file in the working directory that is removed again on destruction
+class TempRawFile {
+public:
+    TempRawFile() : file_(filesystem::getWorkingDirectory() + "/rawvolumeramloader-test.raw") {}
+    ~TempRawFile() { std::remove(file_.c_str()); }
+
+    void write(const std::vector<unsigned char>& bytes) const {
+        std::ofstream out(file_, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    const std::string& file() const { return file_; }
+
+private:
+    std::string file_;
+};
+
+// Sets the memory mapping mode for the lifetime of the object
+class MemoryMappingScope {
+public:
+    MemoryMappingScope(bool enable) : previous_(RawVolumeRAMLoader::getMemoryMapping()) {
+        RawVolumeRAMLoader::setMemoryMapping(enable);
+    }
+    ~MemoryMappingScope() { RawVolumeRAMLoader::setMemoryMapping(previous_); }
+
+private:
+    bool previous_;
+};
+
+std::vector<uint16_t> makeValues() {
+    std::vector<uint16_t> values(dims.x * dims.y * dims.z);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<uint16_t>(i * 263 + 7);
+    return values;
+}
+
+std::vector<unsigned char> toBytes(const std::vector<uint16_t>& values, size_t offset,
+                                   bool littleEndian) {
+    std::vector<unsigned char> bytes(offset, 0xff);
+    for (auto v : values) {
+        const auto lo = static_cast<unsigned char>(v & 0xff);
+        const auto hi = static_cast<unsigned char>(v >> 8);
+        bytes.push_back(littleEndian ? lo : hi);
+        bytes.push_back(littleEndian ? hi : lo);
+    }
+    return bytes;
+}
+
+std::shared_ptr<VolumeRAM> load(const TempRawFile& raw, size_t offset, bool littleEndian,
+                                const DataFormatBase* format) {
+    RawVolumeRAMLoader loader(raw.file(), offset, dims, littleEndian, format);
+    return std::static_pointer_cast<VolumeRAM>(loader.createRepresentation());
+}
+
+void expectValues(const VolumeRAM& ram, const std::vector<uint16_t>& values) {
+    auto data = static_cast<const uint16_t*>(ram.getData());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], data[i]) << "at index " << i;
+    }
+}
+
+}  // namespace
+
+TEST(RawVolumeRAMLoader, MappedAndCopiedDataMatch) {
+    const auto values = makeValues();
+    TempRawFile raw;
+    raw.write(toBytes(values, 4, true));
+
+    for (bool mapping : {false, true}) {
+        MemoryMappingScope scope(mapping);
+        auto ram = load(raw, 4, true, DataUInt16::get());
+        ASSERT_EQ(DataUInt16::get(), ram->getDataFormat());
+        ASSERT_EQ(dims, ram->getDimensions());
+        expectValues(*ram, values);
+
+        // Writing to the representation must never change the file
+        static_cast<uint16_t*>(ram->getData())[0] = 0;
+        RawVolumeRAMLoader loader(raw.file(), 4, dims, true, DataUInt16::get());
+        std::vector<uint16_t> slices(dims.x * dims.y);
+        loader.readSlices(0, 1, slices.data());
+        EXPECT_EQ(values[0], slices[0]);
+    }
+}
+
+TEST(RawVolumeRAMLoader, BigEndianDataIsSwappedWhenMappingIsEnabled) {
+    MemoryMappingScope scope(true);
+    const auto values = makeValues();
+    TempRawFile raw;
+    raw.write(toBytes(values, 0, false));
+
+    auto ram = load(raw, 0, false, DataUInt16::get());
+    expectValues(*ram, values);
+}
+
+TEST(RawVolumeRAMLoader, UnalignedDataIsReadWhenMappingIsEnabled) {
+    MemoryMappingScope scope(true);
+    const auto values = makeValues();
+    TempRawFile raw;
+    raw.write(toBytes(values, 1, true));
+
+    auto ram = load(raw, 1, true, DataUInt16::get());
+    expectValues(*ram, values);
+}
+
+TEST(RawVolumeRAMLoader, CopiedDataIsIndependentOfFile) {
+    MemoryMappingScope scope(false);
+    const auto values = makeValues();
+    TempRawFile raw;
+    raw.write(toBytes(values, 0, true));
+
+    auto ram = load(raw, 0, true, DataUInt16::get());
+    raw.write(std::vector<unsigned char>(values.size() * 2, 0));
+    expectValues(*ram, values);
+}
+
+}  // namespace inviwo
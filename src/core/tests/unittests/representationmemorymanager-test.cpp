@@ -0,0 +1,161 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+namespace inviwo {
+
+namespace {
+
+struct TypeA {};
+struct TypeB {};
+
+RepresentationMemoryManager::Evictor makeEvictor(std::vector<int>& evicted, int id,
+                                                  bool allow = true) {
+    return [&evicted, id, allow]() -> std::shared_ptr<void> {
+        if (!allow) return nullptr;
+        evicted.push_back(id);
+        return std::make_shared<int>(id);
+    };
+}
+
+}  // namespace
+
+TEST(RepresentationMemoryManager, UnlimitedByDefault) {
+    RepresentationMemoryManager manager;
+    std::vector<int> evicted;
+    int owners[2];
+    manager.track(&owners[0], typeid(TypeA), 100, makeEvictor(evicted, 0));
+    manager.track(&owners[1], typeid(TypeA), 100, makeEvictor(evicted, 1));
+    EXPECT_FALSE(manager.isOverBudget());
+    manager.enforceBudget({&owners[0], &owners[1]});
+
+    EXPECT_EQ(200, manager.getUsage());
+    EXPECT_TRUE(evicted.empty());
+}
+
+TEST(RepresentationMemoryManager, EvictsLeastRecentlyUsed) {
+    RepresentationMemoryManager manager;
+    std::vector<int> evicted;
+    int owners[3];
+    manager.track(&owners[0], typeid(TypeA), 100, makeEvictor(evicted, 0));
+    manager.track(&owners[1], typeid(TypeA), 100, makeEvictor(evicted, 1));
+    manager.track(&owners[2], typeid(TypeB), 100, makeEvictor(evicted, 2));
+    manager.touch(&owners[0], typeid(TypeA));
+
+    manager.setBudget(150);
+    EXPECT_TRUE(manager.isOverBudget());
+    EXPECT_TRUE(evicted.empty());
+    manager.enforceBudget({&owners[0], &owners[1], &owners[2]});
+
+    EXPECT_FALSE(manager.isOverBudget());
+    EXPECT_EQ(std::vector<int>({1, 2}), evicted);
+    EXPECT_EQ(100, manager.getUsage());
+
+    const auto stats = manager.getStats();
+    EXPECT_EQ(1, stats.at(typeid(TypeA)).evictions);
+    EXPECT_EQ(1, stats.at(typeid(TypeA)).hits);
+    EXPECT_EQ(100, stats.at(typeid(TypeA)).bytes);
+    EXPECT_EQ(1, stats.at(typeid(TypeB)).evictions);
+    EXPECT_EQ(0, stats.at(typeid(TypeB)).bytes);
+}
+
+TEST(RepresentationMemoryManager, SkipsRepresentationsThatCanNotBeEvicted) {
+    RepresentationMemoryManager manager;
+    std::vector<int> evicted;
+    int owners[2];
+    manager.track(&owners[0], typeid(TypeA), 100, makeEvictor(evicted, 0, false));
+    manager.track(&owners[1], typeid(TypeA), 100, makeEvictor(evicted, 1));
+
+    manager.setBudget(50);
+    manager.enforceBudget({&owners[0], &owners[1]});
+
+    EXPECT_EQ(std::vector<int>({1}), evicted);
+    EXPECT_EQ(100, manager.getUsage());
+}
+
+TEST(RepresentationMemoryManager, OnlyEvictsGivenOwners) {
+    RepresentationMemoryManager manager;
+    std::vector<int> evicted;
+    int owners[3];
+    manager.track(&owners[0], typeid(TypeA), 100, makeEvictor(evicted, 0));
+    manager.track(&owners[1], typeid(TypeA), 100, makeEvictor(evicted, 1));
+    manager.track(&owners[2], typeid(TypeA), 100, makeEvictor(evicted, 2));
+
+    // The least recently used owner is referenced elsewhere and has to be kept
+    manager.setBudget(150);
+    manager.enforceBudget({&owners[1], &owners[2]});
+    EXPECT_EQ(std::vector<int>({1, 2}), evicted);
+    EXPECT_EQ(100, manager.getUsage());
+
+    manager.enforceBudget({});
+    EXPECT_EQ(std::vector<int>({1, 2}), evicted);
+}
+
+TEST(RepresentationMemoryManager, RemoveAllOfOwner) {
+    RepresentationMemoryManager manager;
+    std::vector<int> evicted;
+    int owners[2];
+    manager.track(&owners[0], typeid(TypeA), 100, makeEvictor(evicted, 0));
+    manager.track(&owners[0], typeid(TypeB), 50, makeEvictor(evicted, 1));
+    manager.track(&owners[1], typeid(TypeA), 10, makeEvictor(evicted, 2));
+    manager.track(&owners[1], typeid(TypeA), 20, makeEvictor(evicted, 2));
+    EXPECT_EQ(170, manager.getUsage());
+
+    manager.removeAll(&owners[0]);
+    EXPECT_EQ(20, manager.getUsage());
+    manager.remove(&owners[1], typeid(TypeA));
+    EXPECT_EQ(0, manager.getUsage());
+}
+
+TEST(RepresentationMemoryManager, TracksDataRepresentations) {
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto usage = manager->getUsage();
+    {
+        Volume volume(std::make_shared<VolumeRAMPrecision<vec2>>(size3_t{4, 5, 6}));
+        EXPECT_EQ(usage + 4 * 5 * 6 * sizeof(vec2), manager->getUsage());
+    }
+    EXPECT_EQ(usage, manager->getUsage());
+
+    // Bricked volumes limit their own cache and are not counted
+    {
+        Volume volume(std::make_shared<VolumeBricked>(size3_t{64, 64, 64}, DataFloat32::get()));
+        EXPECT_EQ(usage, manager->getUsage());
+    }
+}
+
+}  // namespace inviwo
@@ -235,6 +235,44 @@ TEST(SerializationTest, vectorOfPointersTest) {
     delete outVector[2];
 }
 
+TEST(SerializationTest, listTest) {
+    const std::list<MinimumSerilizableClass> inList{MinimumSerilizableClass(0.1f),
+                                                    MinimumSerilizableClass(0.2f),
+                                                    MinimumSerilizableClass(0.3f)};
+    std::string refpath = filesystem::findBasePath();
+    std::stringstream ss;
+    Serializer serializer(refpath);
+    serializer.serialize("serializedList", inList, "value");
+    serializer.writeFile(ss);
+    Deserializer deserializer(ss, refpath);
+    // Existing items are deserialized in place and missing ones appended
+    std::list<MinimumSerilizableClass> outList{MinimumSerilizableClass(1.0f)};
+    deserializer.deserialize("serializedList", outList, "value");
+    EXPECT_EQ(inList, outList);
+}
+
+TEST(SerializationTest, manyChildrenLookupTest) {
+    // Enough children for the deserializer to index them by name
+    const size_t count = 40;
+    std::string refpath = filesystem::findBasePath();
+    std::stringstream ss;
+    Serializer serializer(refpath);
+    for (size_t i = 0; i < count; ++i) {
+        serializer.serialize("value" + toString(i), static_cast<int>(i * i));
+    }
+    serializer.writeFile(ss);
+
+    Deserializer deserializer(ss, refpath);
+    for (size_t i = count; i-- > 0;) {
+        int value = -1;
+        deserializer.deserialize("value" + toString(i), value);
+        EXPECT_EQ(static_cast<int>(i * i), value);
+    }
+    int missing = -1;
+    deserializer.deserialize("missing", missing);
+    EXPECT_EQ(-1, missing);
+}
+
 TEST(SerializationTest, vec2Tests) {
     vec2 inVec(1.1f, 2.2f), outVec;
     outVec = serializationOfType(inVec);
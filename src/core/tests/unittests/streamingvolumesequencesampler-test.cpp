@@ -0,0 +1,172 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/streamingvolumesequencesampler.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/metadata/metadata.h>
+#include <inviwo/core/io/datareaderexception.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+// Creates a constant field (value, 0, 0) and counts the reads. Reads fail if fail is set, and
+// wait for gate to become ready if it is valid.
+class TestTimeStepLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    TestTimeStepLoader(float value, std::shared_ptr<std::vector<size_t>> reads, size_t index)
+        : value_(value), reads_(reads), index_(index) {}
+    virtual TestTimeStepLoader* clone() const override { return new TestTimeStepLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        ++(*reads_)[index_];
+        if (started) *started = true;
+        if (gate.valid()) gate.wait();
+        if (fail) throw DataReaderException("Test read failure", IvwContext);
+        auto ram = std::make_shared<VolumeRAMPrecision<vec3>>(size3_t(4));
+        auto data = ram->getDataTyped();
+        std::fill(data, data + 4 * 4 * 4, vec3(value_, 0.0f, 0.0f));
+        return ram;
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {}
+
+private:
+    float value_;
+    std::shared_ptr<std::vector<size_t>> reads_;
+    size_t index_;
+
+public:
+    bool fail = false;
+    std::shared_future<void> gate;
+    std::shared_ptr<std::atomic<bool>> started;
+};
+
+// The loader of each time step can be adjusted with configure
+std::shared_ptr<std::vector<std::shared_ptr<Volume>>> createSequence(
+    size_t size, std::shared_ptr<std::vector<size_t>> reads,
+    std::function<void(size_t, TestTimeStepLoader&)> configure = nullptr) {
+    reads->assign(size, 0);
+    auto seq = std::make_shared<std::vector<std::shared_ptr<Volume>>>();
+    for (size_t i = 0; i < size; ++i) {
+        auto disk = std::make_shared<VolumeDisk>(size3_t(4), DataVec3Float32::get());
+        auto loader = new TestTimeStepLoader(static_cast<float>(i), reads, i);
+        if (configure) configure(i, *loader);
+        disk->setLoader(loader);
+        auto volume = std::make_shared<Volume>(disk);
+        volume->setMetaData<DoubleMetaData>("timestamp", 0.1 * i);
+        seq->push_back(volume);
+    }
+    return seq;
+}
+
+}  // namespace
+
+TEST(StreamingVolumeSequenceSamplerTest, Interpolation) {
+    auto reads = std::make_shared<std::vector<size_t>>();
+    StreamingVolumeSequenceSampler sampler(createSequence(10, reads), 2, false);
+
+    EXPECT_EQ(10u, sampler.getNumberOfTimeSteps());
+    EXPECT_EQ(0u, sampler.getNumberOfResidentTimeSteps());
+    EXPECT_NEAR(2.5, sampler.sample(dvec4(0.5, 0.5, 0.5, 0.25)).x, 1e-9);
+    EXPECT_NEAR(9.0, sampler.sample(dvec4(0.5, 0.5, 0.5, 0.95)).x, 1e-9);
+
+    // Only the sampled time steps are read
+    EXPECT_EQ(3u, sampler.getNumberOfResidentTimeSteps());
+    EXPECT_EQ(std::vector<size_t>({0, 0, 1, 1, 0, 0, 0, 0, 0, 1}), *reads);
+}
+
+TEST(StreamingVolumeSequenceSamplerTest, SlidingWindow) {
+    auto reads = std::make_shared<std::vector<size_t>>();
+    StreamingVolumeSequenceSampler sampler(createSequence(10, reads), 2, false);
+
+    const double dt = 0.01;
+    for (double t = 0.0; t < 0.9; t += dt) {
+        sampler.setWindow(t, t + dt);
+        EXPECT_LE(sampler.getNumberOfResidentTimeSteps(), 3u);
+        const auto expected = t * 10.0;
+        EXPECT_NEAR(expected, sampler.sample(dvec4(0.5, 0.5, 0.5, t)).x, 1e-6);
+    }
+    // Every time step is read exactly once when moving through time
+    EXPECT_EQ(std::vector<size_t>(10, 1), *reads);
+
+    sampler.setWindow(0.45, 0.46, false);
+    EXPECT_EQ(2u, sampler.getNumberOfResidentTimeSteps());
+}
+
+TEST(StreamingVolumeSequenceSamplerTest, FailedReadThrows) {
+    auto reads = std::make_shared<std::vector<size_t>>();
+    StreamingVolumeSequenceSampler sampler(
+        createSequence(4, reads, [](size_t i, TestTimeStepLoader& loader) { loader.fail = i == 2; }),
+        2, false);
+
+    EXPECT_THROW(sampler.setWindow(0.2, 0.21), Exception);
+    EXPECT_NO_THROW(sampler.setWindow(0.0, 0.01));
+    EXPECT_NEAR(0.5, sampler.sample(dvec4(0.5, 0.5, 0.5, 0.05)).x, 1e-9);
+}
+
+TEST(StreamingVolumeSequenceSamplerTest, LoadDoesNotBlockResidentTimeSteps) {
+    auto reads = std::make_shared<std::vector<size_t>>();
+    std::promise<void> release;
+    auto started = std::make_shared<std::atomic<bool>>(false);
+    StreamingVolumeSequenceSampler sampler(
+        createSequence(10, reads,
+                       [&](size_t i, TestTimeStepLoader& loader) {
+                           if (i == 5) {
+                               loader.gate = release.get_future().share();
+                               loader.started = started;
+                           }
+                       }),
+        0, false);
+    sampler.setWindow(0.0, 0.01);
+
+    // Sample a time step outside of the window, its read waits for release
+    std::thread loading([&]() { sampler.sample(dvec4(0.5, 0.5, 0.5, 0.5)); });
+    while (!*started) std::this_thread::yield();
+
+    // Resident time steps can still be sampled while the read is in progress
+    EXPECT_NEAR(0.5, sampler.sample(dvec4(0.5, 0.5, 0.5, 0.05)).x, 1e-9);
+
+    release.set_value();
+    loading.join();
+    EXPECT_EQ(1u, (*reads)[5]);
+}
+
+}  // namespace inviwo
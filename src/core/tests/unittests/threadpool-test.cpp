@@ -0,0 +1,127 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/threadpool.h>
+
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+namespace inviwo {
+
+TEST(ThreadPoolTest, EnqueueResults) {
+    ThreadPool pool(4);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.enqueue([](int a) { return a * a; }, i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i * i, futures[i].get());
+    }
+}
+
+TEST(ThreadPoolTest, Priorities) {
+    ThreadPool pool(1);
+    std::promise<void> block;
+    auto blocker = block.get_future().share();
+    auto first = pool.enqueue([blocker]() { blocker.wait(); });
+
+    // Queue the tasks while the only worker is blocked, in reverse priority order
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto record = [&](int value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        order.push_back(value);
+    };
+    auto background = pool.enqueue(ThreadPool::Priority::Background, record, 3);
+    auto io = pool.enqueue(ThreadPool::Priority::IO, record, 2);
+    auto interactive = pool.enqueue(ThreadPool::Priority::Interactive, record, 1);
+    block.set_value();
+
+    first.get();
+    background.get();
+    io.get();
+    interactive.get();
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+}
+
+TEST(ThreadPoolTest, NestedTasks) {
+    ThreadPool pool(4);
+    auto res = pool.enqueue([&pool]() {
+        std::vector<std::future<size_t>> futures;
+        for (size_t i = 0; i < 16; ++i) {
+            futures.push_back(pool.enqueue([](size_t a) { return a; }, i));
+        }
+        size_t sum = 0;
+        for (auto& f : futures) sum += f.get();
+        return sum;
+    });
+    EXPECT_EQ(120u, res.get());
+}
+
+TEST(ThreadPoolTest, Cancellation) {
+    ThreadPool pool(1);
+    std::promise<void> block;
+    auto blocker = block.get_future().share();
+    auto first = pool.enqueue([blocker]() { blocker.wait(); });
+
+    CancellationToken token;
+    std::atomic<bool> ran{false};
+    auto cancelled = pool.enqueue(ThreadPool::Priority::Background, token, [&ran]() { ran = true; });
+    token.cancel();
+    block.set_value();
+
+    first.get();
+    EXPECT_THROW(cancelled.get(), std::future_error);
+    EXPECT_FALSE(ran);
+    // Shrinking to zero waits for the workers to finish counting
+    while (pool.trySetSize(0) != 0) {}
+    EXPECT_EQ(1u, pool.getStats().cancelled);
+    EXPECT_EQ(1u, pool.getStats().executed);
+}
+
+TEST(ThreadPoolTest, SubmitAndResize) {
+    ThreadPool pool(4);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit(ThreadPool::Priority::Background, [&count]() { ++count; });
+    }
+    // Shrinking to zero waits for all queued tasks to finish
+    while (pool.trySetSize(0) != 0) {}
+    EXPECT_EQ(1000, count);
+    EXPECT_EQ(1000u, pool.getStats().executed);
+}
+
+}  // namespace inviwo
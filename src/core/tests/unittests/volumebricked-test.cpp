@@ -0,0 +1,257 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/volumesampler.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+float voxelValue(const size3_t& p) { return static_cast<float>(p.x + 100 * p.y + 10000 * p.z); }
+
+std::shared_ptr<VolumeRAMPrecision<float>> createVolumeRAM(const size3_t& dims,
+                                                          const size3_t& offset = size3_t(0)) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[x + dims.x * (y + dims.y * z)] = voxelValue(offset + size3_t(x, y, z));
+            }
+        }
+    }
+    return ram;
+}
+
+struct ReadStats {
+    std::atomic<size_t> reads{0};
+    std::atomic<size_t> active{0};
+    std::atomic<size_t> maxActive{0};  ///< max number of reads in progress at the same time
+    std::chrono::milliseconds delay{0};
+};
+
+// Generates voxelValue for any requested region and counts the reads
+class TestRegionLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                         public VolumeRegionLoader {
+public:
+    TestRegionLoader(size3_t dims, std::shared_ptr<ReadStats> stats)
+        : dims_(dims), stats_(stats) {}
+    virtual TestRegionLoader* clone() const override { return new TestRegionLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        return readRegion(size3_t(0), dims_);
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {}
+    virtual std::shared_ptr<VolumeRAM> readRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const override {
+        ++stats_->reads;
+        const size_t active = ++stats_->active;
+        size_t max = stats_->maxActive;
+        while (active > max && !stats_->maxActive.compare_exchange_weak(max, active)) {
+        }
+        std::this_thread::sleep_for(stats_->delay);
+        auto ram = createVolumeRAM(dimensions, offset);
+        --stats_->active;
+        return ram;
+    }
+
+private:
+    size3_t dims_;
+    std::shared_ptr<ReadStats> stats_;
+};
+
+void expectRegion(const VolumeRAM& ram, const size3_t& offset) {
+    const auto dims = ram.getDimensions();
+    const auto data = static_cast<const float*>(ram.getData());
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                ASSERT_EQ(voxelValue(offset + size3_t(x, y, z)),
+                          data[x + dims.x * (y + dims.y * z)]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(VolumeBrickedTest, Bricks) {
+    VolumeBricked bricked(size3_t(10, 7, 5), DataFloat32::get(), size3_t(4), 1);
+    EXPECT_EQ(size3_t(3, 2, 2), bricked.getBrickCount());
+    EXPECT_EQ(12u, bricked.getNumberOfBricks());
+
+    const auto interior = bricked.getBrickInterior(size3_t(2, 1, 0));
+    EXPECT_EQ(size3_t(8, 4, 0), interior.offset);
+    EXPECT_EQ(size3_t(2, 3, 4), interior.dimensions);
+
+    const auto region = bricked.getBrickRegion(size3_t(2, 1, 0));
+    EXPECT_EQ(size3_t(7, 3, 0), region.offset);
+    EXPECT_EQ(size3_t(3, 4, 5), region.dimensions);
+}
+
+TEST(VolumeBrickedTest, SplitAndReadRegion) {
+    const size3_t dims(10, 7, 5);
+    VolumeBricked bricked(dims, DataFloat32::get(), size3_t(4), 1);
+    bricked.setBricks(*createVolumeRAM(dims));
+
+    expectRegion(*bricked.getBrick(size3_t(1, 1, 1)), size3_t(3, 3, 3));
+    expectRegion(*bricked.readRegion(size3_t(0), dims), size3_t(0));
+    expectRegion(*bricked.readRegion(size3_t(3, 2, 1), size3_t(6, 4, 3)), size3_t(3, 2, 1));
+
+    EXPECT_TRUE(bricked.hasBrickMinMax(size3_t(1, 0, 1)));
+    const auto minMax = bricked.getBrickMinMax(size3_t(1, 0, 1));
+    EXPECT_EQ(voxelValue(size3_t(4, 0, 4)), minMax.first.x);
+    EXPECT_EQ(voxelValue(size3_t(7, 3, 4)), minMax.second.x);
+    EXPECT_EQ(0u, bricked.getCachedBytes());
+}
+
+TEST(VolumeBrickedTest, CacheLimit) {
+    const size3_t dims(16, 16, 16);
+    auto stats = std::make_shared<ReadStats>();
+    auto disk = std::make_shared<VolumeDisk>("", dims, DataFloat32::get());
+    disk->setLoader(new TestRegionLoader(dims, stats));
+
+    VolumeBricked bricked(disk, size3_t(8), 1);
+    const size_t brickBytes = 9 * 9 * 9 * sizeof(float);
+    bricked.setCacheLimit(2 * brickBytes);
+
+    expectRegion(*bricked.getBrick(size3_t(0, 0, 0)), size3_t(0));
+    expectRegion(*bricked.getBrick(size3_t(1, 0, 0)), size3_t(7, 0, 0));
+    EXPECT_EQ(2u, stats->reads.load());
+    EXPECT_EQ(2 * brickBytes, bricked.getCachedBytes());
+
+    // Using brick 0 makes brick 1 the least recently used one
+    bricked.getBrick(size3_t(0, 0, 0));
+    bricked.getBrick(size3_t(0, 1, 0));
+    EXPECT_EQ(3u, stats->reads.load());
+    EXPECT_TRUE(bricked.isBrickInMemory(size3_t(0, 0, 0)));
+    EXPECT_FALSE(bricked.isBrickInMemory(size3_t(1, 0, 0)));
+    EXPECT_EQ(2 * brickBytes, bricked.getCachedBytes());
+
+    // Min max is kept for evicted bricks
+    const auto minMax = bricked.getBrickMinMax(size3_t(1, 0, 0));
+    EXPECT_EQ(3u, stats->reads.load());
+    EXPECT_EQ(voxelValue(size3_t(8, 0, 0)), minMax.first.x);
+    EXPECT_EQ(voxelValue(size3_t(15, 7, 7)), minMax.second.x);
+
+    // Bricks that have not been read are not read for their min max
+    EXPECT_FALSE(bricked.hasBrickMinMax(size3_t(1, 1, 1)));
+    const auto unknown = bricked.getBrickMinMax(size3_t(1, 1, 1));
+    EXPECT_EQ(3u, stats->reads.load());
+    EXPECT_EQ(DataFloat32::lowest(), unknown.first.x);
+    EXPECT_EQ(DataFloat32::max(), unknown.second.x);
+
+    expectRegion(*bricked.readRegion(size3_t(5), size3_t(7)), size3_t(5));
+    EXPECT_LE(bricked.getCachedBytes(), 2 * brickBytes);
+}
+
+TEST(VolumeBrickedTest, ConcurrentReads) {
+    const size3_t dims(16, 16, 16);
+    auto stats = std::make_shared<ReadStats>();
+    stats->delay = std::chrono::milliseconds(20);
+    auto disk = std::make_shared<VolumeDisk>("", dims, DataFloat32::get());
+    disk->setLoader(new TestRegionLoader(dims, stats));
+    VolumeBricked bricked(disk, size3_t(8), 1);
+
+    // Different bricks are read in parallel
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&bricked, i]() {
+            const size3_t brick(i % 2, i / 2, 0);
+            expectRegion(*bricked.getBrick(brick), bricked.getBrickRegion(brick).offset);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(4u, stats->reads.load());
+    EXPECT_LT(1u, stats->maxActive.load());
+
+    // Threads requesting the same brick wait for a single read
+    threads.clear();
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&bricked]() {
+            expectRegion(*bricked.getBrick(size3_t(1, 1, 1)), size3_t(7));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(5u, stats->reads.load());
+}
+
+TEST(VolumeBrickedTest, Sampler) {
+    const size3_t dims(10, 7, 5);
+    auto ram = createVolumeRAM(dims);
+    auto bricked = std::make_shared<VolumeBricked>(dims, DataFloat32::get(), size3_t(3), 1);
+    bricked->setBricks(*ram);
+
+    auto volume = std::make_shared<Volume>(ram);
+    auto brickedVolume = std::make_shared<Volume>(bricked);
+    VolumeDoubleSampler<1> reference(volume);
+    BrickedVolumeSampler<1> sampler(brickedVolume);
+
+    std::vector<dvec3> pos;
+    for (double z = 0.0; z <= 1.0; z += 0.125) {
+        for (double y = 0.0; y <= 1.0; y += 0.1) {
+            for (double x = 0.0; x <= 1.0; x += 0.07) pos.emplace_back(x, y, z);
+        }
+    }
+    std::vector<Vector<1, double>> result(pos.size());
+    sampler.sample(pos.data(), result.data(), pos.size());
+    for (size_t i = 0; i < pos.size(); ++i) {
+        EXPECT_NEAR(reference.sample(pos[i]), sampler.sample(pos[i]), 1e-6);
+        EXPECT_NEAR(reference.sample(pos[i]), result[i], 1e-6);
+    }
+}
+
+TEST(VolumeBrickedTest, SamplerReadsBricksOnDemand) {
+    const size3_t dims(16, 16, 16);
+    auto stats = std::make_shared<ReadStats>();
+    auto disk = std::make_shared<VolumeDisk>("", dims, DataFloat32::get());
+    disk->setLoader(new TestRegionLoader(dims, stats));
+    auto volume = std::make_shared<Volume>(std::make_shared<VolumeBricked>(disk, size3_t(8), 1));
+
+    BrickedVolumeSampler<1> sampler(volume);
+    EXPECT_EQ(0u, stats->reads.load());
+    EXPECT_NEAR(voxelValue(size3_t(15)), sampler.sample(dvec3(1.0)), 1e-6);
+    EXPECT_EQ(1u, stats->reads.load());
+}
+
+}  // namespace inviwo
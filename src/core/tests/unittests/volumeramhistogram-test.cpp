@@ -0,0 +1,142 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <algorithm>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::vector<T> makeData(size3_t dims) {
+    std::vector<T> data(dims.x * dims.y * dims.z);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<T>((i * 37 + (i / 7) * 11) % 200);
+    }
+    return data;
+}
+
+// Serial per voxel reference of the histogram bins
+template <typename T>
+std::vector<double> serialHistogram(const std::vector<T>& data, size3_t dims, dvec2 dataRange,
+                                    size_t bins, size3_t sampleRate) {
+    std::vector<double> counts(bins, 0.0);
+    util::IndexMapper3D mapper(dims);
+    const double scale = static_cast<double>(bins - 1) / (dataRange.y - dataRange.x);
+    for (size_t z = 0; z < dims.z; z += sampleRate.z) {
+        for (size_t y = 0; y < dims.y; y += sampleRate.y) {
+            for (size_t x = 0; x < dims.x; x += sampleRate.x) {
+                const double val = static_cast<double>(data[mapper(size3_t(x, y, z))]);
+                const auto bin = static_cast<size_t>((val - dataRange.x) * scale);
+                if (bin < bins) counts[bin] += 1.0;
+            }
+        }
+    }
+    return counts;
+}
+
+template <typename T>
+void compareWithSerialHistogram(size3_t sampleRate) {
+    const size3_t dims(13, 11, 17);
+    const dvec2 dataRange(0.0, 255.0);
+    const size_t bins = 64;
+    const auto data = makeData<T>(dims);
+
+    const auto histograms =
+        util::calculateVolumeHistogram(data.data(), dims, dataRange, false, bins, sampleRate);
+    const auto expected = serialHistogram(data, dims, dataRange, bins, sampleRate);
+
+    ASSERT_EQ(1, histograms.size());
+    ASSERT_TRUE(histograms.isValid());
+    const auto& result = *histograms[0].getData();
+    const double maxCount = histograms[0].getMaximumBinValue();
+    ASSERT_EQ(bins, result.size());
+    for (size_t bin = 0; bin < bins; ++bin) {
+        EXPECT_DOUBLE_EQ(expected[bin], result[bin] * maxCount) << "bin " << bin;
+    }
+}
+
+// Splitting the volume into several partials gives the same result as a single partial
+template <typename T>
+void compareChunks(size3_t sampleRate) {
+    const size3_t dims(13, 11, 17);
+    const dvec2 dataRange(0.0, 255.0);
+    const size_t bins = 64;
+    const auto data = makeData<T>(dims);
+    const bool stop = false;
+
+    const auto serial = util::detail::calculateVolumeHistogramPartial(
+        data.data(), dims, dataRange, stop, bins, sampleRate, 1,
+        util::detail::UseValueCounts<T>{});
+    for (size_t chunks : {2, 5, 17}) {
+        const auto chunked = util::detail::calculateVolumeHistogramPartial(
+            data.data(), dims, dataRange, stop, bins, sampleRate,
+            std::min(chunks, (dims.z + sampleRate.z - 1) / sampleRate.z),
+            util::detail::UseValueCounts<T>{});
+        EXPECT_EQ(serial.counts, chunked.counts);
+        EXPECT_EQ(serial.min, chunked.min);
+        EXPECT_EQ(serial.max, chunked.max);
+        EXPECT_EQ(serial.count, chunked.count);
+        EXPECT_EQ(serial.significant, chunked.significant);
+        EXPECT_NEAR(serial.sum, chunked.sum, 1e-6);
+    }
+}
+
+}  // namespace
+
+TEST(VolumeRAMHistogram, MatchesSerialHistogram) {
+    compareWithSerialHistogram<float>(size3_t(1));
+    compareWithSerialHistogram<unsigned char>(size3_t(1));
+    compareWithSerialHistogram<unsigned short>(size3_t(1));
+}
+
+TEST(VolumeRAMHistogram, MatchesSerialHistogramStrided) {
+    compareWithSerialHistogram<float>(size3_t(2, 1, 3));
+    compareWithSerialHistogram<unsigned char>(size3_t(1, 2, 4));
+}
+
+TEST(VolumeRAMHistogram, PartialsMatchSingleChunk) {
+    compareChunks<float>(size3_t(1));
+    compareChunks<double>(size3_t(1, 1, 2));
+    compareChunks<unsigned char>(size3_t(1));
+    compareChunks<unsigned short>(size3_t(2, 1, 3));
+}
+
+}  // namespace inviwo
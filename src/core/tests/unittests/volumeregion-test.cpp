@@ -0,0 +1,175 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/volumeutils.h>
+
+namespace inviwo {
+
+namespace {
+
+float voxelValue(const size3_t& p) { return static_cast<float>(p.x + 100 * p.y + 10000 * p.z); }
+
+struct Region {
+    size3_t offset;
+    size3_t dimensions;
+};
+
+// Generates voxelValue for any requested region and records the regions that are read
+class RecordingLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                        public VolumeRegionLoader {
+public:
+    RecordingLoader(size3_t dims, std::shared_ptr<std::vector<Region>> reads)
+        : dims_(dims), reads_(reads) {}
+    virtual RecordingLoader* clone() const override { return new RecordingLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        return readRegion(size3_t(0), dims_);
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {}
+    virtual std::shared_ptr<VolumeRAM> readRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const override {
+        reads_->push_back({offset, dimensions});
+        auto ram = std::make_shared<VolumeRAMPrecision<float>>(dimensions);
+        auto data = ram->getDataTyped();
+        for (size_t z = 0; z < dimensions.z; ++z) {
+            for (size_t y = 0; y < dimensions.y; ++y) {
+                for (size_t x = 0; x < dimensions.x; ++x) {
+                    data[x + dimensions.x * (y + dimensions.y * z)] =
+                        voxelValue(offset + size3_t(x, y, z));
+                }
+            }
+        }
+        return ram;
+    }
+
+private:
+    size3_t dims_;
+    std::shared_ptr<std::vector<Region>> reads_;
+};
+
+// A loader that can only read the full volume
+class FullLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    FullLoader(size3_t dims) : dims_(dims) {}
+    virtual FullLoader* clone() const override { return new FullLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        return std::make_shared<VolumeRAMPrecision<float>>(dims_);
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {}
+
+private:
+    size3_t dims_;
+};
+
+std::shared_ptr<Volume> createDiskVolume(const size3_t& dims,
+                                         DiskRepresentationLoader<VolumeRepresentation>* loader) {
+    auto disk = std::make_shared<VolumeDisk>("", dims, DataFloat32::get());
+    disk->setLoader(loader);
+    return std::make_shared<Volume>(disk);
+}
+
+void expectRegion(const VolumeRAM& ram, const size3_t& offset, const size3_t& dims) {
+    ASSERT_EQ(dims, ram.getDimensions());
+    const auto data = static_cast<const float*>(ram.getData());
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                ASSERT_EQ(voxelValue(offset + size3_t(x, y, z)),
+                          data[x + dims.x * (y + dims.y * z)]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(VolumeRegionTest, Subset) {
+    const size3_t dims(32, 24, 16);
+    auto reads = std::make_shared<std::vector<Region>>();
+    auto volume = createDiskVolume(dims, new RecordingLoader(dims, reads));
+
+    const size3_t offset(3, 5, 7);
+    const size3_t subset(10, 4, 6);
+    auto ram = util::readVolumeRegion(*volume, offset, subset);
+    ASSERT_TRUE(ram != nullptr);
+    expectRegion(*ram, offset, subset);
+
+    // Only the requested region is read, and no full RAM representation is created
+    ASSERT_EQ(1u, reads->size());
+    EXPECT_EQ(offset, reads->front().offset);
+    EXPECT_EQ(subset, reads->front().dimensions);
+    EXPECT_FALSE(volume->hasRepresentation<VolumeRAM>());
+}
+
+TEST(VolumeRegionTest, Slices) {
+    const size3_t dims(32, 24, 16);
+    auto reads = std::make_shared<std::vector<Region>>();
+    auto volume = createDiskVolume(dims, new RecordingLoader(dims, reads));
+
+    // One slice along each axis
+    const std::vector<Region> slices{{size3_t(0, 0, 9), size3_t(dims.x, dims.y, 1)},
+                                     {size3_t(0, 11, 0), size3_t(dims.x, 1, dims.z)},
+                                     {size3_t(31, 0, 0), size3_t(1, dims.y, dims.z)}};
+    for (const auto& slice : slices) {
+        auto ram = util::readVolumeRegion(*volume, slice.offset, slice.dimensions);
+        ASSERT_TRUE(ram != nullptr);
+        expectRegion(*ram, slice.offset, slice.dimensions);
+    }
+    ASSERT_EQ(slices.size(), reads->size());
+    for (size_t i = 0; i < slices.size(); ++i) {
+        EXPECT_EQ(slices[i].offset, (*reads)[i].offset);
+        EXPECT_EQ(slices[i].dimensions, (*reads)[i].dimensions);
+    }
+    EXPECT_FALSE(volume->hasRepresentation<VolumeRAM>());
+
+    EXPECT_THROW(util::readVolumeRegion(*volume, size3_t(0, 0, 16), size3_t(dims.x, dims.y, 1)),
+                 Exception);
+}
+
+TEST(VolumeRegionTest, Fallback) {
+    const size3_t dims(8, 8, 8);
+
+    // Use the RAM representation when there is one
+    Volume volume(std::make_shared<VolumeRAMPrecision<float>>(dims));
+    EXPECT_TRUE(util::readVolumeRegion(volume, size3_t(0), size3_t(2)) == nullptr);
+
+    // Loaders without region support
+    auto full = createDiskVolume(dims, new FullLoader(dims));
+    EXPECT_TRUE(util::readVolumeRegion(*full, size3_t(0), size3_t(2)) == nullptr);
+    EXPECT_FALSE(full->hasRepresentation<VolumeRAM>());
+}
+
+}  // namespace inviwo
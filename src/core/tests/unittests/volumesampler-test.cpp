@@ -0,0 +1,97 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+namespace inviwo {
+
+namespace {
+
+// a volume where the voxel values are linear in the voxel position
+std::shared_ptr<Volume> createLinearVolume() {
+    const size3_t dims{4, 3, 5};
+    auto ram = std::make_shared<VolumeRAMPrecision<glm::u8vec2>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[x + y * dims.x + z * dims.x * dims.y] =
+                    glm::u8vec2(x + 10 * y + 20 * z, 100 - x);
+            }
+        }
+    }
+    return std::make_shared<Volume>(ram);
+}
+
+dvec2 expected(const dvec3& pos) {
+    const dvec3 p = pos * dvec3(3.0, 2.0, 4.0);
+    return dvec2(p.x + 10.0 * p.y + 20.0 * p.z, 100.0 - p.x);
+}
+
+}  // namespace
+
+TEST(VolumeSamplerTest, sample) {
+    auto volume = createLinearVolume();
+    VolumeDoubleSampler<2> sampler(volume);
+    TypedVolumeSampler<glm::u8vec2> typed(volume);
+
+    const std::vector<dvec3> positions = {
+        dvec3(0.0), dvec3(1.0), dvec3(0.5), dvec3(0.1, 0.7, 0.3), dvec3(1.0, 0.25, 0.0)};
+    for (const auto& pos : positions) {
+        const auto value = sampler.sample(pos);
+        EXPECT_DOUBLE_EQ(expected(pos).x, value.x);
+        EXPECT_DOUBLE_EQ(expected(pos).y, value.y);
+
+        const auto typedValue = typed.sample(pos);
+        EXPECT_DOUBLE_EQ(value.x, typedValue.x);
+        EXPECT_DOUBLE_EQ(value.y, typedValue.y);
+    }
+
+    std::vector<dvec2> values(positions.size());
+    sampler.sample(positions.data(), values.data(), positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_DOUBLE_EQ(expected(positions[i]).x, values[i].x);
+    }
+
+    // first channel only, and outside of the volume
+    VolumeDoubleSampler<1> scalar(volume);
+    EXPECT_DOUBLE_EQ(expected(dvec3(0.5)).x, scalar.sample(dvec3(0.5)));
+    EXPECT_DOUBLE_EQ(0.0, scalar.sample(dvec3(1.5)));
+
+    EXPECT_THROW(TypedVolumeSampler<float>{volume}, Exception);
+}
+
+}  // namespace inviwo
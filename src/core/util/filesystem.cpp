@@ -31,7 +31,7 @@
 #include <inviwo/core/util/exception.h>
 #include <inviwo/core/util/tinydirinterface.h>
 
-// For directory exists
+// For directory exists, file size and modification time
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -126,6 +126,18 @@ bool fileExists(const std::string& filePath) {
     return (stat(filePath.c_str(), &buffer) == 0);
 }
 
+std::time_t fileModificationTime(const std::string& filePath) {
+    struct stat buffer;
+    if (stat(filePath.c_str(), &buffer) != 0) return 0;
+    return buffer.st_mtime;
+}
+
+size_t fileSize(const std::string& filePath) {
+    struct stat buffer;
+    if (stat(filePath.c_str(), &buffer) != 0) return 0;
+    return static_cast<size_t>(buffer.st_size);
+}
+
 bool directoryExists(const std::string& path) {
     struct stat buffer;
     // If path contains the location of a directory, it cannot contain a trailing backslash.
@@ -0,0 +1,155 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/memorymappedfile.h>
+#include <inviwo/core/util/exception.h>
+
+#ifdef WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace inviwo {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filePath, Access access)
+    : filePath_(filePath), access_(access) {
+    const bool copyOnWrite = access == Access::CopyOnWrite;
+#ifdef WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw FileException("Could not open file \"" + filePath + "\"", IvwContext);
+    }
+    file_ = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        unmap();
+        throw FileException("Could not query size of file \"" + filePath + "\"", IvwContext);
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    if (size_ == 0) return;
+
+    mapping_ = CreateFileMappingA(file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0,
+                                  0, nullptr);
+    if (!mapping_) {
+        unmap();
+        throw FileException("Could not map file \"" + filePath + "\"", IvwContext);
+    }
+    data_ = static_cast<char*>(
+        MapViewOfFile(mapping_, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        unmap();
+        throw FileException("Could not map file \"" + filePath + "\"", IvwContext);
+    }
+#else
+    file_ = ::open(filePath.c_str(), O_RDONLY);
+    if (file_ == -1) {
+        throw FileException("Could not open file \"" + filePath + "\"", IvwContext);
+    }
+    struct stat info;
+    if (::fstat(file_, &info) == -1) {
+        unmap();
+        throw FileException("Could not query size of file \"" + filePath + "\"", IvwContext);
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ == 0) return;
+
+    void* ptr = ::mmap(nullptr, size_, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ,
+                       MAP_PRIVATE, file_, 0);
+    if (ptr == MAP_FAILED) {
+        size_ = 0;
+        unmap();
+        throw FileException("Could not map file \"" + filePath + "\"", IvwContext);
+    }
+    data_ = static_cast<char*>(ptr);
+#endif
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs)
+    : filePath_(std::move(rhs.filePath_))
+    , access_(rhs.access_)
+    , data_(rhs.data_)
+    , size_(rhs.size_)
+    , file_(rhs.file_)
+#ifdef WIN32
+    , mapping_(rhs.mapping_)
+#endif
+{
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+#ifdef WIN32
+    rhs.file_ = nullptr;
+    rhs.mapping_ = nullptr;
+#else
+    rhs.file_ = -1;
+#endif
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& that) {
+    if (this != &that) {
+        unmap();
+        filePath_ = std::move(that.filePath_);
+        access_ = that.access_;
+        std::swap(data_, that.data_);
+        std::swap(size_, that.size_);
+        std::swap(file_, that.file_);
+#ifdef WIN32
+        std::swap(mapping_, that.mapping_);
+#endif
+    }
+    return *this;
+}
+
+MemoryMappedFile::~MemoryMappedFile() { unmap(); }
+
+void MemoryMappedFile::unmap() {
+#ifdef WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    if (data_) ::munmap(data_, size_);
+    if (file_ != -1) ::close(file_);
+    file_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+}  // namespace inviwo
@@ -0,0 +1,96 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/parallel.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <warn/pop>
+
+namespace inviwo {
+
+size_t util::getPoolSize() {
+    if (!InviwoApplication::isInitialized()) return 0;
+    return InviwoApplication::getPtr()->getPoolSize();
+}
+
+size_t util::parallelChunks(size_t count, size_t minChunkSize) {
+    const size_t chunksPerThread = 4;
+    const size_t maxChunks = chunksPerThread * (getPoolSize() + 1);
+    return std::max<size_t>(1, std::min(maxChunks, count / std::max<size_t>(minChunkSize, 1)));
+}
+
+void util::parallelFor(size_t count, const std::function<void(size_t)>& func,
+                       ThreadPool::Priority priority) {
+    if (count == 0) return;
+    const size_t helpers = std::min(getPoolSize(), count - 1);
+    if (helpers == 0) {
+        for (size_t i = 0; i < count; ++i) func(i);
+        return;
+    }
+
+    // Helpers might start after all work is done and we have returned, so the state is shared.
+    // func is only accessed for claimed indices, which we wait for, so it can be a reference.
+    struct State {
+        std::atomic<size_t> next{0};
+        size_t finished{0};
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+    auto state = std::make_shared<State>();
+    const auto work = [state, &func, count]() {
+        for (size_t i = state->next++; i < count; i = state->next++) {
+            std::exception_ptr exception;
+            try {
+                func(i);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (exception && !state->exception) state->exception = exception;
+            if (++state->finished == count) state->condition.notify_all();
+        }
+    };
+
+    auto app = InviwoApplication::getPtr();
+    for (size_t i = 0; i < helpers; ++i) app->dispatchPool(priority, work);
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&]() { return state->finished == count; });
+    if (state->exception) std::rethrow_exception(state->exception);
+}
+
+}  // namespace inviwo
@@ -32,6 +32,8 @@
 #include <inviwo/core/util/systemcapabilities.h>
 #include <inviwo/core/util/formatconversion.h>
 #include <inviwo/core/common/inviwocore.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
 
 namespace inviwo {
 
@@ -42,6 +44,7 @@ SystemSettings::SystemSettings()
                              {"developerMode", "Developer Mode", UsageMode::Development}},
                             1)
     , poolSize_("poolSize", "Pool Size", 4, 0, 32)
+    , parallelEvaluation_("parallelEvaluation", "Parallel network evaluation", false)
     , txtEditor_("txtEditor", "Use system text editor", true)
     , enablePortInformation_("enablePortInformation", "Enable port information", true)
     , enablePortInspectors_("enablePortInspectors", "Enable port inspectors", true)
@@ -54,7 +57,12 @@ SystemSettings::SystemSettings()
     , enablePickingProperty_("enablePicking", "Enable picking", true)
     , enableSoundProperty_("enableSound", "Enable sound", true)
     , useRAMPercentProperty_("useRAMPercent", "Max memory usage (%)", 50, 1, 100)
+    , representationMemoryBudget_("representationMemoryBudget",
+                                  "Representation memory budget (MB, 0 = unlimited)", 0, 0,
+                                  1024 * 1024)
+    , mapRawVolumeFiles_("mapRawVolumeFiles", "Memory map raw volume files", false)
     , logStackTraceProperty_("logStackTraceProperty", "Error stack trace log", false)
+    , logWorkspaceLoadTimes_("logWorkspaceLoadTimes", "Log workspace load times", false)
     , btnAllocTestProperty_("allocTest", "Perform Allocation Test")
     , btnSysInfoProperty_("printSysInfo", "Print System Info")
 
@@ -101,6 +109,7 @@ SystemSettings::SystemSettings()
 
     addProperty(applicationUsageMode_);
     addProperty(poolSize_);
+    addProperty(parallelEvaluation_);
     addProperty(txtEditor_);
     addProperty(enablePortInformation_);
     addProperty(enablePortInspectors_);
@@ -109,7 +118,10 @@ SystemSettings::SystemSettings()
     addProperty(enablePickingProperty_);
     addProperty(enableSoundProperty_);
     addProperty(useRAMPercentProperty_);
+    addProperty(representationMemoryBudget_);
+    addProperty(mapRawVolumeFiles_);
     addProperty(logStackTraceProperty_);
+    addProperty(logWorkspaceLoadTimes_);
     addProperty(pythonSyntax_);
     addProperty(glslSyntax_);
     addProperty(followObjectDuringRotation_);
@@ -130,6 +142,12 @@ SystemSettings::SystemSettings()
     pythonSyntax_.addProperty(pyTypeColor_);
 
     logStackTraceProperty_.onChange(this, &SystemSettings::logStacktraceCallback);
+    representationMemoryBudget_.onChange([this]() {
+        RepresentationMemoryManager::getPtr()->setBudget(
+            static_cast<size_t>(representationMemoryBudget_.get()) * 1024 * 1024);
+    });
+    mapRawVolumeFiles_.onChange(
+        [this]() { RawVolumeRAMLoader::setMemoryMapping(mapRawVolumeFiles_.get()); });
     // btnAllocTestProperty_.onChange(this, &SystemSettings::allocationTest);
     // addProperty(&btnAllocTestProperty_);
 
@@ -0,0 +1,282 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/streamingvolumesequencesampler.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/interpolation.h>
+#include <inviwo/core/util/parallel.h>
+
+namespace inviwo {
+
+StreamingVolumeSequenceSampler::StreamingVolumeSequenceSampler(
+    std::shared_ptr<const std::vector<std::shared_ptr<Volume>>> volumeSequence, size_t prefetch,
+    bool allowLooping)
+    : Spatial4DSampler<3, double>(volumeSequence->front())
+    , steps_()
+    , allowLooping_(allowLooping)
+    , prefetch_(prefetch)
+    , timeRange_(0, 0)
+    , totDuration_(0) {
+
+    const auto inf = std::numeric_limits<double>::infinity();
+    for (const auto &vol : *volumeSequence) {
+        auto step = util::make_unique<TimeStep>();
+        step->source = vol;
+        step->timestamp = vol->hasMetaData<DoubleMetaData>("timestamp")
+                              ? vol->getMetaData<DoubleMetaData>("timestamp")->get()
+                              : inf;
+        step->duration = vol->hasMetaData<DoubleMetaData>("duration")
+                             ? vol->getMetaData<DoubleMetaData>("duration")->get()
+                             : inf;
+        // Only time steps that are not already in memory are streamed from disk
+        if (!vol->hasRepresentation<VolumeRAM>() && vol->hasRepresentation<VolumeDisk>()) {
+            step->disk = vol->getRepresentation<VolumeDisk>();
+        }
+        steps_.push_back(std::move(step));
+    }
+
+    const auto size = static_cast<std::ptrdiff_t>(steps_.size());
+    const auto infsTime = std::count_if(steps_.begin(), steps_.end(),
+                                        [&](const auto &s) { return s->timestamp == inf; });
+    const auto infsDuration = std::count_if(steps_.begin(), steps_.end(),
+                                            [&](const auto &s) { return s->duration == inf; });
+
+    if (!(infsTime == 0 || infsTime == size) || !(infsDuration == 0 || infsDuration == size)) {
+        throw Exception("Volume sequence has timestamps or durations for only some time steps",
+                        IvwContext);
+    }
+
+    if (infsTime == 0) {
+        std::stable_sort(steps_.begin(), steps_.end(), [](const auto &a, const auto &b) {
+            return a->timestamp < b->timestamp;
+        });
+        for (size_t i = 0; i + 1 < steps_.size(); ++i) {
+            if (infsDuration == size) {
+                steps_[i]->duration = steps_[i + 1]->timestamp - steps_[i]->timestamp;
+            }
+        }
+        if (infsDuration == size) {
+            steps_.back()->duration =
+                steps_.size() > 1 ? steps_[steps_.size() - 2]->duration : 0.0;
+        }
+    } else {
+        const double dur = size > 1 ? 1.0 / (size - 1.0) : 0.0;
+        double t = 0;
+        for (auto &s : steps_) {
+            if (infsDuration == size) s->duration = dur;
+            s->timestamp = t;
+            t += s->duration;
+        }
+    }
+
+    for (auto &s : steps_) totDuration_ += s->duration;
+    timeRange_.x = steps_.front()->timestamp;
+    timeRange_.y = steps_.back()->timestamp + steps_.back()->duration;
+}
+
+StreamingVolumeSequenceSampler::~StreamingVolumeSequenceSampler() {
+    for (auto &step : steps_) step->token.cancel();
+}
+
+void StreamingVolumeSequenceSampler::setWindow(double t0, double t1, bool forward) const {
+    if (t1 < t0) std::swap(t0, t1);
+    const size_t n = steps_.size();
+
+    // Time steps needed for interpolation within the window
+    std::vector<char> keep(n, 0);
+    size_t first = 0;
+    size_t last = n - 1;
+    if (allowLooping_ && t1 - t0 >= totDuration_) {
+        std::fill(keep.begin(), keep.end(), 1);
+    } else {
+        first = indexOf(wrap(t0));
+        last = indexOf(wrap(t1));
+        for (size_t i = first;; i = (i + 1) % n) {
+            keep[i] = 1;
+            if (i == last) break;
+        }
+        if (last + 1 < n) keep[++last] = 1;
+    }
+
+    // Time steps to load in the background, ahead in the direction of integration
+    std::vector<char> ahead(n, 0);
+    size_t i = forward ? last : first;
+    for (size_t count = 0; count < prefetch_; ++count) {
+        if (forward) {
+            if (i + 1 == n && !allowLooping_) break;
+            i = (i + 1) % n;
+        } else {
+            if (i == 0 && !allowLooping_) break;
+            i = (i + n - 1) % n;
+        }
+        if (keep[i]) break;
+        ahead[i] = 1;
+    }
+
+    for (size_t j = 0; j < n; ++j) {
+        auto &step = *steps_[j];
+        std::lock_guard<std::mutex> lock(step.mutex);
+        if (ahead[j]) {
+            prefetch(step);
+        } else if (!keep[j]) {
+            evict(step);
+        }
+    }
+    for (size_t j = 0; j < n; ++j) {
+        if (!keep[j]) continue;
+        auto &step = *steps_[j];
+        std::lock_guard<std::mutex> lock(step.mutex);
+        load(step);
+    }
+}
+
+size_t StreamingVolumeSequenceSampler::getNumberOfResidentTimeSteps() const {
+    return std::count_if(steps_.begin(), steps_.end(),
+                         [](const auto &s) { return s->resident.load() != nullptr; });
+}
+
+size_t StreamingVolumeSequenceSampler::getNumberOfTimeSteps() const { return steps_.size(); }
+
+dvec2 StreamingVolumeSequenceSampler::getTimeRange() const { return timeRange_; }
+
+dvec3 StreamingVolumeSequenceSampler::sampleDataSpace(const dvec4 &pos) const {
+    double t = pos.w;
+    if (t < timeRange_.x || t > timeRange_.y) {
+        if (!allowLooping_) return dvec3(0);
+        t = wrap(t);
+    }
+
+    const auto spatialPos = dvec3(pos);
+    const auto i = indexOf(t);
+    const auto val0 = get(i).sample(spatialPos);
+    if (i + 1 >= steps_.size()) return val0;
+    const auto val1 = get(i + 1).sample(spatialPos);
+
+    const double x = (t - steps_[i]->timestamp) / steps_[i]->duration;
+    return Interpolation<dvec3>::linear(val0, val1, x);
+}
+
+bool StreamingVolumeSequenceSampler::withinBoundsDataSpace(const dvec4 &pos) const {
+    if (glm::any(glm::lessThan(dvec3(pos), dvec3(0.0)))) {
+        return false;
+    }
+    if (glm::any(glm::greaterThan(dvec3(pos), dvec3(1.0)))) {
+        return false;
+    }
+    return true;
+}
+
+size_t StreamingVolumeSequenceSampler::indexOf(double t) const {
+    auto it = std::upper_bound(steps_.begin(), steps_.end(), t,
+                               [](double t2, const auto &s) { return t2 < s->timestamp; });
+    return it == steps_.begin() ? 0 : static_cast<size_t>(std::distance(steps_.begin(), it)) - 1;
+}
+
+double StreamingVolumeSequenceSampler::wrap(double t) const {
+    if (!allowLooping_ || totDuration_ <= 0.0) {
+        return glm::clamp(t, timeRange_.x, timeRange_.y);
+    }
+    if (t < timeRange_.x || t > timeRange_.y) {
+        t = timeRange_.x + std::fmod(t - timeRange_.x, totDuration_);
+        if (t < timeRange_.x) t += totDuration_;
+    }
+    return t;
+}
+
+const VolumeDoubleSampler<3> &StreamingVolumeSequenceSampler::get(size_t index) const {
+    auto &step = *steps_[index];
+    if (auto sampler = step.resident.load(std::memory_order_acquire)) return *sampler;
+
+    // Only threads that need this time step wait for it to be loaded
+    std::lock_guard<std::mutex> lock(step.mutex);
+    load(step);
+    return *step.sampler;
+}
+
+void StreamingVolumeSequenceSampler::load(TimeStep &step) const {
+    if (step.resident.load()) return;
+
+    std::shared_ptr<const Volume> volume;
+    if (!step.disk) {
+        volume = step.source;
+    } else if (step.pending.valid()) {
+        try {
+            volume = step.pending.get();
+        } catch (const std::exception &) {
+            // The prefetch was cancelled before it started or failed, read it here instead
+        }
+    }
+    if (!volume) volume = read(*step.source, *step.disk);
+
+    step.sampler = util::make_unique<VolumeDoubleSampler<3>>(volume);
+    step.resident.store(step.sampler.get(), std::memory_order_release);
+}
+
+void StreamingVolumeSequenceSampler::prefetch(TimeStep &step) const {
+    if (step.resident.load() || step.pending.valid() || !step.disk) return;
+    if (util::getPoolSize() == 0) return;  // Will be read on demand instead
+
+    step.token = CancellationToken();
+    step.pending = InviwoApplication::getPtr()->dispatchPool(
+        ThreadPool::Priority::IO, step.token,
+        [source = step.source, disk = step.disk]() { return read(*source, *disk); });
+}
+
+void StreamingVolumeSequenceSampler::evict(TimeStep &step) const {
+    if (step.pending.valid()) {
+        step.token.cancel();
+        step.pending = std::future<std::shared_ptr<const Volume>>();
+    }
+    step.resident.store(nullptr);
+    step.sampler.reset();
+}
+
+std::shared_ptr<const Volume> StreamingVolumeSequenceSampler::read(const Volume &source,
+                                                                   const VolumeDisk &disk) {
+    std::shared_ptr<VolumeRAM> ram;
+    try {
+        ram = std::dynamic_pointer_cast<VolumeRAM>(disk.createRepresentation());
+    } catch (const std::exception &e) {
+        throw Exception("Could not read time step " + disk.getSourceFile() + ": " + e.what(),
+                        IvwContextCustom("StreamingVolumeSequenceSampler"));
+    }
+    if (!ram) {
+        throw Exception("Could not read time step " + disk.getSourceFile() + " into memory",
+                        IvwContextCustom("StreamingVolumeSequenceSampler"));
+    }
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setModelMatrix(source.getModelMatrix());
+    volume->setWorldMatrix(source.getWorldMatrix());
+    volume->dataMap_ = source.dataMap_;
+    return volume;
+}
+
+}  // namespace inviwo
@@ -33,21 +33,35 @@
 
 namespace inviwo {
 
+CancellationToken::CancellationToken() : cancelled_{std::make_shared<std::atomic<bool>>(false)} {}
+
+void CancellationToken::cancel() { *cancelled_ = true; }
+
+bool CancellationToken::isCancelled() const { return *cancelled_; }
+
 // the constructor just launches some amount of workers
 ThreadPool::ThreadPool(size_t threads, std::function<void()> onThreadStart,
                        std::function<void()> onThreadStop)
-    : onThreadStart_{std::move(onThreadStart)}, onThreadStop_{std::move(onThreadStop)} {
+    : pending{0}
+    , executed{0}
+    , stolen{0}
+    , cancelled{0}
+    , onThreadStart_{std::move(onThreadStart)}
+    , onThreadStop_{std::move(onThreadStop)} {
+    std::unique_lock<std::mutex> lock(workers_mutex);
     while (workers.size() < threads) {
         workers.push_back(util::make_unique<Worker>(*this));
     }
 }
 
 size_t ThreadPool::trySetSize(size_t size) {
-    while (workers.size() < size) {
-        workers.push_back(util::make_unique<Worker>(*this));
-    }
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex);
+        while (workers.size() < size) {
+            workers.push_back(util::make_unique<Worker>(*this));
+        }
+        if (workers.size() <= size) return workers.size();
 
-    if (workers.size() > size) {
         auto active = workers.size();
         for (auto& worker : workers) {
             auto exprected = State::Free;
@@ -58,47 +72,181 @@ size_t ThreadPool::trySetSize(size_t size) {
             }
             if (active <= size) break;
         }
+    }
 
-        condition.notify_all();
+    // make sure no worker is between checking its state and going to sleep
+    { std::unique_lock<std::mutex> lock(queue_mutex); }
+    condition.notify_all();
 
-        util::erase_remove_if(workers, [this](std::unique_ptr<Worker>& worker) {
-            return worker->state == State::Done;
-        });
+    // join the finished workers outside of the lock, since they might want to steal tasks.
+    std::vector<std::unique_ptr<Worker>> done;
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex);
+        for (auto& worker : workers) {
+            if (worker->state == State::Done) done.push_back(std::move(worker));
+        }
+        util::erase_remove(workers, nullptr);
     }
+    done.clear();
+
     return workers.size();
 }
 
-size_t ThreadPool::getSize() const { return workers.size(); }
+size_t ThreadPool::getSize() const {
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    return workers.size();
+}
+
+ThreadPool::Stats ThreadPool::getStats() const {
+    Stats stats{};
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        for (size_t i = 0; i < tasks.size(); ++i) stats.queued[i] = tasks[i].size();
+    }
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex);
+        for (auto& worker : workers) {
+            std::unique_lock<std::mutex> workerLock(worker->mutex);
+            stats.local += worker->tasks.size();
+        }
+    }
+    stats.executed = executed;
+    stats.stolen = stolen;
+    stats.cancelled = cancelled;
+    return stats;
+}
 
 ThreadPool::~ThreadPool() {
-    for (auto& worker : workers) worker->state = State::Abort;
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex);
+        for (auto& worker : workers) worker->state = State::Abort;
+    }
+    { std::unique_lock<std::mutex> lock(queue_mutex); }
     condition.notify_all();
-    workers.clear(); // this will join all threads.
+
+    std::vector<std::unique_ptr<Worker>> done;
+    {
+        std::unique_lock<std::mutex> lock(workers_mutex);
+        std::swap(done, workers);
+    }
+    done.clear(); // this will join all threads.
+}
+
+void ThreadPool::push(Priority priority, detail::PoolTask task) {
+    auto worker = currentWorker();
+    if (worker && &worker->pool == this) {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->tasks.push_back(std::move(task));
+    } else {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        tasks[static_cast<size_t>(priority)].push(std::move(task));
+        ++pending;
+        lock.unlock();
+        condition.notify_one();
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        ++pending;
+    }
+    condition.notify_one();
+}
+
+detail::PoolTask ThreadPool::take(Worker& worker) {
+    // The calling worker has already claimed a task by decrementing pending, hence we are
+    // guaranteed to find one, although it might take a few tries if another worker is faster.
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty()) {
+                auto task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                return task;
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            for (auto& queue : tasks) {
+                if (!queue.empty()) {
+                    auto task = std::move(queue.front());
+                    queue.pop();
+                    return task;
+                }
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(workers_mutex);
+            for (auto& other : workers) {
+                if (other.get() == &worker) continue;
+                std::unique_lock<std::mutex> otherLock(other->mutex);
+                if (!other->tasks.empty()) {
+                    auto task = std::move(other->tasks.front());
+                    other->tasks.pop_front();
+                    ++stolen;
+                    return task;
+                }
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::release(Worker& worker) {
+    // Hand over any remaining sub tasks to the global queue, they might have been claimed by
+    // another worker already.
+    std::deque<detail::PoolTask> remaining;
+    {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        std::swap(remaining, worker.tasks);
+    }
+    if (remaining.empty()) return;
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    for (auto& task : remaining) {
+        tasks[static_cast<size_t>(Priority::Interactive)].push(std::move(task));
+    }
+}
+
+ThreadPool::Worker*& ThreadPool::currentWorker() {
+    static thread_local Worker* worker = nullptr;
+    return worker;
 }
 
 ThreadPool::Worker::~Worker() { thread.join(); }
 
 ThreadPool::Worker::Worker(ThreadPool& pool)
-    : state{ State::Free }
-    , thread{ [this, &pool]() {
-        pool.onThreadStart_();
-        util::OnScopeExit cleanup{[&pool]() { pool.onThreadStop_(); }};
+    : pool{pool}
+    , state{ State::Free }
+    , thread{ [this]() {
+        this->pool.onThreadStart_();
+        util::OnScopeExit cleanup{[this]() { this->pool.onThreadStop_(); }};
+        currentWorker() = this;
 
-        std::function<void()> task;
         for (;;) {
-            state = State::Free;
             {
-                std::unique_lock<std::mutex> lock(pool.queue_mutex);
-                pool.condition.wait(lock, [this, &pool] {
-                    return state == State::Abort || state == State::Stop || !pool.tasks.empty();
+                std::unique_lock<std::mutex> lock(this->pool.queue_mutex);
+                this->pool.condition.wait(lock, [this] {
+                    return state == State::Abort || state == State::Stop ||
+                           this->pool.pending > 0;
                 });
-                if (state == State::Abort || (state == State::Stop && pool.tasks.empty())) break;
-                task = std::move(pool.tasks.front());
-                pool.tasks.pop();
+                if (state == State::Abort || this->pool.pending == 0) break;
+                --this->pool.pending;
             }
-            state = State::Working;
+            auto task = this->pool.take(*this);
+
+            auto expected = State::Free;
+            state.compare_exchange_strong(expected, State::Working);
             task();
+            if (discarded) {
+                discarded = false;
+                ++this->pool.cancelled;
+            } else {
+                ++this->pool.executed;
+            }
+            expected = State::Working;
+            state.compare_exchange_strong(expected, State::Free);
         }
+        this->pool.release(*this);
+        currentWorker() = nullptr;
         state = State::Done;
 
     } } {}
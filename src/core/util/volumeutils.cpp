@@ -29,6 +29,9 @@
 
 #include <inviwo/core/util/volumeutils.h>
 #include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
 
 namespace inviwo {
 
@@ -85,6 +88,18 @@ size3_t getVolumeDimensions(const std::shared_ptr<const Volume> &volume) {
     return dims;
 }
 
+std::shared_ptr<VolumeRAM> readVolumeRegion(const Volume &volume, const size3_t &offset,
+                                            const size3_t &dimensions) {
+    if (volume.hasValidRepresentation<VolumeRAM>()) return nullptr;
+    if (volume.hasValidRepresentation<VolumeBricked>()) {
+        return volume.getRepresentation<VolumeBricked>()->readRegion(offset, dimensions);
+    }
+    if (volume.hasValidRepresentation<VolumeDisk>()) {
+        return volume.getRepresentation<VolumeDisk>()->readRegion(offset, dimensions);
+    }
+    return nullptr;
+}
+
 } // namespace util
 
 }  // namespace inviwo
@@ -869,6 +869,7 @@ void InviwoMainWindow::openWorkspace() {
         openFileDialog.addSidebarPath(PathType::Workspaces);
         openFileDialog.addSidebarPath(workspaceFileDir_);
         openFileDialog.addExtension("inv", "Inviwo File");
+        openFileDialog.addExtension("invb", "Inviwo Binary File");
         openFileDialog.setFileMode(FileMode::AnyFile);
 
         if (openFileDialog.exec()) {
@@ -931,10 +932,11 @@ void InviwoMainWindow::saveWorkspaceAs() {
     saveFileDialog.addSidebarPath(workspaceFileDir_);
 
     saveFileDialog.addExtension("inv", "Inviwo File");
+    saveFileDialog.addExtension("invb", "Inviwo Binary File");
 
     if (saveFileDialog.exec()) {
         QString path = saveFileDialog.selectedFiles().at(0);
-        if (!path.endsWith(".inv")) path.append(".inv");
+        if (!path.endsWith(".inv") && !path.endsWith(".invb")) path.append(".inv");
 
         saveWorkspace(path);
         setCurrentWorkspace(path);
@@ -953,11 +955,12 @@ void InviwoMainWindow::saveWorkspaceAsCopy() {
     saveFileDialog.addSidebarPath(workspaceFileDir_);
 
     saveFileDialog.addExtension("inv", "Inviwo File");
+    saveFileDialog.addExtension("invb", "Inviwo Binary File");
 
     if (saveFileDialog.exec()) {
         QString path = saveFileDialog.selectedFiles().at(0);
 
-        if (!path.endsWith(".inv")) path.append(".inv");
+        if (!path.endsWith(".inv") && !path.endsWith(".invb")) path.append(".inv");
 
         saveWorkspace(path);
         addToRecentWorkspaces(path);
@@ -28,6 +28,13 @@
  *********************************************************************************/
 
 #include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/network/processornetworkevaluator.h>
+#include <inviwo/core/network/networklock.h>
+#include <inviwo/core/network/networkutils.h>
+#include <inviwo/core/ports/datainport.h>
+#include <inviwo/core/ports/dataoutport.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/settings/systemsettings.h>
 #include <modules/base/processors/volumesource.h>
 #include <modules/base/processors/cubeproxygeometryprocessor.h>
 #include <modules/base/processors/volumeslice.h>
@@ -35,6 +42,8 @@
 #include <warn/push>
 #include <warn/ignore/all>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <mutex>
 #include <warn/pop>
 
 namespace inviwo {
@@ -131,4 +140,144 @@ TEST_F(NetworkTest, ProcessorGetProperty) {
     ASSERT_TRUE(prop != nullptr);
 }
 
-}
\ No newline at end of file
+namespace {
+
+// Records the order in which processors are processed. Sinks have no outport.
+class OrderRecordingProcessor : public Processor {
+public:
+    OrderRecordingProcessor(const std::string& identifier, std::vector<std::string>& order,
+                            std::mutex& mutex, bool sink = false)
+        : Processor(), inport_("inport"), outport_("outport"), order_(order), mutex_(mutex) {
+        setIdentifier(identifier);
+        inport_.setOptional(true);
+        addPort(inport_);
+        if (!sink) addPort(outport_);
+    }
+
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return ProcessorInfo{"org.inviwo.OrderRecordingProcessor", "Order Recording",
+                             "Testing", CodeState::Experimental, Tags::CPU};
+    }
+
+    // Only sets its outport, so it can be processed on the pool
+    virtual bool requiresMainThread() const override { return false; }
+
+    // Ask the network for an evaluation
+    void requestEvaluate() { notifyObserversRequestEvaluate(this); }
+
+    virtual void process() override {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            order_.push_back(getIdentifier());
+        }
+        if (!isSink()) outport_.setData(std::make_shared<int>(0));
+    }
+
+    DataInport<int, 0> inport_;
+    DataOutport<int> outport_;
+
+private:
+    std::vector<std::string>& order_;
+    std::mutex& mutex_;
+};
+
+}  // namespace
+
+TEST(NetworkEvaluationTest, ParallelDiamond) {
+    auto app = InviwoApplication::getPtr();
+    auto& poolSize = app->getSettingsByType<SystemSettings>()->poolSize_;
+    const auto oldPoolSize = poolSize.get();
+    poolSize.set(4);
+    util::OnScopeExit restorePool{[&]() { poolSize.set(oldPoolSize); }};
+
+    std::vector<std::string> order;
+    std::mutex mutex;
+
+    ProcessorNetwork network(app);
+    ProcessorNetworkEvaluator evaluator(&network);
+    evaluator.setParallelEvaluation(true);
+    std::vector<OrderRecordingProcessor*> p;
+    {
+        NetworkLock lock(&network);
+        // a -> b, a -> c, b -> d, c -> d
+        for (auto id : {"a", "b", "c", "d"}) {
+            p.push_back(new OrderRecordingProcessor(id, order, mutex, id == std::string("d")));
+            network.addProcessor(p.back());
+        }
+        network.addConnection(&p[0]->outport_, &p[1]->inport_);
+        network.addConnection(&p[0]->outport_, &p[2]->inport_);
+        network.addConnection(&p[1]->outport_, &p[3]->inport_);
+        network.addConnection(&p[2]->outport_, &p[3]->inport_);
+    }
+    // The network is evaluated when unlocked, valid processors are not processed again
+    p.back()->requestEvaluate();
+
+    ASSERT_EQ(4u, order.size());
+    EXPECT_EQ("a", order.front());
+    EXPECT_EQ("d", order.back());
+    EXPECT_EQ(1, std::count(order.begin(), order.end(), "b"));
+    EXPECT_EQ(1, std::count(order.begin(), order.end(), "c"));
+}
+
+TEST(NetworkEvaluationTest, IncrementalSortOrder) {
+    auto app = InviwoApplication::getPtr();
+
+    std::vector<std::string> order;
+    std::mutex mutex;
+
+    ProcessorNetwork network(app);
+    ProcessorNetworkEvaluator evaluator(&network);
+
+    // Invalidate everything within a single lock to evaluate the whole network once using the
+    // incrementally maintained order, then compare against a full sort of the network.
+    auto checkOrder = [&]() {
+        order.clear();
+        {
+            NetworkLock lock(&network);
+            for (auto p : network.getProcessors()) p->invalidate(InvalidationLevel::InvalidOutput);
+        }
+        const auto sorted = util::topologicalSort(&network);
+        ASSERT_EQ(sorted.size(), order.size());
+        auto pos = [&](Processor* p) {
+            return std::find(order.begin(), order.end(), p->getIdentifier()) - order.begin();
+        };
+        for (auto p : sorted) {
+            EXPECT_EQ(1, std::count(order.begin(), order.end(), p->getIdentifier()));
+            for (auto successor : util::getDirectSuccessors(p)) {
+                EXPECT_LT(pos(p), pos(successor))
+                    << p->getIdentifier() << " before " << successor->getIdentifier();
+            }
+        }
+    };
+
+    std::vector<OrderRecordingProcessor*> p;
+    for (auto id : {"a", "b", "c", "s"}) {
+        p.push_back(new OrderRecordingProcessor(id, order, mutex, id == std::string("s")));
+        network.addProcessor(p.back());
+    }
+    auto& a = *p[0];
+    auto& b = *p[1];
+    auto& c = *p[2];
+    auto& s = *p[3];
+
+    // Each edit below is applied incrementally to the evaluation order
+    checkOrder();
+    network.addConnection(&a.outport_, &b.inport_);  // does not reach the sink
+    checkOrder();
+    network.addConnection(&b.outport_, &s.inport_);  // a and b are inserted before s
+    checkOrder();
+    network.addConnection(&c.outport_, &a.inport_);  // c is inserted before a
+    checkOrder();
+    network.removeConnection(&b.outport_, &s.inport_);  // a, b and c no longer reach the sink
+    checkOrder();
+    network.addConnection(&c.outport_, &s.inport_);  // only c reaches the sink
+    checkOrder();
+    network.removeConnection(&c.outport_, &a.inport_);
+    network.addConnection(&b.outport_, &c.inport_);  // a and b are moved before c
+    checkOrder();
+    network.removeProcessor(&a);
+    delete &a;
+    checkOrder();
+}
+
+}
@@ -33,15 +33,20 @@
 #include <inviwo/core/io/datareaderfactory.h>
 #include <inviwo/core/resources/templateresource.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
 #include <modules/opengl/volume/volumegl.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/filesystem.h>
 #include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/settings/systemsettings.h>
 #include <cmath>
 
 #include <warn/push>
 #include <warn/ignore/all>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <future>
 #include <warn/pop>
 
 
@@ -503,4 +508,80 @@ TEST(VolumeTest, IvfReaderCloneTypeFLOAT64BigEndian) {
     testIvfVolumeClone<double>("testdata.FLOAT64.BigEndian.ivf");
 }
 
+namespace {
+
+// Creates a float volume filled with value and counts the reads
+class CountingVolumeLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    CountingVolumeLoader(float value, std::shared_ptr<std::atomic<size_t>> reads)
+        : value_(value), reads_(reads) {}
+    virtual CountingVolumeLoader* clone() const override {
+        return new CountingVolumeLoader(*this);
+    }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        ++(*reads_);
+        auto ram = std::make_shared<VolumeRAMPrecision<float>>(size3_t(4));
+        std::fill(ram->getDataTyped(), ram->getDataTyped() + 4 * 4 * 4, value_);
+        return ram;
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {}
+
+private:
+    float value_;
+    std::shared_ptr<std::atomic<size_t>> reads_;
+};
+
+std::shared_ptr<Volume> createDiskVolume(float value, std::shared_ptr<std::atomic<size_t>> reads) {
+    auto disk = std::make_shared<VolumeDisk>(size3_t(4), DataFloat32::get());
+    disk->setLoader(new CountingVolumeLoader(value, reads));
+    return std::make_shared<Volume>(disk);
+}
+
+}  // namespace
+
+TEST(VolumeTest, RequestRepresentation) {
+    auto reads = std::make_shared<std::atomic<size_t>>(0);
+    auto volume = createDiskVolume(3.0f, reads);
+
+    auto request = volume->requestRepresentation<VolumeRAM>();
+    const auto ram = request.get();
+    ASSERT_TRUE(ram != nullptr);
+    EXPECT_EQ(3.0, ram->getAsDouble(size3_t(1, 2, 3)));
+
+    // The request created the same representation as getRepresentation would
+    EXPECT_EQ(ram, volume->getRepresentation<VolumeRAM>());
+    EXPECT_EQ(1u, reads->load());
+}
+
+TEST(VolumeTest, RequestRepresentationCancelled) {
+    auto app = InviwoApplication::getPtr();
+    auto& poolSize = app->getSettingsByType<SystemSettings>()->poolSize_;
+    const auto oldPoolSize = poolSize.get();
+    poolSize.set(1);
+    util::OnScopeExit restorePool{[&]() { poolSize.set(oldPoolSize); }};
+
+    auto reads = std::make_shared<std::atomic<size_t>>(0);
+    auto volume = createDiskVolume(3.0f, reads);
+
+    // Keep the only pool thread busy until the request has been cancelled
+    std::promise<void> started;
+    std::promise<void> release;
+    auto blocker = app->dispatchPool([&]() {
+        started.set_value();
+        release.get_future().wait();
+    });
+    started.get_future().wait();
+
+    CancellationToken token;
+    auto request =
+        volume->requestRepresentation<VolumeRAM>(ThreadPool::Priority::IO, token);
+    token.cancel();
+    release.set_value();
+    blocker.get();
+
+    EXPECT_THROW(request.get(), std::future_error);
+    EXPECT_FALSE(volume->hasRepresentation<VolumeRAM>());
+    EXPECT_EQ(0u, reads->load());
+}
+
 }
\ No newline at end of file